@@ -0,0 +1,706 @@
+#include "assemble.h"
+#include "batch.h"
+#include "pair.h"
+#include "topology.h"
+#include "ui.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Families
+// ═══════════════════════════════════════════════════════════════
+// Boards can share a miner when their names resolve to the same topology
+// record (machine name or one of its mix_boardnames). Without a config
+// the board name itself is the family.
+
+#define ASSEMBLY_MAX_SIZE    4
+#define ASSEMBLY_DEFAULT     3     // Miner size without -n or chain_num
+#define ASSEMBLY_VARIANTS    8     // Greedy orders tried per family
+#define ASSEMBLY_MAX_PASSES  16    // Local search rounds per variant
+
+typedef struct
+{
+	uint32_t member[ASSEMBLY_MAX_SIZE]; // Family-local board indices
+	uint16_t min_v;                // PT2 voltage range, hundredths
+	uint16_t max_v;
+} Miner;
+
+typedef struct
+{
+	Miner *miners;
+	size_t miner_count;
+	uint64_t hashrate;             // Sum over the boards placed
+	uint64_t spread;               // Sum of the miners' voltage ranges
+	int variant;
+} AssemblyResult;
+
+typedef struct
+{
+	char name[TOPOLOGY_NAME_LEN];
+	size_t size;                   // Boards per miner
+	uint32_t *rows;                // Inventory rows
+	uint16_t *voltage;             // Per board, same order as rows
+	uint16_t *hashrate;
+	size_t count;
+	size_t capacity;
+	AssemblyResult best;
+} AssemblyFamily;
+
+// Sweep hashrate when the board has one, PT2 nonce rate otherwise
+static uint16_t expected_hashrate(const PairBoard *board)
+{
+	return board->has_sweep && board->sweep_hashrate ? board->sweep_hashrate : board->nonce_rate;
+}
+
+static AssemblyFamily *family_for(AssemblyFamily **families, size_t *count, size_t *capacity,
+								  const char *name, size_t size)
+{
+	for (size_t i = 0; i < *count; i++)
+	{
+		if (strcmp((*families)[i].name, name) == 0)
+		{
+			return &(*families)[i];
+		}
+	}
+	if (*count == *capacity)
+	{
+		size_t next = *capacity ? *capacity * 2 : 16;
+		AssemblyFamily *grown = realloc(*families, next * sizeof(AssemblyFamily));
+		if (!grown)
+		{
+			return NULL;
+		}
+		*families = grown;
+		*capacity = next;
+	}
+
+	AssemblyFamily *family = &(*families)[(*count)++];
+	memset(family, 0, sizeof(*family));
+	snprintf(family->name, sizeof(family->name), "%s", name);
+	family->size = size;
+	return family;
+}
+
+static int family_add(AssemblyFamily *family, uint32_t row, const PairBoard *board)
+{
+	if (family->count == family->capacity)
+	{
+		size_t next = family->capacity ? family->capacity * 2 : 64;
+		uint32_t *rows = realloc(family->rows, next * sizeof(uint32_t));
+		if (rows)
+		{
+			family->rows = rows;
+		}
+		uint16_t *voltage = rows ? realloc(family->voltage, next * sizeof(uint16_t)) : NULL;
+		if (voltage)
+		{
+			family->voltage = voltage;
+		}
+		uint16_t *hashrate = voltage ? realloc(family->hashrate, next * sizeof(uint16_t)) : NULL;
+		if (!hashrate)
+		{
+			return -1;
+		}
+		family->hashrate = hashrate;
+		family->capacity = next;
+	}
+	family->rows[family->count] = row;
+	family->voltage[family->count] = board->voltage;
+	family->hashrate[family->count] = expected_hashrate(board);
+	family->count++;
+	return 0;
+}
+
+static void family_free(AssemblyFamily *family)
+{
+	free(family->rows);
+	free(family->voltage);
+	free(family->hashrate);
+	free(family->best.miners);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Solver
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	const AssemblyFamily *family;
+	int tolerance;                 // Max voltage range in a miner, hundredths
+	int32_t *slot;                 // Miner per board, -1 = unassigned
+	Miner *miners;
+	size_t miner_count;
+	uint64_t *keys;                // Sort scratch: key << 32 | board
+	uint32_t *list;                // Board scratch
+} Solver;
+
+static int key_compare(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t*)a, y = *(const uint64_t*)b;
+	return x < y ? -1 : x > y;
+}
+
+static uint32_t next_random(uint32_t *state)
+{
+	*state ^= *state << 13;
+	*state ^= *state >> 17;
+	*state ^= *state << 5;
+	return *state;
+}
+
+static void miner_range(const Solver *solver, Miner *miner)
+{
+	const uint16_t *v = solver->family->voltage;
+	miner->min_v = UINT16_MAX;
+	miner->max_v = 0;
+	for (size_t k = 0; k < solver->family->size; k++)
+	{
+		uint16_t value = v[miner->member[k]];
+		miner->min_v = value < miner->min_v ? value : miner->min_v;
+		miner->max_v = value > miner->max_v ? value : miner->max_v;
+	}
+}
+
+// Consecutive groups along list (sorted by voltage) whose range fits;
+// a board that cannot start a group is left out. Returns miners added.
+static size_t solver_greedy(Solver *solver, const uint32_t *list, size_t count)
+{
+	const AssemblyFamily *family = solver->family;
+	size_t size = family->size, added = 0, pos = 0;
+	while (pos + size <= count)
+	{
+		uint16_t lo = UINT16_MAX, hi = 0;
+		for (size_t k = 0; k < size; k++)
+		{
+			uint16_t value = family->voltage[list[pos + k]];
+			lo = value < lo ? value : lo;
+			hi = value > hi ? value : hi;
+		}
+		if (hi - lo > solver->tolerance)
+		{
+			pos++;
+			continue;
+		}
+
+		Miner *miner = &solver->miners[solver->miner_count];
+		for (size_t k = 0; k < size; k++)
+		{
+			miner->member[k] = list[pos + k];
+			solver->slot[list[pos + k]] = (int32_t)solver->miner_count;
+		}
+		miner->min_v = lo;
+		miner->max_v = hi;
+		solver->miner_count++;
+		added++;
+		pos += size;
+	}
+	return added;
+}
+
+// Unassigned boards by voltage, best hashrate first within a voltage
+static size_t solver_pool(Solver *solver, int by_hashrate)
+{
+	const AssemblyFamily *family = solver->family;
+	size_t n = 0;
+	for (size_t i = 0; i < family->count; i++)
+	{
+		if (solver->slot[i] < 0)
+		{
+			uint64_t h = UINT16_MAX - family->hashrate[i];
+			uint64_t key = by_hashrate ? h : ((uint64_t)family->voltage[i] << 16 | h);
+			solver->keys[n++] = key << 32 | i;
+		}
+	}
+	qsort(solver->keys, n, sizeof(uint64_t), key_compare);
+	for (size_t i = 0; i < n; i++)
+	{
+		solver->list[i] = (uint32_t)solver->keys[i];
+	}
+	return n;
+}
+
+// Swap unassigned boards into miners in place of weaker members while
+// the miner's voltage range still fits. Candidate miners are found by
+// binary search on a snapshot of their minimum voltages: a miner can
+// take board u only if its minimum lies in [v(u) - 2 tol, v(u) + tol].
+static int solver_swap_pass(Solver *solver, uint64_t *by_min)
+{
+	const AssemblyFamily *family = solver->family;
+	const uint16_t *v = family->voltage;
+	const uint16_t *h = family->hashrate;
+	size_t size = family->size;
+	int tol = solver->tolerance;
+	int improved = 0;
+
+	for (size_t m = 0; m < solver->miner_count; m++)
+	{
+		by_min[m] = (uint64_t)solver->miners[m].min_v << 32 | m;
+	}
+	qsort(by_min, solver->miner_count, sizeof(uint64_t), key_compare);
+
+	size_t pool = solver_pool(solver, 1);
+	for (size_t p = 0; p < pool; p++)
+	{
+		uint32_t u = solver->list[p];
+		int64_t lo_v = (int64_t)v[u] - 2 * tol, hi_v = (int64_t)v[u] + tol;
+
+		size_t lo = 0, hi = solver->miner_count;
+		while (lo < hi)
+		{
+			size_t mid = lo + (hi - lo) / 2;
+			if ((int64_t)(by_min[mid] >> 32) < lo_v)
+			{
+				lo = mid + 1;
+			}
+			else
+			{
+				hi = mid;
+			}
+		}
+
+		int best_gain = 0;
+		size_t best_miner = 0, best_member = 0;
+		for (size_t c = lo; c < solver->miner_count && (int64_t)(by_min[c] >> 32) <= hi_v; c++)
+		{
+			size_t m = (uint32_t)by_min[c];
+			const Miner *miner = &solver->miners[m];
+			for (size_t k = 0; k < size; k++)
+			{
+				int gain = (int)h[u] - (int)h[miner->member[k]];
+				if (gain <= best_gain)
+				{
+					continue;
+				}
+				int mn = v[u], mx = v[u];
+				for (size_t j = 0; j < size; j++)
+				{
+					if (j != k)
+					{
+						int value = v[miner->member[j]];
+						mn = value < mn ? value : mn;
+						mx = value > mx ? value : mx;
+					}
+				}
+				if (mx - mn <= tol)
+				{
+					best_gain = gain;
+					best_miner = m;
+					best_member = k;
+				}
+			}
+		}
+
+		if (best_gain > 0)
+		{
+			Miner *miner = &solver->miners[best_miner];
+			solver->slot[miner->member[best_member]] = -1;
+			miner->member[best_member] = u;
+			solver->slot[u] = (int32_t)best_miner;
+			miner_range(solver, miner);
+			improved = 1;
+		}
+	}
+	return improved;
+}
+
+// Greedy in the variant's order, then swap / regroup rounds until stable
+static int solve(const AssemblyFamily *family, int tolerance, int variant, AssemblyResult *result)
+{
+	size_t n = family->count;
+	size_t max_miners = n / family->size + 1;
+	Solver solver;
+	memset(&solver, 0, sizeof(solver));
+	solver.family = family;
+	solver.tolerance = tolerance;
+	solver.slot = malloc(n * sizeof(int32_t));
+	solver.miners = malloc(max_miners * sizeof(Miner));
+	solver.keys = malloc(n * sizeof(uint64_t));
+	solver.list = malloc(n * sizeof(uint32_t));
+	uint64_t *by_min = malloc(max_miners * sizeof(uint64_t));
+	if (!solver.slot || !solver.miners || !solver.keys || !solver.list || !by_min)
+	{
+		free(solver.slot);
+		free(solver.miners);
+		free(solver.keys);
+		free(solver.list);
+		free(by_min);
+		return -1;
+	}
+
+	// 0: rising voltage, 1: falling voltage, others: rising voltage with
+	// random order among equal voltages (best hashrate first otherwise)
+	uint32_t state = 0x9E3779B9u * (uint32_t)(variant + 1);
+	for (size_t i = 0; i < n; i++)
+	{
+		uint64_t v = variant == 1 ? UINT16_MAX - family->voltage[i] : family->voltage[i];
+		uint64_t tie = variant >= 2 ? (next_random(&state) & 0xFFFF) : (UINT16_MAX - family->hashrate[i]);
+		solver.keys[i] = (v << 16 | tie) << 32 | i;
+		solver.slot[i] = -1;
+	}
+	qsort(solver.keys, n, sizeof(uint64_t), key_compare);
+	for (size_t i = 0; i < n; i++)
+	{
+		solver.list[i] = (uint32_t)solver.keys[i];
+	}
+	solver_greedy(&solver, solver.list, n);
+
+	for (int pass = 0; pass < ASSEMBLY_MAX_PASSES; pass++)
+	{
+		int improved = solver_swap_pass(&solver, by_min);
+		size_t pool = solver_pool(&solver, 0);
+		improved |= solver_greedy(&solver, solver.list, pool) != 0;
+		if (!improved)
+		{
+			break;
+		}
+	}
+
+	memset(result, 0, sizeof(*result));
+	result->variant = variant;
+	result->miners = solver.miners;
+	result->miner_count = solver.miner_count;
+	for (size_t m = 0; m < solver.miner_count; m++)
+	{
+		const Miner *miner = &solver.miners[m];
+		for (size_t k = 0; k < family->size; k++)
+		{
+			result->hashrate += family->hashrate[miner->member[k]];
+		}
+		result->spread += (uint64_t)(miner->max_v - miner->min_v);
+	}
+
+	free(solver.slot);
+	free(solver.keys);
+	free(solver.list);
+	free(by_min);
+	return 0;
+}
+
+// More hashrate wins, then tighter voltages, then the lower variant
+static int result_better(const AssemblyResult *a, const AssemblyResult *b)
+{
+	if (a->hashrate != b->hashrate)
+	{
+		return a->hashrate > b->hashrate;
+	}
+	if (a->spread != b->spread)
+	{
+		return a->spread < b->spread;
+	}
+	return a->variant < b->variant;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Worker Pool
+// ═══════════════════════════════════════════════════════════════
+// Tasks are (family, variant) pairs. Each keeps its result only if it
+// beats the family's best so far, under the pool lock.
+
+typedef struct
+{
+	AssemblyFamily *families;
+	size_t family_count;
+	int tolerance;
+	size_t next_task;
+	size_t task_count;
+	int failed;
+	pthread_mutex_t lock;
+} AssemblyPool;
+
+static void *assembly_worker(void *arg)
+{
+	AssemblyPool *pool = (AssemblyPool*)arg;
+	for (;;)
+	{
+		pthread_mutex_lock(&pool->lock);
+		size_t task = pool->next_task++;
+		pthread_mutex_unlock(&pool->lock);
+		if (task >= pool->task_count)
+		{
+			return NULL;
+		}
+
+		AssemblyFamily *family = &pool->families[task / ASSEMBLY_VARIANTS];
+		AssemblyResult result;
+		if (solve(family, pool->tolerance, (int)(task % ASSEMBLY_VARIANTS), &result) != 0)
+		{
+			pool->failed = 1;
+			continue;
+		}
+
+		pthread_mutex_lock(&pool->lock);
+		if (!family->best.miners || result_better(&result, &family->best))
+		{
+			free(family->best.miners);
+			family->best = result;
+			result.miners = NULL;
+		}
+		pthread_mutex_unlock(&pool->lock);
+		free(result.miners);
+	}
+}
+
+static int assembly_run(AssemblyFamily *families, size_t family_count, int tolerance)
+{
+	AssemblyPool pool;
+	memset(&pool, 0, sizeof(pool));
+	pool.families = families;
+	pool.family_count = family_count;
+	pool.tolerance = tolerance;
+	pool.task_count = family_count * ASSEMBLY_VARIANTS;
+	pthread_mutex_init(&pool.lock, NULL);
+
+	int threads = batch_thread_count();
+	threads = threads < 1 ? 1 : threads > 64 ? 64 : threads;
+	pthread_t workers[64];
+	int started = 0;
+	for (int i = 0; i < threads; i++)
+	{
+		if (pthread_create(&workers[started], NULL, assembly_worker, &pool) == 0)
+		{
+			started++;
+		}
+	}
+	if (started == 0)
+	{
+		assembly_worker(&pool);
+	}
+	for (int i = 0; i < started; i++)
+	{
+		pthread_join(workers[i], NULL);
+	}
+	pthread_mutex_destroy(&pool.lock);
+	return pool.failed ? -1 : 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+static void render_family(EmitBuffer *buf, const AssemblyFamily *family, const PairInventory *inventory,
+						  int csv, size_t *miner_number)
+{
+	const AssemblyResult *best = &family->best;
+	for (size_t m = 0; m < best->miner_count; m++)
+	{
+		const Miner *miner = &best->miners[m];
+		uint32_t members[ASSEMBLY_MAX_SIZE];
+		uint32_t total = 0;
+		memcpy(members, miner->member, sizeof(members));
+		for (size_t k = 1; k < family->size; k++)
+		{
+			for (size_t j = k; j > 0 && family->voltage[members[j]] < family->voltage[members[j - 1]]; j--)
+			{
+				uint32_t swap = members[j];
+				members[j] = members[j - 1];
+				members[j - 1] = swap;
+			}
+		}
+		(*miner_number)++;
+
+		for (size_t k = 0; k < family->size; k++)
+		{
+			total += family->hashrate[members[k]];
+		}
+		if (!csv)
+		{
+			ui_appendf(buf, "  %5zu  %-10s %5.2f-%-5.2f %9u ", *miner_number, family->name,
+					   miner->min_v / 100.0, miner->max_v / 100.0, total);
+		}
+		for (size_t k = 0; k < family->size; k++)
+		{
+			const PairBoard *board = &inventory->boards[family->rows[members[k]]];
+			if (csv)
+			{
+				ui_appendf(buf, "%zu,%s,%s,%s,%.2f,%u\n", *miner_number, family->name, board->serial,
+						   board->board, board->voltage / 100.0, family->hashrate[members[k]]);
+			}
+			else
+			{
+				ui_appendf(buf, " %s", board->serial[0] ? board->serial : "-");
+			}
+		}
+		if (!csv)
+		{
+			emit_char(buf, '\n');
+		}
+	}
+}
+
+int cmd_assemble(int argc, char **argv)
+{
+	const char *topology_dir = NULL;
+	size_t forced_size = 0;
+	double tolerance_volts = 0.10;
+	int include_failed = 0;
+	int csv = 0;
+	char *paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			topology_dir = argv[++i];
+		}
+		else if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+		{
+			forced_size = strtoul(argv[++i], NULL, 10);
+			if (forced_size != 3 && forced_size != 4)
+			{
+				fprintf(stderr, "Error: Miner size must be 3 or 4\n");
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "-V") == 0 && i + 1 < argc)
+		{
+			tolerance_volts = strtod(argv[++i], NULL);
+		}
+		else if (strcmp(argv[i], "-a") == 0)
+		{
+			include_failed = 1;
+		}
+		else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+		{
+			const char *format = argv[++i];
+			if (strcmp(format, "text") != 0 && strcmp(format, "csv") != 0)
+			{
+				fprintf(stderr, "Error: Unknown format '%s' (text, csv)\n", format);
+				return 1;
+			}
+			csv = format[0] == 'c';
+		}
+		else
+		{
+			paths[path_count++] = argv[i];
+		}
+	}
+
+	if (path_count == 0)
+	{
+		fprintf(stderr, "Usage: eeprom_tool assemble [-t TOPOLOGY_DIR] [-n 3|4] [-V VOLTS] [-a]\n"
+						"                             [-f text|csv] PATH...\n");
+		return 1;
+	}
+
+	TopologyDB *topologies = NULL;
+	if (topology_dir && !(topologies = topology_open(topology_dir)))
+	{
+		return 1;
+	}
+
+	PairInventory inventory;
+	if (pair_inventory_load(paths, path_count, &inventory) < 0 && inventory.count == 0)
+	{
+		topology_close(topologies);
+		return 1;
+	}
+
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+
+	AssemblyFamily *families = NULL;
+	size_t family_count = 0, family_capacity = 0, failed_pt2 = 0, unnamed = 0;
+	int result = 0;
+	for (size_t i = 0; i < inventory.count && result == 0; i++)
+	{
+		const PairBoard *board = &inventory.boards[i];
+		if (!board->board[0])
+		{
+			unnamed++;
+			continue;
+		}
+		if (!board->pt2_pass && !include_failed)
+		{
+			failed_pt2++;
+			continue;
+		}
+
+		const TopologyBoard *topology = topology_find(topologies, board->board);
+		size_t size = forced_size ? forced_size : ASSEMBLY_DEFAULT;
+		if (!forced_size && topology && (topology->chain_num == 3 || topology->chain_num == 4))
+		{
+			size = topology->chain_num;
+		}
+		AssemblyFamily *family = family_for(&families, &family_count, &family_capacity,
+											topology ? topology->machine : board->board, size);
+		if (!family || family_add(family, (uint32_t)i, board) != 0)
+		{
+			fprintf(stderr, "Error: Out of memory\n");
+			result = 1;
+		}
+	}
+
+	if (result == 0 && assembly_run(families, family_count, (int)lround(tolerance_volts * 100.0)) != 0)
+	{
+		fprintf(stderr, "Error: Out of memory\n");
+		result = 1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &end);
+
+	if (result == 0)
+	{
+		size_t placed = 0, miners = 0, candidates = 0;
+		uint64_t hashrate = 0, available = 0;
+		for (size_t f = 0; f < family_count; f++)
+		{
+			const AssemblyFamily *family = &families[f];
+			candidates += family->count;
+			miners += family->best.miner_count;
+			placed += family->best.miner_count * family->size;
+			hashrate += family->best.hashrate;
+			for (size_t i = 0; i < family->count; i++)
+			{
+				available += family->hashrate[i];
+			}
+		}
+
+		EmitBuffer buf = { 0 };
+		size_t miner_number = 0;
+		if (csv)
+		{
+			ui_appendf(&buf, "miner,family,serial,board,voltage,hashrate\n");
+		}
+		else
+		{
+			ui_render_header(&buf, "Miner Assembly");
+			ui_appendf(&buf, "  %5s  %-10s %-11s %9s  %s\n", "Miner", "Family", "PT2 V", "Hashrate", "Boards");
+			ui_render_separator(&buf);
+		}
+		for (size_t f = 0; f < family_count; f++)
+		{
+			render_family(&buf, &families[f], &inventory, csv, &miner_number);
+		}
+		if (!csv)
+		{
+			ui_render_separator(&buf);
+			ui_appendf(&buf, "  Boards: %zu, PT2 failed: %zu, no board name: %zu, families: %zu\n",
+					   inventory.count, failed_pt2, unnamed, family_count);
+			ui_appendf(&buf, "  Miners: %zu using %zu of %zu boards, expected hashrate %llu of %llu (%.1f%%)\n",
+					   miners, placed, candidates, (unsigned long long)hashrate, (unsigned long long)available,
+					   available ? 100.0 * (double)hashrate / (double)available : 0.0);
+		}
+		ui_flush(&buf);
+		emit_buffer_free(&buf);
+
+		double ms = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+		fprintf(stderr, "Optimized %zu families x %d orders in %.1f ms\n", family_count, ASSEMBLY_VARIANTS, ms);
+	}
+
+	for (size_t f = 0; f < family_count; f++)
+	{
+		family_free(&families[f]);
+	}
+	free(families);
+	pair_inventory_free(&inventory);
+	topology_close(topologies);
+	return result;
+}
@@ -0,0 +1,13 @@
+#ifndef ASSEMBLE_H
+#define ASSEMBLE_H
+
+// CLI: eeprom_tool assemble [-t TOPOLOGY_DIR] [-n 3|4] [-V VOLTS] [-a]
+//                           [-f text|csv] PATH...
+// Partitions the decoded boards into miners of 3 or 4 hashboards that
+// share a board family and a PT2 voltage window, maximizing the total
+// expected hashrate of the boards placed (sweep hashrate, else PT2 nonce
+// rate). Greedy grouping on voltage order is refined by local search;
+// families and restarts run on the batch worker threads.
+int cmd_assemble(int argc, char **argv);
+
+#endif // ASSEMBLE_H
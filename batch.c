@@ -0,0 +1,613 @@
+#include "batch.h"
+#include "eeprom_defs.h"
+#include "dump_format.h"
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <strings.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+
+#ifdef HAVE_DIR_WALKER
+#include "dir_walker.h"
+#endif
+
+#define TAR_BLOCK_SIZE 512
+
+static BatchOptions batch_options = { .cache_mb = DECODE_CACHE_DEFAULT_MB };
+static DecodeCache *batch_cache;
+static pthread_once_t batch_cache_once = PTHREAD_ONCE_INIT;
+
+typedef struct
+{
+	batch_filter_cb filter;
+	batch_image_cb cb;
+	void *ctx;
+	BatchStats *stats;
+} BatchWalk;
+
+// Locate the 256-byte window (raw, programmer dump, Intel HEX, hex text)
+static int batch_image(const char *name, const uint8_t *raw, size_t size, BatchWalk *walk)
+{
+	uint8_t window[EEPROM_SIZE];
+	DumpInfo info;
+
+	if (dump_extract(raw, size, window, &info) != 0)
+	{
+		walk->stats->skipped++;
+		return 0;
+	}
+
+	walk->stats->images++;
+	size_t len = info.image_size < EEPROM_SIZE ? info.image_size : EEPROM_SIZE;
+	return walk->cb(name, window, len, walk->ctx);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Tar archives (ustar / GNU, uncompressed)
+// ═══════════════════════════════════════════════════════════════
+
+static int tar_is_header(const uint8_t *block)
+{
+	return memcmp(block + 257, "ustar", 5) == 0;
+}
+
+static size_t tar_octal(const uint8_t *field, size_t len)
+{
+	size_t value = 0;
+	for (size_t i = 0; i < len && field[i]; i++)
+	{
+		if (field[i] < '0' || field[i] > '7')
+		{
+			continue;
+		}
+		value = (value << 3) | (field[i] - '0');
+	}
+	return value;
+}
+
+static int batch_tar(int fd, const char *path, const struct stat *archive, BatchWalk *walk)
+{
+	uint8_t block[TAR_BLOCK_SIZE];
+	uint8_t *data = NULL;
+	char name[512];
+	int stop = 0;
+
+	while (read(fd, block, TAR_BLOCK_SIZE) == TAR_BLOCK_SIZE)
+	{
+		if (block[0] == 0 || !tar_is_header(block))
+		{
+			break;
+		}
+
+		size_t size = tar_octal(block + 124, 12);
+		size_t padded = (size + TAR_BLOCK_SIZE - 1) & ~(size_t)(TAR_BLOCK_SIZE - 1);
+		char type = (char)block[156];
+
+		if (type != '0' && type != '\0')
+		{
+			lseek(fd, (off_t)padded, SEEK_CUR);
+			continue;
+		}
+
+		walk->stats->files_seen++;
+
+		if (size == 0 || size > DUMP_MAX_SIZE)
+		{
+			walk->stats->skipped++;
+			lseek(fd, (off_t)padded, SEEK_CUR);
+			continue;
+		}
+
+		// ustar prefix (345..499) + name (0..99)
+		if (block[345])
+		{
+			snprintf(name, sizeof(name), "%s:%.155s/%.100s", path,
+					 (const char*)block + 345, (const char*)block);
+		}
+		else
+		{
+			snprintf(name, sizeof(name), "%s:%.100s", path, (const char*)block);
+		}
+
+		if (walk->filter)
+		{
+			struct stat st = *archive;
+			st.st_size = (off_t)size;
+			st.st_mtim.tv_sec = (time_t)tar_octal(block + 136, 12);
+			st.st_mtim.tv_nsec = 0;
+
+			if (!walk->filter(name, &st, walk->ctx))
+			{
+				walk->stats->filtered++;
+				lseek(fd, (off_t)padded, SEEK_CUR);
+				continue;
+			}
+		}
+
+		if (!data && !(data = malloc(DUMP_MAX_SIZE)))
+		{
+			walk->stats->skipped++;
+			break;
+		}
+		if (read(fd, data, size) != (ssize_t)size)
+		{
+			walk->stats->skipped++;
+			break;
+		}
+		lseek(fd, (off_t)(padded - size), SEEK_CUR);
+
+		if (batch_image(name, data, size, walk))
+		{
+			stop = 1;
+			break;
+		}
+	}
+
+	free(data);
+	return stop;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Files and directories
+// ═══════════════════════════════════════════════════════════════
+
+static int batch_file(const char *path, const struct stat *st, BatchWalk *walk)
+{
+	if (walk->filter && !walk->filter(path, st, walk->ctx))
+	{
+		walk->stats->files_seen++;
+		walk->stats->filtered++;
+		return 0;
+	}
+
+	int fd = open(path, O_RDONLY);
+	if (fd < 0)
+	{
+		walk->stats->skipped++;
+		return 0;
+	}
+
+	// Most inputs are raw 256-byte images; only larger dumps need the heap
+	uint8_t block[TAR_BLOCK_SIZE];
+	ssize_t n = read(fd, block, sizeof(block));
+
+	if (n == TAR_BLOCK_SIZE && tar_is_header(block))
+	{
+		lseek(fd, 0, SEEK_SET);
+		int stop = batch_tar(fd, path, st, walk);
+		close(fd);
+		return stop;
+	}
+
+	walk->stats->files_seen++;
+
+	if (n <= 0)
+	{
+		close(fd);
+		walk->stats->skipped++;
+		return 0;
+	}
+
+	if (n < TAR_BLOCK_SIZE)
+	{
+		close(fd);
+		return batch_image(path, block, (size_t)n, walk);
+	}
+
+	// Same limits as read_eeprom_file(): 1..DUMP_MAX_SIZE bytes
+	uint8_t *raw = malloc(DUMP_MAX_SIZE + 1);
+	if (!raw)
+	{
+		close(fd);
+		walk->stats->skipped++;
+		return 0;
+	}
+
+	memcpy(raw, block, (size_t)n);
+	size_t size = (size_t)n;
+	while (size <= DUMP_MAX_SIZE && (n = read(fd, raw + size, DUMP_MAX_SIZE + 1 - size)) > 0)
+	{
+		size += (size_t)n;
+	}
+	close(fd);
+
+	int stop = 0;
+	if (size > DUMP_MAX_SIZE)
+	{
+		walk->stats->skipped++;
+	}
+	else
+	{
+		stop = batch_image(path, raw, size, walk);
+	}
+
+	free(raw);
+	return stop;
+}
+
+#ifdef HAVE_DIR_WALKER
+
+// Walker threads enumerate the tree while this thread reads and decodes
+static int batch_dir(const char *path, BatchWalk *walk)
+{
+	DirWalkerOptions options;
+	memset(&options, 0, sizeof(options));
+	options.threads = batch_options.threads;
+	options.extensions = batch_options.extensions;
+	options.max_size = DUMP_MAX_SIZE;
+	options.always_ext = ".tar";
+
+	DirWalker *walker = dir_walker_start(path, &options);
+	if (!walker)
+	{
+		walk->stats->skipped++;
+		return 0;
+	}
+
+	DirWalkerEntry entry;
+	int stop = 0;
+	while (!stop && dir_walker_next(walker, &entry))
+	{
+		stop = batch_file(entry.path, &entry.st, walk);
+		free(entry.path);
+	}
+
+	dir_walker_finish(walker);
+	return stop;
+}
+
+#else
+
+static int has_extension(const char *name, const char *list)
+{
+	const char *dot = strrchr(name, '.');
+	if (!dot)
+	{
+		return 0;
+	}
+
+	size_t len = strlen(dot);
+	for (const char *p = list; *p; )
+	{
+		size_t item = strcspn(p, ",");
+		if (item == len && strncasecmp(p, dot, len) == 0)
+		{
+			return 1;
+		}
+		p += item + (p[item] == ',');
+	}
+	return 0;
+}
+
+static int batch_dir(const char *path, BatchWalk *walk)
+{
+	DIR *dir = opendir(path);
+	if (!dir)
+	{
+		walk->stats->skipped++;
+		return 0;
+	}
+
+	struct dirent *entry;
+	char child[4096];
+	int stop = 0;
+
+	while (!stop && (entry = readdir(dir)) != NULL)
+	{
+		if (entry->d_name[0] == '.' &&
+			(entry->d_name[1] == '\0' || (entry->d_name[1] == '.' && entry->d_name[2] == '\0')))
+		{
+			continue;
+		}
+
+		snprintf(child, sizeof(child), "%s/%s", path, entry->d_name);
+
+		// The filter needs size/mtime/inode, otherwise d_type is enough
+		struct stat st;
+		memset(&st, 0, sizeof(st));
+		unsigned char type = entry->d_type;
+		if (walk->filter || type == DT_UNKNOWN || type == DT_LNK)
+		{
+			if (stat(child, &st) != 0)
+			{
+				continue;
+			}
+			type = S_ISDIR(st.st_mode) ? DT_DIR : (S_ISREG(st.st_mode) ? DT_REG : DT_UNKNOWN);
+		}
+
+		if (type == DT_DIR)
+		{
+			stop = batch_dir(child, walk);
+		}
+		else if (type == DT_REG)
+		{
+			if (batch_options.extensions && !has_extension(entry->d_name, batch_options.extensions) &&
+				!has_extension(entry->d_name, ".tar"))
+			{
+				continue;
+			}
+			stop = batch_file(child, &st, walk);
+		}
+	}
+
+	closedir(dir);
+	return stop;
+}
+
+#endif // HAVE_DIR_WALKER
+
+int batch_parse_option(int argc, char **argv, int *i)
+{
+	if ((strcmp(argv[*i], "-j") == 0 || strcmp(argv[*i], "--threads") == 0) && *i + 1 < argc)
+	{
+		batch_options.threads = atoi(argv[++*i]);
+		return 1;
+	}
+	if (strcmp(argv[*i], "--ext") == 0 && *i + 1 < argc)
+	{
+		batch_options.extensions = argv[++*i];
+		return 1;
+	}
+	if (strcmp(argv[*i], "--cache") == 0 && *i + 1 < argc)
+	{
+		batch_options.cache_dir = argv[++*i];
+		return 1;
+	}
+	if (strcmp(argv[*i], "--cache-size") == 0 && *i + 1 < argc)
+	{
+		batch_options.cache_mb = strtoul(argv[++*i], NULL, 10);
+		return 1;
+	}
+	return 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Decode Cache
+// ═══════════════════════════════════════════════════════════════
+
+static void batch_cache_open(void)
+{
+	if (batch_options.cache_dir)
+	{
+		batch_cache = decode_cache_open(batch_options.cache_dir, batch_options.cache_mb << 20);
+	}
+}
+
+int batch_decode(uint8_t data[EEPROM_SIZE], EEPROMCheck *check)
+{
+	pthread_once(&batch_cache_once, batch_cache_open);
+	return decode_cache_decode(batch_cache, data, check);
+}
+
+int batch_decode_cached(uint8_t data[EEPROM_SIZE], EEPROMCheck *check)
+{
+	pthread_once(&batch_cache_once, batch_cache_open);
+	int result;
+	return batch_cache && decode_cache_lookup(batch_cache, data, check, &result);
+}
+
+int batch_cache_stats(DecodeCacheStats *stats)
+{
+	if (!batch_cache)
+	{
+		return 0;
+	}
+	decode_cache_get_stats(batch_cache, stats);
+	return 1;
+}
+
+void batch_finish(void)
+{
+	decode_cache_close(batch_cache);
+	batch_cache = NULL;
+}
+
+int batch_thread_count(void)
+{
+	if (batch_options.threads > 0)
+	{
+		return batch_options.threads;
+	}
+	long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+	return cpus > 0 ? (int)cpus : 1;
+}
+
+int batch_for_each_filtered(const char *path, batch_filter_cb filter, batch_image_cb cb,
+							void *ctx, BatchStats *stats)
+{
+	BatchStats local;
+	if (!stats)
+	{
+		memset(&local, 0, sizeof(local));
+		stats = &local;
+	}
+
+	BatchWalk walk = { filter, cb, ctx, stats };
+
+	struct stat st;
+	if (stat(path, &st) != 0)
+	{
+		fprintf(stderr, "Error: Cannot open %s\n", path);
+		return -1;
+	}
+
+	if (S_ISDIR(st.st_mode))
+	{
+		batch_dir(path, &walk);
+	}
+	else
+	{
+		batch_file(path, &st, &walk);
+	}
+
+	return 0;
+}
+
+int batch_for_each(const char *path, batch_image_cb cb, void *ctx, BatchStats *stats)
+{
+	return batch_for_each_filtered(path, NULL, cb, ctx, stats);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Parallel consumers
+// ═══════════════════════════════════════════════════════════════
+// The walk runs on the calling thread and copies each image into a
+// bounded queue; worker threads pop and run the callback.
+
+#define BATCH_QUEUE       256
+#define BATCH_MAX_WORKERS 64
+
+typedef struct
+{
+	char *name;
+	uint8_t data[EEPROM_SIZE];
+	size_t size;
+} BatchJob;
+
+typedef struct
+{
+	batch_image_cb cb;
+	void *ctx;
+
+	pthread_mutex_t lock;
+	pthread_cond_t not_empty;
+	pthread_cond_t not_full;
+	BatchJob jobs[BATCH_QUEUE];
+	size_t head;
+	size_t count;
+	int done;
+	int stop;                      // A callback returned non-zero
+} BatchPool;
+
+static int batch_enqueue(const char *name, const uint8_t *data, size_t size, void *ctx)
+{
+	BatchPool *pool = (BatchPool*)ctx;
+	char *copy = strdup(name);
+	if (!copy)
+	{
+		fprintf(stderr, "Error: Out of memory\n");
+		return 1;
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	while (pool->count == BATCH_QUEUE && !pool->stop)
+	{
+		pthread_cond_wait(&pool->not_full, &pool->lock);
+	}
+	if (pool->stop)
+	{
+		pthread_mutex_unlock(&pool->lock);
+		free(copy);
+		return 1;
+	}
+	BatchJob *job = &pool->jobs[(pool->head + pool->count) % BATCH_QUEUE];
+	job->name = copy;
+	job->size = size < EEPROM_SIZE ? size : EEPROM_SIZE;
+	memcpy(job->data, data, job->size);
+	pool->count++;
+	pthread_cond_signal(&pool->not_empty);
+	pthread_mutex_unlock(&pool->lock);
+	return 0;
+}
+
+static int batch_stopped(BatchPool *pool)
+{
+	pthread_mutex_lock(&pool->lock);
+	int stop = pool->stop;
+	pthread_mutex_unlock(&pool->lock);
+	return stop;
+}
+
+static void *batch_worker(void *arg)
+{
+	BatchPool *pool = (BatchPool*)arg;
+	BatchJob job;
+
+	for (;;)
+	{
+		pthread_mutex_lock(&pool->lock);
+		while (pool->count == 0 && !pool->done)
+		{
+			pthread_cond_wait(&pool->not_empty, &pool->lock);
+		}
+		if (pool->count == 0)
+		{
+			pthread_mutex_unlock(&pool->lock);
+			break;
+		}
+		job = pool->jobs[pool->head];
+		pool->head = (pool->head + 1) % BATCH_QUEUE;
+		pool->count--;
+		int stop = pool->stop;
+		pthread_cond_signal(&pool->not_full);
+		pthread_mutex_unlock(&pool->lock);
+
+		if (!stop && pool->cb(job.name, job.data, job.size, pool->ctx) != 0)
+		{
+			pthread_mutex_lock(&pool->lock);
+			pool->stop = 1;
+			pthread_cond_broadcast(&pool->not_full);
+			pthread_mutex_unlock(&pool->lock);
+		}
+		free(job.name);
+	}
+	return NULL;
+}
+
+int batch_for_each_parallel(char **paths, int count, batch_image_cb cb, void *ctx, BatchStats *stats)
+{
+	int threads = batch_thread_count();
+	if (threads > BATCH_MAX_WORKERS)
+	{
+		threads = BATCH_MAX_WORKERS;
+	}
+
+	BatchPool *pool = calloc(1, sizeof(*pool));
+	if (!pool)
+	{
+		fprintf(stderr, "Error: Out of memory\n");
+		return -1;
+	}
+	pool->cb = cb;
+	pool->ctx = ctx;
+	pthread_mutex_init(&pool->lock, NULL);
+	pthread_cond_init(&pool->not_empty, NULL);
+	pthread_cond_init(&pool->not_full, NULL);
+
+	pthread_t workers[BATCH_MAX_WORKERS];
+	int started = 0;
+	for (; started < threads; started++)
+	{
+		if (pthread_create(&workers[started], NULL, batch_worker, pool) != 0)
+		{
+			break;
+		}
+	}
+
+	int result = started > 0 ? 0 : -1;
+	for (int i = 0; i < count && started > 0 && !batch_stopped(pool); i++)
+	{
+		if (batch_for_each(paths[i], batch_enqueue, pool, stats) != 0)
+		{
+			result = -1;
+		}
+	}
+
+	pthread_mutex_lock(&pool->lock);
+	pool->done = 1;
+	pthread_cond_broadcast(&pool->not_empty);
+	pthread_mutex_unlock(&pool->lock);
+	for (int i = 0; i < started; i++)
+	{
+		pthread_join(workers[i], NULL);
+	}
+
+	pthread_mutex_destroy(&pool->lock);
+	pthread_cond_destroy(&pool->not_empty);
+	pthread_cond_destroy(&pool->not_full);
+	free(pool);
+	return result;
+}
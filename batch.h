@@ -0,0 +1,69 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/stat.h>
+#include "decode_cache.h"
+#include "eeprom_ops.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Batch Input: files, directory trees and tar archives
+// ═══════════════════════════════════════════════════════════════
+
+// Called once per image found. name is the file path (or "archive:member"),
+// data holds size bytes (size <= EEPROM_SIZE). Return non-zero to stop.
+typedef int (*batch_image_cb)(const char *name, const uint8_t *data, size_t size, void *ctx);
+
+// Optional: called with the stat of a file (or tar member: size, mtime and
+// the archive's device/inode) before it is read. Return 0 to skip reading.
+typedef int (*batch_filter_cb)(const char *name, const struct stat *st, void *ctx);
+
+typedef struct
+{
+	size_t files_seen;             // Regular files / archive members visited
+	size_t images;                 // Images passed to the callback
+	size_t skipped;                // Wrong size or unreadable
+	size_t filtered;               // Not read because the filter declined them
+} BatchStats;
+
+// Options shared by all batch commands (-j N, --ext LIST, --cache DIR,
+// --cache-size MB)
+typedef struct
+{
+	int threads;                   // Directory walker threads, 0 = number of CPUs
+	const char *extensions;        // ".bin,.eep": only files with these extensions
+	const char *cache_dir;         // Decode cache directory, NULL = no cache
+	size_t cache_mb;               // Decode cache size bound
+} BatchOptions;
+
+// If argv[*i] is a batch option, consume it (and its value) and return 1
+int batch_parse_option(int argc, char **argv, int *i);
+
+// Thread count from -j, or the number of CPUs if not given
+int batch_thread_count(void);
+
+// eeprom_decode_check() of an image of unknown version, through the
+// --cache decode cache when one was given (opened on first use).
+// Thread-safe.
+int batch_decode(uint8_t data[EEPROM_SIZE], EEPROMCheck *check);
+// Decode cache lookup only, for callers that decode part of an image on a
+// miss: returns 1 and decodes data in place on hit, 0 otherwise
+int batch_decode_cached(uint8_t data[EEPROM_SIZE], EEPROMCheck *check);
+// Statistics of the decode cache; returns 0 if none is open
+int batch_cache_stats(DecodeCacheStats *stats);
+// Write back and close the decode cache (after the command has run)
+void batch_finish(void);
+
+// Walk a file, directory (recursively) or tar archive and feed every
+// candidate image to cb. Returns 0 on success, -1 if path cannot be opened.
+int batch_for_each(const char *path, batch_image_cb cb, void *ctx, BatchStats *stats);
+int batch_for_each_filtered(const char *path, batch_filter_cb filter, batch_image_cb cb,
+							void *ctx, BatchStats *stats);
+
+// Walk every path, running cb on batch_thread_count() worker threads with
+// a private copy of each image. cb must be thread-safe; returning non-zero
+// stops the walk. Returns -1 if a path could not be opened.
+int batch_for_each_parallel(char **paths, int count, batch_image_cb cb, void *ctx, BatchStats *stats);
+
+#endif // BATCH_H
@@ -0,0 +1,155 @@
+#include "bench.h"
+#include "batch.h"
+#include "eeprom_defs.h"
+#include "eeprom_ops.h"
+#include "ui.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define BENCH_HAVE_TSC 1
+#endif
+
+typedef int (*bench_decode_fn)(uint8_t *data, size_t size, EEPROMVersion version, EEPROMCheck *check);
+
+typedef struct
+{
+	uint8_t (*images)[EEPROM_SIZE];
+	size_t count;
+	size_t capacity;
+} BenchSet;
+
+static int bench_collect(const char *name, const uint8_t *data, size_t size, void *ctx)
+{
+	BenchSet *set = (BenchSet*)ctx;
+	(void)name;
+
+	if (set->count == set->capacity)
+	{
+		size_t capacity = set->capacity ? set->capacity * 2 : 256;
+		void *images = realloc(set->images, capacity * EEPROM_SIZE);
+		if (!images)
+		{
+			fprintf(stderr, "Error: Out of memory\n");
+			return 1;
+		}
+		set->images = images;
+		set->capacity = capacity;
+	}
+
+	memset(set->images[set->count], 0xFF, EEPROM_SIZE);
+	memcpy(set->images[set->count], data, size < EEPROM_SIZE ? size : EEPROM_SIZE);
+	set->count++;
+	return 0;
+}
+
+static double now_ns(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint64_t now_cycles(void)
+{
+#ifdef BENCH_HAVE_TSC
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+typedef struct
+{
+	double ns;
+	uint64_t cycles;
+	uint32_t digest;               // Folded CRC/test results, to compare paths
+} BenchResult;
+
+static void bench_run(const BenchSet *set, bench_decode_fn decode, int rounds, BenchResult *result)
+{
+	uint8_t work[EEPROM_SIZE];
+	uint32_t digest = 0;
+
+	double start_ns = now_ns();
+	uint64_t start_cycles = now_cycles();
+
+	for (int r = 0; r < rounds; r++)
+	{
+		for (size_t i = 0; i < set->count; i++)
+		{
+			EEPROMCheck check;
+			memcpy(work, set->images[i], EEPROM_SIZE);
+			decode(work, EEPROM_SIZE, EEPROM_VERSION_UNKNOWN, &check);
+			digest = digest * 31 + (check.crc_ok << 8 | check.test_pass) + work[EEPROM_SIZE / 2];
+		}
+	}
+
+	result->cycles = now_cycles() - start_cycles;
+	result->ns = now_ns() - start_ns;
+	result->digest = digest;
+}
+
+int cmd_bench(int argc, char **argv)
+{
+	BenchSet set;
+	memset(&set, 0, sizeof(set));
+	int rounds = 0;
+	int paths = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-n") == 0 && i + 1 < argc)
+		{
+			rounds = atoi(argv[++i]);
+			continue;
+		}
+		batch_for_each(argv[i], bench_collect, &set, NULL);
+		paths++;
+	}
+
+	if (paths == 0 || set.count == 0)
+	{
+		fprintf(stderr, "Usage: eeprom_tool bench [-n ROUNDS] PATH...\n");
+		free(set.images);
+		return 1;
+	}
+
+	// Default: about 200k decodes per path
+	if (rounds <= 0)
+	{
+		rounds = (int)(200000 / set.count) + 1;
+	}
+
+	BenchResult generic, special;
+	bench_run(&set, eeprom_decode_check, 1, &special);     // Warm up caches and key schedules
+	bench_run(&set, eeprom_decode_generic, rounds, &generic);
+	bench_run(&set, eeprom_decode_check, rounds, &special);
+
+	double decodes = (double)set.count * rounds;
+
+	ui_print_header("Decode Benchmark");
+	printf("  Images: %zu, rounds: %d\n\n", set.count, rounds);
+	printf("  %-14s %12s %14s\n", "Path", "ns/image", "cycles/image");
+	ui_print_separator();
+	printf("  %-14s %12.1f %14.0f\n", "generic", generic.ns / decodes, generic.cycles / decodes);
+	printf("  %-14s %12.1f %14.0f\n", "specialized", special.ns / decodes, special.cycles / decodes);
+	ui_print_separator();
+	printf("  Speedup: %.2fx\n", special.ns > 0 ? generic.ns / special.ns : 0.0);
+
+	free(set.images);
+
+	if (generic.digest != special.digest)
+	{
+		fprintf(stderr, "Error: generic and specialized decoders disagree\n");
+		return 2;
+	}
+	return 0;
+}
@@ -0,0 +1,9 @@
+#ifndef BENCH_H
+#define BENCH_H
+
+// CLI: eeprom_tool bench [-n ROUNDS] PATH...
+// Times the table-driven reference decoder against the version-specialized
+// decoders on the given images and checks that both agree.
+int cmd_bench(int argc, char **argv);
+
+#endif // BENCH_H
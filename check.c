@@ -0,0 +1,245 @@
+#include "check.h"
+#include "batch.h"
+#include "manifest.h"
+#include "eeprom_defs.h"
+#include "eeprom_ops.h"
+#include "ui.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct
+{
+	Manifest *manifest;
+	int quiet;
+
+	// Stat of the file the filter just accepted, for manifest_update()
+	char pending_name[4096];
+	struct stat pending_stat;
+	int pending;                   // Accepted, no image reported yet
+	size_t pending_seen;           // Walk counters when it was accepted
+	size_t pending_skipped;
+	char archive[4096];            // Tar archive whose members are being read
+	const BatchStats *stats;
+
+	size_t images;
+	size_t unknown;
+	size_t crc_errors;
+	size_t test_failures;
+	size_t reused;
+	size_t reused_skipped;         // Files the manifest records as holding no image
+} CheckState;
+
+static void format_mask(char *buf, size_t len, uint8_t mask, uint8_t all, const char *good, const char *bad)
+{
+	if ((mask & all) == all)
+	{
+		snprintf(buf, len, "%s", good);
+		return;
+	}
+
+	int pos = snprintf(buf, len, "%s:", bad);
+	const char *sep = "";
+	for (int i = 0; i < 8 && pos < (int)len; i++)
+	{
+		if ((all >> i & 1) && !(mask >> i & 1))
+		{
+			pos += snprintf(buf + pos, len - pos, "%s%d", sep, i + 1);
+			sep = ",";
+		}
+	}
+}
+
+static void check_report(CheckState *state, const char *name, const EEPROMCheck *check)
+{
+	state->images++;
+
+	if (check->version == EEPROM_VERSION_UNKNOWN)
+	{
+		state->unknown++;
+		if (!state->quiet)
+		{
+			printf("%s\tunknown\n", name);
+		}
+		return;
+	}
+
+	uint8_t all = EEPROM_CHECK_ALL(check);
+	if ((check->crc_ok & all) != all)
+	{
+		state->crc_errors++;
+	}
+	if ((check->test_pass & all) != all)
+	{
+		state->test_failures++;
+	}
+
+	if (!state->quiet)
+	{
+		char crc[32], test[32];
+		format_mask(crc, sizeof(crc), check->crc_ok, all, "ok", "bad");
+		format_mask(test, sizeof(test), check->test_pass, all, "pass", "fail");
+		printf("%s\tv%d\tcrc=%s\ttest=%s\n", name, check->version, crc, test);
+	}
+}
+
+static int is_member(const char *name, const char *archive)
+{
+	size_t len = strlen(archive);
+	return len && strncmp(name, archive, len) == 0 && name[len] == ':';
+}
+
+// Record the file accepted last as skipped if it gave no image because it
+// is not a dump or extraction failed. Files that could not be opened are
+// not recorded (the walk counts a file as seen once it is open, a tar
+// member before the filter), and a tar archive is followed by its members.
+static void check_settle(CheckState *state, const char *next)
+{
+	if (!state->pending)
+	{
+		return;
+	}
+	state->pending = 0;
+
+	if (next && is_member(next, state->pending_name))
+	{
+		snprintf(state->archive, sizeof(state->archive), "%s", state->pending_name);
+		return;
+	}
+	if (state->stats->skipped > state->pending_skipped &&
+		(state->stats->files_seen > state->pending_seen || is_member(state->pending_name, state->archive)))
+	{
+		manifest_skip(state->manifest, state->pending_name, &state->pending_stat);
+	}
+}
+
+// Incremental mode: unchanged files are reported from the manifest, not read
+static int check_filter(const char *name, const struct stat *st, void *ctx)
+{
+	CheckState *state = (CheckState*)ctx;
+	check_settle(state, name);
+
+	int skipped;
+	const EEPROMCheck *previous = manifest_lookup(state->manifest, name, st, &skipped);
+	if (previous && skipped)
+	{
+		state->reused_skipped++;
+		return 0;
+	}
+	if (previous)
+	{
+		state->reused++;
+		check_report(state, name, previous);
+		return 0;
+	}
+
+	snprintf(state->pending_name, sizeof(state->pending_name), "%s", name);
+	state->pending_stat = *st;
+	state->pending = 1;
+	state->pending_seen = state->stats->files_seen;
+	state->pending_skipped = state->stats->skipped;
+	return 1;
+}
+
+static int check_image(const char *name, const uint8_t *data, size_t size, void *ctx)
+{
+	CheckState *state = (CheckState*)ctx;
+	uint8_t decoded[EEPROM_SIZE];
+	EEPROMCheck check;
+
+	memset(decoded, 0xFF, EEPROM_SIZE);
+	memcpy(decoded, data, size);
+	batch_decode(decoded, &check);
+
+	if (state->manifest && strcmp(state->pending_name, name) == 0)
+	{
+		manifest_update(state->manifest, name, &state->pending_stat, &check);
+		state->pending = 0;
+	}
+
+	check_report(state, name, &check);
+	return 0;
+}
+
+int cmd_check(int argc, char **argv)
+{
+	CheckState state;
+	memset(&state, 0, sizeof(state));
+
+	const char *manifest_path = NULL;
+	const char **paths = calloc(argc + 1, sizeof(char*));
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-q") == 0)
+		{
+			state.quiet = 1;
+		}
+		else if (strcmp(argv[i], "--incremental") == 0 && i + 1 < argc)
+		{
+			manifest_path = argv[++i];
+		}
+		else
+		{
+			paths[path_count++] = argv[i];
+		}
+	}
+
+	if (path_count == 0)
+	{
+		fprintf(stderr, "Usage: eeprom_tool check [-q] [--cache DIR] [--cache-size MB]\n"
+						"                          [--incremental MANIFEST] PATH...\n");
+		free(paths);
+		return 1;
+	}
+
+	if (manifest_path)
+	{
+		state.manifest = manifest_load(manifest_path);
+	}
+
+	BatchStats stats;
+	memset(&stats, 0, sizeof(stats));
+	state.stats = &stats;
+
+	for (int i = 0; i < path_count; i++)
+	{
+		batch_for_each_filtered(paths[i], state.manifest ? check_filter : NULL,
+								check_image, &state, &stats);
+	}
+	if (state.manifest)
+	{
+		check_settle(&state, NULL);
+	}
+	free(paths);
+
+	ui_print_header("EEPROM Check Summary");
+	printf("  Images: %zu (skipped files: %zu)\n", state.images, stats.skipped + state.reused_skipped);
+	printf("  Unknown version: %zu\n", state.unknown);
+	printf("  CRC errors: %zu\n", state.crc_errors);
+	printf("  Test failures: %zu\n", state.test_failures);
+
+	if (state.manifest)
+	{
+		printf("  Incremental: %zu unchanged, %zu read\n", state.reused + state.reused_skipped,
+			   state.images - state.reused);
+		manifest_save(state.manifest, manifest_path);
+		manifest_free(state.manifest);
+	}
+
+	DecodeCacheStats cs;
+	if (batch_cache_stats(&cs))
+	{
+		size_t lookups = cs.hits + cs.misses;
+		printf("  Cache: %zu hits, %zu misses (%.1f%% hit rate), %zu stored, %zu evicted, %zu/%zu entries\n",
+			   cs.hits, cs.misses, lookups ? 100.0 * cs.hits / lookups : 0.0,
+			   cs.stores, cs.evictions, cs.entries, cs.capacity);
+	}
+
+	return state.crc_errors || state.unknown ? 2 : 0;
+}
@@ -0,0 +1,10 @@
+#ifndef CHECK_H
+#define CHECK_H
+
+// CLI: eeprom_tool check [-q] [--cache DIR] [--cache-size MB]
+//                        [--incremental MANIFEST] PATH...
+// Decodes every image and reports CRC / production test results.
+// With --incremental only new or changed files are read.
+int cmd_check(int argc, char **argv);
+
+#endif // CHECK_H
@@ -0,0 +1,465 @@
+#include "columns.h"
+#include "batch.h"
+#include "eeprom_ops.h"
+#include "field_index.h"
+#include "ui.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Column Binding
+// ═══════════════════════════════════════════════════════════════
+
+static const EEPROMVersion column_versions[COLUMN_VERSIONS] =
+{
+	EEPROM_VERSION_V1,
+	EEPROM_VERSION_V4,
+	EEPROM_VERSION_V5,
+	EEPROM_VERSION_V6,
+	EEPROM_VERSION_V17
+};
+
+EEPROMVersion column_version(int slot)
+{
+	return column_versions[slot];
+}
+
+int column_slot(uint8_t version)
+{
+	switch (version)
+	{
+		case EEPROM_VERSION_V1:  return 0;
+		case EEPROM_VERSION_V4:  return 1;
+		case EEPROM_VERSION_V5:  return 2;
+		case EEPROM_VERSION_V6:  return 3;
+		case EEPROM_VERSION_V17: return 4;
+		default:                 return -1;
+	}
+}
+
+static int field_is_numeric(FieldType type)
+{
+	return type != FIELD_TYPE_STRING && type != FIELD_TYPE_ARRAY_UINT8 &&
+		   type != FIELD_TYPE_FREQ_LEVELS;
+}
+
+int column_bind(Column *column, const char *name)
+{
+	memset(column, 0, sizeof(*column));
+	int numeric = 0, bytes = 0, is_signed = 0;
+
+	for (int slot = 0; slot < COLUMN_VERSIONS; slot++)
+	{
+		EEPROMVersion version = column_versions[slot];
+		const EEPROMLayout *layout = eeprom_get_layout(version);
+		const FieldMetadata *field = field_index_find(version, name);
+		if (!field || !eeprom_field_in_layout(field, layout))
+		{
+			continue;
+		}
+
+		if (!column->field)
+		{
+			column->field = field;
+		}
+		column->source[slot].offset = (uint16_t)field->offset;
+		column->source[slot].size = (uint8_t)field->size;
+		column->source[slot].big_endian = field->big_endian;
+		column->source[slot].regions = eeprom_field_regions(field, layout);
+
+		if (field_is_numeric(field->type) && field->size <= 2)
+		{
+			numeric = 1;
+			is_signed |= field->type == FIELD_TYPE_INT8;
+		}
+		else
+		{
+			bytes = 1;
+		}
+		if (field->size > column->width)
+		{
+			column->width = field->size;
+		}
+	}
+
+	if (!column->field)
+	{
+		return -1;
+	}
+
+	// Mixed numeric/bytes bindings are stored as bytes
+	if (numeric && !bytes)
+	{
+		column->kind = column->width == 2 ? COLUMN_U16 : is_signed ? COLUMN_I8 : COLUMN_U8;
+	}
+	else
+	{
+		column->kind = COLUMN_BYTES;
+	}
+	return 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Column Set
+// ═══════════════════════════════════════════════════════════════
+
+ColumnSet *columns_create(const char *const *names, size_t count)
+{
+	ColumnSet *set = calloc(1, sizeof(*set));
+	if (!set || !(set->columns = calloc(count ? count : 1, sizeof(Column))))
+	{
+		fprintf(stderr, "Error: Out of memory\n");
+		free(set);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (column_bind(&set->columns[i], names[i]) != 0)
+		{
+			fprintf(stderr, "Error: Unknown field '%s'\n", names[i]);
+			columns_free(set);
+			return NULL;
+		}
+		set->column_count++;
+	}
+	return set;
+}
+
+void columns_free(ColumnSet *set)
+{
+	if (!set)
+	{
+		return;
+	}
+	for (size_t i = 0; i < set->column_count; i++)
+	{
+		free(set->columns[i].values);
+		free(set->columns[i].valid);
+	}
+	free(set->columns);
+	free(set->version);
+	free(set->crc_ok);
+	free(set->test_pass);
+	free(set);
+}
+
+static int grow(void **ptr, size_t size)
+{
+	void *next = realloc(*ptr, size);
+	if (!next)
+	{
+		return -1;
+	}
+	*ptr = next;
+	return 0;
+}
+
+static int columns_reserve(ColumnSet *set, size_t rows)
+{
+	if (rows <= set->capacity)
+	{
+		return 0;
+	}
+
+	size_t capacity = set->capacity ? set->capacity * 2 : 1024;
+	while (capacity < rows)
+	{
+		capacity *= 2;
+	}
+
+	if (grow((void**)&set->version, capacity) || grow((void**)&set->crc_ok, capacity) ||
+		grow((void**)&set->test_pass, capacity))
+	{
+		return -1;
+	}
+	for (size_t i = 0; i < set->column_count; i++)
+	{
+		Column *column = &set->columns[i];
+		if (grow((void**)&column->values, capacity * column->width) ||
+			grow((void**)&column->valid, capacity))
+		{
+			return -1;
+		}
+	}
+
+	set->capacity = capacity;
+	return 0;
+}
+
+// Copy one field of the decoded image into the column's row
+static void column_store(Column *column, size_t row, const ColumnSource *source, const uint8_t *image,
+						 uint8_t crc_ok)
+{
+	const uint8_t *src = image + source->offset;
+	uint8_t *dst = column->values + row * column->width;
+
+	column->valid[row] = source->size != 0 && !(source->regions & ~crc_ok);
+
+	switch (column->kind)
+	{
+		case COLUMN_U8:
+		case COLUMN_I8:
+			*dst = source->size ? src[0] : 0;
+			break;
+
+		case COLUMN_U16:
+		{
+			uint16_t value = 0;
+			if (source->size == 2)
+			{
+				value = source->big_endian ? (uint16_t)(src[0] << 8 | src[1]) : (uint16_t)(src[0] | src[1] << 8);
+			}
+			else if (source->size == 1)
+			{
+				value = src[0];
+			}
+			memcpy(dst, &value, 2);
+			break;
+		}
+
+		case COLUMN_BYTES:
+			memset(dst, 0, column->width);
+			memcpy(dst, src, source->size);
+			break;
+	}
+}
+
+int columns_append(ColumnSet *set, const uint8_t *data, size_t size)
+{
+	uint8_t work[EEPROM_SIZE];
+	memset(work, 0xFF, sizeof(work));
+	memcpy(work, data, size < EEPROM_SIZE ? size : EEPROM_SIZE);
+
+	int slot = column_slot(work[0]);
+	if (slot < 0)
+	{
+		return EEPROM_ERROR_VERSION;
+	}
+
+	EEPROMCheck check;
+	if (batch_decode(work, &check) == EEPROM_ERROR_VERSION)
+	{
+		return EEPROM_ERROR_VERSION;
+	}
+
+	if (columns_reserve(set, set->rows + 1) != 0)
+	{
+		fprintf(stderr, "Error: Out of memory\n");
+		return EEPROM_ERROR_UNKNOWN;
+	}
+
+	size_t row = set->rows++;
+	set->version[row] = (uint8_t)check.version;
+	set->crc_ok[row] = check.crc_ok;
+	set->test_pass[row] = check.test_pass;
+
+	for (size_t i = 0; i < set->column_count; i++)
+	{
+		Column *column = &set->columns[i];
+		column_store(column, row, &column->source[slot], work, check.crc_ok);
+	}
+	return EEPROM_SUCCESS;
+}
+
+const Column *columns_find(const ColumnSet *set, const char *name)
+{
+	for (size_t i = 0; i < set->column_count; i++)
+	{
+		if (eeprom_field_name_match(set->columns[i].field->name, name))
+		{
+			return &set->columns[i];
+		}
+	}
+	return NULL;
+}
+
+int32_t column_value(const Column *column, size_t row)
+{
+	switch (column->kind)
+	{
+		case COLUMN_U8:
+			return column->values[row];
+		case COLUMN_I8:
+			return (int8_t)column->values[row];
+		case COLUMN_U16:
+		{
+			uint16_t value;
+			memcpy(&value, column->values + row * 2, 2);
+			return value;
+		}
+		default:
+			return 0;
+	}
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Aggregates
+// ═══════════════════════════════════════════════════════════════
+// One tight loop per element type; invalid rows are masked out instead
+// of branched over so the compiler can vectorize the scan.
+
+#define COLUMN_SCAN(ctype, values, valid, rows, stats) \
+	do \
+	{ \
+		const ctype *v = (const ctype*)(values); \
+		int64_t sum = 0; \
+		size_t count = 0; \
+		int32_t lo = INT32_MAX, hi = INT32_MIN; \
+		for (size_t i = 0; i < (rows); i++) \
+		{ \
+			int32_t x = v[i]; \
+			int32_t m = -(int32_t)(valid)[i]; \
+			sum += x & m; \
+			count += (valid)[i]; \
+			int32_t a = (x & m) | (INT32_MAX & ~m); \
+			int32_t b = (x & m) | (INT32_MIN & ~m); \
+			lo = a < lo ? a : lo; \
+			hi = b > hi ? b : hi; \
+		} \
+		(stats)->sum = sum; \
+		(stats)->count = count; \
+		(stats)->min = count ? lo : 0; \
+		(stats)->max = count ? hi : 0; \
+	} while (0)
+
+void column_stats(const ColumnSet *set, const Column *column, ColumnStats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+
+	switch (column->kind)
+	{
+		case COLUMN_U8:
+			COLUMN_SCAN(uint8_t, column->values, column->valid, set->rows, stats);
+			break;
+		case COLUMN_I8:
+			COLUMN_SCAN(int8_t, column->values, column->valid, set->rows, stats);
+			break;
+		case COLUMN_U16:
+			COLUMN_SCAN(uint16_t, column->values, column->valid, set->rows, stats);
+			break;
+		case COLUMN_BYTES:
+			for (size_t i = 0; i < set->rows; i++)
+			{
+				stats->count += column->valid[i];
+			}
+			break;
+	}
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+#define STATS_MAX_FIELDS 32
+
+static const char *const stats_default_fields[] =
+{
+	"PSU Voltage", "Frequency", "Chip Bin", "PT1 Result", "PT2 Result"
+};
+
+static int stats_collect(const char *name, const uint8_t *data, size_t size, void *ctx)
+{
+	(void)name;
+	if (columns_append((ColumnSet*)ctx, data, size) == EEPROM_ERROR_UNKNOWN)
+	{
+		return 1;
+	}
+	return 0;
+}
+
+// Voltages and hashrates are stored in hundredths
+static double stats_scale(const FieldMetadata *field)
+{
+	return (field->type == FIELD_TYPE_VOLTAGE || field->type == FIELD_TYPE_HASHRATE) ? 100.0 : 1.0;
+}
+
+int cmd_stats(int argc, char **argv)
+{
+	const char *names[STATS_MAX_FIELDS];
+	size_t name_count = 0;
+	char *list = NULL;
+	int paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+		{
+			list = argv[++i];
+			continue;
+		}
+		paths[path_count++] = i;
+	}
+
+	if (path_count == 0)
+	{
+		fprintf(stderr, "Usage: eeprom_tool stats [-f FIELD,...] PATH...\n");
+		return 1;
+	}
+
+	if (list)
+	{
+		for (char *name = strtok(list, ","); name && name_count < STATS_MAX_FIELDS; name = strtok(NULL, ","))
+		{
+			names[name_count++] = name;
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < sizeof(stats_default_fields) / sizeof(stats_default_fields[0]); i++)
+		{
+			names[name_count++] = stats_default_fields[i];
+		}
+	}
+
+	ColumnSet *set = columns_create(names, name_count);
+	if (!set)
+	{
+		return 1;
+	}
+
+	for (int i = 0; i < path_count; i++)
+	{
+		batch_for_each(argv[paths[i]], stats_collect, set, NULL);
+	}
+
+	size_t crc_failed = 0;
+	for (size_t i = 0; i < set->rows; i++)
+	{
+		const EEPROMLayout *layout = eeprom_get_layout((EEPROMVersion)set->version[i]);
+		crc_failed += set->crc_ok[i] != (uint8_t)((1u << layout->region_count) - 1);
+	}
+
+	ui_print_header("Fleet Statistics");
+	printf("  Images: %zu, CRC errors: %zu\n\n", set->rows, crc_failed);
+	printf("  %-22s %8s %10s %10s %10s\n", "Field", "Count", "Min", "Mean", "Max");
+	ui_print_separator();
+
+	for (size_t c = 0; c < set->column_count; c++)
+	{
+		const Column *column = &set->columns[c];
+		ColumnStats stats;
+		column_stats(set, column, &stats);
+
+		if (column->kind == COLUMN_BYTES)
+		{
+			printf("  %-22s %8zu %10s %10s %10s\n", column->field->name, stats.count, "-", "-", "-");
+			continue;
+		}
+
+		double scale = stats_scale(column->field);
+		double mean = stats.count ? (double)stats.sum / stats.count / scale : 0.0;
+		printf("  %-22s %8zu %10.2f %10.2f %10.2f\n", column->field->name, stats.count,
+			   stats.min / scale, mean, stats.max / scale);
+	}
+	ui_print_separator();
+
+	columns_free(set);
+	return 0;
+}
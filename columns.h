@@ -0,0 +1,94 @@
+#ifndef COLUMNS_H
+#define COLUMNS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "eeprom_defs.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Columnar Decode (structure of arrays)
+// ═══════════════════════════════════════════════════════════════
+// Images are decoded straight into one dense vector per requested field
+// so fleet-wide aggregates are plain loops over contiguous memory. Only
+// the requested fields are stored: a row costs the width of each column
+// plus one validity byte per column and three bytes of row header.
+
+// Slots for the layouts a column can bind to (v1, v4, v5, v6, v17)
+#define COLUMN_VERSIONS 5
+
+typedef enum
+{
+	COLUMN_U8,                     // uint8_t per row
+	COLUMN_I8,                     // int8_t per row
+	COLUMN_U16,                    // uint16_t per row (host order)
+	COLUMN_BYTES                   // width raw bytes per row (strings, arrays)
+} ColumnKind;
+
+typedef struct
+{
+	uint16_t offset;               // Offset in the decoded image
+	uint8_t size;                  // Field size, 0 = not in this layout
+	uint8_t big_endian;            // Stored big-endian in the image
+	uint8_t regions;               // Regions holding it, see eeprom_field_regions()
+} ColumnSource;
+
+typedef struct
+{
+	const FieldMetadata *field;    // Metadata of the first layout that has it
+	ColumnKind kind;
+	size_t width;                  // Bytes per row
+	uint8_t *values;               // rows * width
+	uint8_t *valid;                // 1 if the row's layout has the field and
+	                               // its regions passed their CRC
+	ColumnSource source[COLUMN_VERSIONS];
+} Column;
+
+typedef struct
+{
+	size_t rows;
+	size_t capacity;
+	uint8_t *version;              // Version byte per row
+	uint8_t *crc_ok;               // EEPROMCheck.crc_ok per row
+	uint8_t *test_pass;            // EEPROMCheck.test_pass per row
+	Column *columns;
+	size_t column_count;
+} ColumnSet;
+
+typedef struct
+{
+	size_t count;                  // Valid rows
+	int64_t sum;
+	int32_t min;
+	int32_t max;
+} ColumnStats;
+
+// Slot of a version byte in Column.source, -1 if not a known version
+int column_slot(uint8_t version);
+EEPROMVersion column_version(int slot);
+
+// Bind column (no storage) to every layout that has a field with this
+// name or alias; returns -1 if no layout has it
+int column_bind(Column *column, const char *name);
+
+// Build a set for the named fields (FieldMetadata names, any layout).
+// Returns NULL and prints an error if a name is unknown.
+ColumnSet *columns_create(const char *const *names, size_t count);
+void columns_free(ColumnSet *set);
+
+// Decode one image (size <= EEPROM_SIZE, copied) and append its row.
+// Returns EEPROM_SUCCESS, or EEPROM_ERROR_VERSION if the image is not
+// recognised (no row is added).
+int columns_append(ColumnSet *set, const uint8_t *data, size_t size);
+
+const Column *columns_find(const ColumnSet *set, const char *name);
+
+// Numeric value of row i (0 if the column is COLUMN_BYTES)
+int32_t column_value(const Column *column, size_t row);
+
+// Aggregate over the valid rows of a numeric column
+void column_stats(const ColumnSet *set, const Column *column, ColumnStats *stats);
+
+// CLI: eeprom_tool stats [-f FIELD,...] PATH...
+int cmd_stats(int argc, char **argv);
+
+#endif // COLUMNS_H
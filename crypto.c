@@ -1,11 +1,10 @@
 #include "crypto.h"
 #include "eeprom_defs.h"
+#include "crypto_kernels.h"
 #include <string.h>
 #include <openssl/evp.h>
 #include <openssl/aes.h>
 
-#define DELTA 0x9E3779B9
-
 // XXTEA ключи для S19 (EEPROM v4/v5/v6)
 static const uint8_t KEY_LARGE[4][16] = {
 	"ilijnaiaayuxnixo",
@@ -29,139 +28,48 @@ static const uint8_t KEY_LARGE_V17[4][16] = {
 
 static const uint32_t KEY_SMALL[4] = {0xBABEFACE, 0xFEEDCAFE, 0xDEADBEEF, 0xABCD55AA};
 
-static uint32_t MX(uint32_t sum, uint32_t y, uint32_t z, uint32_t p, uint32_t e, const uint32_t *k) {
-	return ((z >> 5 ^ y << 2) + (y >> 3 ^ z << 4)) ^ ((sum ^ y) + (k[(p & 3) ^ e] ^ z));
-}
-
-static void XXTEA_encode(uint32_t *v, int n, const uint32_t *k) {
-	uint32_t y, z, sum;
-	unsigned p, rounds, e;
-
-	rounds = 6 + 52/n;
-	sum = 0;
-	z = v[n-1];
-	do {
-		sum += DELTA;
-		e = (sum >> 2) & 3;
-		for (p=0; p<n-1; p++) {
-			y = v[p+1];
-			z = v[p] += MX(sum, y, z, p, e, k);
-		}
-		y = v[0];
-		z = v[n-1] += MX(sum, y, z, p, e, k);
-	} while (--rounds);
+const uint32_t *crypto_xxtea_key(EEPROMVersion eeprom_version, uint8_t key_index)
+{
+	const uint8_t (*key_large)[16] = (eeprom_version == EEPROM_VERSION_V17)
+									 ? KEY_LARGE_V17
+									 : KEY_LARGE;
+	return (const uint32_t*)key_large[key_index & 3];
 }
 
-static void XXTEA_decode(uint32_t *v, int n, const uint32_t *k) {
-	uint32_t y, z, sum;
-	unsigned p, rounds, e;
-
-	rounds = 6 + 52/n;
-	sum = rounds*DELTA;
-	y = v[0];
-	do {
-		e = (sum >> 2) & 3;
-		for (p=n-1; p>0; p--) {
-			z = v[p-1];
-			y = v[p] -= MX(sum, y, z, p, e, k);
-		}
-		z = v[n-1];
-		y = v[0] -= MX(sum, y, z, p, e, k);
-		sum -= DELTA;
-	} while (--rounds);
+uint32_t crypto_xor_key(uint8_t key_index)
+{
+	return KEY_SMALL[key_index & 3];
 }
 
 void encode_data(uint8_t *data, size_t length, uint8_t algorithm_version,
 				 uint8_t key_index, EEPROMVersion eeprom_version)
 {
-	const uint8_t (*key_large)[16] = (eeprom_version == EEPROM_VERSION_V17)
-									 ? KEY_LARGE_V17
-									 : KEY_LARGE;
-
 	if (algorithm_version == CRYPTO_ALGORITHM_XXTEA)
 	{
-		XXTEA_encode((uint32_t*)data, length/4, (uint32_t*)key_large[key_index]);
+		xxtea_encode((uint32_t*)data, length/4, crypto_xxtea_key(eeprom_version, key_index));
 	}
 	else if (algorithm_version == CRYPTO_ALGORITHM_XOR)
 	{
-		uint32_t key = KEY_SMALL[key_index];
-		for (size_t i = 0; i < length; i += 4)
-		{
-			*(uint32_t*)(data + i) ^= key;
-		}
+		xor_words(data, length, crypto_xor_key(key_index));
 	}
 }
 
 void decode_data(uint8_t *data, size_t length, uint8_t algorithm_version,
 				 uint8_t key_index, EEPROMVersion eeprom_version)
 {
-	const uint8_t (*key_large)[16] = (eeprom_version == EEPROM_VERSION_V17)
-									 ? KEY_LARGE_V17
-									 : KEY_LARGE;
-
 	if (algorithm_version == CRYPTO_ALGORITHM_XXTEA)
 	{
-		XXTEA_decode((uint32_t*)data, length/4, (uint32_t*)key_large[key_index]);
+		xxtea_decode((uint32_t*)data, length/4, crypto_xxtea_key(eeprom_version, key_index));
 	}
 	else if (algorithm_version == CRYPTO_ALGORITHM_XOR)
 	{
-		encode_data(data, length, algorithm_version, key_index, eeprom_version);
+		xor_words(data, length, crypto_xor_key(key_index));
 	}
 }
 
-static const uint8_t CRC5_Lookup[256]=
-{// CRC-5/BITMAIN = x5 + x2 + 1 POLY=0x5
-0x00, 0x28, 0x50, 0x78, 0xA0, 0x88, 0xF0, 0xD8,
-0x68, 0x40, 0x38, 0x10, 0xC8, 0xE0, 0x98, 0xB0,
-0xD0, 0xF8, 0x80, 0xA8, 0x70, 0x58, 0x20, 0x08,
-0xB8, 0x90, 0xE8, 0xC0, 0x18, 0x30, 0x48, 0x60,
-0x88, 0xA0, 0xD8, 0xF0, 0x28, 0x00, 0x78, 0x50,
-0xE0, 0xC8, 0xB0, 0x98, 0x40, 0x68, 0x10, 0x38,
-0x58, 0x70, 0x08, 0x20, 0xF8, 0xD0, 0xA8, 0x80,
-0x30, 0x18, 0x60, 0x48, 0x90, 0xB8, 0xC0, 0xE8,
-0x38, 0x10, 0x68, 0x40, 0x98, 0xB0, 0xC8, 0xE0,
-0x50, 0x78, 0x00, 0x28, 0xF0, 0xD8, 0xA0, 0x88,
-0xE8, 0xC0, 0xB8, 0x90, 0x48, 0x60, 0x18, 0x30,
-0x80, 0xA8, 0xD0, 0xF8, 0x20, 0x08, 0x70, 0x58,
-0xB0, 0x98, 0xE0, 0xC8, 0x10, 0x38, 0x40, 0x68,
-0xD8, 0xF0, 0x88, 0xA0, 0x78, 0x50, 0x28, 0x00,
-0x60, 0x48, 0x30, 0x18, 0xC0, 0xE8, 0x90, 0xB8,
-0x08, 0x20, 0x58, 0x70, 0xA8, 0x80, 0xF8, 0xD0,
-0x70, 0x58, 0x20, 0x08, 0xD0, 0xF8, 0x80, 0xA8,
-0x18, 0x30, 0x48, 0x60, 0xB8, 0x90, 0xE8, 0xC0,
-0xA0, 0x88, 0xF0, 0xD8, 0x00, 0x28, 0x50, 0x78,
-0xC8, 0xE0, 0x98, 0xB0, 0x68, 0x40, 0x38, 0x10,
-0xF8, 0xD0, 0xA8, 0x80, 0x58, 0x70, 0x08, 0x20,
-0x90, 0xB8, 0xC0, 0xE8, 0x30, 0x18, 0x60, 0x48,
-0x28, 0x00, 0x78, 0x50, 0x88, 0xA0, 0xD8, 0xF0,
-0x40, 0x68, 0x10, 0x38, 0xE0, 0xC8, 0xB0, 0x98,
-0x48, 0x60, 0x18, 0x30, 0xE8, 0xC0, 0xB8, 0x90,
-0x20, 0x08, 0x70, 0x58, 0x80, 0xA8, 0xD0, 0xF8,
-0x98, 0xB0, 0xC8, 0xE0, 0x38, 0x10, 0x68, 0x40,
-0xF0, 0xD8, 0xA0, 0x88, 0x50, 0x78, 0x00, 0x28,
-0xC0, 0xE8, 0x90, 0xB8, 0x60, 0x48, 0x30, 0x18,
-0xA8, 0x80, 0xF8, 0xD0, 0x08, 0x20, 0x58, 0x70,
-0x10, 0x38, 0x40, 0x68, 0xB0, 0x98, 0xE0, 0xC8,
-0x78, 0x50, 0x28, 0x00, 0xD8, 0xF0, 0x88, 0xA0,
-};
-
-static uint8_t crc5(uint8_t crc, const uint8_t *ptr, size_t bits)
-{
-	crc<<=3;
-	int i;
-	for (i=0; i< (bits>>3); i++)
-		crc = CRC5_Lookup[crc ^ (*ptr++)];
-	bits &= 7;
-	if (bits)
-	{
-		crc = (crc << bits) ^ CRC5_Lookup[(crc ^ (*ptr++))>>(8-bits)];
-	}
-	return (crc>>3);
-}
-
 uint8_t calculate_crc(const uint8_t *ptr, size_t bits)
 {
-	return crc5(0xFF, ptr, bits);
+	return crc5_bits(ptr, bits);
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -193,6 +101,110 @@ uint8_t calculate_crc8_v1(const uint8_t *data, size_t length)
 	return crc;
 }
 
+// ═══════════════════════════════════════════════════════════════
+// Incremental CRC Update
+// ═══════════════════════════════════════════════════════════════
+// Both CRCs are linear over GF(2) apart from the initial value, so
+// CRC(M ^ D) = CRC(M) ^ CRC0(D) where CRC0 starts from zero. D is zero
+// outside the edited bytes: leading zeros leave CRC0 at zero, the edited
+// bytes are fed normally and the trailing zeros are applied as one linear
+// map raised to their count by repeated squaring, O(log n).
+
+typedef uint8_t (*crc_step_fn)(uint8_t crc, uint8_t byte);
+
+// CRC-5 register kept in the top five bits, as in crc5_bits()
+static uint8_t crc5_step(uint8_t crc, uint8_t byte)
+{
+	return CRC5_Lookup[crc ^ byte];
+}
+
+static uint8_t crc8_v1_step(uint8_t crc, uint8_t byte)
+{
+	crc ^= byte;
+	for (int bit = 0; bit < 8; bit++)
+	{
+		crc = (crc & 1) ? (crc >> 1) ^ 0x8C : crc >> 1;
+	}
+	return crc;
+}
+
+// 8x8 GF(2) matrix as columns: m[i] is the image of bit i
+static uint8_t gf2_times(const uint8_t m[8], uint8_t v)
+{
+	uint8_t r = 0;
+	for (int i = 0; v; i++, v >>= 1)
+	{
+		if (v & 1)
+		{
+			r ^= m[i];
+		}
+	}
+	return r;
+}
+
+// Advance a CRC0 register over count zero bytes
+static uint8_t crc_zero_extend(uint8_t crc, size_t count, crc_step_fn step)
+{
+	uint8_t op[8];
+	for (int i = 0; i < 8; i++)
+	{
+		op[i] = step((uint8_t)(1u << i), 0);
+	}
+
+	while (count)
+	{
+		if (count & 1)
+		{
+			crc = gf2_times(op, crc);
+		}
+		count >>= 1;
+		if (count)
+		{
+			uint8_t square[8];
+			for (int i = 0; i < 8; i++)
+			{
+				square[i] = gf2_times(op, op[i]);
+			}
+			memcpy(op, square, sizeof(op));
+		}
+	}
+	return crc;
+}
+
+static uint8_t crc_delta(const uint8_t *old_bytes, const uint8_t *new_bytes, size_t length,
+						 crc_step_fn step)
+{
+	uint8_t crc = 0;
+	for (size_t i = 0; i < length; i++)
+	{
+		crc = step(crc, old_bytes[i] ^ new_bytes[i]);
+	}
+	return crc;
+}
+
+uint8_t crc5_update(uint8_t crc, const uint8_t *old_bytes, const uint8_t *new_bytes,
+					size_t length, size_t offset, size_t bits)
+{
+	uint8_t delta = crc_delta(old_bytes, new_bytes, length, crc5_step);
+	size_t tail_bits = bits - (offset + length) * 8;
+	delta = crc_zero_extend(delta, tail_bits >> 3, crc5_step);
+
+	// Partial last byte, as in crc5_bits() with a zero data byte
+	tail_bits &= 7;
+	if (tail_bits)
+	{
+		delta = (uint8_t)(delta << tail_bits) ^ CRC5_Lookup[delta >> (8 - tail_bits)];
+	}
+	return (uint8_t)(crc ^ (delta >> 3));
+}
+
+uint8_t crc8_v1_update(uint8_t crc, const uint8_t *old_bytes, const uint8_t *new_bytes,
+					   size_t length, size_t offset, size_t span_length)
+{
+	uint8_t delta = crc_delta(old_bytes, new_bytes, length, crc8_v1_step);
+	return crc ^ crc_zero_extend(delta, span_length - offset - length, crc8_v1_step);
+}
+
 // ═══════════════════════════════════════════════════════════════
 // EEPROM v1 Crypto (AES-256-CBC for S21+)
 // ═══════════════════════════════════════════════════════════════
@@ -12,9 +12,21 @@ void decode_data(uint8_t *data, size_t length, uint8_t algorithm_version,
 
 uint8_t calculate_crc(const uint8_t *data, size_t length);
 
+// Key tables (key_index is taken modulo 4)
+const uint32_t *crypto_xxtea_key(EEPROMVersion eeprom_version, uint8_t key_index);
+uint32_t crypto_xor_key(uint8_t key_index);
+
 // CRC-8 for EEPROM v1
 uint8_t calculate_crc8_v1(const uint8_t *data, size_t length);
 
+// New CRC after bytes [offset, offset + length) of the covered span changed
+// from old_bytes to new_bytes, without reading the rest of the span.
+// crc5_update takes the span in bits (as calculate_crc), crc8_v1_update in bytes.
+uint8_t crc5_update(uint8_t crc, const uint8_t *old_bytes, const uint8_t *new_bytes,
+					size_t length, size_t offset, size_t bits);
+uint8_t crc8_v1_update(uint8_t crc, const uint8_t *old_bytes, const uint8_t *new_bytes,
+					   size_t length, size_t offset, size_t span_length);
+
 // ═══════════════════════════════════════════════════════════════
 // EEPROM v1 Crypto (AES-256-CBC)
 // ═══════════════════════════════════════════════════════════════
@@ -0,0 +1,126 @@
+#ifndef CRYPTO_KERNELS_H
+#define CRYPTO_KERNELS_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Cipher and CRC kernels
+// ═══════════════════════════════════════════════════════════════
+// Header-only so the version-specialized codecs in eeprom_ops.c can
+// inline them with constant lengths; crypto.c wraps them for the
+// generic entry points.
+
+#define CRYPTO_INLINE static inline __attribute__((always_inline))
+
+#define XXTEA_DELTA 0x9E3779B9
+
+#define XXTEA_MX(sum, y, z, p, e, k) \
+	((((z) >> 5 ^ (y) << 2) + ((y) >> 3 ^ (z) << 4)) ^ (((sum) ^ (y)) + ((k)[((p) & 3) ^ (e)] ^ (z))))
+
+CRYPTO_INLINE void xxtea_encode(uint32_t *v, int n, const uint32_t *k)
+{
+	uint32_t y, z, sum;
+	unsigned p, rounds, e;
+
+	rounds = 6 + 52/n;
+	sum = 0;
+	z = v[n-1];
+	do {
+		sum += XXTEA_DELTA;
+		e = (sum >> 2) & 3;
+		for (p=0; p<n-1; p++) {
+			y = v[p+1];
+			z = v[p] += XXTEA_MX(sum, y, z, p, e, k);
+		}
+		y = v[0];
+		z = v[n-1] += XXTEA_MX(sum, y, z, p, e, k);
+	} while (--rounds);
+}
+
+CRYPTO_INLINE void xxtea_decode(uint32_t *v, int n, const uint32_t *k)
+{
+	uint32_t y, z, sum;
+	unsigned p, rounds, e;
+
+	rounds = 6 + 52/n;
+	sum = rounds*XXTEA_DELTA;
+	y = v[0];
+	do {
+		e = (sum >> 2) & 3;
+		for (p=n-1; p>0; p--) {
+			z = v[p-1];
+			y = v[p] -= XXTEA_MX(sum, y, z, p, e, k);
+		}
+		z = v[n-1];
+		y = v[0] -= XXTEA_MX(sum, y, z, p, e, k);
+		sum -= XXTEA_DELTA;
+	} while (--rounds);
+}
+
+// DWORD-wise XOR in host byte order (encode and decode are the same)
+CRYPTO_INLINE void xor_words(uint8_t *data, size_t length, uint32_t key)
+{
+	for (size_t i = 0; i < length; i += 4)
+	{
+		uint32_t word;
+		memcpy(&word, data + i, 4);
+		word ^= key;
+		memcpy(data + i, &word, 4);
+	}
+}
+
+static const uint8_t CRC5_Lookup[256] =
+{// CRC-5/BITMAIN = x5 + x2 + 1 POLY=0x5
+0x00, 0x28, 0x50, 0x78, 0xA0, 0x88, 0xF0, 0xD8,
+0x68, 0x40, 0x38, 0x10, 0xC8, 0xE0, 0x98, 0xB0,
+0xD0, 0xF8, 0x80, 0xA8, 0x70, 0x58, 0x20, 0x08,
+0xB8, 0x90, 0xE8, 0xC0, 0x18, 0x30, 0x48, 0x60,
+0x88, 0xA0, 0xD8, 0xF0, 0x28, 0x00, 0x78, 0x50,
+0xE0, 0xC8, 0xB0, 0x98, 0x40, 0x68, 0x10, 0x38,
+0x58, 0x70, 0x08, 0x20, 0xF8, 0xD0, 0xA8, 0x80,
+0x30, 0x18, 0x60, 0x48, 0x90, 0xB8, 0xC0, 0xE8,
+0x38, 0x10, 0x68, 0x40, 0x98, 0xB0, 0xC8, 0xE0,
+0x50, 0x78, 0x00, 0x28, 0xF0, 0xD8, 0xA0, 0x88,
+0xE8, 0xC0, 0xB8, 0x90, 0x48, 0x60, 0x18, 0x30,
+0x80, 0xA8, 0xD0, 0xF8, 0x20, 0x08, 0x70, 0x58,
+0xB0, 0x98, 0xE0, 0xC8, 0x10, 0x38, 0x40, 0x68,
+0xD8, 0xF0, 0x88, 0xA0, 0x78, 0x50, 0x28, 0x00,
+0x60, 0x48, 0x30, 0x18, 0xC0, 0xE8, 0x90, 0xB8,
+0x08, 0x20, 0x58, 0x70, 0xA8, 0x80, 0xF8, 0xD0,
+0x70, 0x58, 0x20, 0x08, 0xD0, 0xF8, 0x80, 0xA8,
+0x18, 0x30, 0x48, 0x60, 0xB8, 0x90, 0xE8, 0xC0,
+0xA0, 0x88, 0xF0, 0xD8, 0x00, 0x28, 0x50, 0x78,
+0xC8, 0xE0, 0x98, 0xB0, 0x68, 0x40, 0x38, 0x10,
+0xF8, 0xD0, 0xA8, 0x80, 0x58, 0x70, 0x08, 0x20,
+0x90, 0xB8, 0xC0, 0xE8, 0x30, 0x18, 0x60, 0x48,
+0x28, 0x00, 0x78, 0x50, 0x88, 0xA0, 0xD8, 0xF0,
+0x40, 0x68, 0x10, 0x38, 0xE0, 0xC8, 0xB0, 0x98,
+0x48, 0x60, 0x18, 0x30, 0xE8, 0xC0, 0xB8, 0x90,
+0x20, 0x08, 0x70, 0x58, 0x80, 0xA8, 0xD0, 0xF8,
+0x98, 0xB0, 0xC8, 0xE0, 0x38, 0x10, 0x68, 0x40,
+0xF0, 0xD8, 0xA0, 0x88, 0x50, 0x78, 0x00, 0x28,
+0xC0, 0xE8, 0x90, 0xB8, 0x60, 0x48, 0x30, 0x18,
+0xA8, 0x80, 0xF8, 0xD0, 0x08, 0x20, 0x58, 0x70,
+0x10, 0x38, 0x40, 0x68, 0xB0, 0x98, 0xE0, 0xC8,
+0x78, 0x50, 0x28, 0x00, 0xD8, 0xF0, 0x88, 0xA0,
+};
+
+// CRC-5/BITMAIN over the first bits of ptr, initial value 0x1F
+CRYPTO_INLINE uint8_t crc5_bits(const uint8_t *ptr, size_t bits)
+{
+	uint8_t crc = 0xF8;                // 0x1F, kept in the top five bits
+	for (size_t i = 0; i < (bits >> 3); i++)
+	{
+		crc = CRC5_Lookup[crc ^ *ptr++];
+	}
+	bits &= 7;
+	if (bits)
+	{
+		crc = (crc << bits) ^ CRC5_Lookup[(crc ^ *ptr) >> (8 - bits)];
+	}
+	return crc >> 3;
+}
+
+#endif // CRYPTO_KERNELS_H
@@ -0,0 +1,432 @@
+#include "decode_cache.h"
+#include "hash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+#define CACHE_MAGIC        "EEPCACHE"
+#define CACHE_SEED_KEY     (0x45455052u ^ DECODE_CACHE_SCHEMA)
+#define CACHE_SEED_TAG     (0x4F4D5441u + DECODE_CACHE_SCHEMA)
+
+typedef struct __attribute__((__packed__))
+{
+	char magic[8];
+	uint32_t schema;
+	uint32_t slots;                // Number of entries that follow
+	uint32_t clock;                // Run counter used as LRU stamp
+	uint32_t reserved;
+} CacheHeader;
+
+typedef struct __attribute__((__packed__))
+{
+	uint64_t key;                  // Hash of the raw image
+	uint32_t tag;                  // Independent hash, guards against collisions
+	uint32_t stamp;                // Last run that used the entry (0 = free)
+} CacheEntry;
+
+// Records carry their own key and tag: the index is only written on close,
+// so after a crash it can name slots that were reused since
+typedef struct __attribute__((__packed__))
+{
+	uint64_t key;
+	uint32_t tag;
+	uint8_t decoded[EEPROM_SIZE];
+	int8_t result;                 // eeprom_decode_check() return value
+	int8_t version;
+	uint8_t region_count;
+	uint8_t crc_ok;
+	uint8_t test_pass;
+} CacheRecord;
+
+struct DecodeCache
+{
+	pthread_mutex_t lock;          // Batch worker threads share the cache
+	char idx_path[4096];
+	int dat_fd;
+	uint32_t clock;
+
+	CacheEntry *entries;           // entries[i] describes data slot i
+	size_t slots;                  // Slots in use (live or free)
+	size_t capacity;               // Max slots allowed by the size bound
+
+	uint32_t *table;               // Open addressing: slot + 1, 0 = empty
+	size_t table_mask;
+
+	uint32_t *free_slots;
+	size_t free_count;
+
+	DecodeCacheStats stats;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// Hash table
+// ═══════════════════════════════════════════════════════════════
+
+static void cache_table_insert(DecodeCache *cache, uint32_t slot)
+{
+	size_t i = (size_t)cache->entries[slot].key & cache->table_mask;
+	while (cache->table[i])
+	{
+		i = (i + 1) & cache->table_mask;
+	}
+	cache->table[i] = slot + 1;
+}
+
+static void cache_table_rebuild(DecodeCache *cache)
+{
+	memset(cache->table, 0, (cache->table_mask + 1) * sizeof(uint32_t));
+	for (size_t slot = 0; slot < cache->slots; slot++)
+	{
+		if (cache->entries[slot].stamp)
+		{
+			cache_table_insert(cache, (uint32_t)slot);
+		}
+	}
+}
+
+static int64_t cache_find(const DecodeCache *cache, uint64_t key, uint32_t tag)
+{
+	size_t i = (size_t)key & cache->table_mask;
+	while (cache->table[i])
+	{
+		const CacheEntry *entry = &cache->entries[cache->table[i] - 1];
+		if (entry->key == key && entry->tag == tag)
+		{
+			return cache->table[i] - 1;
+		}
+		i = (i + 1) & cache->table_mask;
+	}
+	return -1;
+}
+
+static void cache_drop(DecodeCache *cache, uint32_t slot)
+{
+	cache->entries[slot].stamp = 0;
+	cache->free_slots[cache->free_count++] = slot;
+	cache->stats.entries--;
+	cache_table_rebuild(cache);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Eviction (LRU by run stamp, oldest 1/8 at a time)
+// ═══════════════════════════════════════════════════════════════
+
+static int cache_stamp_cmp(const void *a, const void *b)
+{
+	uint32_t sa = ((const uint64_t*)a)[0] >> 32;
+	uint32_t sb = ((const uint64_t*)b)[0] >> 32;
+	return sa < sb ? -1 : (sa > sb ? 1 : 0);
+}
+
+static void cache_evict(DecodeCache *cache)
+{
+	uint64_t *order = malloc(cache->slots * sizeof(uint64_t));
+	if (!order)
+	{
+		return;
+	}
+
+	size_t live = 0;
+	for (size_t slot = 0; slot < cache->slots; slot++)
+	{
+		if (cache->entries[slot].stamp)
+		{
+			order[live++] = ((uint64_t)cache->entries[slot].stamp << 32) | slot;
+		}
+	}
+	qsort(order, live, sizeof(uint64_t), cache_stamp_cmp);
+
+	size_t victims = live / 8 ? live / 8 : 1;
+	for (size_t i = 0; i < victims && i < live; i++)
+	{
+		uint32_t slot = (uint32_t)order[i];
+		cache->entries[slot].stamp = 0;
+		cache->free_slots[cache->free_count++] = slot;
+	}
+	cache->stats.evictions += victims;
+	cache->stats.entries -= victims;
+
+	free(order);
+	cache_table_rebuild(cache);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Open / close
+// ═══════════════════════════════════════════════════════════════
+
+static void cache_load_index(DecodeCache *cache)
+{
+	FILE *file = fopen(cache->idx_path, "rb");
+	if (!file)
+	{
+		return;
+	}
+
+	CacheHeader header;
+	if (fread(&header, sizeof(header), 1, file) != 1 ||
+		memcmp(header.magic, CACHE_MAGIC, 8) != 0 ||
+		header.schema != DECODE_CACHE_SCHEMA)
+	{
+		fclose(file);
+		return;
+	}
+
+	size_t slots = header.slots < cache->capacity ? header.slots : cache->capacity;
+	slots = fread(cache->entries, sizeof(CacheEntry), slots, file);
+	fclose(file);
+
+	cache->slots = slots;
+	cache->clock = header.clock;
+
+	for (size_t slot = 0; slot < slots; slot++)
+	{
+		if (cache->entries[slot].stamp)
+		{
+			cache->stats.entries++;
+		}
+		else
+		{
+			cache->free_slots[cache->free_count++] = (uint32_t)slot;
+		}
+	}
+	cache_table_rebuild(cache);
+}
+
+DecodeCache *decode_cache_open(const char *dir, size_t max_bytes)
+{
+	if (mkdir(dir, 0755) != 0 && errno != EEXIST)
+	{
+		fprintf(stderr, "Error: Cannot create cache directory %s\n", dir);
+		return NULL;
+	}
+
+	DecodeCache *cache = calloc(1, sizeof(DecodeCache));
+	if (!cache)
+	{
+		return NULL;
+	}
+	pthread_mutex_init(&cache->lock, NULL);
+
+	cache->capacity = max_bytes / (sizeof(CacheEntry) + sizeof(CacheRecord));
+	if (cache->capacity < 64)
+	{
+		cache->capacity = 64;
+	}
+	if (cache->capacity > UINT32_MAX / 2)
+	{
+		cache->capacity = UINT32_MAX / 2;
+	}
+
+	size_t table_size = 1;
+	while (table_size < cache->capacity * 2)
+	{
+		table_size <<= 1;
+	}
+	cache->table_mask = table_size - 1;
+
+	cache->entries = calloc(cache->capacity, sizeof(CacheEntry));
+	cache->table = calloc(table_size, sizeof(uint32_t));
+	cache->free_slots = malloc(cache->capacity * sizeof(uint32_t));
+
+	char dat_path[4096];
+	snprintf(cache->idx_path, sizeof(cache->idx_path), "%s/decode.idx", dir);
+	snprintf(dat_path, sizeof(dat_path), "%s/decode.dat", dir);
+	cache->dat_fd = open(dat_path, O_RDWR | O_CREAT, 0644);
+
+	if (!cache->entries || !cache->table || !cache->free_slots || cache->dat_fd < 0)
+	{
+		fprintf(stderr, "Error: Cannot open decode cache in %s\n", dir);
+		decode_cache_close(cache);
+		return NULL;
+	}
+
+	// One run at a time: the index is read here and written on close. The
+	// lock goes with the descriptor, so a crashed run does not hold it.
+	if (flock(cache->dat_fd, LOCK_EX | LOCK_NB) != 0)
+	{
+		fprintf(stderr, "Note: Decode cache in %s is in use by another run, decoding without it\n", dir);
+		close(cache->dat_fd);
+		cache->dat_fd = -1;
+		decode_cache_close(cache);
+		return NULL;
+	}
+
+	cache_load_index(cache);
+	cache->clock++;
+	cache->stats.capacity = cache->capacity;
+	return cache;
+}
+
+void decode_cache_close(DecodeCache *cache)
+{
+	if (!cache)
+	{
+		return;
+	}
+
+	if (cache->dat_fd >= 0 && cache->entries)
+	{
+		char tmp_path[4200];
+		snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", cache->idx_path);
+
+		FILE *file = fopen(tmp_path, "wb");
+		if (file)
+		{
+			CacheHeader header;
+			memset(&header, 0, sizeof(header));
+			memcpy(header.magic, CACHE_MAGIC, 8);
+			header.schema = DECODE_CACHE_SCHEMA;
+			header.slots = (uint32_t)cache->slots;
+			header.clock = cache->clock;
+
+			int ok = fwrite(&header, sizeof(header), 1, file) == 1 &&
+					 fwrite(cache->entries, sizeof(CacheEntry), cache->slots, file) == cache->slots;
+			ok = (fclose(file) == 0) && ok;
+
+			if (!ok || rename(tmp_path, cache->idx_path) != 0)
+			{
+				fprintf(stderr, "Error: Failed to write cache index %s\n", cache->idx_path);
+				unlink(tmp_path);
+			}
+		}
+		// Data slots beyond the index are garbage after a size reduction
+		ftruncate(cache->dat_fd, (off_t)(cache->slots * sizeof(CacheRecord)));
+	}
+
+	if (cache->dat_fd >= 0)
+	{
+		close(cache->dat_fd);
+	}
+	free(cache->entries);
+	free(cache->table);
+	free(cache->free_slots);
+	pthread_mutex_destroy(&cache->lock);
+	free(cache);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Lookup / store
+// ═══════════════════════════════════════════════════════════════
+
+int decode_cache_lookup(DecodeCache *cache, uint8_t data[EEPROM_SIZE], EEPROMCheck *check, int *result)
+{
+	uint64_t key = eeprom_hash64(data, EEPROM_SIZE, CACHE_SEED_KEY);
+	uint32_t tag = (uint32_t)eeprom_hash64(data, EEPROM_SIZE, CACHE_SEED_TAG);
+
+	pthread_mutex_lock(&cache->lock);
+	int64_t slot = cache_find(cache, key, tag);
+	CacheRecord record;
+
+	if (slot < 0 ||
+		pread(cache->dat_fd, &record, sizeof(record), (off_t)slot * sizeof(CacheRecord)) != sizeof(record) ||
+		record.key != key || record.tag != tag)
+	{
+		if (slot >= 0)
+		{
+			cache_drop(cache, (uint32_t)slot);
+		}
+		cache->stats.misses++;
+		pthread_mutex_unlock(&cache->lock);
+		return 0;
+	}
+
+	cache->entries[slot].stamp = cache->clock;
+	cache->stats.hits++;
+	pthread_mutex_unlock(&cache->lock);
+
+	memcpy(data, record.decoded, EEPROM_SIZE);
+	memset(check, 0, sizeof(*check));
+	check->version = (EEPROMVersion)record.version;
+	check->region_count = record.region_count;
+	check->crc_ok = record.crc_ok;
+	check->test_pass = record.test_pass;
+	*result = record.result;
+	return 1;
+}
+
+void decode_cache_store(DecodeCache *cache, const uint8_t raw[EEPROM_SIZE],
+						const uint8_t decoded[EEPROM_SIZE], const EEPROMCheck *check, int result)
+{
+	uint64_t key = eeprom_hash64(raw, EEPROM_SIZE, CACHE_SEED_KEY);
+	uint32_t tag = (uint32_t)eeprom_hash64(raw, EEPROM_SIZE, CACHE_SEED_TAG);
+
+	pthread_mutex_lock(&cache->lock);
+	if (cache_find(cache, key, tag) >= 0)
+	{
+		pthread_mutex_unlock(&cache->lock);
+		return;
+	}
+
+	if (cache->free_count == 0 && cache->slots == cache->capacity)
+	{
+		cache_evict(cache);
+	}
+
+	uint32_t slot;
+	if (cache->free_count)
+	{
+		slot = cache->free_slots[--cache->free_count];
+	}
+	else
+	{
+		slot = (uint32_t)cache->slots++;
+	}
+
+	CacheRecord record;
+	record.key = key;
+	record.tag = tag;
+	memcpy(record.decoded, decoded, EEPROM_SIZE);
+	record.result = (int8_t)result;
+	record.version = (int8_t)check->version;
+	record.region_count = check->region_count;
+	record.crc_ok = check->crc_ok;
+	record.test_pass = check->test_pass;
+
+	if (pwrite(cache->dat_fd, &record, sizeof(record), (off_t)slot * sizeof(CacheRecord)) != sizeof(record))
+	{
+		cache->free_slots[cache->free_count++] = slot;
+		pthread_mutex_unlock(&cache->lock);
+		return;
+	}
+
+	cache->entries[slot].key = key;
+	cache->entries[slot].tag = tag;
+	cache->entries[slot].stamp = cache->clock;
+	cache_table_insert(cache, slot);
+
+	cache->stats.stores++;
+	cache->stats.entries++;
+	pthread_mutex_unlock(&cache->lock);
+}
+
+int decode_cache_decode(DecodeCache *cache, uint8_t data[EEPROM_SIZE], EEPROMCheck *check)
+{
+	int result;
+	if (!cache)
+	{
+		return eeprom_decode_check(data, EEPROM_SIZE, EEPROM_VERSION_UNKNOWN, check);
+	}
+	if (decode_cache_lookup(cache, data, check, &result))
+	{
+		return result;
+	}
+
+	uint8_t raw[EEPROM_SIZE];
+	memcpy(raw, data, EEPROM_SIZE);
+	result = eeprom_decode_check(data, EEPROM_SIZE, EEPROM_VERSION_UNKNOWN, check);
+	decode_cache_store(cache, raw, data, check, result);
+	return result;
+}
+
+void decode_cache_get_stats(DecodeCache *cache, DecodeCacheStats *stats)
+{
+	pthread_mutex_lock(&cache->lock);
+	*stats = cache->stats;
+	pthread_mutex_unlock(&cache->lock);
+}
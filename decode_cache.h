@@ -0,0 +1,59 @@
+#ifndef DECODE_CACHE_H
+#define DECODE_CACHE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "eeprom_defs.h"
+#include "eeprom_ops.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Persistent content-addressed decode cache
+// ═══════════════════════════════════════════════════════════════
+// <dir>/decode.idx - header + one 16-byte entry per slot (hash, tag, stamp)
+// <dir>/decode.dat - one record per slot (hash, tag, decoded image +
+//                    EEPROMCheck); a record whose hash and tag differ from
+//                    its index entry is a miss
+//
+// A run holds an exclusive flock on decode.dat while the cache is open.
+// Bump DECODE_CACHE_SCHEMA whenever decoding, EEPROMCheck semantics or the
+// file layout change; caches written by an older schema are discarded on
+// open.
+#define DECODE_CACHE_SCHEMA        5
+#define DECODE_CACHE_DEFAULT_MB    256
+
+typedef struct DecodeCache DecodeCache;
+
+typedef struct
+{
+	size_t hits;
+	size_t misses;
+	size_t stores;
+	size_t evictions;
+	size_t entries;                // Live entries
+	size_t capacity;               // Max entries allowed by the size bound
+} DecodeCacheStats;
+
+// Open (or create) a cache directory bounded to max_bytes on disk. Returns
+// NULL (with a message) if it cannot be opened or another run holds it.
+DecodeCache *decode_cache_open(const char *dir, size_t max_bytes);
+
+// The functions below are thread-safe.
+
+// On hit, returns 1 and replaces the raw image in data by its decoded form,
+// check and result by those of eeprom_decode_check(). Returns 0 on miss.
+int decode_cache_lookup(DecodeCache *cache, uint8_t data[EEPROM_SIZE], EEPROMCheck *check, int *result);
+
+// result is the eeprom_decode_check() return value for raw
+void decode_cache_store(DecodeCache *cache, const uint8_t raw[EEPROM_SIZE],
+						const uint8_t decoded[EEPROM_SIZE], const EEPROMCheck *check, int result);
+
+// eeprom_decode_check(data, EEPROM_SIZE, EEPROM_VERSION_UNKNOWN, check)
+// through the cache; cache may be NULL
+int decode_cache_decode(DecodeCache *cache, uint8_t data[EEPROM_SIZE], EEPROMCheck *check);
+
+void decode_cache_get_stats(DecodeCache *cache, DecodeCacheStats *stats);
+
+// Write the index back and release the cache
+void decode_cache_close(DecodeCache *cache);
+
+#endif // DECODE_CACHE_H
@@ -0,0 +1,331 @@
+#include "detect.h"
+#include "batch.h"
+#include "crypto.h"
+#include "eeprom_ops.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Candidate Scoring
+// ═══════════════════════════════════════════════════════════════
+
+// Numeric range of a field type; fields whose FieldMetadata range covers
+// it say nothing about the layout and are not scored
+static int type_range(FieldType type, int32_t *lo, int32_t *hi)
+{
+	switch (type)
+	{
+		case FIELD_TYPE_UINT8:
+		case FIELD_TYPE_HEX8:
+			*lo = 0;
+			*hi = 0xFF;
+			return 1;
+		case FIELD_TYPE_INT8:
+			*lo = -128;
+			*hi = 127;
+			return 1;
+		case FIELD_TYPE_UINT16:
+		case FIELD_TYPE_HEX16:
+		case FIELD_TYPE_VOLTAGE:
+		case FIELD_TYPE_HASHRATE:
+			*lo = 0;
+			*hi = 0xFFFF;
+			return 1;
+		default:
+			return 0;
+	}
+}
+
+static int32_t field_value(const uint8_t *data, const FieldMetadata *field)
+{
+	const uint8_t *p = data + field->offset;
+	if (field->size == 2)
+	{
+		return field->big_endian ? (p[0] << 8 | p[1]) : (p[0] | p[1] << 8);
+	}
+	return field->type == FIELD_TYPE_INT8 ? (int8_t)p[0] : p[0];
+}
+
+// Printable characters, then only padding (NUL, 0xFF or spaces)
+static int string_plausible(const uint8_t *p, size_t size)
+{
+	size_t n = 0;
+	while (n < size && p[n] >= 0x20 && p[n] < 0x7F)
+	{
+		n++;
+	}
+	for (size_t i = n; i < size; i++)
+	{
+		if (p[i] != 0x00 && p[i] != 0xFF && p[i] != ' ')
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+// Score a decoded image as the given layout (version and region count)
+static uint8_t score_layout(const uint8_t *decoded, EEPROMVersion version, uint8_t crc_ok,
+							int header_match)
+{
+	const EEPROMLayout *layout = eeprom_get_layout(version);
+	size_t count;
+	const FieldMetadata *fields = eeprom_get_fields(version, &count);
+
+	int strings = 0, strings_ok = 0;
+	int numbers = 0, numbers_ok = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		const FieldMetadata *field = &fields[i];
+		if (!eeprom_field_in_layout(field, layout))
+		{
+			continue;
+		}
+
+		int32_t lo, hi;
+		if (field->type == FIELD_TYPE_STRING)
+		{
+			strings++;
+			strings_ok += string_plausible(decoded + field->offset, field->size);
+		}
+		else if (type_range(field->type, &lo, &hi) && (field->min_value > lo || field->max_value < hi))
+		{
+			int32_t value = field_value(decoded, field);
+			numbers++;
+			numbers_ok += value >= field->min_value && value <= field->max_value;
+		}
+	}
+
+	double crc_part = (double)__builtin_popcount(crc_ok) / layout->region_count;
+	double number_part = numbers ? (double)numbers_ok / numbers : 0.0;
+	double string_part = strings ? (double)strings_ok / strings : number_part;
+
+	double score = 40.0 * crc_part + 25.0 * string_part + 15.0 * number_part + 10.0 * header_match;
+	return (uint8_t)(score + 0.5);
+}
+
+static void add_candidate(DetectResult *result, EEPROMVersion version, uint8_t header,
+						  uint8_t crc_ok, uint8_t score)
+{
+	if (result->count < DETECT_MAX_CANDIDATES)
+	{
+		DetectCandidate *c = &result->candidates[result->count++];
+		c->version = version;
+		c->header = header;
+		c->region_count = (uint8_t)eeprom_get_layout(version)->region_count;
+		c->crc_ok = crc_ok;
+		c->score = score;
+	}
+}
+
+// Higher score first; on ties more verified regions, then the lower version
+static int candidate_compare(const void *a, const void *b)
+{
+	const DetectCandidate *ca = (const DetectCandidate*)a;
+	const DetectCandidate *cb = (const DetectCandidate*)b;
+
+	if (ca->score != cb->score)
+	{
+		return cb->score - ca->score;
+	}
+	int crc_a = __builtin_popcount(ca->crc_ok), crc_b = __builtin_popcount(cb->crc_ok);
+	if (crc_a != crc_b)
+	{
+		return crc_b - crc_a;
+	}
+	return ca->version - cb->version;
+}
+
+EEPROMVersion eeprom_detect_scored(const uint8_t *data, DetectResult *result)
+{
+	uint8_t copy[EEPROM_SIZE];
+	EEPROMCheck check;
+	result->count = 0;
+
+	// v1 and v17 have a fixed cipher; only byte 0 is a header
+	static const EEPROMVersion fixed[] = { EEPROM_VERSION_V1, EEPROM_VERSION_V17 };
+	for (size_t i = 0; i < sizeof(fixed) / sizeof(fixed[0]); i++)
+	{
+		memcpy(copy, data, sizeof(copy));
+		copy[0] = (uint8_t)fixed[i];
+		if (eeprom_decode_check(copy, EEPROM_SIZE, fixed[i], &check) == EEPROM_SUCCESS)
+		{
+			int header_match = 2 * (data[0] == (uint8_t)fixed[i]);
+			add_candidate(result, fixed[i], 0, check.crc_ok,
+						  score_layout(copy, fixed[i], check.crc_ok, header_match));
+		}
+	}
+
+	// v4/v5/v6 share region 0-1 ciphertext, so each algorithm/key pair is
+	// decoded once as three regions and scored for all three versions
+	static const uint8_t algorithms[] = { CRYPTO_ALGORITHM_XXTEA, CRYPTO_ALGORITHM_XOR };
+	for (size_t a = 0; a < sizeof(algorithms) / sizeof(algorithms[0]); a++)
+	{
+		for (uint8_t key = 0; key < 4; key++)
+		{
+			uint8_t header = (uint8_t)(algorithms[a] << 4 | key);
+			memcpy(copy, data, sizeof(copy));
+			copy[0] = EEPROM_VERSION_V5;
+			copy[1] = header;
+			if (eeprom_decode_check(copy, EEPROM_SIZE, EEPROM_VERSION_V5, &check) != EEPROM_SUCCESS)
+			{
+				continue;
+			}
+
+			int header_ok = (data[1] >> 4) == algorithms[a] && (data[1] & 3) == key;
+			for (EEPROMVersion version = EEPROM_VERSION_V4; version <= EEPROM_VERSION_V6; version++)
+			{
+				const EEPROMLayout *layout = eeprom_get_layout(version);
+				uint8_t crc_ok = check.crc_ok & (uint8_t)((1u << layout->region_count) - 1);
+				copy[0] = (uint8_t)version;
+
+				// CRCs covering the header see this candidate's version byte
+				for (size_t r = 0; r < layout->region_count; r++)
+				{
+					const RegionMeta *region = &layout->regions[r];
+					if (region->crc_start == 0)
+					{
+						int ok = calculate_crc(copy, region->crc_bits) == copy[region->crc_pos];
+						crc_ok = (uint8_t)((crc_ok & ~(1u << r)) | (unsigned)ok << r);
+					}
+				}
+				int header_match = (data[0] == (uint8_t)version) + header_ok;
+				add_candidate(result, version, header, crc_ok,
+							  score_layout(copy, version, crc_ok, header_match));
+			}
+		}
+	}
+
+	qsort(result->candidates, result->count, sizeof(DetectCandidate), candidate_compare);
+
+	if (result->count == 0 || result->candidates[0].score < DETECT_MIN_SCORE)
+	{
+		return EEPROM_VERSION_UNKNOWN;
+	}
+	return result->candidates[0].version;
+}
+
+void eeprom_detect_apply(uint8_t *data, const DetectCandidate *candidate)
+{
+	data[0] = (uint8_t)candidate->version;
+	if (candidate->version >= EEPROM_VERSION_V4 && candidate->version <= EEPROM_VERSION_V6)
+	{
+		data[1] = candidate->header;
+	}
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	int list_all;
+	pthread_mutex_t lock;
+	size_t images;
+	size_t agree;                  // Verdict matches the header bytes
+	size_t differ;                 // Verdict contradicts the header bytes
+	size_t unknown;
+} DetectRun;
+
+static void format_candidate(const DetectCandidate *c, char *out, size_t size)
+{
+	if (c->version >= EEPROM_VERSION_V4 && c->version <= EEPROM_VERSION_V6)
+	{
+		snprintf(out, size, "v%d %u/%u %d/%d %u", c->version, c->header >> 4, c->header & 0xF,
+				 __builtin_popcount(c->crc_ok), c->region_count, c->score);
+	}
+	else
+	{
+		snprintf(out, size, "v%d %d/%d %u", c->version,
+				 __builtin_popcount(c->crc_ok), c->region_count, c->score);
+	}
+}
+
+static int detect_image(const char *name, const uint8_t *raw, size_t size, void *ctx)
+{
+	DetectRun *run = (DetectRun*)ctx;
+	uint8_t data[EEPROM_SIZE];
+	memset(data, 0xFF, sizeof(data));
+	memcpy(data, raw, size);
+
+	DetectResult result;
+	EEPROMVersion verdict = eeprom_detect_scored(data, &result);
+	const DetectCandidate *best = &result.candidates[0];
+
+	const char *status;
+	if (verdict == EEPROM_VERSION_UNKNOWN)
+	{
+		status = "unknown";
+	}
+	else if (data[0] == (uint8_t)verdict &&
+			 (verdict < EEPROM_VERSION_V4 || verdict > EEPROM_VERSION_V6 ||
+			  ((data[1] >> 4) == (best->header >> 4) && (data[1] & 3) == (best->header & 3))))
+	{
+		status = "ok";
+	}
+	else
+	{
+		status = "header";
+	}
+
+	pthread_mutex_lock(&run->lock);
+	run->images++;
+	run->agree += status[0] == 'o';
+	run->differ += status[0] == 'h';
+	run->unknown += status[0] == 'u';
+	if (run->list_all || status[0] != 'o')
+	{
+		char first[48] = "-", second[48] = "-";
+		if (result.count > 0)
+		{
+			format_candidate(&result.candidates[0], first, sizeof(first));
+		}
+		if (result.count > 1)
+		{
+			format_candidate(&result.candidates[1], second, sizeof(second));
+		}
+		printf("%s\t%s\tbyte0=%u\t%s\t%s\n", name, status, data[0], first, second);
+	}
+	pthread_mutex_unlock(&run->lock);
+	return 0;
+}
+
+int cmd_detect(int argc, char **argv)
+{
+	DetectRun run;
+	memset(&run, 0, sizeof(run));
+	char *paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-a") == 0)
+		{
+			run.list_all = 1;
+			continue;
+		}
+		paths[path_count++] = argv[i];
+	}
+
+	if (path_count == 0)
+	{
+		fprintf(stderr, "Usage: eeprom_tool detect [-a] PATH...\n");
+		return 1;
+	}
+
+	pthread_mutex_init(&run.lock, NULL);
+	batch_for_each_parallel(paths, path_count, detect_image, &run, NULL);
+	pthread_mutex_destroy(&run.lock);
+
+	fflush(stdout);
+	fprintf(stderr, "Images: %zu, header agrees: %zu, header contradicted: %zu, unknown: %zu\n",
+			run.images, run.agree, run.differ, run.unknown);
+	return 0;
+}
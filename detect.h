@@ -0,0 +1,50 @@
+#ifndef DETECT_H
+#define DETECT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "eeprom_defs.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Score-based Version Detection
+// ═══════════════════════════════════════════════════════════════
+// eeprom_detect_version() trusts byte 0. The scored detector decodes the
+// image under every layout and key (v1, v17, and v4/v5/v6 with both S19
+// algorithms and all four keys) and ranks the results on
+//   region CRC agreement                      40 points
+//   printable string fields                   25 points
+//   numeric fields within FieldMetadata range 15 points
+//   header bytes agreeing with the candidate  20 points (10 per byte)
+
+#define DETECT_MAX_CANDIDATES 32
+
+// Best candidates below this score are reported as unknown
+#define DETECT_MIN_SCORE 60
+
+typedef struct
+{
+	EEPROMVersion version;
+	uint8_t header;                // Byte 1 for v4-v6 (algorithm << 4 | key), else 0
+	uint8_t region_count;
+	uint8_t crc_ok;                // Bit i set: region i CRC matches
+	uint8_t score;                 // 0-100
+} DetectCandidate;
+
+typedef struct
+{
+	DetectCandidate candidates[DETECT_MAX_CANDIDATES];   // Best first
+	size_t count;
+} DetectResult;
+
+// Score every layout for a raw (encoded) EEPROM_SIZE image. Returns the
+// best candidate's version, or EEPROM_VERSION_UNKNOWN if it scored below
+// DETECT_MIN_SCORE. Safe to call from several threads.
+EEPROMVersion eeprom_detect_scored(const uint8_t *data, DetectResult *result);
+
+// Rewrite the header bytes of an encoded image to match a candidate
+void eeprom_detect_apply(uint8_t *data, const DetectCandidate *candidate);
+
+// CLI: eeprom_tool detect [-a] PATH...
+int cmd_detect(int argc, char **argv);
+
+#endif // DETECT_H
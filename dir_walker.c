@@ -0,0 +1,597 @@
+#include "dir_walker.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <stdint.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/syscall.h>
+
+#define WALKER_MAX_THREADS    16
+#define WALKER_QUEUE_SIZE     4096
+#define WALKER_MAX_OPEN_DIRS  256      // Pending dirs keeping their fd open
+#define WALKER_DENTS_BUF      (64 * 1024)
+
+struct linux_dirent64
+{
+	uint64_t d_ino;
+	int64_t d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[];
+};
+
+typedef struct
+{
+	int fd;                        // Opened with openat() by the parent, or -1
+	char *path;
+} DirJob;
+
+typedef struct
+{
+	pthread_mutex_t lock;
+	DirJob *jobs;
+	size_t head;                   // Steal from here (oldest)
+	size_t tail;                   // Owner pushes/pops here (newest)
+	size_t capacity;
+} DirDeque;
+
+struct DirWalker
+{
+	DirWalkerOptions options;
+	int thread_count;              // Deques in use
+	int started;                   // Threads running (joined by finish)
+	pthread_t threads[WALKER_MAX_THREADS];
+	DirDeque deques[WALKER_MAX_THREADS];
+
+	pthread_mutex_t state_lock;
+	pthread_cond_t work_changed;   // A job was pushed, or pending_dirs hit 0
+	uint64_t pushes;               // Jobs pushed so far
+	size_t pending_dirs;           // Queued or being processed
+	size_t open_dirs;
+	_Atomic int stop;
+
+	// Bounded file queue (walkers -> consumers)
+	pthread_mutex_t queue_lock;
+	pthread_cond_t queue_not_empty;
+	pthread_cond_t queue_not_full;
+	DirWalkerEntry queue[WALKER_QUEUE_SIZE];
+	size_t queue_head;
+	size_t queue_count;
+	int walkers_running;
+};
+
+typedef struct
+{
+	DirWalker *walker;
+	int index;
+} WalkerThread;
+
+// ═══════════════════════════════════════════════════════════════
+// Work-stealing deques
+// ═══════════════════════════════════════════════════════════════
+
+static int deque_push(DirDeque *deque, DirJob job)
+{
+	pthread_mutex_lock(&deque->lock);
+	if (deque->tail == deque->capacity)
+	{
+		// Compact before growing
+		size_t live = deque->tail - deque->head;
+		if (deque->head > 0)
+		{
+			memmove(deque->jobs, deque->jobs + deque->head, live * sizeof(DirJob));
+			deque->head = 0;
+			deque->tail = live;
+		}
+		if (deque->tail == deque->capacity)
+		{
+			size_t capacity = deque->capacity ? deque->capacity * 2 : 64;
+			DirJob *jobs = realloc(deque->jobs, capacity * sizeof(DirJob));
+			if (!jobs)
+			{
+				pthread_mutex_unlock(&deque->lock);
+				return -1;
+			}
+			deque->jobs = jobs;
+			deque->capacity = capacity;
+		}
+	}
+	deque->jobs[deque->tail++] = job;
+	pthread_mutex_unlock(&deque->lock);
+	return 0;
+}
+
+static int deque_pop(DirDeque *deque, DirJob *job)
+{
+	int found = 0;
+	pthread_mutex_lock(&deque->lock);
+	if (deque->tail > deque->head)
+	{
+		*job = deque->jobs[--deque->tail];
+		found = 1;
+	}
+	pthread_mutex_unlock(&deque->lock);
+	return found;
+}
+
+static int deque_steal(DirDeque *deque, DirJob *job)
+{
+	int found = 0;
+	if (pthread_mutex_trylock(&deque->lock) != 0)
+	{
+		return 0;
+	}
+	if (deque->tail > deque->head)
+	{
+		*job = deque->jobs[deque->head++];
+		found = 1;
+	}
+	pthread_mutex_unlock(&deque->lock);
+	return found;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// File queue
+// ═══════════════════════════════════════════════════════════════
+
+static void queue_push(DirWalker *walker, char *path, const struct stat *st)
+{
+	pthread_mutex_lock(&walker->queue_lock);
+	while (walker->queue_count == WALKER_QUEUE_SIZE && !walker->stop)
+	{
+		pthread_cond_wait(&walker->queue_not_full, &walker->queue_lock);
+	}
+
+	if (walker->stop)
+	{
+		pthread_mutex_unlock(&walker->queue_lock);
+		free(path);
+		return;
+	}
+
+	size_t slot = (walker->queue_head + walker->queue_count) % WALKER_QUEUE_SIZE;
+	walker->queue[slot].path = path;
+	walker->queue[slot].st = *st;
+	walker->queue_count++;
+	pthread_cond_signal(&walker->queue_not_empty);
+	pthread_mutex_unlock(&walker->queue_lock);
+}
+
+int dir_walker_next(DirWalker *walker, DirWalkerEntry *entry)
+{
+	pthread_mutex_lock(&walker->queue_lock);
+	while (walker->queue_count == 0 && walker->walkers_running)
+	{
+		pthread_cond_wait(&walker->queue_not_empty, &walker->queue_lock);
+	}
+
+	if (walker->queue_count == 0)
+	{
+		pthread_mutex_unlock(&walker->queue_lock);
+		return 0;
+	}
+
+	*entry = walker->queue[walker->queue_head];
+	walker->queue_head = (walker->queue_head + 1) % WALKER_QUEUE_SIZE;
+	walker->queue_count--;
+	pthread_cond_signal(&walker->queue_not_full);
+	pthread_mutex_unlock(&walker->queue_lock);
+	return 1;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Directory processing
+// ═══════════════════════════════════════════════════════════════
+
+static int ext_in_list(const char *name, const char *list)
+{
+	const char *dot = strrchr(name, '.');
+	if (!dot)
+	{
+		return 0;
+	}
+
+	size_t len = strlen(dot);
+	const char *p = list;
+	while (*p)
+	{
+		size_t item = strcspn(p, ",");
+		if (item == len && strncasecmp(p, dot, len) == 0)
+		{
+			return 1;
+		}
+		p += item;
+		if (*p == ',')
+		{
+			p++;
+		}
+	}
+	return 0;
+}
+
+static int walker_wants(const DirWalker *walker, const char *name, const struct stat *st)
+{
+	const DirWalkerOptions *options = &walker->options;
+	int exempt = options->always_ext && ext_in_list(name, options->always_ext);
+
+	if (options->extensions && !exempt && !ext_in_list(name, options->extensions))
+	{
+		return 0;
+	}
+	if (options->max_size && st->st_size > options->max_size && !exempt)
+	{
+		return 0;
+	}
+	return st->st_size > 0;
+}
+
+static char *join_path(const char *dir, const char *name)
+{
+	size_t dir_len = strlen(dir);
+	size_t name_len = strlen(name);
+	char *path = malloc(dir_len + name_len + 2);
+	if (path)
+	{
+		memcpy(path, dir, dir_len);
+		path[dir_len] = '/';
+		memcpy(path + dir_len + 1, name, name_len + 1);
+	}
+	return path;
+}
+
+static void walker_add_dir(DirWalker *walker, int self, int parent_fd, const char *parent, const char *name)
+{
+	DirJob job;
+	job.path = join_path(parent, name);
+	job.fd = -1;
+	if (!job.path)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&walker->state_lock);
+	int keep_fd = walker->open_dirs < WALKER_MAX_OPEN_DIRS;
+	if (keep_fd)
+	{
+		walker->open_dirs++;
+	}
+	walker->pending_dirs++;
+	pthread_mutex_unlock(&walker->state_lock);
+
+	if (keep_fd)
+	{
+		job.fd = openat(parent_fd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (job.fd < 0)
+		{
+			pthread_mutex_lock(&walker->state_lock);
+			walker->open_dirs--;
+			pthread_mutex_unlock(&walker->state_lock);
+		}
+	}
+
+	if (deque_push(&walker->deques[self], job) != 0)
+	{
+		if (job.fd >= 0)
+		{
+			close(job.fd);
+		}
+		free(job.path);
+		pthread_mutex_lock(&walker->state_lock);
+		walker->pending_dirs--;
+		pthread_mutex_unlock(&walker->state_lock);
+		return;
+	}
+
+	// Wake one idle thread to steal it
+	pthread_mutex_lock(&walker->state_lock);
+	walker->pushes++;
+	pthread_cond_signal(&walker->work_changed);
+	pthread_mutex_unlock(&walker->state_lock);
+}
+
+static void walker_process(DirWalker *walker, int self, DirJob *job)
+{
+	int fd = job->fd;
+	if (fd < 0)
+	{
+		fd = open(job->path, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	}
+	else
+	{
+		pthread_mutex_lock(&walker->state_lock);
+		walker->open_dirs--;
+		pthread_mutex_unlock(&walker->state_lock);
+	}
+
+	if (fd < 0)
+	{
+		return;
+	}
+
+	char *buf = malloc(WALKER_DENTS_BUF);
+	if (!buf)
+	{
+		close(fd);
+		return;
+	}
+
+	long n;
+	while (!walker->stop && (n = syscall(SYS_getdents64, fd, buf, WALKER_DENTS_BUF)) > 0)
+	{
+		for (long pos = 0; pos < n;)
+		{
+			struct linux_dirent64 *d = (struct linux_dirent64*)(buf + pos);
+			pos += d->d_reclen;
+
+			const char *name = d->d_name;
+			if (name[0] == '.' && (name[1] == '\0' || (name[1] == '.' && name[2] == '\0')))
+			{
+				continue;
+			}
+
+			if (d->d_type == DT_DIR)
+			{
+				walker_add_dir(walker, self, fd, job->path, name);
+				continue;
+			}
+
+			if (d->d_type != DT_REG && d->d_type != DT_LNK && d->d_type != DT_UNKNOWN)
+			{
+				continue;
+			}
+
+			// Cheap rejection by extension before the stat syscall
+			if (walker->options.extensions && !ext_in_list(name, walker->options.extensions) &&
+				!(walker->options.always_ext && ext_in_list(name, walker->options.always_ext)))
+			{
+				if (d->d_type == DT_REG)
+				{
+					continue;
+				}
+			}
+
+			struct stat st;
+			if (fstatat(fd, name, &st, 0) != 0)
+			{
+				continue;
+			}
+
+			if (S_ISDIR(st.st_mode))
+			{
+				// Do not follow directory symlinks (loops)
+				if (d->d_type == DT_UNKNOWN)
+				{
+					walker_add_dir(walker, self, fd, job->path, name);
+				}
+				continue;
+			}
+
+			if (S_ISREG(st.st_mode) && walker_wants(walker, name, &st))
+			{
+				char *path = join_path(job->path, name);
+				if (path)
+				{
+					queue_push(walker, path, &st);
+				}
+			}
+		}
+	}
+
+	free(buf);
+	close(fd);
+}
+
+static void *walker_thread(void *arg)
+{
+	WalkerThread *thread = (WalkerThread*)arg;
+	DirWalker *walker = thread->walker;
+	int self = thread->index;
+
+	while (!walker->stop)
+	{
+		// Pushes seen before looking, so one made while we look is not missed
+		pthread_mutex_lock(&walker->state_lock);
+		uint64_t pushes = walker->pushes;
+		pthread_mutex_unlock(&walker->state_lock);
+
+		DirJob job;
+		int found = deque_pop(&walker->deques[self], &job);
+
+		for (int i = 1; !found && i < walker->thread_count; i++)
+		{
+			found = deque_steal(&walker->deques[(self + i) % walker->thread_count], &job);
+		}
+
+		if (found)
+		{
+			walker_process(walker, self, &job);
+			free(job.path);
+
+			pthread_mutex_lock(&walker->state_lock);
+			if (--walker->pending_dirs == 0)
+			{
+				pthread_cond_broadcast(&walker->work_changed);
+			}
+			pthread_mutex_unlock(&walker->state_lock);
+			continue;
+		}
+
+		// Another thread is still expanding a directory: sleep until it
+		// pushes a subdirectory or the walk ends
+		pthread_mutex_lock(&walker->state_lock);
+		while (walker->pushes == pushes && walker->pending_dirs && !walker->stop)
+		{
+			pthread_cond_wait(&walker->work_changed, &walker->state_lock);
+		}
+		size_t pending = walker->pending_dirs;
+		pthread_mutex_unlock(&walker->state_lock);
+		if (pending == 0)
+		{
+			break;
+		}
+	}
+
+	free(thread);
+
+	pthread_mutex_lock(&walker->queue_lock);
+	walker->walkers_running--;
+	pthread_cond_broadcast(&walker->queue_not_empty);
+	pthread_mutex_unlock(&walker->queue_lock);
+	return NULL;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Public API
+// ═══════════════════════════════════════════════════════════════
+
+DirWalker *dir_walker_start(const char *root, const DirWalkerOptions *options)
+{
+	DirWalker *walker = calloc(1, sizeof(DirWalker));
+	if (!walker)
+	{
+		return NULL;
+	}
+
+	if (options)
+	{
+		walker->options = *options;
+	}
+
+	int threads = walker->options.threads;
+	if (threads <= 0)
+	{
+		long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+		threads = cpus > 0 ? (int)cpus : 4;
+	}
+	if (threads > WALKER_MAX_THREADS)
+	{
+		threads = WALKER_MAX_THREADS;
+	}
+	walker->thread_count = threads;
+
+	pthread_mutex_init(&walker->state_lock, NULL);
+	pthread_cond_init(&walker->work_changed, NULL);
+	pthread_mutex_init(&walker->queue_lock, NULL);
+	pthread_cond_init(&walker->queue_not_empty, NULL);
+	pthread_cond_init(&walker->queue_not_full, NULL);
+	for (int i = 0; i < threads; i++)
+	{
+		pthread_mutex_init(&walker->deques[i].lock, NULL);
+	}
+
+	DirJob job;
+	job.fd = open(root, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+	job.path = strdup(root);
+	if (job.fd < 0 || !job.path)
+	{
+		fprintf(stderr, "Error: Cannot open directory %s\n", root);
+		if (job.fd >= 0)
+		{
+			close(job.fd);
+		}
+		free(job.path);
+		dir_walker_finish(walker);
+		return NULL;
+	}
+
+	// Strip trailing slashes so joined paths look like readdir() ones
+	size_t len = strlen(job.path);
+	while (len > 1 && job.path[len - 1] == '/')
+	{
+		job.path[--len] = '\0';
+	}
+
+	walker->pending_dirs = 1;
+	walker->open_dirs = 1;
+	deque_push(&walker->deques[0], job);
+
+	for (int i = 0; i < threads; i++)
+	{
+		WalkerThread *thread = malloc(sizeof(WalkerThread));
+		if (thread)
+		{
+			thread->walker = walker;
+			thread->index = i;
+		}
+
+		pthread_mutex_lock(&walker->queue_lock);
+		walker->walkers_running++;
+		pthread_mutex_unlock(&walker->queue_lock);
+
+		if (!thread || pthread_create(&walker->threads[i], NULL, walker_thread, thread) != 0)
+		{
+			pthread_mutex_lock(&walker->queue_lock);
+			walker->walkers_running--;
+			pthread_mutex_unlock(&walker->queue_lock);
+			free(thread);
+
+			// Stop and join the threads already running, free the deques
+			fprintf(stderr, "Error: Cannot start directory walker threads\n");
+			dir_walker_finish(walker);
+			return NULL;
+		}
+		walker->started = i + 1;
+	}
+
+	return walker;
+}
+
+void dir_walker_finish(DirWalker *walker)
+{
+	if (!walker)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&walker->queue_lock);
+	walker->stop = 1;
+	pthread_cond_broadcast(&walker->queue_not_full);
+	pthread_mutex_unlock(&walker->queue_lock);
+
+	pthread_mutex_lock(&walker->state_lock);
+	pthread_cond_broadcast(&walker->work_changed);
+	pthread_mutex_unlock(&walker->state_lock);
+
+	for (int i = 0; i < walker->started; i++)
+	{
+		pthread_join(walker->threads[i], NULL);
+	}
+
+	DirWalkerEntry entry;
+	while (walker->queue_count)
+	{
+		entry = walker->queue[walker->queue_head];
+		walker->queue_head = (walker->queue_head + 1) % WALKER_QUEUE_SIZE;
+		walker->queue_count--;
+		free(entry.path);
+	}
+
+	for (int i = 0; i < WALKER_MAX_THREADS; i++)
+	{
+		DirDeque *deque = &walker->deques[i];
+		for (size_t j = deque->head; j < deque->tail; j++)
+		{
+			if (deque->jobs[j].fd >= 0)
+			{
+				close(deque->jobs[j].fd);
+			}
+			free(deque->jobs[j].path);
+		}
+		free(deque->jobs);
+		if (i < walker->thread_count)
+		{
+			pthread_mutex_destroy(&deque->lock);
+		}
+	}
+
+	pthread_mutex_destroy(&walker->state_lock);
+	pthread_cond_destroy(&walker->work_changed);
+	pthread_mutex_destroy(&walker->queue_lock);
+	pthread_cond_destroy(&walker->queue_not_empty);
+	pthread_cond_destroy(&walker->queue_not_full);
+	free(walker);
+}
@@ -0,0 +1,40 @@
+#ifndef DIR_WALKER_H
+#define DIR_WALKER_H
+
+#include <stddef.h>
+#include <sys/stat.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Parallel directory walker (Linux: getdents64 + openat)
+// ═══════════════════════════════════════════════════════════════
+// A set of walker threads enumerates a directory tree with per-thread
+// work-stealing deques of directories. Matching files are pushed into a
+// bounded queue that consumers drain with dir_walker_next() while the
+// walk is still running, so enumeration overlaps decoding.
+
+typedef struct DirWalker DirWalker;
+
+typedef struct
+{
+	char *path;                    // Owned by the caller after dir_walker_next()
+	struct stat st;
+} DirWalkerEntry;
+
+typedef struct
+{
+	int threads;                   // Walker threads, 0 = number of CPUs (max 16)
+	const char *extensions;        // ".bin,.eep" (case-insensitive), NULL = any
+	off_t max_size;                // Skip larger files, 0 = no limit
+	const char *always_ext;        // Extensions exempt from max_size (archives)
+} DirWalkerOptions;
+
+DirWalker *dir_walker_start(const char *root, const DirWalkerOptions *options);
+
+// Blocks until the next file is available. Returns 0 when the walk is
+// finished and the queue is drained. Safe to call from several threads.
+int dir_walker_next(DirWalker *walker, DirWalkerEntry *entry);
+
+// Stops the walk (if still running), joins threads and frees the walker
+void dir_walker_finish(DirWalker *walker);
+
+#endif // DIR_WALKER_H
@@ -0,0 +1,386 @@
+#include "dump_format.h"
+#include "eeprom_ops.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Hex helpers
+// ═══════════════════════════════════════════════════════════════
+
+// 0-15 for hex digits, 0xFF otherwise
+static const uint8_t hex_value[256] =
+{
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	   0,    1,    2,    3,    4,    5,    6,    7,    8,    9, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF,   10,   11,   12,   13,   14,   15, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF,   10,   11,   12,   13,   14,   15, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+	0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+};
+
+static int is_text(const uint8_t *raw, size_t size)
+{
+	for (size_t i = 0; i < size; i++)
+	{
+		uint8_t c = raw[i];
+		if (c < 0x20 && c != '\n' && c != '\r' && c != '\t')
+		{
+			return 0;
+		}
+		if (c >= 0x7F)
+		{
+			return 0;
+		}
+	}
+	return 1;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Intel HEX
+// ═══════════════════════════════════════════════════════════════
+
+static int parse_ihex_byte(const uint8_t *p, uint8_t *value)
+{
+	uint8_t hi = hex_value[p[0]];
+	uint8_t lo = hex_value[p[1]];
+	if ((hi | lo) & 0xF0)
+	{
+		return -1;
+	}
+	*value = (uint8_t)(hi << 4 | lo);
+	return 0;
+}
+
+static long parse_ihex(const uint8_t *raw, size_t size, uint8_t *image)
+{
+	size_t pos = 0;
+	uint32_t base = 0;
+	long extent = 0;
+
+	memset(image, 0xFF, DUMP_MAX_IMAGE);
+
+	while (pos < size)
+	{
+		// Skip to the next record
+		while (pos < size && raw[pos] != ':')
+		{
+			if (raw[pos] != '\n' && raw[pos] != '\r' && raw[pos] != ' ' && raw[pos] != '\t')
+			{
+				return -1;
+			}
+			pos++;
+		}
+		if (pos + 11 > size)
+		{
+			break;
+		}
+
+		const uint8_t *rec = raw + pos + 1;
+		uint8_t count, addr_hi, addr_lo, type;
+		if (parse_ihex_byte(rec, &count) || parse_ihex_byte(rec + 2, &addr_hi) ||
+			parse_ihex_byte(rec + 4, &addr_lo) || parse_ihex_byte(rec + 6, &type))
+		{
+			return -1;
+		}
+		if (pos + 11 + (size_t)count * 2 > size)
+		{
+			return -1;
+		}
+
+		uint8_t sum = count + addr_hi + addr_lo + type;
+		uint8_t data[255];
+		for (int i = 0; i <= count; i++)
+		{
+			uint8_t value;
+			if (parse_ihex_byte(rec + 8 + i * 2, &value))
+			{
+				return -1;
+			}
+			sum += value;
+			if (i < count)
+			{
+				data[i] = value;
+			}
+		}
+		if (sum != 0)
+		{
+			return -1;                 // Checksum error
+		}
+
+		pos += 11 + (size_t)count * 2;
+
+		switch (type)
+		{
+			case 0x00:
+			{
+				uint32_t addr = base + ((uint32_t)addr_hi << 8 | addr_lo);
+				if (addr + count > DUMP_MAX_IMAGE)
+				{
+					return -1;
+				}
+				memcpy(image + addr, data, count);
+				if ((long)(addr + count) > extent)
+				{
+					extent = addr + count;
+				}
+				break;
+			}
+			case 0x01:
+				return extent;
+			case 0x02:
+				base = count == 2 ? ((uint32_t)data[0] << 8 | data[1]) << 4 : base;
+				break;
+			case 0x04:
+				base = count == 2 ? ((uint32_t)data[0] << 8 | data[1]) << 16 : base;
+				break;
+			default:
+				break;
+		}
+	}
+
+	return extent;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Hex text (firmware logs, xxd, hexdump -C, "0x04, 0x11, ...")
+// ═══════════════════════════════════════════════════════════════
+
+static long parse_hextext(const uint8_t *raw, size_t size, uint8_t *image)
+{
+	size_t pos = 0;
+	long count = 0;
+
+	while (pos < size)
+	{
+		size_t end = pos;
+		while (end < size && raw[end] != '\n')
+		{
+			end++;
+		}
+
+		// Anything up to the first ':' is an address or a log prefix
+		size_t p = pos;
+		int had_colon = 0;
+		for (size_t i = pos; i < end; i++)
+		{
+			if (raw[i] == ':')
+			{
+				p = i + 1;
+				had_colon = 1;
+				break;
+			}
+		}
+
+		int first = 1;
+		while (p < end)
+		{
+			while (p < end && (raw[p] == ' ' || raw[p] == '\t' || raw[p] == ',' || raw[p] == '\r'))
+			{
+				p++;
+			}
+			if (p >= end || raw[p] == '|')
+			{
+				break;                 // hexdump -C ASCII column
+			}
+
+			if (p + 1 < end && raw[p] == '0' && (raw[p + 1] == 'x' || raw[p + 1] == 'X'))
+			{
+				p += 2;
+			}
+
+			size_t start = p;
+			while (p < end && hex_value[raw[p]] != 0xFF)
+			{
+				p++;
+			}
+			size_t digits = p - start;
+
+			// A token must end at a separator and hold whole bytes (max 4 per group)
+			int separated = p >= end || raw[p] == ' ' || raw[p] == '\t' || raw[p] == ',' || raw[p] == '\r';
+			if (digits == 0 || !separated || (digits & 1) || digits > 8)
+			{
+				break;                 // xxd ASCII column or trailing text
+			}
+
+			// hexdump -C / od style offset column without ':'
+			if (first && !had_colon && digits >= 6)
+			{
+				first = 0;
+				continue;
+			}
+			first = 0;
+
+			for (size_t i = start; i < p; i += 2)
+			{
+				if (count >= DUMP_MAX_IMAGE)
+				{
+					return count;
+				}
+				image[count++] = (uint8_t)(hex_value[raw[i]] << 4 | hex_value[raw[i + 1]]);
+			}
+		}
+
+		pos = end + 1;
+	}
+
+	return count;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Window selection
+// ═══════════════════════════════════════════════════════════════
+
+static int window_score(const uint8_t *window)
+{
+	if (eeprom_detect_version(window) == EEPROM_VERSION_UNKNOWN)
+	{
+		return -1;
+	}
+
+	uint8_t copy[EEPROM_SIZE];
+	EEPROMCheck check;
+	memcpy(copy, window, EEPROM_SIZE);
+	if (eeprom_decode_check(copy, EEPROM_SIZE, EEPROM_VERSION_UNKNOWN, &check) != EEPROM_SUCCESS)
+	{
+		return -1;
+	}
+	return __builtin_popcount(check.crc_ok);
+}
+
+static int select_window(const uint8_t *image, size_t size, uint8_t window[EEPROM_SIZE], DumpInfo *info)
+{
+	info->image_size = size;
+	info->offset = 0;
+	info->crc_ok_regions = -1;
+
+	if (size <= EEPROM_SIZE)
+	{
+		memset(window, 0xFF, EEPROM_SIZE);
+		memcpy(window, image, size);
+		return 0;
+	}
+
+	// 24C04/08/16 reads are banks of 256 bytes; a 24C02 read with a larger
+	// part selected is the same bank mirrored. Pick the bank whose header
+	// is a known version with the most valid region CRCs.
+	int best_score = -1;
+	size_t best_offset = 0;
+
+	for (size_t offset = 0; offset + EEPROM_SIZE <= size; offset += EEPROM_SIZE)
+	{
+		if (offset > 0 && memcmp(image, image + offset, EEPROM_SIZE) == 0)
+		{
+			continue;                  // Mirror of bank 0
+		}
+
+		int score = window_score(image + offset);
+		if (score > best_score)
+		{
+			best_score = score;
+			best_offset = offset;
+		}
+	}
+
+	if (best_score < 0)
+	{
+		return -1;
+	}
+
+	memcpy(window, image + best_offset, EEPROM_SIZE);
+	info->offset = best_offset;
+	info->crc_ok_regions = best_score;
+	return 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Public API
+// ═══════════════════════════════════════════════════════════════
+
+int dump_extract(const uint8_t *raw, size_t size, uint8_t window[EEPROM_SIZE], DumpInfo *info)
+{
+	DumpInfo local;
+	if (!info)
+	{
+		info = &local;
+	}
+	memset(info, 0, sizeof(*info));
+	info->format = DUMP_FORMAT_BINARY;
+
+	if (size == 0 || size > DUMP_MAX_SIZE)
+	{
+		return -1;
+	}
+
+	// Plain 24C02 image: the common case, no copies
+	if (size <= EEPROM_SIZE && !(size > 16 && is_text(raw, size)))
+	{
+		return select_window(raw, size, window, info);
+	}
+
+	if (!is_text(raw, size))
+	{
+		return size <= DUMP_MAX_IMAGE ? select_window(raw, size, window, info) : -1;
+	}
+
+	uint8_t *image = malloc(DUMP_MAX_IMAGE);
+	if (!image)
+	{
+		return -1;
+	}
+
+	size_t first = 0;
+	while (first < size && (raw[first] == ' ' || raw[first] == '\t' || raw[first] == '\r' || raw[first] == '\n'))
+	{
+		first++;
+	}
+
+	long parsed;
+	if (first < size && raw[first] == ':')
+	{
+		info->format = DUMP_FORMAT_IHEX;
+		parsed = parse_ihex(raw, size, image);
+	}
+	else
+	{
+		info->format = DUMP_FORMAT_HEXTEXT;
+		parsed = parse_hextext(raw, size, image);
+	}
+
+	// Text that merely contains hex tokens (configs, logs) is not a dump
+	// unless it starts with a known version header
+	int result = -1;
+	if (parsed > EEPROM_SIZE ||
+		(parsed >= 2 && eeprom_detect_version(image) != EEPROM_VERSION_UNKNOWN))
+	{
+		result = select_window(image, (size_t)parsed, window, info);
+	}
+
+	free(image);
+	return result;
+}
+
+const char *dump_format_name(DumpFormat format)
+{
+	switch (format)
+	{
+		case DUMP_FORMAT_BINARY:
+			return "binary";
+		case DUMP_FORMAT_IHEX:
+			return "Intel HEX";
+		case DUMP_FORMAT_HEXTEXT:
+			return "hex text";
+		default:
+			return "unknown";
+	}
+}
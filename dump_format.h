@@ -0,0 +1,40 @@
+#ifndef DUMP_FORMAT_H
+#define DUMP_FORMAT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "eeprom_defs.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Programmer dump ingestion
+// ═══════════════════════════════════════════════════════════════
+// Accepts raw 24C02 images (1-256 bytes), larger programmer reads
+// (24C04/08/16 banks or a mirrored 24C02, e.g. CH341A .bin files),
+// Intel HEX and hex text from firmware logs / xxd / hexdump -C.
+
+#define DUMP_MAX_SIZE              (64 * 1024)   // Largest file considered
+#define DUMP_MAX_IMAGE             (16 * 1024)   // Largest decoded image (24C128)
+
+typedef enum
+{
+	DUMP_FORMAT_BINARY,
+	DUMP_FORMAT_IHEX,
+	DUMP_FORMAT_HEXTEXT
+} DumpFormat;
+
+typedef struct
+{
+	DumpFormat format;
+	size_t image_size;             // Bytes after container decoding
+	size_t offset;                 // Offset of the selected 256-byte window
+	int crc_ok_regions;            // Regions with a valid CRC (-1: not checked)
+} DumpInfo;
+
+// Find the EEPROM window in a file's contents. On success window holds
+// EEPROM_SIZE bytes (short images are padded with 0xFF) and 0 is returned.
+// Returns -1 if the contents are not a recognisable dump.
+int dump_extract(const uint8_t *raw, size_t size, uint8_t window[EEPROM_SIZE], DumpInfo *info);
+
+const char *dump_format_name(DumpFormat format);
+
+#endif // DUMP_FORMAT_H
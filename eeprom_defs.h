@@ -27,7 +27,8 @@ typedef enum
 	FIELD_TYPE_HEX16,           // uint16_t displayed as hex
 	FIELD_TYPE_VOLTAGE,         // uint16_t / 100 → float (V)
 	FIELD_TYPE_HASHRATE,        // uint16_t / 100 → float (unit in metadata: GH/s or TH/s)
-	FIELD_TYPE_ARRAY_UINT8      // Array of uint8_t
+	FIELD_TYPE_ARRAY_UINT8,     // Array of uint8_t
+	FIELD_TYPE_FREQ_LEVELS      // Packed 4-bit sweep levels (base/step from the same region)
 } FieldType;
 
 // ═══════════════════════════════════════════════════════════════
@@ -48,19 +49,19 @@ typedef enum
 #define EEPROM_V4_REGION1_START    2
 #define EEPROM_V4_REGION1_SIZE     96
 #define EEPROM_V4_REGION1_CRC_POS  97
-#define EEPROM_V4_REGION1_CRC_BITS (97 * 8)  // 776 bits
+#define EEPROM_V4_REGION1_CRC_BITS (97 * 8)  // 776 bits (bytes 0-96, header included)
 
 // Region 2: Test Parameters (v4/v5/v6)
 #define EEPROM_V4_REGION2_START    98
 #define EEPROM_V4_REGION2_SIZE     16
 #define EEPROM_V4_REGION2_CRC_POS  113
-#define EEPROM_V4_REGION2_CRC_BITS (15 * 8)  // 120 bits
+#define EEPROM_V4_REGION2_CRC_BITS (15 * 8)  // 120 bits (bytes 98-112)
 
 // Region 3: Sweep Data (v5/v6 only)
 #define EEPROM_V5_REGION3_START    114
 #define EEPROM_V5_REGION3_SIZE     136
 #define EEPROM_V5_REGION3_CRC_POS  249
-#define EEPROM_V5_REGION3_CRC_BITS (135 * 8)  // 1080 bits
+#define EEPROM_V5_REGION3_CRC_BITS (135 * 8)  // 1080 bits (bytes 114-248)
 
 // ═══════════════════════════════════════════════════════════════
 // EEPROM v17 Layout (Antminer L)
@@ -113,6 +114,7 @@ typedef struct
 	const char *name;              // Region name for debug output
 	size_t data_start;             // Start offset in byte array
 	size_t data_size;              // Size of encrypted data
+	size_t crc_start;              // First byte covered by the CRC
 	size_t crc_pos;                // CRC position in byte array
 	size_t crc_bits;               // Number of bits for CRC calculation
 	int test_result_pos;           // Test result position (-1 if none)
@@ -131,6 +133,7 @@ typedef struct
 typedef struct
 {
 	const char *name;              // Field name for display
+	const char *path;              // Structure member path, e.g. "pt2_data.voltage"
 	const char *category;          // Category for grouping
 	FieldType type;                // Field type
 	size_t offset;                 // offsetof() from structure base
@@ -140,6 +143,7 @@ typedef struct
 	const char *unit;              // Unit suffix (V, MHz, °C, etc)
 	const char *format;            // printf format string
 	uint8_t read_only;             // Cannot be edited
+	uint8_t big_endian;            // 16-bit value stored big-endian in the image
 } FieldMetadata;
 
 // ═══════════════════════════════════════════════════════════════
@@ -186,82 +190,40 @@ static inline size_t eeprom_get_used_size(EEPROMVersion version)
 // Region Metadata Definitions
 // ═══════════════════════════════════════════════════════════════
 
-// v4/v5/v6 regions
+#include "eeprom_structure.h"
+
+// One RegionMeta per BEGIN entry of a schema (see eeprom_schema.h)
+#define SCHEMA_REGION_BEGIN(T, region, title, crc_member, crc_header, test_member, test) \
+	{ \
+		.name = title, \
+		.data_start = offsetof(T, region), \
+		.data_size = sizeof(((T*)0)->region), \
+		.crc_start = (crc_header) ? 0 : offsetof(T, region), \
+		.crc_pos = offsetof(T, region.crc_member), \
+		.crc_bits = (offsetof(T, region.crc_member) - ((crc_header) ? 0 : offsetof(T, region))) * 8, \
+		.test_result_pos = offsetof(T, region.test_member), \
+		.test_name = test \
+	},
+
+#define SCHEMA_REGIONS(schema, T) \
+	schema(T, SCHEMA_NONE, SCHEMA_NONE, SCHEMA_REGION_BEGIN, SCHEMA_NONE, SCHEMA_NONE, SCHEMA_NONE)
+
+// v4/v5/v6 regions (v4 uses the first two)
 static const RegionMeta v4_v6_regions[] =
 {
-	{
-		.name = "Board Information",
-		.data_start = EEPROM_V4_REGION1_START,
-		.data_size = EEPROM_V4_REGION1_SIZE,
-		.crc_pos = EEPROM_V4_REGION1_CRC_POS,
-		.crc_bits = EEPROM_V4_REGION1_CRC_BITS,
-		.test_result_pos = 95,  // PT1 result position
-		.test_name = "PT1"
-	},
-	{
-		.name = "Test Parameters",
-		.data_start = EEPROM_V4_REGION2_START,
-		.data_size = EEPROM_V4_REGION2_SIZE,
-		.crc_pos = EEPROM_V4_REGION2_CRC_POS,
-		.crc_bits = EEPROM_V4_REGION2_CRC_BITS,
-		.test_result_pos = 108,  // PT2 result position
-		.test_name = "PT2"
-	},
-	{
-		.name = "Sweep Data",
-		.data_start = EEPROM_V5_REGION3_START,
-		.data_size = EEPROM_V5_REGION3_SIZE,
-		.crc_pos = EEPROM_V5_REGION3_CRC_POS,
-		.crc_bits = EEPROM_V5_REGION3_CRC_BITS,
-		.test_result_pos = 247,  // Sweep result position
-		.test_name = "Sweep"
-	}
+	SCHEMA_REGIONS(EEPROM_SCHEMA_V4_V6, EEPROMStructure)
 };
 
 // v17 region
 static const RegionMeta v17_regions[] =
 {
-	{
-		.name = "Encrypted Data",
-		.data_start = EEPROM_V17_HEADER_SIZE,
-		.data_size = EEPROM_V17_DATA_SIZE,
-		.crc_pos = EEPROM_V17_CRC_POS,
-		.crc_bits = EEPROM_V17_CRC_BITS,
-		.test_result_pos = 67,  // Test result position
-		.test_name = "Test"
-	}
+	SCHEMA_REGIONS(EEPROM_SCHEMA_V17, EEPROMStructure_v17)
 };
 
-// v1 regions (for reference; v1 uses special CRC-8 handling)
+// v1 regions (v1 uses CRC-8 and AES per region)
 static const RegionMeta v1_regions[] =
 {
-	{
-		.name = "PT1 (Board Info)",
-		.data_start = EEPROM_V1_PT1_START,
-		.data_size = EEPROM_V1_PT1_SIZE,
-		.crc_pos = EEPROM_V1_PT1_CRC_POS,
-		.crc_bits = EEPROM_V1_PT1_CRC_BYTES * 8,
-		.test_result_pos = 93,  // 16 + 77
-		.test_name = "PT1"
-	},
-	{
-		.name = "PT2 (Test Params)",
-		.data_start = EEPROM_V1_PT2_START,
-		.data_size = EEPROM_V1_PT2_SIZE,
-		.crc_pos = EEPROM_V1_PT2_CRC_POS,
-		.crc_bits = EEPROM_V1_PT2_CRC_BYTES * 8,
-		.test_result_pos = 107,  // 96 + 11
-		.test_name = "PT2"
-	},
-	{
-		.name = "SWEEP (Freq Optimization)",
-		.data_start = EEPROM_V1_SWEEP_START,
-		.data_size = EEPROM_V1_SWEEP_SIZE,
-		.crc_pos = EEPROM_V1_SWEEP_CRC_POS,
-		.crc_bits = EEPROM_V1_SWEEP_CRC_BYTES * 8,
-		.test_result_pos = 253,  // 112 + 141
-		.test_name = "Sweep"
-	}
+	SCHEMA_REGIONS(EEPROM_SCHEMA_V1, EEPROMStructure_v1)
 };
 
 // Get layout for EEPROM version
@@ -307,381 +269,54 @@ static inline const EEPROMLayout* eeprom_get_layout(EEPROMVersion version)
 		}
 	};
 
-	for (size_t i = 0; i < sizeof(layouts) / sizeof(layouts[0]); i++)
+	// Indexed by version byte
+	static const EEPROMLayout *const by_version[EEPROM_VERSION_V17 + 1] =
 	{
-		if (layouts[i].version == version)
-		{
-			return &layouts[i];
-		}
-	}
+		[EEPROM_VERSION_V1] = &layouts[0],
+		[EEPROM_VERSION_V4] = &layouts[1],
+		[EEPROM_VERSION_V5] = &layouts[2],
+		[EEPROM_VERSION_V6] = &layouts[3],
+		[EEPROM_VERSION_V17] = &layouts[4]
+	};
 
-	return NULL;
+	if (version < 0 || version > EEPROM_VERSION_V17)
+	{
+		return NULL;
+	}
+	return by_version[version];
 }
 
 // ═══════════════════════════════════════════════════════════════
 // Field Metadata Definitions
 // ═══════════════════════════════════════════════════════════════
-
-#include "eeprom_structure.h"
+// Used by the interactive editor; display order is the physical order.
+
+#define SCHEMA_META(T, path_, type_, n, name_, cat, lo, hi, unit_, fmt, flags) \
+	{ \
+		.name = name_, \
+		.path = #path_, \
+		.category = cat, \
+		.type = FIELD_TYPE_##type_, \
+		.offset = offsetof(T, path_), \
+		.size = sizeof(((T*)0)->path_), \
+		.min_value = lo, \
+		.max_value = hi, \
+		.unit = unit_, \
+		.format = fmt, \
+		.read_only = ((flags) & SCHEMA_RO) != 0, \
+		.big_endian = ((flags) & SCHEMA_BE) != 0 \
+	},
+
+#define SCHEMA_META_TOP(T, member, ...)            SCHEMA_META(T, member, __VA_ARGS__)
+#define SCHEMA_META_FIELD(T, region, member, ...)  SCHEMA_META(T, region.member, __VA_ARGS__)
+
+#define SCHEMA_FIELDS(schema, T) \
+	schema(T, SCHEMA_META_TOP, SCHEMA_NONE, SCHEMA_NONE, SCHEMA_META_FIELD, SCHEMA_NONE, SCHEMA_NONE)
 
 // v4/v5/v6 field metadata (S series)
 static const FieldMetadata eeprom_v4_v6_fields[] =
 {
-	// Header
-	{
-		.name = "EEPROM Version",
-		.category = "Header",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure, eeprom_version),
-		.size = sizeof(uint8_t),
-		.min_value = 4,
-		.max_value = 6,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 1
-	},
-	{
-		.name = "Algorithm & Key",
-		.category = "Header",
-		.type = FIELD_TYPE_HEX8,
-		.offset = offsetof(EEPROMStructure, algorithm_and_key_version),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 0xFF,
-		.unit = NULL,
-		.format = "0x%02X (alg=%d, key=%d)",
-		.read_only = 0
-	},
-
-	// Board Information
-	{
-		.name = "Board Serial",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure, board_info.board_sn),
-		.size = 18,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.18s",
-		.read_only = 0
-	},
-	{
-		.name = "Board Name",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure, board_info.board_name),
-		.size = 9,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.9s",
-		.read_only = 0
-	},
-	{
-		.name = "PCB Version",
-		.category = "Board Information",
-		.type = FIELD_TYPE_HEX16,
-		.offset = offsetof(EEPROMStructure, board_info.pcb_version),
-		.size = sizeof(uint16_t),
-		.min_value = 0,
-		.max_value = 0xFFFF,
-		.unit = NULL,
-		.format = "0x%04X",
-		.read_only = 0
-	},
-	{
-		.name = "BOM Version",
-		.category = "Board Information",
-		.type = FIELD_TYPE_HEX16,
-		.offset = offsetof(EEPROMStructure, board_info.bom_version),
-		.size = sizeof(uint16_t),
-		.min_value = 0,
-		.max_value = 0xFFFF,
-		.unit = NULL,
-		.format = "0x%04X",
-		.read_only = 0
-	},
-	{
-		.name = "Chip Die",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure, board_info.chip_die),
-		.size = 3,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.3s",
-		.read_only = 0
-	},
-	{
-		.name = "Chip Marking",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure, board_info.chip_marking),
-		.size = 14,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.14s",
-		.read_only = 0
-	},
-	{
-		.name = "Chip Bin",
-		.category = "Board Information",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure, board_info.chip_bin),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "Chip Tech",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure, board_info.chip_tech),
-		.size = 3,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.3s",
-		.read_only = 0
-	},
-	{
-		.name = "FT Version",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure, board_info.ft_version),
-		.size = 10,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.10s",
-		.read_only = 0
-	},
-	{
-		.name = "Factory Job",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure, board_info.factory_job),
-		.size = 24,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.24s",
-		.read_only = 0
-	},
-	{
-		.name = "ASIC Sensor Type",
-		.category = "Board Information",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure, board_info.asic_sensor_type),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "PT1 Result",
-		.category = "Board Information",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure, board_info.pt1_result),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 1,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "PT1 Count",
-		.category = "Board Information",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure, board_info.pt1_count),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-
-	// Test Parameters
-	{
-		.name = "PSU Voltage",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_VOLTAGE,
-		.offset = offsetof(EEPROMStructure, test_params.voltage),
-		.size = sizeof(uint16_t),
-		.min_value = 1000,
-		.max_value = 1500,
-		.unit = "V",
-		.format = "%.2f V",
-		.read_only = 0
-	},
-	{
-		.name = "Frequency",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT16,
-		.offset = offsetof(EEPROMStructure, test_params.frequency),
-		.size = sizeof(uint16_t),
-		.min_value = 100,
-		.max_value = 1000,
-		.unit = "MHz",
-		.format = "%d MHz",
-		.read_only = 0
-	},
-	{
-		.name = "Nonce Rate",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT16,
-		.offset = offsetof(EEPROMStructure, test_params.nonce_rate),
-		.size = sizeof(uint16_t),
-		.min_value = 0,
-		.max_value = 65535,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "PCB Temp In",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_INT8,
-		.offset = offsetof(EEPROMStructure, test_params.pcb_temp_in),
-		.size = sizeof(int8_t),
-		.min_value = -40,
-		.max_value = 125,
-		.unit = "°C",
-		.format = "%d °C",
-		.read_only = 0
-	},
-	{
-		.name = "PCB Temp Out",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_INT8,
-		.offset = offsetof(EEPROMStructure, test_params.pcb_temp_out),
-		.size = sizeof(int8_t),
-		.min_value = -40,
-		.max_value = 125,
-		.unit = "°C",
-		.format = "%d °C",
-		.read_only = 0
-	},
-	{
-		.name = "Test Version",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure, test_params.test_version),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "Test Standard",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure, test_params.test_standard),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "PT2 Result",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure, test_params.pt2_result),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 1,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "PT2 Count",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure, test_params.pt2_count),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-
-	// Sweep Data (v5+ only)
-	{
-		.name = "Sweep Hashrate",
-		.category = "Sweep Data",
-		.type = FIELD_TYPE_UINT16,
-		.offset = offsetof(EEPROMStructure, sweep_data.sweep_hashrate),
-		.size = sizeof(uint16_t),
-		.min_value = 0,
-		.max_value = 65535,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "Sweep Freq Base",
-		.category = "Sweep Data",
-		.type = FIELD_TYPE_UINT16,
-		.offset = offsetof(EEPROMStructure, sweep_data.sweep_freq_base),
-		.size = sizeof(uint16_t),
-		.min_value = 0,
-		.max_value = 2000,
-		.unit = "MHz",
-		.format = "%d MHz",
-		.read_only = 0
-	},
-	{
-		.name = "Sweep Freq Step",
-		.category = "Sweep Data",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure, sweep_data.sweep_freq_step),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = "MHz",
-		.format = "%d MHz",
-		.read_only = 0
-	},
-	{
-		.name = "ASIC Frequencies",
-		.category = "Sweep Data",
-		.type = FIELD_TYPE_ARRAY_UINT8,
-		.offset = offsetof(EEPROMStructure, sweep_data.sweep_level),
-		.size = 128,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = NULL,
-		.read_only = 1
-	},
-	{
-		.name = "Sweep Result",
-		.category = "Sweep Data",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure, sweep_data.sweep_result),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 1,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	}
+	SCHEMA_FIELDS(EEPROM_SCHEMA_V4_V6, EEPROMStructure)
 };
 
 #define EEPROM_V4_V6_FIELD_COUNT (sizeof(eeprom_v4_v6_fields) / sizeof(eeprom_v4_v6_fields[0]))
@@ -689,253 +324,7 @@ static const FieldMetadata eeprom_v4_v6_fields[] =
 // v17 field metadata (L series)
 static const FieldMetadata eeprom_v17_fields[] =
 {
-	// Header
-	{
-		.name = "Algorithm & Key",
-		.category = "Header",
-		.type = FIELD_TYPE_HEX8,
-		.offset = offsetof(EEPROMStructure_v17, algorithm_and_key),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 0xFF,
-		.unit = NULL,
-		.format = "0x%02X (alg=%d, key=%d)",
-		.read_only = 1
-	},
-	{
-		.name = "Data Length",
-		.category = "Header",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v17, data_length),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = "bytes",
-		.format = "%d bytes",
-		.read_only = 1
-	},
-
-	// Identification
-	{
-		.name = "Subformat Version",
-		.category = "Identification",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v17, data.subformat_version),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "Serial Number",
-		.category = "Identification",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v17, data.serial_number),
-		.size = 17,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.17s",
-		.read_only = 0
-	},
-	{
-		.name = "Chip Die",
-		.category = "Identification",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v17, data.chip_die),
-		.size = 2,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.2s",
-		.read_only = 0
-	},
-	{
-		.name = "Chip Marking",
-		.category = "Identification",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v17, data.chip_marking),
-		.size = 13,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.13s",
-		.read_only = 0
-	},
-	{
-		.name = "Chip Bin",
-		.category = "Identification",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v17, data.chip_bin),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "FT Program Version",
-		.category = "Identification",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v17, data.ft_program_version),
-		.size = 9,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.9s",
-		.read_only = 0
-	},
-	{
-		.name = "Miner Type",
-		.category = "Identification",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v17, data.miner_type),
-		.size = 8,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.8s",
-		.read_only = 0
-	},
-
-	// Hardware Versions
-	{
-		.name = "PCB Version",
-		.category = "Hardware",
-		.type = FIELD_TYPE_HEX16,
-		.offset = offsetof(EEPROMStructure_v17, data.pcb_version),
-		.size = sizeof(uint16_t),
-		.min_value = 0,
-		.max_value = 0xFFFF,
-		.unit = NULL,
-		.format = "%d.%02d",
-		.read_only = 0
-	},
-	{
-		.name = "BOM Version",
-		.category = "Hardware",
-		.type = FIELD_TYPE_HEX16,
-		.offset = offsetof(EEPROMStructure_v17, data.bom_version),
-		.size = sizeof(uint16_t),
-		.min_value = 0,
-		.max_value = 0xFFFF,
-		.unit = NULL,
-		.format = "%d.%d",
-		.read_only = 0
-	},
-	{
-		.name = "Chip Technology",
-		.category = "Hardware",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v17, data.chip_technology),
-		.size = 2,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.2s",
-		.read_only = 0
-	},
-	{
-		.name = "ASIC Sensor Type",
-		.category = "Hardware",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v17, data.asic_sensor_type),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-
-	// Test Parameters
-	{
-		.name = "Test Voltage",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT16,
-		.offset = offsetof(EEPROMStructure_v17, data.test_voltage),
-		.size = sizeof(uint16_t),
-		.min_value = 8000,
-		.max_value = 14000,
-		.unit = "mV",
-		.format = "%d mV",
-		.read_only = 0
-	},
-	{
-		.name = "Test Frequency",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT16,
-		.offset = offsetof(EEPROMStructure_v17, data.test_frequency),
-		.size = sizeof(uint16_t),
-		.min_value = 100,
-		.max_value = 2000,
-		.unit = "MHz",
-		.format = "%d MHz",
-		.read_only = 0
-	},
-	{
-		.name = "Test Hashrate",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_HASHRATE,
-		.offset = offsetof(EEPROMStructure_v17, data.test_hashrate),
-		.size = sizeof(uint16_t),
-		.min_value = 0,
-		.max_value = 10000,
-		.unit = "GH/s",
-		.format = "%.2f GH/s",
-		.read_only = 0
-	},
-	{
-		.name = "PCB Temp In",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_INT8,
-		.offset = offsetof(EEPROMStructure_v17, data.pcb_temperature_in),
-		.size = sizeof(int8_t),
-		.min_value = -40,
-		.max_value = 125,
-		.unit = "°C",
-		.format = "%d °C",
-		.read_only = 0
-	},
-	{
-		.name = "PCB Temp Out",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_INT8,
-		.offset = offsetof(EEPROMStructure_v17, data.pcb_temperature_out),
-		.size = sizeof(int8_t),
-		.min_value = -40,
-		.max_value = 125,
-		.unit = "°C",
-		.format = "%d °C",
-		.read_only = 0
-	},
-	{
-		.name = "Test Parameter",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v17, data.test_parameter),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "Test Result",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v17, data.test_result),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 1,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	}
+	SCHEMA_FIELDS(EEPROM_SCHEMA_V17, EEPROMStructure_v17)
 };
 
 #define EEPROM_V17_FIELD_COUNT (sizeof(eeprom_v17_fields) / sizeof(eeprom_v17_fields[0]))
@@ -943,362 +332,7 @@ static const FieldMetadata eeprom_v17_fields[] =
 // v1 field metadata (S21+ series)
 static const FieldMetadata eeprom_v1_fields[] =
 {
-	// Header
-	{
-		.name = "EEPROM Version",
-		.category = "Header",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, eeprom_version),
-		.size = sizeof(uint8_t),
-		.min_value = 1,
-		.max_value = 1,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 1
-	},
-	{
-		.name = "Board Name",
-		.category = "Header",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v1, board_name),
-		.size = 15,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.15s",
-		.read_only = 0
-	},
-
-	// PT1: Board Information
-	{
-		.name = "Board Serial",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v1, pt1_data.board_serial),
-		.size = 18,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.18s",
-		.read_only = 0
-	},
-	{
-		.name = "Factory Job",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v1, pt1_data.factory_job),
-		.size = 24,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.24s",
-		.read_only = 0
-	},
-	{
-		.name = "Chip Die",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v1, pt1_data.chip_die),
-		.size = 3,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.3s",
-		.read_only = 0
-	},
-	{
-		.name = "Chip Marking",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v1, pt1_data.chip_marking),
-		.size = 14,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.14s",
-		.read_only = 0
-	},
-	{
-		.name = "FT Version",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v1, pt1_data.ft_version),
-		.size = 10,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.10s",
-		.read_only = 0
-	},
-	{
-		.name = "Chip Tech",
-		.category = "Board Information",
-		.type = FIELD_TYPE_STRING,
-		.offset = offsetof(EEPROMStructure_v1, pt1_data.chip_tech),
-		.size = 3,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = "%.3s",
-		.read_only = 0
-	},
-	{
-		.name = "Chip Bin",
-		.category = "Board Information",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, pt1_data.chip_bin),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "PCB Version",
-		.category = "Board Information",
-		.type = FIELD_TYPE_HEX16,
-		.offset = offsetof(EEPROMStructure_v1, pt1_data.pcb_version),
-		.size = sizeof(uint16_t),
-		.min_value = 0,
-		.max_value = 0xFFFF,
-		.unit = NULL,
-		.format = "0x%04X",
-		.read_only = 0
-	},
-	{
-		.name = "BOM Version",
-		.category = "Board Information",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, pt1_data.bom_version),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "ASIC Sensor Type",
-		.category = "Board Information",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, pt1_data.asic_sensor_type),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "PT1 Result",
-		.category = "Board Information",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, pt1_data.pt1_result),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 1,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "PT1 Count",
-		.category = "Board Information",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, pt1_data.pt1_count),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-
-	// PT2: Test Parameters
-	{
-		.name = "PSU Voltage",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_VOLTAGE,
-		.offset = offsetof(EEPROMStructure_v1, pt2_data.voltage),
-		.size = sizeof(uint16_t),
-		.min_value = 1000,
-		.max_value = 1500,
-		.unit = "V",
-		.format = "%.2f V",
-		.read_only = 0
-	},
-	{
-		.name = "Frequency",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT16,
-		.offset = offsetof(EEPROMStructure_v1, pt2_data.frequency),
-		.size = sizeof(uint16_t),
-		.min_value = 100,
-		.max_value = 1000,
-		.unit = "MHz",
-		.format = "%d MHz",
-		.read_only = 0
-	},
-	{
-		.name = "Nonce Rate",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT16,
-		.offset = offsetof(EEPROMStructure_v1, pt2_data.nonce_rate),
-		.size = sizeof(uint16_t),
-		.min_value = 0,
-		.max_value = 65535,
-		.unit = NULL,
-		.format = "%.2f",
-		.read_only = 0
-	},
-	{
-		.name = "Done Type",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, pt2_data.done_type),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "PCB Temp In",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_INT8,
-		.offset = offsetof(EEPROMStructure_v1, pt2_data.temp_in),
-		.size = sizeof(int8_t),
-		.min_value = -40,
-		.max_value = 125,
-		.unit = "°C",
-		.format = "%d °C",
-		.read_only = 0
-	},
-	{
-		.name = "PCB Temp Out",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_INT8,
-		.offset = offsetof(EEPROMStructure_v1, pt2_data.temp_out),
-		.size = sizeof(int8_t),
-		.min_value = -40,
-		.max_value = 125,
-		.unit = "°C",
-		.format = "%d °C",
-		.read_only = 0
-	},
-	{
-		.name = "PT2 Result",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, pt2_data.pt2_result),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 1,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "PT2 Count",
-		.category = "Test Parameters",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, pt2_data.pt2_count),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-
-	// SWEEP: Frequency Optimization
-	{
-		.name = "SWEEP Voltage",
-		.category = "Sweep Data",
-		.type = FIELD_TYPE_VOLTAGE,
-		.offset = offsetof(EEPROMStructure_v1, sweep_data.voltage),
-		.size = sizeof(uint16_t),
-		.min_value = 1000,
-		.max_value = 1500,
-		.unit = "V",
-		.format = "%.2f V",
-		.read_only = 0
-	},
-	{
-		.name = "Sweep Hashrate",
-		.category = "Sweep Data",
-		.type = FIELD_TYPE_HASHRATE,
-		.offset = offsetof(EEPROMStructure_v1, sweep_data.sweep_hashrate),
-		.size = sizeof(uint16_t),
-		.min_value = 0,
-		.max_value = 65535,
-		.unit = "TH/s",
-		.format = "%.2f TH/s",
-		.read_only = 0
-	},
-	{
-		.name = "Sweep Freq Base",
-		.category = "Sweep Data",
-		.type = FIELD_TYPE_UINT16,
-		.offset = offsetof(EEPROMStructure_v1, sweep_data.sweep_freq_base),
-		.size = sizeof(uint16_t),
-		.min_value = 0,
-		.max_value = 2000,
-		.unit = "MHz",
-		.format = "%d MHz",
-		.read_only = 0
-	},
-	{
-		.name = "Sweep Freq Step",
-		.category = "Sweep Data",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, sweep_data.sweep_freq_step),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = "MHz",
-		.format = "%d MHz",
-		.read_only = 0
-	},
-	{
-		.name = "ASIC Frequencies",
-		.category = "Sweep Data",
-		.type = FIELD_TYPE_ARRAY_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, sweep_data.sweep_level),
-		.size = 128,
-		.min_value = 0,
-		.max_value = 0,
-		.unit = NULL,
-		.format = NULL,
-		.read_only = 1
-	},
-	{
-		.name = "Sweep Result",
-		.category = "Sweep Data",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, sweep_data.sweep_result),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 1,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	},
-	{
-		.name = "Sweep Count",
-		.category = "Sweep Data",
-		.type = FIELD_TYPE_UINT8,
-		.offset = offsetof(EEPROMStructure_v1, sweep_data.sweep_count),
-		.size = sizeof(uint8_t),
-		.min_value = 0,
-		.max_value = 255,
-		.unit = NULL,
-		.format = "%d",
-		.read_only = 0
-	}
-
+	SCHEMA_FIELDS(EEPROM_SCHEMA_V1, EEPROMStructure_v1)
 };
 
 #define EEPROM_V1_FIELD_COUNT (sizeof(eeprom_v1_fields) / sizeof(eeprom_v1_fields[0]))
@@ -1328,4 +362,75 @@ static inline const FieldMetadata* eeprom_get_fields(EEPROMVersion version, size
 	}
 }
 
+// Fields past the last region the layout uses (v4 has no sweep region)
+static inline int eeprom_field_in_layout(const FieldMetadata *field, const EEPROMLayout *layout)
+{
+	const RegionMeta *last = &layout->regions[layout->region_count - 1];
+	return field->offset < last->data_start + last->data_size;
+}
+
+// Regions whose ciphertext or CRC depend on a field (bit i = region i)
+static inline uint8_t eeprom_field_regions(const FieldMetadata *field, const EEPROMLayout *layout)
+{
+	size_t start = field->offset;
+	size_t end = field->offset + field->size;
+	uint8_t mask = 0;
+
+	// The header byte selecting algorithm and key (byte 1 on v4-v6, byte 0
+	// on v17) feeds the cipher of every region
+	size_t key_byte = layout->version == EEPROM_VERSION_V17 ? 0 : 1;
+	if (layout->version != EEPROM_VERSION_V1 && start <= key_byte && end > key_byte)
+	{
+		return (uint8_t)((1u << layout->region_count) - 1);
+	}
+
+	for (size_t i = 0; i < layout->region_count; i++)
+	{
+		const RegionMeta *region = &layout->regions[i];
+		size_t crc_end = region->crc_start + region->crc_bits / 8;
+		if ((start < region->data_start + region->data_size && end > region->data_start) ||
+			(start < crc_end && end > region->crc_start))
+		{
+			mask |= (uint8_t)(1u << i);
+		}
+	}
+	return mask;
+}
+
+// Field names match case-insensitively, with any run of non-alphanumeric
+// characters acting as one separator: "PT2 Result" == "pt2_result"
+static inline int eeprom_field_name_match(const char *name, const char *query)
+{
+	for (;;)
+	{
+		int name_sep = 0, query_sep = 0;
+		while (*name && !((*name | 0x20) >= 'a' && (*name | 0x20) <= 'z') && !(*name >= '0' && *name <= '9'))
+		{
+			name++;
+			name_sep = 1;
+		}
+		while (*query && !((*query | 0x20) >= 'a' && (*query | 0x20) <= 'z') && !(*query >= '0' && *query <= '9'))
+		{
+			query++;
+			query_sep = 1;
+		}
+		if (!*name || !*query)
+		{
+			return !*name && !*query;
+		}
+		if (name_sep != query_sep)
+		{
+			return 0;
+		}
+		char a = (*name >= 'A' && *name <= 'Z') ? *name | 0x20 : *name;
+		char b = (*query >= 'A' && *query <= 'Z') ? *query | 0x20 : *query;
+		if (a != b)
+		{
+			return 0;
+		}
+		name++;
+		query++;
+	}
+}
+
 #endif // EEPROM_DEFS_H
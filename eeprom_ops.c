@@ -1,5 +1,6 @@
 #include "eeprom_ops.h"
 #include "crypto.h"
+#include "crypto_kernels.h"
 #include <stdio.h>
 #include <string.h>
 
@@ -11,22 +12,28 @@ static void process_region_decode(uint8_t *data,
 								   const RegionMeta *region,
 								   uint8_t algorithm,
 								   uint8_t key_index,
-								   EEPROMVersion version)
+								   EEPROMVersion version,
+								   int verbose,
+								   int *crc_ok,
+								   int *test_pass)
 {
 	decode_data(data + region->data_start,
 			   region->data_size,
 			   algorithm, key_index, version);
 
-	uint8_t calculated_crc = calculate_crc(data, region->crc_bits);
-	if (calculated_crc != data[region->crc_pos])
+	uint8_t calculated_crc = calculate_crc(data + region->crc_start, region->crc_bits);
+	*crc_ok = calculated_crc == data[region->crc_pos];
+	if (!*crc_ok && verbose)
 	{
 		printf("Warning: CRC mismatch in %s. Calculated: 0x%02X, Stored: 0x%02X\n",
 			  region->name, calculated_crc, data[region->crc_pos]);
 	}
 
+	*test_pass = 1;
 	if (region->test_result_pos >= 0 && region->test_name)
 	{
-		if (data[region->test_result_pos] != 1)
+		*test_pass = data[region->test_result_pos] == 1;
+		if (!*test_pass && verbose)
 		{
 			printf("Warning: %s test did not pass (result = %d)\n",
 				  region->test_name, data[region->test_result_pos]);
@@ -34,24 +41,49 @@ static void process_region_decode(uint8_t *data,
 	}
 }
 
-static void process_region_encode(uint8_t *data,
-								   const RegionMeta *region,
-								   uint8_t algorithm,
-								   uint8_t key_index,
-								   EEPROMVersion version)
+static int decode_v1_block(uint8_t *data, const RegionMeta *region, uint32_t encryption_key,
+						   const char *block_name, int verbose, int *crc_ok)
 {
-	data[region->crc_pos] = calculate_crc(data, region->crc_bits);
+	if (decode_data_v1(data + region->data_start,
+					   region->data_size,
+					   encryption_key) != 0)
+	{
+		if (verbose)
+		{
+			printf("Error: Failed to decrypt %s block\n", block_name);
+		}
+		return EEPROM_ERROR_UNKNOWN;
+	}
 
-	encode_data(data + region->data_start,
-			   region->data_size,
-			   algorithm, key_index, version);
+	uint8_t crc_calc = calculate_crc8_v1(data + region->crc_start, region->crc_bits / 8);
+	*crc_ok = crc_calc == data[region->crc_pos];
+	if (!*crc_ok && verbose)
+	{
+		printf("Warning: %s CRC mismatch. Calculated: 0x%02X, Stored: 0x%02X\n",
+			   block_name, crc_calc, data[region->crc_pos]);
+	}
+
+	return EEPROM_SUCCESS;
 }
 
-int eeprom_decode(uint8_t *data, size_t size, EEPROMVersion version)
+// Table-driven path: layout lookup and runtime region parameters
+static int decode_generic(uint8_t *data, size_t size, EEPROMVersion version,
+						  EEPROMCheck *check, int verbose)
 {
+	EEPROMCheck local;
+	if (!check)
+	{
+		check = &local;
+	}
+	memset(check, 0, sizeof(*check));
+	check->version = EEPROM_VERSION_UNKNOWN;
+
 	if (size != EEPROM_SIZE)
 	{
-		printf("Error: Invalid buffer size %zu, expected %d\n", size, EEPROM_SIZE);
+		if (verbose)
+		{
+			printf("Error: Invalid buffer size %zu, expected %d\n", size, EEPROM_SIZE);
+		}
 		return EEPROM_ERROR_UNKNOWN;
 	}
 
@@ -60,66 +92,54 @@ int eeprom_decode(uint8_t *data, size_t size, EEPROMVersion version)
 		version = eeprom_detect_version(data);
 		if (version == EEPROM_VERSION_UNKNOWN)
 		{
-			printf("Error: Unknown EEPROM version (byte 0 = 0x%02X)\n", data[0]);
+			if (verbose)
+			{
+				printf("Error: Unknown EEPROM version (byte 0 = 0x%02X)\n", data[0]);
+			}
 			return EEPROM_ERROR_VERSION;
 		}
 	}
 
-	printf("EEPROM Version: %d (0x%02X)\n", version, data[0]);
+	if (verbose)
+	{
+		printf("EEPROM Version: %d (0x%02X)\n", version, data[0]);
+	}
+
+	const EEPROMLayout *layout = eeprom_get_layout(version);
+	if (!layout)
+	{
+		if (verbose)
+		{
+			printf("Error: No layout found for EEPROM version %d\n", version);
+		}
+		return EEPROM_ERROR_VERSION;
+	}
+
+	check->version = version;
+	check->region_count = (uint8_t)layout->region_count;
 
 	// ═══════════════════════════════════════════════════════════════
 	// EEPROM v1 (AES-256-CBC)
 	// ═══════════════════════════════════════════════════════════════
 	if (version == EEPROM_VERSION_V1)
 	{
+		static const char *block_names[] = { "PT1", "PT2", "SWEEP" };
 		uint32_t encryption_key = EEPROM_V1_KEY_PRODUCTION;
 
-		if (decode_data_v1(data + EEPROM_V1_PT1_START,
-						   EEPROM_V1_PT1_SIZE,
-						   encryption_key) != 0)
-		{
-			printf("Error: Failed to decrypt PT1 block\n");
-			return EEPROM_ERROR_UNKNOWN;
-		}
-
-		uint8_t pt1_crc_calc = calculate_crc8_v1(data + EEPROM_V1_PT1_START,
-												  EEPROM_V1_PT1_CRC_BYTES);
-		if (pt1_crc_calc != data[EEPROM_V1_PT1_CRC_POS])
-		{
-			printf("Warning: PT1 CRC mismatch. Calculated: 0x%02X, Stored: 0x%02X\n",
-				   pt1_crc_calc, data[EEPROM_V1_PT1_CRC_POS]);
-		}
-
-		if (decode_data_v1(data + EEPROM_V1_PT2_START,
-						   EEPROM_V1_PT2_SIZE,
-						   encryption_key) != 0)
-		{
-			printf("Error: Failed to decrypt PT2 block\n");
-			return EEPROM_ERROR_UNKNOWN;
-		}
-
-		uint8_t pt2_crc_calc = calculate_crc8_v1(data + EEPROM_V1_PT2_START,
-												  EEPROM_V1_PT2_CRC_BYTES);
-		if (pt2_crc_calc != data[EEPROM_V1_PT2_CRC_POS])
+		for (size_t i = 0; i < layout->region_count; i++)
 		{
-			printf("Warning: PT2 CRC mismatch. Calculated: 0x%02X, Stored: 0x%02X\n",
-				   pt2_crc_calc, data[EEPROM_V1_PT2_CRC_POS]);
-		}
+			const RegionMeta *region = &layout->regions[i];
+			int crc_ok;
 
-		if (decode_data_v1(data + EEPROM_V1_SWEEP_START,
-						   EEPROM_V1_SWEEP_SIZE,
-						   encryption_key) != 0)
-		{
-			printf("Error: Failed to decrypt SWEEP block\n");
-			return EEPROM_ERROR_UNKNOWN;
-		}
+			int result = decode_v1_block(data, region, encryption_key,
+										 block_names[i], verbose, &crc_ok);
+			if (result != EEPROM_SUCCESS)
+			{
+				return result;
+			}
 
-		uint8_t sweep_crc_calc = calculate_crc8_v1(data + EEPROM_V1_SWEEP_START,
-													EEPROM_V1_SWEEP_CRC_BYTES);
-		if (sweep_crc_calc != data[EEPROM_V1_SWEEP_CRC_POS])
-		{
-			printf("Warning: SWEEP CRC mismatch. Calculated: 0x%02X, Stored: 0x%02X\n",
-				   sweep_crc_calc, data[EEPROM_V1_SWEEP_CRC_POS]);
+			check->crc_ok |= crc_ok << i;
+			check->test_pass |= (data[region->test_result_pos] == 1) << i;
 		}
 
 		return EEPROM_SUCCESS;
@@ -129,13 +149,6 @@ int eeprom_decode(uint8_t *data, size_t size, EEPROMVersion version)
 	// EEPROM v4/v5/v6/v17 - Generic region processing (XXTEA/XOR)
 	// ═══════════════════════════════════════════════════════════════
 
-	const EEPROMLayout *layout = eeprom_get_layout(version);
-	if (!layout)
-	{
-		printf("Error: No layout found for EEPROM version %d\n", version);
-		return EEPROM_ERROR_VERSION;
-	}
-
 	uint8_t algorithm = layout->algorithm;
 	uint8_t key_index = layout->key_index;
 
@@ -147,101 +160,450 @@ int eeprom_decode(uint8_t *data, size_t size, EEPROMVersion version)
 
 	for (size_t i = 0; i < layout->region_count; i++)
 	{
+		int crc_ok, test_pass;
 		process_region_decode(data, &layout->regions[i],
-							 algorithm, key_index, version);
+							 algorithm, key_index, version,
+							 verbose, &crc_ok, &test_pass);
+		check->crc_ok |= crc_ok << i;
+		check->test_pass |= test_pass << i;
 	}
 
 	return EEPROM_SUCCESS;
 }
 
-int eeprom_encode(uint8_t *data, size_t size, EEPROMVersion version)
+// ═══════════════════════════════════════════════════════════════
+// Version-Specialized Codecs
+// ═══════════════════════════════════════════════════════════════
+// Each version gets its own decode/encode with the region table entries
+// inlined, so offsets, sizes and CRC bit counts are constants and the
+// XXTEA round count folds. Dispatch is a direct table on the version
+// byte.
+
+#define CODEC_INLINE static inline __attribute__((always_inline))
+
+CODEC_INLINE void region_cipher(uint8_t *data, const RegionMeta *region, uint8_t algorithm,
+								uint8_t key_index, EEPROMVersion version, int decode)
 {
-	if (size != EEPROM_SIZE)
+	uint8_t *p = data + region->data_start;
+
+	if (algorithm == CRYPTO_ALGORITHM_XXTEA)
 	{
-		printf("Error: Invalid buffer size %zu, expected %d\n", size, EEPROM_SIZE);
-		return EEPROM_ERROR_UNKNOWN;
+		const uint32_t *key = crypto_xxtea_key(version, key_index);
+		if (decode)
+		{
+			xxtea_decode((uint32_t*)p, region->data_size / 4, key);
+		}
+		else
+		{
+			xxtea_encode((uint32_t*)p, region->data_size / 4, key);
+		}
 	}
+	else if (algorithm == CRYPTO_ALGORITHM_XOR)
+	{
+		xor_words(p, region->data_size, crypto_xor_key(key_index));
+	}
+}
 
-	if (version == EEPROM_VERSION_UNKNOWN)
+CODEC_INLINE void region_decode(uint8_t *data, const RegionMeta *region, int index,
+								uint8_t algorithm, uint8_t key_index, EEPROMVersion version,
+								EEPROMCheck *check, int verbose)
+{
+	region_cipher(data, region, algorithm, key_index, version, 1);
+
+	uint8_t calculated_crc = crc5_bits(data + region->crc_start, region->crc_bits);
+	int crc_ok = calculated_crc == data[region->crc_pos];
+	if (!crc_ok && verbose)
 	{
-		version = eeprom_detect_version(data);
-		if (version == EEPROM_VERSION_UNKNOWN)
+		printf("Warning: CRC mismatch in %s. Calculated: 0x%02X, Stored: 0x%02X\n",
+			  region->name, calculated_crc, data[region->crc_pos]);
+	}
+
+	int test_pass = data[region->test_result_pos] == 1;
+	if (!test_pass && verbose)
+	{
+		printf("Warning: %s test did not pass (result = %d)\n",
+			  region->test_name, data[region->test_result_pos]);
+	}
+
+	check->crc_ok |= crc_ok << index;
+	check->test_pass |= test_pass << index;
+}
+
+CODEC_INLINE void region_encode(uint8_t *data, const RegionMeta *region, uint8_t algorithm,
+								uint8_t key_index, EEPROMVersion version, int update_crc)
+{
+	if (update_crc)
+	{
+		data[region->crc_pos] = crc5_bits(data + region->crc_start, region->crc_bits);
+	}
+	region_cipher(data, region, algorithm, key_index, version, 0);
+}
+
+// v4/v5/v6: algorithm and key come from byte 1 of each image
+CODEC_INLINE int decode_s19(uint8_t *data, EEPROMCheck *check, int verbose,
+							EEPROMVersion version, int regions)
+{
+	uint8_t algorithm = data[1] >> 4;
+	uint8_t key_index = data[1] & 0xF;
+
+	region_decode(data, &v4_v6_regions[0], 0, algorithm, key_index, version, check, verbose);
+	region_decode(data, &v4_v6_regions[1], 1, algorithm, key_index, version, check, verbose);
+	if (regions > 2)
+	{
+		region_decode(data, &v4_v6_regions[2], 2, algorithm, key_index, version, check, verbose);
+	}
+	return EEPROM_SUCCESS;
+}
+
+CODEC_INLINE int encode_s19(uint8_t *data, int update_crc, uint8_t mask, EEPROMVersion version, int regions)
+{
+	uint8_t algorithm = data[1] >> 4;
+	uint8_t key_index = data[1] & 0xF;
+
+	if (mask & 1)
+	{
+		region_encode(data, &v4_v6_regions[0], algorithm, key_index, version, update_crc);
+	}
+	if (mask & 2)
+	{
+		region_encode(data, &v4_v6_regions[1], algorithm, key_index, version, update_crc);
+	}
+	if (regions > 2 && (mask & 4))
+	{
+		region_encode(data, &v4_v6_regions[2], algorithm, key_index, version, update_crc);
+	}
+	return EEPROM_SUCCESS;
+}
+
+static int decode_v4(uint8_t *data, EEPROMCheck *check, int verbose)
+{
+	return decode_s19(data, check, verbose, EEPROM_VERSION_V4, 2);
+}
+
+static int decode_v5(uint8_t *data, EEPROMCheck *check, int verbose)
+{
+	return decode_s19(data, check, verbose, EEPROM_VERSION_V5, 3);
+}
+
+static int decode_v6(uint8_t *data, EEPROMCheck *check, int verbose)
+{
+	return decode_s19(data, check, verbose, EEPROM_VERSION_V6, 3);
+}
+
+static int encode_v4(uint8_t *data, int update_crc, uint8_t mask)
+{
+	return encode_s19(data, update_crc, mask, EEPROM_VERSION_V4, 2);
+}
+
+static int encode_v5(uint8_t *data, int update_crc, uint8_t mask)
+{
+	return encode_s19(data, update_crc, mask, EEPROM_VERSION_V5, 3);
+}
+
+static int encode_v6(uint8_t *data, int update_crc, uint8_t mask)
+{
+	return encode_s19(data, update_crc, mask, EEPROM_VERSION_V6, 3);
+}
+
+// v17: fixed algorithm/key (XXTEA, key 1)
+static int decode_v17(uint8_t *data, EEPROMCheck *check, int verbose)
+{
+	region_decode(data, &v17_regions[0], 0, CRYPTO_ALGORITHM_XXTEA, 1,
+				  EEPROM_VERSION_V17, check, verbose);
+	return EEPROM_SUCCESS;
+}
+
+static int encode_v17(uint8_t *data, int update_crc, uint8_t mask)
+{
+	if (mask & 1)
+	{
+		region_encode(data, &v17_regions[0], CRYPTO_ALGORITHM_XXTEA, 1, EEPROM_VERSION_V17, update_crc);
+	}
+	return EEPROM_SUCCESS;
+}
+
+// v1: AES-256-CBC + CRC-8 per block
+static int decode_v1(uint8_t *data, EEPROMCheck *check, int verbose)
+{
+	static const char *block_names[] = { "PT1", "PT2", "SWEEP" };
+
+	for (int i = 0; i < 3; i++)
+	{
+		const RegionMeta *region = &v1_regions[i];
+		int crc_ok;
+
+		int result = decode_v1_block(data, region, EEPROM_V1_KEY_PRODUCTION,
+									 block_names[i], verbose, &crc_ok);
+		if (result != EEPROM_SUCCESS)
 		{
-			printf("Error: Unknown EEPROM version (byte 0 = 0x%02X)\n", data[0]);
-			return EEPROM_ERROR_VERSION;
+			return result;
 		}
+
+		check->crc_ok |= crc_ok << i;
+		check->test_pass |= (data[region->test_result_pos] == 1) << i;
 	}
 
-	// ═══════════════════════════════════════════════════════════════
-	// EEPROM v1 (AES-256-CBC)
-	// ═══════════════════════════════════════════════════════════════
-	if (version == EEPROM_VERSION_V1)
+	return EEPROM_SUCCESS;
+}
+
+static int encode_v1(uint8_t *data, int update_crc, uint8_t mask)
+{
+	static const char *block_names[] = { "PT1", "PT2", "SWEEP" };
+
+	for (int i = 0; i < 3; i++)
 	{
-		uint32_t encryption_key = EEPROM_V1_KEY_PRODUCTION;
+		const RegionMeta *region = &v1_regions[i];
+		if (!(mask & (1u << i)))
+		{
+			continue;
+		}
 
-		data[EEPROM_V1_PT1_CRC_POS] = calculate_crc8_v1(data + EEPROM_V1_PT1_START,
-														 EEPROM_V1_PT1_CRC_BYTES);
+		if (update_crc)
+		{
+			data[region->crc_pos] = calculate_crc8_v1(data + region->crc_start, region->crc_bits / 8);
+		}
 
-		if (encode_data_v1(data + EEPROM_V1_PT1_START,
-						   EEPROM_V1_PT1_SIZE,
-						   encryption_key) != 0)
+		if (encode_data_v1(data + region->data_start,
+						   region->data_size,
+						   EEPROM_V1_KEY_PRODUCTION) != 0)
 		{
-			printf("Error: Failed to encrypt PT1 block\n");
+			printf("Error: Failed to encrypt %s block\n", block_names[i]);
 			return EEPROM_ERROR_UNKNOWN;
 		}
+	}
+
+	return EEPROM_SUCCESS;
+}
+
+typedef struct
+{
+	uint8_t region_count;
+	int (*decode)(uint8_t *data, EEPROMCheck *check, int verbose);
+	int (*encode)(uint8_t *data, int update_crc, uint8_t mask);
+} EEPROMCodec;
+
+// Indexed by version byte (EEPROMVersion values equal their byte 0)
+static const EEPROMCodec codecs[256] =
+{
+	[EEPROM_VERSION_V1]  = { 3, decode_v1, encode_v1 },
+	[EEPROM_VERSION_V4]  = { 2, decode_v4, encode_v4 },
+	[EEPROM_VERSION_V5]  = { 3, decode_v5, encode_v5 },
+	[EEPROM_VERSION_V6]  = { 3, decode_v6, encode_v6 },
+	[EEPROM_VERSION_V17] = { 1, decode_v17, encode_v17 }
+};
+
+static const EEPROMCodec *codec_for(EEPROMVersion version)
+{
+	if (version < 0 || version > 0xFF || !codecs[version].decode)
+	{
+		return NULL;
+	}
+	return &codecs[version];
+}
 
-		data[EEPROM_V1_PT2_CRC_POS] = calculate_crc8_v1(data + EEPROM_V1_PT2_START,
-														 EEPROM_V1_PT2_CRC_BYTES);
+static int decode_internal(uint8_t *data, size_t size, EEPROMVersion version,
+						   EEPROMCheck *check, int verbose)
+{
+	EEPROMCheck local;
+	if (!check)
+	{
+		check = &local;
+	}
+	memset(check, 0, sizeof(*check));
+	check->version = EEPROM_VERSION_UNKNOWN;
 
-		if (encode_data_v1(data + EEPROM_V1_PT2_START,
-						   EEPROM_V1_PT2_SIZE,
-						   encryption_key) != 0)
+	if (size != EEPROM_SIZE)
+	{
+		if (verbose)
 		{
-			printf("Error: Failed to encrypt PT2 block\n");
-			return EEPROM_ERROR_UNKNOWN;
+			printf("Error: Invalid buffer size %zu, expected %d\n", size, EEPROM_SIZE);
 		}
+		return EEPROM_ERROR_UNKNOWN;
+	}
 
-		data[EEPROM_V1_SWEEP_CRC_POS] = calculate_crc8_v1(data + EEPROM_V1_SWEEP_START,
-														   EEPROM_V1_SWEEP_CRC_BYTES);
+	if (version == EEPROM_VERSION_UNKNOWN)
+	{
+		version = (EEPROMVersion)data[0];
+	}
 
-		if (encode_data_v1(data + EEPROM_V1_SWEEP_START,
-						   EEPROM_V1_SWEEP_SIZE,
-						   encryption_key) != 0)
+	const EEPROMCodec *codec = codec_for(version);
+	if (!codec)
+	{
+		if (verbose)
 		{
-			printf("Error: Failed to encrypt SWEEP block\n");
-			return EEPROM_ERROR_UNKNOWN;
+			printf("Error: Unknown EEPROM version (byte 0 = 0x%02X)\n", data[0]);
 		}
+		return EEPROM_ERROR_VERSION;
+	}
 
-		return EEPROM_SUCCESS;
+	if (verbose)
+	{
+		printf("EEPROM Version: %d (0x%02X)\n", version, data[0]);
 	}
 
-	// ═══════════════════════════════════════════════════════════════
-	// EEPROM v4/v5/v6/v17 - Generic region processing (XXTEA/XOR)
-	// ═══════════════════════════════════════════════════════════════
+	check->version = version;
+	check->region_count = codec->region_count;
+	return codec->decode(data, check, verbose);
+}
 
-	const EEPROMLayout *layout = eeprom_get_layout(version);
-	if (!layout)
+int eeprom_decode(uint8_t *data, size_t size, EEPROMVersion version)
+{
+	return decode_internal(data, size, version, NULL, 1);
+}
+
+int eeprom_decode_check(uint8_t *data, size_t size, EEPROMVersion version, EEPROMCheck *check)
+{
+	return decode_internal(data, size, version, check, 0);
+}
+
+int eeprom_decode_generic(uint8_t *data, size_t size, EEPROMVersion version, EEPROMCheck *check)
+{
+	return decode_generic(data, size, version, check, 0);
+}
+
+int eeprom_decode_region(uint8_t *data, EEPROMVersion version, int index, EEPROMCheck *check)
+{
+	const EEPROMCodec *codec = codec_for(version);
+	if (!codec || index < 0 || index >= codec->region_count)
 	{
-		printf("Error: No layout found for EEPROM version %d\n", version);
 		return EEPROM_ERROR_VERSION;
 	}
 
-	uint8_t algorithm = layout->algorithm;
-	uint8_t key_index = layout->key_index;
+	check->version = version;
+	check->region_count = codec->region_count;
 
-	if (version >= EEPROM_VERSION_V4 && version <= EEPROM_VERSION_V6)
+	if (version == EEPROM_VERSION_V1)
 	{
-		algorithm = data[1] >> 4;
-		key_index = data[1] & 0xF;
+		static const char *block_names[] = { "PT1", "PT2", "SWEEP" };
+		const RegionMeta *region = &v1_regions[index];
+		int crc_ok;
+
+		int result = decode_v1_block(data, region, EEPROM_V1_KEY_PRODUCTION,
+									 block_names[index], 0, &crc_ok);
+		if (result != EEPROM_SUCCESS)
+		{
+			return result;
+		}
+		check->crc_ok |= crc_ok << index;
+		check->test_pass |= (data[region->test_result_pos] == 1) << index;
+	}
+	else if (version == EEPROM_VERSION_V17)
+	{
+		region_decode(data, &v17_regions[0], 0, CRYPTO_ALGORITHM_XXTEA, 1,
+					  EEPROM_VERSION_V17, check, 0);
+	}
+	else
+	{
+		region_decode(data, &v4_v6_regions[index], index, data[1] >> 4, data[1] & 0xF,
+					  version, check, 0);
+	}
+	return EEPROM_SUCCESS;
+}
+
+static int encode_internal(uint8_t *data, size_t size, EEPROMVersion version, int update_crc,
+						   const uint8_t *original, uint8_t dirty)
+{
+	if (size != EEPROM_SIZE)
+	{
+		printf("Error: Invalid buffer size %zu, expected %d\n", size, EEPROM_SIZE);
+		return EEPROM_ERROR_UNKNOWN;
+	}
+
+	if (version == EEPROM_VERSION_UNKNOWN)
+	{
+		version = (EEPROMVersion)data[0];
+	}
+
+	const EEPROMCodec *codec = codec_for(version);
+	if (!codec)
+	{
+		printf("Error: Unknown EEPROM version (byte 0 = 0x%02X)\n", data[0]);
+		return EEPROM_ERROR_VERSION;
+	}
+
+	if (!original)
+	{
+		return codec->encode(data, update_crc, 0xFF);
 	}
 
+	// Untouched regions keep their original ciphertext byte for byte
+	const EEPROMLayout *layout = eeprom_get_layout(version);
 	for (size_t i = 0; i < layout->region_count; i++)
 	{
-		process_region_encode(data, &layout->regions[i],
-							 algorithm, key_index, version);
+		if (!(dirty & (1u << i)))
+		{
+			const RegionMeta *region = &layout->regions[i];
+			memcpy(data + region->data_start, original + region->data_start, region->data_size);
+		}
 	}
+	return codec->encode(data, update_crc, dirty);
+}
 
-	return EEPROM_SUCCESS;
+int eeprom_encode(uint8_t *data, size_t size, EEPROMVersion version)
+{
+	return encode_internal(data, size, version, 1, NULL, 0);
+}
+
+int eeprom_encrypt(uint8_t *data, size_t size, EEPROMVersion version)
+{
+	return encode_internal(data, size, version, 0, NULL, 0);
+}
+
+int eeprom_encode_dirty(uint8_t *data, size_t size, EEPROMVersion version,
+						const uint8_t *original, uint8_t dirty)
+{
+	return encode_internal(data, size, version, 0, original, dirty);
+}
+
+// Field bytes as stored in the image (the parsed structure holds
+// big-endian fields in host order)
+static void field_wire_bytes(const FieldMetadata *field, const uint8_t *value, uint8_t *out)
+{
+	memcpy(out, value, field->size);
+	if (field->big_endian && field->size == 2)
+	{
+		uint16_t v;
+		memcpy(&v, value, 2);
+		out[0] = (uint8_t)(v >> 8);
+		out[1] = (uint8_t)v;
+	}
+}
+
+void eeprom_field_update_crc(void *eeprom, EEPROMVersion version, const FieldMetadata *field,
+							 const uint8_t *old_value)
+{
+	const EEPROMLayout *layout = eeprom_get_layout(version);
+	if (!layout || field->size > EEPROM_SIZE)
+	{
+		return;
+	}
+
+	uint8_t *base = (uint8_t*)eeprom;
+	uint8_t old_bytes[EEPROM_SIZE];
+	uint8_t new_bytes[EEPROM_SIZE];
+	field_wire_bytes(field, old_value, old_bytes);
+	field_wire_bytes(field, base + field->offset, new_bytes);
+
+	for (size_t i = 0; i < layout->region_count; i++)
+	{
+		const RegionMeta *region = &layout->regions[i];
+		size_t span = region->crc_bits / 8;
+		if (field->offset < region->crc_start || field->offset + field->size > region->crc_start + span)
+		{
+			continue;
+		}
+
+		size_t offset = field->offset - region->crc_start;
+		uint8_t *crc = base + region->crc_pos;
+		if (version == EEPROM_VERSION_V1)
+		{
+			*crc = crc8_v1_update(*crc, old_bytes, new_bytes, field->size, offset, span);
+		}
+		else
+		{
+			*crc = crc5_update(*crc, old_bytes, new_bytes, field->size, offset, region->crc_bits);
+		}
+	}
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -250,9 +612,11 @@ int eeprom_encode(uint8_t *data, size_t size, EEPROMVersion version)
 
 #include "ui.h"
 
-static int edit_field_interactive(void *base, const FieldMetadata *field)
+static int edit_field_interactive(void *base, EEPROMVersion version, const FieldMetadata *field,
+								  uint8_t *dirty)
 {
 	uint8_t *ptr = (uint8_t*)base + field->offset;
+	uint8_t old_value[EEPROM_SIZE];
 
 	if (field->read_only)
 	{
@@ -260,6 +624,13 @@ static int edit_field_interactive(void *base, const FieldMetadata *field)
 		return EEPROM_SUCCESS;
 	}
 
+	if (field->size > sizeof(old_value))
+	{
+		ui_print_error("Editing not supported for this field type");
+		return EEPROM_ERROR_UNKNOWN;
+	}
+	memcpy(old_value, ptr, field->size);
+
 	printf("\n");
 	ui_print_info("Editing: %s", field->name);
 	printf("Current value: ");
@@ -321,14 +692,21 @@ static int edit_field_interactive(void *base, const FieldMetadata *field)
 			return EEPROM_ERROR_UNKNOWN;
 	}
 
+	// Keep the region CRC current for this edit
+	if (memcmp(old_value, ptr, field->size) != 0)
+	{
+		eeprom_field_update_crc(base, version, field, old_value);
+		*dirty |= eeprom_field_regions(field, eeprom_get_layout(version));
+	}
 	return EEPROM_SUCCESS;
 }
 
-int eeprom_edit_interactive(void *eeprom_struct, EEPROMVersion version)
+int eeprom_edit_interactive(void *eeprom_struct, EEPROMVersion version, uint8_t *dirty)
 {
 	size_t field_count;
 	const FieldMetadata *fields = eeprom_get_fields(version, &field_count);
 
+	*dirty = 0;
 	if (!fields || field_count == 0)
 	{
 		ui_print_error("No field metadata for EEPROM version %d", version);
@@ -337,28 +715,35 @@ int eeprom_edit_interactive(void *eeprom_struct, EEPROMVersion version)
 
 	while (1)
 	{
-		ui_print_eeprom(eeprom_struct, version);
+		// Board and menu go out in one write
+		EmitBuffer screen = { 0 };
+		ui_render_eeprom(&screen, eeprom_struct, version);
 
-		printf("\n" TERM_BOLD "Edit Menu:" TERM_RESET "\n");
-		printf("Select field to edit (1-%zu), or 0 to finish:\n", field_count);
+		ui_appendf(&screen, "\n%sEdit Menu:%s\n", ui_color(TERM_BOLD), ui_color(TERM_RESET));
+		ui_appendf(&screen, "Select field to edit (1-%zu), or 0 to finish:\n", field_count);
 
 		const char *current_category = NULL;
 		for (size_t i = 0; i < field_count; i++)
 		{
-			if (current_category == NULL || strcmp(current_category, fields[i].category) != 0)
+			if (fields[i].category != current_category)
 			{
-				printf("\n" TERM_BOLD TERM_CYAN "  %s:" TERM_RESET "\n", fields[i].category);
+				ui_appendf(&screen, "\n%s  %s:%s\n", ui_color(TERM_BOLD TERM_CYAN), fields[i].category,
+						   ui_color(TERM_RESET));
 				current_category = fields[i].category;
 			}
-			printf("    [%2zu] %s", i + 1, fields[i].name);
+			ui_appendf(&screen, "    [%2zu] %s", i + 1, fields[i].name);
 			if (fields[i].read_only)
 			{
-				printf(TERM_DIM " (read-only)" TERM_RESET);
+				ui_appendf(&screen, "%s (read-only)%s", ui_color(TERM_DIM), ui_color(TERM_RESET));
 			}
-			printf("\n");
+			emit_char(&screen, '\n');
 		}
 
-		printf("\n    [ 0] " TERM_BOLD TERM_GREEN "Finish editing" TERM_RESET "\n");
+		ui_appendf(&screen, "\n    [ 0] %sFinish editing%s\n", ui_color(TERM_BOLD TERM_GREEN),
+				   ui_color(TERM_RESET));
+
+		ui_flush(&screen);
+		emit_buffer_free(&screen);
 
 		printf("\nChoice: ");
 		int choice;
@@ -382,7 +767,7 @@ int eeprom_edit_interactive(void *eeprom_struct, EEPROMVersion version)
 		}
 
 		const FieldMetadata *field = &fields[choice - 1];
-		edit_field_interactive(eeprom_struct, field);
+		edit_field_interactive(eeprom_struct, version, field, dirty);
 	}
 
 	ui_print_success("Editing complete");
@@ -14,9 +14,42 @@
 #define EEPROM_ERROR_VERSION      -3
 #define EEPROM_ERROR_TEST_FAIL    -4
 
+// ═══════════════════════════════════════════════════════════════
+// Validation Results
+// ═══════════════════════════════════════════════════════════════
+typedef struct
+{
+	EEPROMVersion version;         // Version the image was decoded as
+	uint8_t region_count;          // Number of regions in the layout
+	uint8_t crc_ok;                // Bit i set: region i CRC matches
+	uint8_t test_pass;             // Bit i set: region i test result == 1
+} EEPROMCheck;
+
+#define EEPROM_CHECK_ALL(check) ((uint8_t)((1u << (check)->region_count) - 1))
 
 int eeprom_decode(uint8_t *data, size_t size, EEPROMVersion version);
+// Same as eeprom_decode() but silent; fills check with CRC/test results
+int eeprom_decode_check(uint8_t *data, size_t size, EEPROMVersion version, EEPROMCheck *check);
+// Table-driven reference decoder (layout lookup, runtime region sizes)
+int eeprom_decode_generic(uint8_t *data, size_t size, EEPROMVersion version, EEPROMCheck *check);
+// Decode a single region in place (silent); sets its crc_ok/test_pass bits.
+// Lets callers decrypt only the regions holding the fields they read.
+int eeprom_decode_region(uint8_t *data, EEPROMVersion version, int index, EEPROMCheck *check);
 int eeprom_encode(uint8_t *data, size_t size, EEPROMVersion version);
-int eeprom_edit_interactive(void *eeprom_struct, EEPROMVersion version);
+// Same as eeprom_encode() but keeps the stored CRC bytes (kept current
+// by eeprom_field_update_crc() while editing)
+int eeprom_encrypt(uint8_t *data, size_t size, EEPROMVersion version);
+// eeprom_encrypt() limited to the regions in dirty (bit i = region i, see
+// eeprom_field_regions()); the others are copied from original, the
+// encoded image data was decoded from
+int eeprom_encode_dirty(uint8_t *data, size_t size, EEPROMVersion version,
+						const uint8_t *original, uint8_t dirty);
+// Update the region CRCs of a parsed structure after one field changed;
+// old_value is the field's previous contents
+void eeprom_field_update_crc(void *eeprom, EEPROMVersion version, const FieldMetadata *field,
+							 const uint8_t *old_value);
+// Menu-driven field editor; dirty receives the regions whose fields were
+// changed (see eeprom_field_regions())
+int eeprom_edit_interactive(void *eeprom_struct, EEPROMVersion version, uint8_t *dirty);
 
 #endif // EEPROM_OPS_H
@@ -0,0 +1,208 @@
+#ifndef EEPROM_SCHEMA_H
+#define EEPROM_SCHEMA_H
+
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════════
+// EEPROM Field Schema
+// ═══════════════════════════════════════════════════════════════
+// Each layout is listed once, in physical byte order. The structures
+// (eeprom_structure.h), region tables and field metadata
+// (eeprom_defs.h), parse/serialize/validate (eeprom_structure.c) and
+// the printers (ui.c) are all expanded from these lists.
+//
+// A schema is invoked with the structure type and six entry macros:
+//   TOP(T, member, TYPE, n, name, category, min, max, unit, format, flags)
+//   TOP_PAD(T, member, TYPE, n)
+//   BEGIN(T, region, title, crc_member, crc_header, test_member, test_name)
+//   FIELD(T, region, member, TYPE, n, name, category, min, max, unit, format, flags)
+//   PAD(T, region, member, TYPE, n)
+//   END(T, region)
+// TYPE is the FieldType suffix, n the length of STRING / array types.
+// PAD entries are CRC and reserved bytes that are not displayed.
+// crc_header: the region CRC also covers the bytes from offset 0.
+
+#define SCHEMA_RO                  0x01  // Not editable
+#define SCHEMA_BE                  0x02  // 16-bit value stored big-endian
+
+// Entry macro that expands to nothing
+#define SCHEMA_NONE(...)
+
+// C type of each field type
+#define SCHEMA_CTYPE_UINT8         uint8_t
+#define SCHEMA_CTYPE_UINT16        uint16_t
+#define SCHEMA_CTYPE_INT8          int8_t
+#define SCHEMA_CTYPE_STRING        char
+#define SCHEMA_CTYPE_HEX8          uint8_t
+#define SCHEMA_CTYPE_HEX16         uint16_t
+#define SCHEMA_CTYPE_VOLTAGE       uint16_t
+#define SCHEMA_CTYPE_HASHRATE      uint16_t
+#define SCHEMA_CTYPE_ARRAY_UINT8   uint8_t
+#define SCHEMA_CTYPE_FREQ_LEVELS   uint8_t
+
+// Array dimension of each field type
+#define SCHEMA_DIM_UINT8(n)
+#define SCHEMA_DIM_UINT16(n)
+#define SCHEMA_DIM_INT8(n)
+#define SCHEMA_DIM_STRING(n)       [n]
+#define SCHEMA_DIM_HEX8(n)
+#define SCHEMA_DIM_HEX16(n)
+#define SCHEMA_DIM_VOLTAGE(n)
+#define SCHEMA_DIM_HASHRATE(n)
+#define SCHEMA_DIM_ARRAY_UINT8(n)  [n]
+#define SCHEMA_DIM_FREQ_LEVELS(n)  [n]
+
+// Display categories (compared by pointer when printing)
+static const char eeprom_category_header[] = "Header";
+static const char eeprom_category_board[] = "Board Information";
+static const char eeprom_category_test[] = "Test Parameters";
+static const char eeprom_category_sweep[] = "Sweep Data";
+static const char eeprom_category_ident[] = "Identification";
+static const char eeprom_category_hardware[] = "Hardware";
+
+// ═══════════════════════════════════════════════════════════════
+// v4/v5/v6 (Antminer S series - 256 bytes)
+// ═══════════════════════════════════════════════════════════════
+#define EEPROM_SCHEMA_V4_V6(T, TOP, TOP_PAD, BEGIN, FIELD, PAD, END) \
+	/* Header (bytes 0-1) */ \
+	TOP(T, eeprom_version, UINT8, 1, "EEPROM Version", eeprom_category_header, 4, 6, NULL, "%d", SCHEMA_RO) \
+	TOP(T, algorithm_and_key_version, HEX8, 1, "Algorithm & Key", eeprom_category_header, 0, 0xFF, NULL, "0x%02X (alg=%d, key=%d)", 0) \
+	\
+	/* Region 1: Board Information (bytes 2-97, encrypted) */ \
+	BEGIN(T, board_info, "Board Information", crc, 1, pt1_result, "PT1") \
+	FIELD(T, board_info, board_sn, STRING, 18, "Board Serial", eeprom_category_board, 0, 0, NULL, "%.18s", 0)             /* 2-19 */ \
+	FIELD(T, board_info, chip_die, STRING, 3, "Chip Die", eeprom_category_board, 0, 0, NULL, "%.3s", 0)                   /* 20-22 */ \
+	FIELD(T, board_info, chip_marking, STRING, 14, "Chip Marking", eeprom_category_board, 0, 0, NULL, "%.14s", 0)         /* 23-36 */ \
+	FIELD(T, board_info, chip_bin, UINT8, 1, "Chip Bin", eeprom_category_board, 0, 255, NULL, "%d", 0)                    /* 37 */ \
+	FIELD(T, board_info, ft_version, STRING, 10, "FT Version", eeprom_category_board, 0, 0, NULL, "%.10s", 0)             /* 38-47 */ \
+	FIELD(T, board_info, pcb_version, HEX16, 1, "PCB Version", eeprom_category_board, 0, 0xFFFF, NULL, "0x%04X", 0)       /* 48-49 */ \
+	FIELD(T, board_info, bom_version, HEX16, 1, "BOM Version", eeprom_category_board, 0, 0xFFFF, NULL, "0x%04X", 0)       /* 50-51 */ \
+	FIELD(T, board_info, asic_sensor_type, UINT8, 1, "ASIC Sensor Type", eeprom_category_board, 0, 255, NULL, "%d", 0)    /* 52 */ \
+	PAD(T, board_info, asic_sensor_addr, ARRAY_UINT8, 4)                                                                  /* 53-56 */ \
+	PAD(T, board_info, pic_sensor_type, UINT8, 1)                                                                         /* 57 */ \
+	PAD(T, board_info, pic_sensor_addr, UINT8, 1)                                                                         /* 58 */ \
+	FIELD(T, board_info, chip_tech, STRING, 3, "Chip Tech", eeprom_category_board, 0, 0, NULL, "%.3s", 0)                 /* 59-61 */ \
+	FIELD(T, board_info, board_name, STRING, 9, "Board Name", eeprom_category_board, 0, 0, NULL, "%.9s", 0)               /* 62-70 */ \
+	FIELD(T, board_info, factory_job, STRING, 24, "Factory Job", eeprom_category_board, 0, 0, NULL, "%.24s", 0)           /* 71-94 */ \
+	FIELD(T, board_info, pt1_result, UINT8, 1, "PT1 Result", eeprom_category_board, 0, 1, NULL, "%d", 0)                  /* 95 */ \
+	FIELD(T, board_info, pt1_count, UINT8, 1, "PT1 Count", eeprom_category_board, 0, 255, NULL, "%d", 0)                  /* 96 */ \
+	PAD(T, board_info, crc, UINT8, 1)                                                                                     /* 97 */ \
+	END(T, board_info) \
+	\
+	/* Region 2: Test Parameters (bytes 98-113, encrypted) */ \
+	BEGIN(T, test_params, "Test Parameters", crc, 0, pt2_result, "PT2") \
+	FIELD(T, test_params, voltage, VOLTAGE, 1, "PSU Voltage", eeprom_category_test, 1000, 1500, "V", "%.2f V", 0)          /* 98-99 */ \
+	FIELD(T, test_params, frequency, UINT16, 1, "Frequency", eeprom_category_test, 100, 1000, "MHz", "%d MHz", 0)         /* 100-101 */ \
+	FIELD(T, test_params, nonce_rate, UINT16, 1, "Nonce Rate", eeprom_category_test, 0, 65535, NULL, "%d", 0)             /* 102-103 */ \
+	FIELD(T, test_params, pcb_temp_in, INT8, 1, "PCB Temp In", eeprom_category_test, -40, 125, "°C", "%d °C", 0)          /* 104 */ \
+	FIELD(T, test_params, pcb_temp_out, INT8, 1, "PCB Temp Out", eeprom_category_test, -40, 125, "°C", "%d °C", 0)        /* 105 */ \
+	FIELD(T, test_params, test_version, UINT8, 1, "Test Version", eeprom_category_test, 0, 255, NULL, "%d", 0)            /* 106 */ \
+	FIELD(T, test_params, test_standard, UINT8, 1, "Test Standard", eeprom_category_test, 0, 255, NULL, "%d", 0)          /* 107 */ \
+	FIELD(T, test_params, pt2_result, UINT8, 1, "PT2 Result", eeprom_category_test, 0, 1, NULL, "%d", 0)                  /* 108 */ \
+	FIELD(T, test_params, pt2_count, UINT8, 1, "PT2 Count", eeprom_category_test, 0, 255, NULL, "%d", 0)                  /* 109 */ \
+	PAD(T, test_params, reserved, ARRAY_UINT8, 3)                                                                         /* 110-112 */ \
+	PAD(T, test_params, crc, UINT8, 1)                                                                                    /* 113 */ \
+	END(T, test_params) \
+	\
+	/* Region 3: Sweep Data (bytes 114-249, encrypted, v5+ only) */ \
+	BEGIN(T, sweep_data, "Sweep Data", crc, 0, sweep_result, "Sweep") \
+	FIELD(T, sweep_data, sweep_hashrate, UINT16, 1, "Sweep Hashrate", eeprom_category_sweep, 0, 65535, NULL, "%d", 0)      /* 114-115 */ \
+	FIELD(T, sweep_data, sweep_freq_base, UINT16, 1, "Sweep Freq Base", eeprom_category_sweep, 0, 2000, "MHz", "%d MHz", 0) /* 116-117 */ \
+	FIELD(T, sweep_data, sweep_freq_step, UINT8, 1, "Sweep Freq Step", eeprom_category_sweep, 0, 255, "MHz", "%d MHz", 0) /* 118 */ \
+	FIELD(T, sweep_data, sweep_level, FREQ_LEVELS, 128, "ASIC Frequencies", eeprom_category_sweep, 0, 0, NULL, NULL, SCHEMA_RO) /* 119-246 */ \
+	FIELD(T, sweep_data, sweep_result, UINT8, 1, "Sweep Result", eeprom_category_sweep, 0, 1, NULL, "%d", 0)              /* 247 */ \
+	PAD(T, sweep_data, reserved, UINT8, 1)                                                                                /* 248 */ \
+	PAD(T, sweep_data, crc, UINT8, 1)                                                                                     /* 249 */ \
+	END(T, sweep_data) \
+	\
+	TOP_PAD(T, reserved, ARRAY_UINT8, 6)                                                                                  /* 250-255 */
+
+// ═══════════════════════════════════════════════════════════════
+// v17 (Antminer L series - 82 bytes)
+// ═══════════════════════════════════════════════════════════════
+#define EEPROM_SCHEMA_V17(T, TOP, TOP_PAD, BEGIN, FIELD, PAD, END) \
+	/* Header (2 bytes, not encrypted) */ \
+	TOP(T, algorithm_and_key, HEX8, 1, "Algorithm & Key", eeprom_category_header, 0, 0xFF, NULL, "0x%02X (alg=%d, key=%d)", SCHEMA_RO) \
+	TOP(T, data_length, UINT8, 1, "Data Length", eeprom_category_header, 0, 255, "bytes", "%d bytes", SCHEMA_RO) \
+	\
+	/* Single encrypted region (bytes 2-81) */ \
+	BEGIN(T, data, "Encrypted Data", crc, 1, test_result, "Test") \
+	FIELD(T, data, subformat_version, UINT8, 1, "Subformat Version", eeprom_category_ident, 0, 255, NULL, "%d", 0)        /* 0x02 */ \
+	FIELD(T, data, serial_number, STRING, 17, "Serial Number", eeprom_category_ident, 0, 0, NULL, "%.17s", 0)             /* 0x03-0x13 */ \
+	FIELD(T, data, chip_die, STRING, 2, "Chip Die", eeprom_category_ident, 0, 0, NULL, "%.2s", 0)                         /* 0x14-0x15 */ \
+	FIELD(T, data, chip_marking, STRING, 13, "Chip Marking", eeprom_category_ident, 0, 0, NULL, "%.13s", 0)               /* 0x16-0x22 */ \
+	FIELD(T, data, chip_bin, UINT8, 1, "Chip Bin", eeprom_category_ident, 0, 255, NULL, "%d", 0)                          /* 0x23 */ \
+	FIELD(T, data, ft_program_version, STRING, 9, "FT Program Version", eeprom_category_ident, 0, 0, NULL, "%.9s", 0)     /* 0x24-0x2C */ \
+	FIELD(T, data, asic_sensor_type, UINT8, 1, "ASIC Sensor Type", eeprom_category_hardware, 0, 255, NULL, "%d", 0)       /* 0x2D */ \
+	PAD(T, data, asic_sensor_addr, ARRAY_UINT8, 4)                                                                        /* 0x2E-0x31 */ \
+	PAD(T, data, pic_sensor_type, UINT8, 1)                                                                               /* 0x32 */ \
+	PAD(T, data, pic_sensor_addr, UINT8, 1)                                                                               /* 0x33 */ \
+	FIELD(T, data, pcb_version, HEX16, 1, "PCB Version", eeprom_category_hardware, 0, 0xFFFF, NULL, "%d.%02d", 0)         /* 0x34-0x35 */ \
+	FIELD(T, data, bom_version, HEX16, 1, "BOM Version", eeprom_category_hardware, 0, 0xFFFF, NULL, "%d.%d", 0)           /* 0x36-0x37 */ \
+	FIELD(T, data, chip_technology, STRING, 2, "Chip Technology", eeprom_category_hardware, 0, 0, NULL, "%.2s", 0)        /* 0x38-0x39 */ \
+	FIELD(T, data, test_voltage, UINT16, 1, "Test Voltage", eeprom_category_test, 8000, 14000, "mV", "%d mV", SCHEMA_BE)  /* 0x3A-0x3B */ \
+	FIELD(T, data, test_frequency, UINT16, 1, "Test Frequency", eeprom_category_test, 100, 2000, "MHz", "%d MHz", SCHEMA_BE) /* 0x3C-0x3D */ \
+	FIELD(T, data, test_hashrate, HASHRATE, 1, "Test Hashrate", eeprom_category_test, 0, 10000, "GH/s", "%.2f GH/s", SCHEMA_BE) /* 0x3E-0x3F */ \
+	FIELD(T, data, pcb_temperature_in, INT8, 1, "PCB Temp In", eeprom_category_test, -40, 125, "°C", "%d °C", 0)          /* 0x40 */ \
+	FIELD(T, data, pcb_temperature_out, INT8, 1, "PCB Temp Out", eeprom_category_test, -40, 125, "°C", "%d °C", 0)        /* 0x41 */ \
+	FIELD(T, data, test_parameter, UINT8, 1, "Test Parameter", eeprom_category_test, 0, 255, NULL, "%d", 0)               /* 0x42 */ \
+	FIELD(T, data, test_result, UINT8, 1, "Test Result", eeprom_category_test, 0, 1, NULL, "%d", 0)                       /* 0x43 */ \
+	FIELD(T, data, miner_type, STRING, 8, "Miner Type", eeprom_category_test, 0, 0, NULL, "%.8s", 0)                      /* 0x44-0x4B */ \
+	PAD(T, data, reserved, ARRAY_UINT8, 5)                                                                                /* 0x4C-0x50 */ \
+	PAD(T, data, crc, UINT8, 1)                                                                                           /* 0x51 */ \
+	END(T, data)
+
+// ═══════════════════════════════════════════════════════════════
+// v1 (Antminer S21+ - 256 bytes)
+// ═══════════════════════════════════════════════════════════════
+#define EEPROM_SCHEMA_V1(T, TOP, TOP_PAD, BEGIN, FIELD, PAD, END) \
+	/* Header (16 bytes, NOT encrypted) */ \
+	TOP(T, eeprom_version, UINT8, 1, "EEPROM Version", eeprom_category_header, 1, 1, NULL, "%d", SCHEMA_RO) \
+	TOP(T, board_name, STRING, 15, "Board Name", eeprom_category_header, 0, 0, NULL, "%.15s", 0) \
+	\
+	/* PT1: Board Information (80 bytes, encrypted) */ \
+	BEGIN(T, pt1_data, "PT1 (Board Info)", crc, 0, pt1_result, "PT1") \
+	FIELD(T, pt1_data, board_serial, STRING, 18, "Board Serial", eeprom_category_board, 0, 0, NULL, "%.18s", 0)           /* 0-17 */ \
+	FIELD(T, pt1_data, factory_job, STRING, 24, "Factory Job", eeprom_category_board, 0, 0, NULL, "%.24s", 0)             /* 18-41 */ \
+	FIELD(T, pt1_data, chip_die, STRING, 3, "Chip Die", eeprom_category_board, 0, 0, NULL, "%.3s", 0)                     /* 42-44 */ \
+	FIELD(T, pt1_data, chip_marking, STRING, 14, "Chip Marking", eeprom_category_board, 0, 0, NULL, "%.14s", 0)           /* 45-58 */ \
+	FIELD(T, pt1_data, ft_version, STRING, 10, "FT Version", eeprom_category_board, 0, 0, NULL, "%.10s", 0)               /* 59-68 */ \
+	FIELD(T, pt1_data, chip_tech, STRING, 3, "Chip Tech", eeprom_category_board, 0, 0, NULL, "%.3s", 0)                   /* 69-71 */ \
+	FIELD(T, pt1_data, chip_bin, UINT8, 1, "Chip Bin", eeprom_category_board, 0, 255, NULL, "%d", 0)                      /* 72 */ \
+	FIELD(T, pt1_data, pcb_version, HEX16, 1, "PCB Version", eeprom_category_board, 0, 0xFFFF, NULL, "0x%04X", 0)         /* 73-74 */ \
+	FIELD(T, pt1_data, bom_version, UINT8, 1, "BOM Version", eeprom_category_board, 0, 255, NULL, "%d", 0)                /* 75 */ \
+	FIELD(T, pt1_data, asic_sensor_type, UINT8, 1, "ASIC Sensor Type", eeprom_category_board, 0, 255, NULL, "%d", 0)      /* 76 */ \
+	FIELD(T, pt1_data, pt1_result, UINT8, 1, "PT1 Result", eeprom_category_board, 0, 1, NULL, "%d", 0)                    /* 77 */ \
+	FIELD(T, pt1_data, pt1_count, UINT8, 1, "PT1 Count", eeprom_category_board, 0, 255, NULL, "%d", 0)                    /* 78 */ \
+	PAD(T, pt1_data, crc, UINT8, 1)                                                                                       /* 79 */ \
+	END(T, pt1_data) \
+	\
+	/* PT2: Test Parameters (16 bytes, encrypted) */ \
+	BEGIN(T, pt2_data, "PT2 (Test Params)", crc, 0, pt2_result, "PT2") \
+	FIELD(T, pt2_data, voltage, VOLTAGE, 1, "PSU Voltage", eeprom_category_test, 1000, 1500, "V", "%.2f V", 0)             /* 0-1 */ \
+	FIELD(T, pt2_data, frequency, UINT16, 1, "Frequency", eeprom_category_test, 100, 1000, "MHz", "%d MHz", 0)            /* 2-3 */ \
+	FIELD(T, pt2_data, nonce_rate, UINT16, 1, "Nonce Rate", eeprom_category_test, 0, 65535, NULL, "%.2f", 0)              /* 4-5 */ \
+	FIELD(T, pt2_data, done_type, UINT8, 1, "Done Type", eeprom_category_test, 0, 255, NULL, "%d", 0)                     /* 6 */ \
+	FIELD(T, pt2_data, temp_in, INT8, 1, "PCB Temp In", eeprom_category_test, -40, 125, "°C", "%d °C", 0)                 /* 7 */ \
+	FIELD(T, pt2_data, temp_out, INT8, 1, "PCB Temp Out", eeprom_category_test, -40, 125, "°C", "%d °C", 0)               /* 8 */ \
+	PAD(T, pt2_data, reserved1, ARRAY_UINT8, 2)                                                                           /* 9-10 */ \
+	FIELD(T, pt2_data, pt2_result, UINT8, 1, "PT2 Result", eeprom_category_test, 0, 1, NULL, "%d", 0)                     /* 11 */ \
+	FIELD(T, pt2_data, pt2_count, UINT8, 1, "PT2 Count", eeprom_category_test, 0, 255, NULL, "%d", 0)                     /* 12 */ \
+	PAD(T, pt2_data, reserved2, ARRAY_UINT8, 2)                                                                           /* 13-14 */ \
+	PAD(T, pt2_data, crc, UINT8, 1)                                                                                       /* 15 */ \
+	END(T, pt2_data) \
+	\
+	/* SWEEP: Frequency Optimization (144 bytes, encrypted) */ \
+	BEGIN(T, sweep_data, "SWEEP (Freq Optimization)", sweep_crc, 0, sweep_result, "Sweep") \
+	FIELD(T, sweep_data, voltage, VOLTAGE, 1, "SWEEP Voltage", eeprom_category_sweep, 1000, 1500, "V", "%.2f V", 0)        /* 0-1 */ \
+	FIELD(T, sweep_data, sweep_hashrate, HASHRATE, 1, "Sweep Hashrate", eeprom_category_sweep, 0, 65535, "TH/s", "%.2f TH/s", 0) /* 2-3 */ \
+	FIELD(T, sweep_data, sweep_freq_base, UINT16, 1, "Sweep Freq Base", eeprom_category_sweep, 0, 2000, "MHz", "%d MHz", 0) /* 4-5 */ \
+	FIELD(T, sweep_data, sweep_freq_step, UINT8, 1, "Sweep Freq Step", eeprom_category_sweep, 0, 255, "MHz", "%d MHz", 0) /* 6 */ \
+	FIELD(T, sweep_data, sweep_level, FREQ_LEVELS, 128, "ASIC Frequencies", eeprom_category_sweep, 0, 0, NULL, NULL, SCHEMA_RO) /* 7-134 */ \
+	FIELD(T, sweep_data, sweep_result, UINT8, 1, "Sweep Result", eeprom_category_sweep, 0, 1, NULL, "%d", 0)              /* 135 */ \
+	FIELD(T, sweep_data, sweep_count, UINT8, 1, "Sweep Count", eeprom_category_sweep, 0, 255, NULL, "%d", 0)              /* 136 */ \
+	PAD(T, sweep_data, placeholder, ARRAY_UINT8, 6)                                                                       /* 137-142 */ \
+	PAD(T, sweep_data, sweep_crc, UINT8, 1)                                                                               /* 143 */ \
+	END(T, sweep_data)
+
+#endif // EEPROM_SCHEMA_H
@@ -2,81 +2,115 @@
 #include "eeprom_defs.h"
 #include <string.h>
 #include <stdio.h>
-//#include <arpa/inet.h>
-#if !defined(__BYTE_ORDER__) || (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
-static inline uint16_t htons(uint16_t x){
-	return __builtin_bswap16(x);
-}
-static inline uint16_t ntohs(uint16_t x){
-	return __builtin_bswap16(x);
-}
-#else
-static inline uint16_t htons (uint16_t a){
-	return (a);// BE
-}
-static inline uint16_t ntohs (uint16_t a){
-	return (a);// BE
-}
-#endif
+
 // ═══════════════════════════════════════════════════════════════
-// EEPROM v4/v5/v6 (S series)
+// Generated codec
 // ═══════════════════════════════════════════════════════════════
+// Parse and serialize copy the packed structure and then fix up the
+// big-endian fields; validate checks every numeric field against its
+// schema range. All offsets and ranges are compile-time constants.
 
-void eeprom_to_bytes(const EEPROMStructure *eeprom, uint8_t *data)
-{
-	memcpy(data, eeprom, EEPROM_SIZE);
-}
+#define CODEC_LOAD(T, path, flags) \
+	if (((flags) & SCHEMA_BE) && sizeof(((T*)0)->path) == 2) \
+	{ \
+		uint16_t value = (uint16_t)(data[offsetof(T, path)] << 8 | data[offsetof(T, path) + 1]); \
+		memcpy(&eeprom->path, &value, 2); \
+	}
 
-void eeprom_from_bytes(EEPROMStructure *eeprom, const uint8_t *data)
-{
-	memcpy(eeprom, data, EEPROM_SIZE);
-}
+#define CODEC_STORE(T, path, flags) \
+	if (((flags) & SCHEMA_BE) && sizeof(((T*)0)->path) == 2) \
+	{ \
+		uint16_t value; \
+		memcpy(&value, &eeprom->path, 2); \
+		data[offsetof(T, path)] = (uint8_t)(value >> 8); \
+		data[offsetof(T, path) + 1] = (uint8_t)value; \
+	}
 
-// ═══════════════════════════════════════════════════════════════
-// EEPROM v17 (L series)
-// ═══════════════════════════════════════════════════════════════
+#define CODEC_LOAD_TOP(T, member, type, n, name, cat, lo, hi, unit, fmt, flags)           CODEC_LOAD(T, member, flags)
+#define CODEC_LOAD_FIELD(T, region, member, type, n, name, cat, lo, hi, unit, fmt, flags) CODEC_LOAD(T, region.member, flags)
+#define CODEC_STORE_TOP(T, member, type, n, name, cat, lo, hi, unit, fmt, flags)          CODEC_STORE(T, member, flags)
+#define CODEC_STORE_FIELD(T, region, member, type, n, name, cat, lo, hi, unit, fmt, flags) CODEC_STORE(T, region.member, flags)
 
-void eeprom_v17_parse(EEPROMStructure_v17 *eeprom, const uint8_t *data)
-{
-	eeprom->algorithm_and_key = data[0];
-	eeprom->data_length = data[1];
+// Range check for numeric field types, nothing for strings and arrays
+#define CODEC_RANGE(value, name, lo, hi) \
+	if ((int32_t)(value) < (lo) || (int32_t)(value) > (hi)) \
+	{ \
+		if (cb) \
+		{ \
+			cb(name, (int32_t)(value), lo, hi, ctx); \
+		} \
+		errors++; \
+	}
+#define CODEC_RANGE_UINT8          CODEC_RANGE
+#define CODEC_RANGE_UINT16         CODEC_RANGE
+#define CODEC_RANGE_INT8           CODEC_RANGE
+#define CODEC_RANGE_HEX8           CODEC_RANGE
+#define CODEC_RANGE_HEX16          CODEC_RANGE
+#define CODEC_RANGE_VOLTAGE        CODEC_RANGE
+#define CODEC_RANGE_HASHRATE       CODEC_RANGE
+#define CODEC_RANGE_STRING(...)
+#define CODEC_RANGE_ARRAY_UINT8(...)
+#define CODEC_RANGE_FREQ_LEVELS(...)
 
-	memcpy(&eeprom->data,
-		   data + EEPROM_V17_HEADER_SIZE,
-		   EEPROM_V17_DATA_SIZE);
+#define CODEC_CHECK_TOP(T, member, type, n, name, cat, lo, hi, unit, fmt, flags) \
+	CODEC_RANGE_##type(eeprom->member, name, lo, hi)
+#define CODEC_CHECK_FIELD(T, region, member, type, n, name, cat, lo, hi, unit, fmt, flags) \
+	CODEC_RANGE_##type(eeprom->region.member, name, lo, hi)
 
-	eeprom->data.test_voltage = ntohs(eeprom->data.test_voltage);
-	eeprom->data.test_frequency = ntohs(eeprom->data.test_frequency);
-	eeprom->data.test_hashrate = ntohs(eeprom->data.test_hashrate);
-}
+#define CODEC_DEFINE(schema, T, parse, serialize, validate) \
+	void parse(T *eeprom, const uint8_t *data) \
+	{ \
+		memcpy(eeprom, data, sizeof(T)); \
+		schema(T, CODEC_LOAD_TOP, SCHEMA_NONE, SCHEMA_NONE, CODEC_LOAD_FIELD, SCHEMA_NONE, SCHEMA_NONE) \
+	} \
+	\
+	void serialize(const T *eeprom, uint8_t *data) \
+	{ \
+		memcpy(data, eeprom, sizeof(T)); \
+		schema(T, CODEC_STORE_TOP, SCHEMA_NONE, SCHEMA_NONE, CODEC_STORE_FIELD, SCHEMA_NONE, SCHEMA_NONE) \
+	} \
+	\
+	int validate(const T *eeprom, eeprom_range_cb cb, void *ctx) \
+	{ \
+		int errors = 0; \
+		schema(T, CODEC_CHECK_TOP, SCHEMA_NONE, SCHEMA_NONE, CODEC_CHECK_FIELD, SCHEMA_NONE, SCHEMA_NONE) \
+		return errors; \
+	}
 
-void eeprom_v17_serialize(const EEPROMStructure_v17 *eeprom, uint8_t *data)
-{
-	EEPROMStructure_v17 temp;
-	memcpy(&temp, eeprom, sizeof(EEPROMStructure_v17));
+// ═══════════════════════════════════════════════════════════════
+// EEPROM v4/v5/v6 (S series)
+// ═══════════════════════════════════════════════════════════════
+
+_Static_assert(sizeof(EEPROMStructure) == EEPROM_SIZE, "v4-v6 layout must fill the EEPROM");
+_Static_assert(offsetof(EEPROMStructure, board_info) == EEPROM_V4_REGION1_START, "v4 region 1 start");
+_Static_assert(offsetof(EEPROMStructure, board_info.crc) == EEPROM_V4_REGION1_CRC_POS, "v4 region 1 CRC");
+_Static_assert(offsetof(EEPROMStructure, test_params) == EEPROM_V4_REGION2_START, "v4 region 2 start");
+_Static_assert(offsetof(EEPROMStructure, test_params.crc) == EEPROM_V4_REGION2_CRC_POS, "v4 region 2 CRC");
+_Static_assert(offsetof(EEPROMStructure, sweep_data) == EEPROM_V5_REGION3_START, "v5 region 3 start");
+_Static_assert(offsetof(EEPROMStructure, sweep_data.crc) == EEPROM_V5_REGION3_CRC_POS, "v5 region 3 CRC");
+
+CODEC_DEFINE(EEPROM_SCHEMA_V4_V6, EEPROMStructure, eeprom_from_bytes, eeprom_to_bytes, eeprom_validate)
 
-	temp.data.test_voltage = htons(temp.data.test_voltage);
-	temp.data.test_frequency = htons(temp.data.test_frequency);
-	temp.data.test_hashrate = htons(temp.data.test_hashrate);
+// ═══════════════════════════════════════════════════════════════
+// EEPROM v17 (L series)
+// ═══════════════════════════════════════════════════════════════
 
-	data[0] = temp.algorithm_and_key;
-	data[1] = temp.data_length;
+_Static_assert(sizeof(EEPROMStructure_v17) == EEPROM_USED_SIZE_V17, "v17 layout size");
+_Static_assert(offsetof(EEPROMStructure_v17, data) == EEPROM_V17_HEADER_SIZE, "v17 data start");
+_Static_assert(offsetof(EEPROMStructure_v17, data.crc) == EEPROM_V17_CRC_POS, "v17 CRC");
 
-	memcpy(data + EEPROM_V17_HEADER_SIZE,
-		   &temp.data,
-		   EEPROM_V17_DATA_SIZE);
-}
+CODEC_DEFINE(EEPROM_SCHEMA_V17, EEPROMStructure_v17, eeprom_v17_parse, eeprom_v17_serialize, eeprom_v17_validate)
 
 // ═══════════════════════════════════════════════════════════════
 // EEPROM v1 (S21+ series)
 // ═══════════════════════════════════════════════════════════════
 
-void eeprom_v1_parse(EEPROMStructure_v1 *eeprom, const uint8_t *data)
-{
-	memcpy(eeprom, data, sizeof(EEPROMStructure_v1));
-}
+_Static_assert(sizeof(EEPROMStructure_v1) == EEPROM_V1_USED_SIZE, "v1 layout size");
+_Static_assert(offsetof(EEPROMStructure_v1, pt1_data) == EEPROM_V1_PT1_START, "v1 PT1 start");
+_Static_assert(offsetof(EEPROMStructure_v1, pt1_data.crc) == EEPROM_V1_PT1_CRC_POS, "v1 PT1 CRC");
+_Static_assert(offsetof(EEPROMStructure_v1, pt2_data) == EEPROM_V1_PT2_START, "v1 PT2 start");
+_Static_assert(offsetof(EEPROMStructure_v1, pt2_data.crc) == EEPROM_V1_PT2_CRC_POS, "v1 PT2 CRC");
+_Static_assert(offsetof(EEPROMStructure_v1, sweep_data) == EEPROM_V1_SWEEP_START, "v1 SWEEP start");
+_Static_assert(offsetof(EEPROMStructure_v1, sweep_data.sweep_crc) == EEPROM_V1_SWEEP_CRC_POS, "v1 SWEEP CRC");
 
-void eeprom_v1_serialize(const EEPROMStructure_v1 *eeprom, uint8_t *data)
-{
-	memcpy(data, eeprom, sizeof(EEPROMStructure_v1));
-}
+CODEC_DEFINE(EEPROM_SCHEMA_V1, EEPROMStructure_v1, eeprom_v1_parse, eeprom_v1_serialize, eeprom_v1_validate)
@@ -0,0 +1,701 @@
+#include "emit.h"
+#include "batch.h"
+#include "sweep.h"
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <unistd.h>
+
+#define EMIT_FLUSH_SIZE  (256 * 1024)
+#define EMIT_MAX_COLUMNS 160
+
+// ═══════════════════════════════════════════════════════════════
+// Buffer and Formatters
+// ═══════════════════════════════════════════════════════════════
+
+int emit_format_parse(const char *name)
+{
+	static const char *names[] = { "ndjson", "json", "csv", "tsv" };
+	for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+	{
+		if (strcasecmp(name, names[i]) == 0)
+		{
+			return (int)i;
+		}
+	}
+	return -1;
+}
+
+void emit_buffer_free(EmitBuffer *buf)
+{
+	free(buf->data);
+	buf->data = NULL;
+	buf->len = buf->capacity = 0;
+}
+
+static void emit_reserve(EmitBuffer *buf, size_t n)
+{
+	if (buf->len + n <= buf->capacity)
+	{
+		return;
+	}
+	size_t capacity = buf->capacity ? buf->capacity : 4096;
+	while (capacity < buf->len + n)
+	{
+		capacity *= 2;
+	}
+	char *data = realloc(buf->data, capacity);
+	if (!data)
+	{
+		fprintf(stderr, "Error: Out of memory\n");
+		exit(1);
+	}
+	buf->data = data;
+	buf->capacity = capacity;
+}
+
+void emit_put(EmitBuffer *buf, const char *s, size_t n)
+{
+	emit_reserve(buf, n);
+	memcpy(buf->data + buf->len, s, n);
+	buf->len += n;
+}
+
+void emit_str(EmitBuffer *buf, const char *s)
+{
+	emit_put(buf, s, strlen(s));
+}
+
+void emit_char(EmitBuffer *buf, char c)
+{
+	emit_reserve(buf, 1);
+	buf->data[buf->len++] = c;
+}
+
+void emit_uint(EmitBuffer *buf, uint32_t value)
+{
+	char digits[10];
+	int n = 0;
+	do
+	{
+		digits[n++] = (char)('0' + value % 10);
+		value /= 10;
+	} while (value);
+
+	emit_reserve(buf, (size_t)n);
+	while (n)
+	{
+		buf->data[buf->len++] = digits[--n];
+	}
+}
+
+void emit_int(EmitBuffer *buf, int32_t value)
+{
+	if (value < 0)
+	{
+		emit_char(buf, '-');
+		emit_uint(buf, (uint32_t)0 - (uint32_t)value);
+	}
+	else
+	{
+		emit_uint(buf, (uint32_t)value);
+	}
+}
+
+void emit_fixed2(EmitBuffer *buf, int32_t hundredths)
+{
+	uint32_t v = (uint32_t)hundredths;
+	if (hundredths < 0)
+	{
+		emit_char(buf, '-');
+		v = (uint32_t)0 - v;
+	}
+	emit_uint(buf, v / 100);
+	char frac[3] = { '.', (char)('0' + v % 100 / 10), (char)('0' + v % 10) };
+	emit_put(buf, frac, sizeof(frac));
+}
+
+void emit_hex(EmitBuffer *buf, uint32_t value, int digits)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	emit_reserve(buf, (size_t)digits + 2);
+	buf->data[buf->len++] = '0';
+	buf->data[buf->len++] = 'x';
+	for (int i = digits - 1; i >= 0; i--)
+	{
+		buf->data[buf->len++] = hex[(value >> (4 * i)) & 0xF];
+	}
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Columns
+// ═══════════════════════════════════════════════════════════════
+// One column per structure path across all layouts, so CSV/TSV rows of
+// mixed versions share a header. Tables: v4/v5/v6, v17, v1.
+
+typedef struct
+{
+	const char *path;
+	const FieldMetadata *field[3];
+	const FieldMetadata *freq_base[3];   // FREQ_LEVELS: same-region base/step
+	const FieldMetadata *freq_step[3];
+} EmitColumn;
+
+static EmitColumn columns[EMIT_MAX_COLUMNS];
+static size_t column_count;
+static pthread_once_t columns_once = PTHREAD_ONCE_INIT;
+
+static const EEPROMVersion table_versions[3] = { EEPROM_VERSION_V4, EEPROM_VERSION_V17, EEPROM_VERSION_V1 };
+
+static int table_of(EEPROMVersion version)
+{
+	switch (version)
+	{
+		case EEPROM_VERSION_V4:
+		case EEPROM_VERSION_V5:
+		case EEPROM_VERSION_V6:
+			return 0;
+		case EEPROM_VERSION_V17:
+			return 1;
+		case EEPROM_VERSION_V1:
+			return 2;
+		default:
+			return -1;
+	}
+}
+
+// Field named member in the same region as field (path "region.member")
+static const FieldMetadata *sibling(const FieldMetadata *fields, size_t count,
+									const FieldMetadata *field, const char *member)
+{
+	const char *dot = strrchr(field->path, '.');
+	size_t prefix = dot ? (size_t)(dot - field->path) + 1 : 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (strncmp(fields[i].path, field->path, prefix) == 0 && strcmp(fields[i].path + prefix, member) == 0)
+		{
+			return &fields[i];
+		}
+	}
+	return NULL;
+}
+
+static void build_columns(void)
+{
+	for (int t = 0; t < 3; t++)
+	{
+		size_t count;
+		const FieldMetadata *fields = eeprom_get_fields(table_versions[t], &count);
+
+		for (size_t i = 0; i < count; i++)
+		{
+			size_t c = 0;
+			while (c < column_count && strcmp(columns[c].path, fields[i].path) != 0)
+			{
+				c++;
+			}
+			if (c == column_count)
+			{
+				if (column_count == EMIT_MAX_COLUMNS)
+				{
+					continue;
+				}
+				columns[column_count++].path = fields[i].path;
+			}
+
+			columns[c].field[t] = &fields[i];
+			if (fields[i].type == FIELD_TYPE_FREQ_LEVELS)
+			{
+				columns[c].freq_base[t] = sibling(fields, count, &fields[i], "sweep_freq_base");
+				columns[c].freq_step[t] = sibling(fields, count, &fields[i], "sweep_freq_step");
+			}
+		}
+	}
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Records
+// ═══════════════════════════════════════════════════════════════
+
+static uint32_t field_u16(const uint8_t *p, const FieldMetadata *field)
+{
+	return field->big_endian ? (uint32_t)(p[0] << 8 | p[1]) : (uint32_t)(p[0] | p[1] << 8);
+}
+
+static void emit_json_string(EmitBuffer *buf, const char *s, size_t n)
+{
+	static const char hex[] = "0123456789abcdef";
+	emit_char(buf, '"');
+	for (size_t i = 0; i < n; i++)
+	{
+		unsigned char c = (unsigned char)s[i];
+		if (c == '"' || c == '\\')
+		{
+			char esc[2] = { '\\', (char)c };
+			emit_put(buf, esc, 2);
+		}
+		else if (c < 0x20 || c >= 0x7F)
+		{
+			char esc[6] = { '\\', 'u', '0', '0', hex[c >> 4], hex[c & 0xF] };
+			emit_put(buf, esc, 6);
+		}
+		else
+		{
+			emit_char(buf, (char)c);
+		}
+	}
+	emit_char(buf, '"');
+}
+
+static void emit_cell_string(EmitBuffer *buf, EmitFormat format, const char *s, size_t n)
+{
+	int quote = 0;
+	if (format == EMIT_CSV)
+	{
+		for (size_t i = 0; i < n && !quote; i++)
+		{
+			quote = s[i] == ',' || s[i] == '"' || s[i] == '\n' || s[i] == '\r';
+		}
+	}
+
+	if (quote)
+	{
+		emit_char(buf, '"');
+	}
+	for (size_t i = 0; i < n; i++)
+	{
+		unsigned char c = (unsigned char)s[i];
+		if (quote && c == '"')
+		{
+			emit_put(buf, "\"\"", 2);
+		}
+		else if (c < 0x20 || c >= 0x7F)
+		{
+			emit_char(buf, format == EMIT_TSV && (c == '\t' || c == '\n') ? ' ' : '?');
+		}
+		else
+		{
+			emit_char(buf, (char)c);
+		}
+	}
+	if (quote)
+	{
+		emit_char(buf, '"');
+	}
+}
+
+static void emit_value(EmitBuffer *buf, EmitFormat format, const uint8_t *decoded,
+					   const EmitColumn *column, int t)
+{
+	const FieldMetadata *field = column->field[t];
+	const uint8_t *p = decoded + field->offset;
+	int json = format == EMIT_JSON || format == EMIT_NDJSON;
+
+	switch (field->type)
+	{
+		case FIELD_TYPE_UINT8:
+			emit_uint(buf, p[0]);
+			break;
+		case FIELD_TYPE_INT8:
+			emit_int(buf, (int8_t)p[0]);
+			break;
+		case FIELD_TYPE_UINT16:
+			emit_uint(buf, field_u16(p, field));
+			break;
+		case FIELD_TYPE_HEX8:
+		case FIELD_TYPE_HEX16:
+			if (json)
+			{
+				emit_char(buf, '"');
+			}
+			emit_hex(buf, field->size == 2 ? field_u16(p, field) : p[0], (int)field->size * 2);
+			if (json)
+			{
+				emit_char(buf, '"');
+			}
+			break;
+		case FIELD_TYPE_VOLTAGE:
+		case FIELD_TYPE_HASHRATE:
+			emit_fixed2(buf, (int32_t)field_u16(p, field));
+			break;
+		case FIELD_TYPE_STRING:
+		{
+			size_t n = 0;
+			while (n < field->size && p[n] && p[n] != 0xFF)
+			{
+				n++;
+			}
+			if (json)
+			{
+				emit_json_string(buf, (const char*)p, n);
+			}
+			else
+			{
+				emit_cell_string(buf, format, (const char*)p, n);
+			}
+			break;
+		}
+		case FIELD_TYPE_ARRAY_UINT8:
+		case FIELD_TYPE_FREQ_LEVELS:
+		{
+			uint16_t values[SWEEP_MAX_ASICS];
+			size_t n = field->size;
+			if (field->type == FIELD_TYPE_FREQ_LEVELS && column->freq_base[t] && column->freq_step[t])
+			{
+				n = n > SWEEP_LEVEL_BYTES ? SWEEP_LEVEL_BYTES : n;
+				sweep_expand(p, n, (uint16_t)field_u16(decoded + column->freq_base[t]->offset, column->freq_base[t]),
+							 decoded[column->freq_step[t]->offset], values);
+				n *= 2;
+			}
+			else
+			{
+				for (size_t i = 0; i < n && i < SWEEP_MAX_ASICS; i++)
+				{
+					values[i] = p[i];
+				}
+			}
+
+			// JSON array, or one space-separated cell
+			if (json)
+			{
+				emit_char(buf, '[');
+			}
+			for (size_t i = 0; i < n; i++)
+			{
+				if (i)
+				{
+					emit_char(buf, json ? ',' : ' ');
+				}
+				emit_uint(buf, values[i]);
+			}
+			if (json)
+			{
+				emit_char(buf, ']');
+			}
+			break;
+		}
+		default:
+			if (json)
+			{
+				emit_str(buf, "null");
+			}
+			break;
+	}
+}
+
+void emit_record(EmitBuffer *buf, EmitFormat format, const char *name, const uint8_t *decoded,
+				 const EEPROMCheck *check)
+{
+	pthread_once(&columns_once, build_columns);
+
+	int t = table_of(check->version);
+	const EEPROMLayout *layout = eeprom_get_layout(check->version);
+	int crc_ok = check->crc_ok == EEPROM_CHECK_ALL(check);
+	int test_pass = check->test_pass == EEPROM_CHECK_ALL(check);
+
+	if (format == EMIT_JSON || format == EMIT_NDJSON)
+	{
+		if (format == EMIT_JSON && buf->records)
+		{
+			emit_put(buf, ",\n", 2);
+		}
+		emit_str(buf, "{\"name\":");
+		emit_json_string(buf, name, strlen(name));
+		emit_str(buf, ",\"version\":");
+		emit_int(buf, check->version);
+		emit_str(buf, crc_ok ? ",\"crc_ok\":true" : ",\"crc_ok\":false");
+		emit_str(buf, test_pass ? ",\"test_pass\":true" : ",\"test_pass\":false");
+
+		for (size_t c = 0; t >= 0 && c < column_count; c++)
+		{
+			const FieldMetadata *field = columns[c].field[t];
+			if (!field || !eeprom_field_in_layout(field, layout))
+			{
+				continue;
+			}
+			emit_str(buf, ",\"");
+			emit_str(buf, columns[c].path);
+			emit_str(buf, "\":");
+			emit_value(buf, format, decoded, &columns[c], t);
+		}
+		emit_char(buf, '}');
+		if (format == EMIT_NDJSON)
+		{
+			emit_char(buf, '\n');
+		}
+	}
+	else
+	{
+		char sep = format == EMIT_CSV ? ',' : '\t';
+		emit_cell_string(buf, format, name, strlen(name));
+		emit_char(buf, sep);
+		emit_int(buf, check->version);
+		emit_char(buf, sep);
+		emit_char(buf, crc_ok ? '1' : '0');
+		emit_char(buf, sep);
+		emit_char(buf, test_pass ? '1' : '0');
+
+		for (size_t c = 0; c < column_count; c++)
+		{
+			emit_char(buf, sep);
+			const FieldMetadata *field = t >= 0 ? columns[c].field[t] : NULL;
+			if (field && eeprom_field_in_layout(field, layout))
+			{
+				emit_value(buf, format, decoded, &columns[c], t);
+			}
+		}
+		emit_char(buf, '\n');
+	}
+	buf->records++;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Writer
+// ═══════════════════════════════════════════════════════════════
+
+static int write_all(int fd, const char *data, size_t len)
+{
+	while (len)
+	{
+		ssize_t n = write(fd, data, len);
+		if (n <= 0)
+		{
+			return -1;
+		}
+		data += n;
+		len -= (size_t)n;
+	}
+	return 0;
+}
+
+static void emit_flush(EmitBuffer *buf)
+{
+	EmitWriter *writer = buf->writer;
+	if (!buf->len)
+	{
+		return;
+	}
+
+	pthread_mutex_lock(&writer->lock);
+	// JSON: records inside one buffer are already comma-separated
+	if (writer->format == EMIT_JSON && writer->records && write_all(writer->fd, ",\n", 2) != 0)
+	{
+		writer->error = 1;
+	}
+	if (write_all(writer->fd, buf->data, buf->len) != 0)
+	{
+		writer->error = 1;
+	}
+	writer->records += buf->records;
+	pthread_mutex_unlock(&writer->lock);
+
+	buf->len = 0;
+	buf->records = 0;
+}
+
+static void buffer_destroy(void *arg)
+{
+	EmitBuffer *buf = (EmitBuffer*)arg;
+	emit_flush(buf);
+	emit_buffer_free(buf);
+	free(buf);
+}
+
+int emit_writer_open(EmitWriter *writer, int fd, EmitFormat format)
+{
+	memset(writer, 0, sizeof(*writer));
+	writer->fd = fd;
+	writer->format = format;
+	writer->flush_size = EMIT_FLUSH_SIZE;
+	if (pthread_key_create(&writer->key, buffer_destroy) != 0)
+	{
+		return -1;
+	}
+	pthread_mutex_init(&writer->lock, NULL);
+	pthread_once(&columns_once, build_columns);
+
+	EmitBuffer head = { 0 };
+	if (format == EMIT_JSON)
+	{
+		emit_str(&head, "[\n");
+	}
+	else if (format == EMIT_CSV || format == EMIT_TSV)
+	{
+		char sep = format == EMIT_CSV ? ',' : '\t';
+		emit_str(&head, "name");
+		emit_char(&head, sep);
+		emit_str(&head, "version");
+		emit_char(&head, sep);
+		emit_str(&head, "crc_ok");
+		emit_char(&head, sep);
+		emit_str(&head, "test_pass");
+		for (size_t c = 0; c < column_count; c++)
+		{
+			emit_char(&head, sep);
+			emit_str(&head, columns[c].path);
+		}
+		emit_char(&head, '\n');
+	}
+	if (head.len && write_all(fd, head.data, head.len) != 0)
+	{
+		writer->error = 1;
+	}
+	emit_buffer_free(&head);
+	return 0;
+}
+
+EmitBuffer *emit_writer_buffer(EmitWriter *writer)
+{
+	EmitBuffer *buf = pthread_getspecific(writer->key);
+	if (!buf)
+	{
+		buf = calloc(1, sizeof(*buf));
+		if (!buf)
+		{
+			fprintf(stderr, "Error: Out of memory\n");
+			exit(1);
+		}
+		buf->writer = writer;
+		emit_reserve(buf, writer->flush_size + 4096);
+		pthread_setspecific(writer->key, buf);
+	}
+	return buf;
+}
+
+void emit_writer_commit(EmitBuffer *buf)
+{
+	if (buf->len >= buf->writer->flush_size)
+	{
+		emit_flush(buf);
+	}
+}
+
+int emit_writer_close(EmitWriter *writer)
+{
+	EmitBuffer *buf = pthread_getspecific(writer->key);
+	if (buf)
+	{
+		pthread_setspecific(writer->key, NULL);
+		buffer_destroy(buf);
+	}
+	pthread_key_delete(writer->key);
+
+	if (writer->format == EMIT_JSON && write_all(writer->fd, "\n]\n", 3) != 0)
+	{
+		writer->error = 1;
+	}
+	pthread_mutex_destroy(&writer->lock);
+	return writer->error ? -1 : 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	EmitWriter writer;
+	pthread_mutex_t lock;
+	size_t exported;
+	size_t unknown;
+} ExportRun;
+
+static int export_image(const char *name, const uint8_t *raw, size_t size, void *ctx)
+{
+	ExportRun *run = (ExportRun*)ctx;
+	uint8_t data[EEPROM_SIZE];
+	memset(data, 0xFF, sizeof(data));
+	memcpy(data, raw, size);
+
+	EEPROMCheck check;
+	int known = batch_decode(data, &check) == EEPROM_SUCCESS;
+	if (known)
+	{
+		EmitBuffer *buf = emit_writer_buffer(&run->writer);
+		emit_record(buf, run->writer.format, name, data, &check);
+		emit_writer_commit(buf);
+	}
+
+	pthread_mutex_lock(&run->lock);
+	run->exported += known;
+	run->unknown += !known;
+	pthread_mutex_unlock(&run->lock);
+	return 0;
+}
+
+int cmd_export(int argc, char **argv)
+{
+	ExportRun run;
+	memset(&run, 0, sizeof(run));
+	EmitFormat format = EMIT_NDJSON;
+	const char *out_path = NULL;
+	char *paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+		{
+			int parsed = emit_format_parse(argv[++i]);
+			if (parsed < 0)
+			{
+				fprintf(stderr, "Error: Unknown format '%s' (ndjson, json, csv, tsv)\n", argv[i]);
+				return 1;
+			}
+			format = (EmitFormat)parsed;
+		}
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			out_path = argv[++i];
+		}
+		else
+		{
+			paths[path_count++] = argv[i];
+		}
+	}
+
+	if (path_count == 0)
+	{
+		fprintf(stderr, "Usage: eeprom_tool export [-f ndjson|json|csv|tsv] [-o FILE] PATH...\n");
+		return 1;
+	}
+
+	int fd = STDOUT_FILENO;
+	if (out_path)
+	{
+		fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+		if (fd < 0)
+		{
+			fprintf(stderr, "Error: Cannot create %s\n", out_path);
+			return 1;
+		}
+	}
+
+	fflush(stdout);
+	if (emit_writer_open(&run.writer, fd, format) != 0)
+	{
+		fprintf(stderr, "Error: Cannot set up output\n");
+		return 1;
+	}
+	pthread_mutex_init(&run.lock, NULL);
+	batch_for_each_parallel(paths, path_count, export_image, &run, NULL);
+	pthread_mutex_destroy(&run.lock);
+	int result = emit_writer_close(&run.writer);
+
+	if (out_path)
+	{
+		result |= close(fd);
+	}
+	if (result != 0)
+	{
+		fprintf(stderr, "Error: Write failed\n");
+	}
+	fprintf(stderr, "Exported: %zu, unknown version: %zu\n", run.exported, run.unknown);
+	return result != 0;
+}
@@ -0,0 +1,80 @@
+#ifndef EMIT_H
+#define EMIT_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "eeprom_defs.h"
+#include "eeprom_ops.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Machine-readable Output
+// ═══════════════════════════════════════════════════════════════
+// Records are rendered from FieldMetadata with hand-written integer and
+// fixed-point formatters into a per-thread buffer, which is written out
+// in large blocks. Keys are structure paths ("pt2_data.voltage").
+
+typedef enum
+{
+	EMIT_NDJSON,                   // One JSON object per line
+	EMIT_JSON,                     // One JSON array of objects
+	EMIT_CSV,                      // Header row, RFC 4180 quoting
+	EMIT_TSV                       // Header row, tabs/newlines in values become spaces
+} EmitFormat;
+
+// Growable byte buffer
+typedef struct EmitWriter EmitWriter;
+
+typedef struct
+{
+	char *data;
+	size_t len;
+	size_t capacity;
+	size_t records;                // Records since the last flush
+	EmitWriter *writer;            // Owner, NULL for standalone buffers
+} EmitBuffer;
+
+struct EmitWriter
+{
+	int fd;
+	EmitFormat format;
+	size_t flush_size;
+	pthread_key_t key;             // Per-thread EmitBuffer
+	pthread_mutex_t lock;
+	size_t records;                // Records written to fd
+	int error;                     // A write failed
+};
+
+// "ndjson", "json", "csv" or "tsv"; -1 if unknown
+int emit_format_parse(const char *name);
+
+void emit_buffer_free(EmitBuffer *buf);
+void emit_put(EmitBuffer *buf, const char *s, size_t n);
+void emit_str(EmitBuffer *buf, const char *s);
+void emit_char(EmitBuffer *buf, char c);
+void emit_uint(EmitBuffer *buf, uint32_t value);
+void emit_int(EmitBuffer *buf, int32_t value);
+// value / 100 with two decimals: 1380 -> "13.80"
+void emit_fixed2(EmitBuffer *buf, int32_t hundredths);
+// "0x" and digits upper-case hex digits
+void emit_hex(EmitBuffer *buf, uint32_t value, int digits);
+
+// Append one record for a decoded image
+void emit_record(EmitBuffer *buf, EmitFormat format, const char *name, const uint8_t *decoded,
+				 const EEPROMCheck *check);
+
+// Writer on fd; emits the CSV/TSV header row or the opening '['
+int emit_writer_open(EmitWriter *writer, int fd, EmitFormat format);
+// The calling thread's buffer (created on first use, flushed when the
+// thread exits)
+EmitBuffer *emit_writer_buffer(EmitWriter *writer);
+// Call after appending a record; writes the buffer once it is large
+void emit_writer_commit(EmitBuffer *buf);
+// Flush the calling thread's buffer, close the JSON array; 0 if every
+// write succeeded
+int emit_writer_close(EmitWriter *writer);
+
+// CLI: eeprom_tool export [-f ndjson|json|csv|tsv] [-o FILE] PATH...
+int cmd_export(int argc, char **argv);
+
+#endif // EMIT_H
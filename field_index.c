@@ -0,0 +1,254 @@
+#include "field_index.h"
+#include <pthread.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Perfect Hash per Field Table
+// ═══════════════════════════════════════════════════════════════
+// The keys of each field table are fixed by the schema, so a seed is
+// searched once (on first use) for which FNV-1a places every key in its
+// own slot. A lookup is then one hash, one slot and one strcmp.
+
+#define FIELD_INDEX_KEYS      192
+#define FIELD_INDEX_MAX_SLOTS 16384
+
+typedef struct
+{
+	const FieldMetadata *fields;
+	uint32_t seed;
+	uint32_t mask;
+	uint8_t slots[FIELD_INDEX_MAX_SLOTS];   // Key index + 1, 0 = empty
+	char keys[FIELD_INDEX_KEYS][FIELD_KEY_MAX];
+	uint8_t field_of_key[FIELD_INDEX_KEYS];
+	size_t key_count;
+} FieldIndex;
+
+// Member names several fields of a layout share, resolved to the field the
+// name means in the other layouts
+typedef struct
+{
+	EEPROMVersion version;
+	const char *member;
+	const char *path;
+} MemberAlias;
+
+static const MemberAlias member_aliases[] =
+{
+	// PSU Voltage as in v4-v6; the sweep one is "sweep_voltage"
+	{ EEPROM_VERSION_V1, "voltage", "pt2_data.voltage" },
+};
+
+// v4/v5/v6, v17, v1 field tables
+static FieldIndex indexes[3];
+static pthread_once_t indexes_once = PTHREAD_ONCE_INIT;
+
+size_t field_key(const char *name, char out[FIELD_KEY_MAX])
+{
+	size_t n = 0;
+	int separator = 0;
+
+	for (const char *p = name; *p; p++)
+	{
+		char c = *p;
+		if (c >= 'A' && c <= 'Z')
+		{
+			c = (char)(c | 0x20);
+		}
+		if (!((c >= 'a' && c <= 'z') || (c >= '0' && c <= '9')))
+		{
+			separator = n > 0;
+			continue;
+		}
+		if (n + separator + 1 >= FIELD_KEY_MAX)
+		{
+			return 0;
+		}
+		if (separator)
+		{
+			out[n++] = '_';
+			separator = 0;
+		}
+		out[n++] = c;
+	}
+
+	out[n] = '\0';
+	return n;
+}
+
+static uint32_t key_hash(const char *key, uint32_t seed)
+{
+	uint32_t h = 2166136261u ^ (seed * 0x9E3779B9u);
+	for (; *key; key++)
+	{
+		h ^= (uint8_t)*key;
+		h *= 16777619u;
+	}
+	return h ^ (h >> 15);
+}
+
+static int key_exists(const FieldIndex *index, const char *key)
+{
+	for (size_t i = 0; i < index->key_count; i++)
+	{
+		if (strcmp(index->keys[i], key) == 0)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+static void add_key(FieldIndex *index, const char *name, size_t field)
+{
+	char key[FIELD_KEY_MAX];
+	if (index->key_count < FIELD_INDEX_KEYS && field_key(name, key) && !key_exists(index, key))
+	{
+		memcpy(index->keys[index->key_count], key, sizeof(key));
+		index->field_of_key[index->key_count++] = (uint8_t)field;
+	}
+}
+
+static const char *member_of(const char *path)
+{
+	const char *dot = strrchr(path, '.');
+	return dot ? dot + 1 : path;
+}
+
+static int try_seed(FieldIndex *index, uint32_t seed, uint32_t size)
+{
+	memset(index->slots, 0, size);
+	for (size_t k = 0; k < index->key_count; k++)
+	{
+		uint32_t slot = key_hash(index->keys[k], seed) & (size - 1);
+		if (index->slots[slot])
+		{
+			return 0;
+		}
+		index->slots[slot] = (uint8_t)(k + 1);
+	}
+	index->seed = seed;
+	index->mask = size - 1;
+	return 1;
+}
+
+static void build_index(FieldIndex *index, EEPROMVersion version)
+{
+	size_t count;
+	index->fields = eeprom_get_fields(version, &count);
+
+	// Display names win over paths, paths over bare member names
+	for (size_t i = 0; i < count; i++)
+	{
+		add_key(index, index->fields[i].name, i);
+	}
+	for (size_t i = 0; i < count; i++)
+	{
+		add_key(index, index->fields[i].path, i);
+	}
+	for (size_t i = 0; i < count; i++)
+	{
+		const char *member = member_of(index->fields[i].path);
+		size_t uses = 0;
+		for (size_t j = 0; j < count; j++)
+		{
+			uses += strcmp(member_of(index->fields[j].path), member) == 0;
+		}
+		if (uses == 1)
+		{
+			add_key(index, member, i);
+		}
+	}
+	for (size_t a = 0; a < sizeof(member_aliases) / sizeof(member_aliases[0]); a++)
+	{
+		for (size_t i = 0; i < count && member_aliases[a].version == version; i++)
+		{
+			if (strcmp(index->fields[i].path, member_aliases[a].path) == 0)
+			{
+				add_key(index, member_aliases[a].member, i);
+			}
+		}
+	}
+
+	uint32_t size = 64;
+	while (size < index->key_count * 8)
+	{
+		size *= 2;
+	}
+	for (; size <= FIELD_INDEX_MAX_SLOTS; size *= 2)
+	{
+		for (uint32_t seed = 1; seed <= 4096; seed++)
+		{
+			if (try_seed(index, seed, size))
+			{
+				return;
+			}
+		}
+	}
+}
+
+static void build_indexes(void)
+{
+	build_index(&indexes[0], EEPROM_VERSION_V4);
+	build_index(&indexes[1], EEPROM_VERSION_V17);
+	build_index(&indexes[2], EEPROM_VERSION_V1);
+}
+
+const FieldMetadata *field_index_find(EEPROMVersion version, const char *name)
+{
+	const FieldIndex *index;
+	switch (version)
+	{
+		case EEPROM_VERSION_V4:
+		case EEPROM_VERSION_V5:
+		case EEPROM_VERSION_V6:
+			index = &indexes[0];
+			break;
+		case EEPROM_VERSION_V17:
+			index = &indexes[1];
+			break;
+		case EEPROM_VERSION_V1:
+			index = &indexes[2];
+			break;
+		default:
+			return NULL;
+	}
+
+	pthread_once(&indexes_once, build_indexes);
+
+	char key[FIELD_KEY_MAX];
+	if (!index->mask || !field_key(name, key))
+	{
+		return NULL;
+	}
+
+	uint8_t slot = index->slots[key_hash(key, index->seed) & index->mask];
+	if (!slot || strcmp(index->keys[slot - 1], key) != 0)
+	{
+		return NULL;
+	}
+	return &index->fields[index->field_of_key[slot - 1]];
+}
+
+size_t field_index_members(EEPROMVersion version, const char *name, const FieldMetadata **out, size_t max)
+{
+	char key[FIELD_KEY_MAX], member[FIELD_KEY_MAX];
+	size_t count, found = 0;
+	const FieldMetadata *fields = eeprom_get_fields(version, &count);
+	if (!fields || !field_key(name, key))
+	{
+		return 0;
+	}
+
+	for (size_t i = 0; i < count; i++)
+	{
+		if (field_key(member_of(fields[i].path), member) && strcmp(member, key) == 0)
+		{
+			if (found < max)
+			{
+				out[found] = &fields[i];
+			}
+			found++;
+		}
+	}
+	return found;
+}
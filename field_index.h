@@ -0,0 +1,32 @@
+#ifndef FIELD_INDEX_H
+#define FIELD_INDEX_H
+
+#include "eeprom_defs.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Field Name Index
+// ═══════════════════════════════════════════════════════════════
+// O(1) lookup of FieldMetadata by name. Accepted keys per layout:
+//   display name      "PT2 Result", "pt2 result", "pt2_result"
+//   structure path    "pt2_data.voltage"
+//   member name       "chip_bin" (only when unique in the layout, or
+//                     an alias such as v1 "voltage" = PT2 PSU Voltage)
+// Keys are compared case-insensitively with separators folded.
+
+// Longest normalized key
+#define FIELD_KEY_MAX 48
+
+// Normalize a name into out: lower case, each run of non-alphanumeric
+// characters becomes one '_', no leading/trailing '_'. Returns the length,
+// or 0 if the name is empty or too long.
+size_t field_key(const char *name, char out[FIELD_KEY_MAX]);
+
+// Lookup without allocation; NULL if the layout has no such field
+const FieldMetadata *field_index_find(EEPROMVersion version, const char *name);
+
+// Fields of the layout's table whose member name is name; up to max are
+// stored in out. More than one means the bare name is ambiguous there and
+// field_index_find() accepts it only if it is an alias.
+size_t field_index_members(EEPROMVersion version, const char *name, const FieldMetadata **out, size_t max);
+
+#endif // FIELD_INDEX_H
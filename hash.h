@@ -0,0 +1,48 @@
+#ifndef HASH_H
+#define HASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// MurmurHash64A (64-bit, non-cryptographic)
+// ═══════════════════════════════════════════════════════════════
+static inline uint64_t eeprom_hash64(const void *key, size_t len, uint64_t seed)
+{
+	const uint64_t m = 0xC6A4A7935BD1E995ULL;
+	const int r = 47;
+	const uint8_t *p = (const uint8_t*)key;
+	const uint8_t *end = p + (len & ~(size_t)7);
+	uint64_t h = seed ^ (len * m);
+
+	for (; p != end; p += 8)
+	{
+		uint64_t k;
+		memcpy(&k, p, 8);
+		k *= m;
+		k ^= k >> r;
+		k *= m;
+		h ^= k;
+		h *= m;
+	}
+
+	switch (len & 7)
+	{
+		case 7: h ^= (uint64_t)p[6] << 48; // fallthrough
+		case 6: h ^= (uint64_t)p[5] << 40; // fallthrough
+		case 5: h ^= (uint64_t)p[4] << 32; // fallthrough
+		case 4: h ^= (uint64_t)p[3] << 24; // fallthrough
+		case 3: h ^= (uint64_t)p[2] << 16; // fallthrough
+		case 2: h ^= (uint64_t)p[1] << 8;  // fallthrough
+		case 1: h ^= (uint64_t)p[0];
+				h *= m;
+	}
+
+	h ^= h >> r;
+	h *= m;
+	h ^= h >> r;
+	return h;
+}
+
+#endif // HASH_H
@@ -0,0 +1,487 @@
+#include "heatmap.h"
+#include "batch.h"
+#include "eeprom_ops.h"
+#include "topology.h"
+#include "ui.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Layout
+// ═══════════════════════════════════════════════════════════════
+
+// min / max over the chip cells
+static void heatmap_range(Heatmap *map)
+{
+	const SweepTopology *topology = map->topology;
+	size_t cells = (size_t)topology->rows * (size_t)topology->columns;
+	int first = 1;
+
+	map->min = map->max = 0.0f;
+	for (size_t c = 0; c < cells; c++)
+	{
+		if (topology->cell_asic[c] < 0)
+		{
+			continue;
+		}
+		if (first || map->mhz[c] < map->min)
+		{
+			map->min = map->mhz[c];
+		}
+		if (first || map->mhz[c] > map->max)
+		{
+			map->max = map->mhz[c];
+		}
+		first = 0;
+	}
+}
+
+void heatmap_fill(Heatmap *map, const SweepTopology *topology, const uint16_t *freq)
+{
+	size_t cells = (size_t)topology->rows * (size_t)topology->columns;
+
+	map->topology = topology;
+	for (size_t c = 0; c < cells; c++)
+	{
+		int asic = topology->cell_asic[c];
+		map->mhz[c] = asic >= 0 ? freq[asic] : 0.0f;
+	}
+	heatmap_range(map);
+}
+
+// Position of a value in the map's range, 0..1
+static float heat(const Heatmap *map, float mhz)
+{
+	return map->max > map->min ? (mhz - map->min) / (map->max - map->min) : 0.5f;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Text and CSV
+// ═══════════════════════════════════════════════════════════════
+
+// Slow chips cold, fast chips hot
+static const char *const heat_colors[] =
+{
+	TERM_BG_BLUE, TERM_BG_CYAN, TERM_BG_GREEN, TERM_BG_YELLOW, TERM_BG_RED
+};
+#define HEAT_COLORS (sizeof(heat_colors) / sizeof(heat_colors[0]))
+
+static void render_text(EmitBuffer *buf, const Heatmap *map, const char *title, const char *board)
+{
+	const SweepTopology *topology = map->topology;
+	int color = ui_color_enabled();
+
+	ui_appendf(buf, "\n  %s%s%s (%s)  %.0f-%.0f MHz\n", ui_color(TERM_BOLD), title, ui_color(TERM_RESET),
+			   board, map->min, map->max);
+
+	ui_appendf(buf, "      ");
+	for (int col = 0; col < topology->columns; col++)
+	{
+		ui_appendf(buf, " %4d", col);
+	}
+	emit_char(buf, '\n');
+
+	for (int row = 0; row < topology->rows; row++)
+	{
+		ui_appendf(buf, "  %3d ", row);
+		for (int col = 0; col < topology->columns; col++)
+		{
+			size_t c = (size_t)row * topology->columns + col;
+			if (topology->cell_asic[c] < 0)
+			{
+				emit_str(buf, "    .");
+				continue;
+			}
+
+			float mhz = map->mhz[c];
+			emit_char(buf, ' ');
+			if (color)
+			{
+				size_t shade = (size_t)(heat(map, mhz) * (HEAT_COLORS - 1) + 0.5f);
+				emit_str(buf, heat_colors[shade]);
+				emit_str(buf, TERM_BLACK);
+			}
+			ui_appendf(buf, "%4.0f", mhz);
+			if (color)
+			{
+				emit_str(buf, TERM_RESET);
+			}
+		}
+		emit_char(buf, '\n');
+	}
+}
+
+// Fields are image names and board types; quote only when needed
+static void render_csv_text(EmitBuffer *buf, const char *s)
+{
+	if (!strpbrk(s, ",\"\n"))
+	{
+		emit_str(buf, s);
+		return;
+	}
+	emit_char(buf, '"');
+	for (; *s; s++)
+	{
+		if (*s == '"')
+		{
+			emit_char(buf, '"');
+		}
+		emit_char(buf, *s);
+	}
+	emit_char(buf, '"');
+}
+
+static void render_csv(EmitBuffer *buf, const Heatmap *map, const char *title, const char *board)
+{
+	const SweepTopology *topology = map->topology;
+	for (int row = 0; row < topology->rows; row++)
+	{
+		for (int col = 0; col < topology->columns; col++)
+		{
+			size_t c = (size_t)row * topology->columns + col;
+			int asic = topology->cell_asic[c];
+			if (asic < 0)
+			{
+				continue;
+			}
+			render_csv_text(buf, title);
+			emit_char(buf, ',');
+			render_csv_text(buf, board);
+			ui_appendf(buf, ",%d,%d,%d,%.1f\n", row, col, asic, map->mhz[c]);
+		}
+	}
+}
+
+void heatmap_render(EmitBuffer *buf, HeatmapFormat format, const Heatmap *map,
+					const char *title, const char *board)
+{
+	if (format == HEATMAP_CSV)
+	{
+		render_csv(buf, map, title, board);
+	}
+	else
+	{
+		render_text(buf, map, title, board);
+	}
+}
+
+// ═══════════════════════════════════════════════════════════════
+// PPM
+// ═══════════════════════════════════════════════════════════════
+
+// Blue -> cyan -> green -> yellow -> red
+static void heat_rgb(float t, uint8_t rgb[3])
+{
+	static const uint8_t stops[][3] =
+	{
+		{ 0, 0, 255 }, { 0, 255, 255 }, { 0, 255, 0 }, { 255, 255, 0 }, { 255, 0, 0 }
+	};
+	float x = t * 4.0f;
+	int i = x >= 4.0f ? 3 : (int)x;
+	float f = x - (float)i;
+	for (int k = 0; k < 3; k++)
+	{
+		rgb[k] = (uint8_t)(stops[i][k] + (stops[i + 1][k] - stops[i][k]) * f + 0.5f);
+	}
+}
+
+int heatmap_write_ppm(const char *path, const Heatmap *map, int cell_pixels)
+{
+	const SweepTopology *topology = map->topology;
+	size_t width = (size_t)topology->columns * cell_pixels;
+	size_t height = (size_t)topology->rows * cell_pixels;
+	uint8_t *row_pixels = malloc(width * 3);
+	FILE *f = fopen(path, "wb");
+	if (!row_pixels || !f)
+	{
+		free(row_pixels);
+		if (f)
+		{
+			fclose(f);
+		}
+		return -1;
+	}
+
+	fprintf(f, "P6\n%zu %zu\n255\n", width, height);
+	for (size_t y = 0; y < height; y++)
+	{
+		int row = (int)(y / cell_pixels);
+		int border_y = y % cell_pixels == 0;
+		for (size_t x = 0; x < width; x++)
+		{
+			int col = (int)(x / cell_pixels);
+			size_t c = (size_t)row * topology->columns + col;
+			uint8_t *px = row_pixels + x * 3;
+
+			if (cell_pixels >= 4 && (border_y || x % cell_pixels == 0))
+			{
+				px[0] = px[1] = px[2] = 0;
+			}
+			else if (topology->cell_asic[c] < 0)
+			{
+				px[0] = px[1] = px[2] = 48;
+			}
+			else
+			{
+				heat_rgb(heat(map, map->mhz[c]), px);
+			}
+		}
+		fwrite(row_pixels, 3, width, f);
+	}
+
+	free(row_pixels);
+	return fclose(f) == 0 ? 0 : -1;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+#define HEATMAP_CELL_PIXELS 16
+#define HEATMAP_MAX_TYPES   64
+
+// Mean frequency per cell over all boards of one type (-a)
+typedef struct
+{
+	char board[16];
+	const SweepTopology *topology; // Record in the topology database
+	size_t boards;
+	double sum[SWEEP_MAX_CELLS];
+} HeatmapAggregate;
+
+typedef struct
+{
+	const TopologyDB *topologies;
+	HeatmapFormat format;
+	const char *out_dir;
+	int aggregate;
+	HeatmapAggregate *types;
+	size_t type_count;
+	size_t boards;
+	size_t skipped;                // No sweep data
+	size_t no_layout;              // No topology or no "tpl" matrix
+	size_t errors;                 // PPM write failures
+} HeatmapRun;
+
+// DIR/<name with path separators folded>.ppm
+static void ppm_path(char *out, size_t size, const char *dir, const char *name)
+{
+	size_t n = (size_t)snprintf(out, size, "%s/", dir);
+	for (const char *p = name; *p && n + 5 < size; p++)
+	{
+		out[n++] = (*p == '/' || *p == ':' || *p == '\\') ? '_' : *p;
+	}
+	snprintf(out + n, size - n, ".ppm");
+}
+
+static void heatmap_emit(HeatmapRun *run, const Heatmap *map, const char *title, const char *board)
+{
+	if (run->format == HEATMAP_PPM)
+	{
+		char path[4096];
+		ppm_path(path, sizeof(path), run->out_dir, title);
+		if (heatmap_write_ppm(path, map, HEATMAP_CELL_PIXELS) != 0)
+		{
+			fprintf(stderr, "Error: Cannot write %s\n", path);
+			run->errors++;
+		}
+		return;
+	}
+
+	EmitBuffer buf = { 0 };
+	heatmap_render(&buf, run->format, map, title, board);
+	ui_flush(&buf);
+	emit_buffer_free(&buf);
+}
+
+static HeatmapAggregate *aggregate_for(HeatmapRun *run, const char *board, const SweepTopology *topology)
+{
+	for (size_t i = 0; i < run->type_count; i++)
+	{
+		if (strcmp(run->types[i].board, board) == 0)
+		{
+			return &run->types[i];
+		}
+	}
+	if (run->type_count == HEATMAP_MAX_TYPES)
+	{
+		return NULL;
+	}
+
+	HeatmapAggregate *type = &run->types[run->type_count++];
+	memset(type, 0, sizeof(*type));
+	snprintf(type->board, sizeof(type->board), "%s", board);
+	type->topology = topology;
+	return type;
+}
+
+static int heatmap_image(const char *name, const uint8_t *data, size_t size, void *ctx)
+{
+	HeatmapRun *run = (HeatmapRun*)ctx;
+	uint8_t work[EEPROM_SIZE];
+	memset(work, 0xFF, sizeof(work));
+	memcpy(work, data, size < EEPROM_SIZE ? size : EEPROM_SIZE);
+
+	EEPROMCheck check;
+	SweepBoard board;
+	if (batch_decode(work, &check) == EEPROM_ERROR_VERSION ||
+		sweep_board(work, &check, &board) != 0)
+	{
+		run->skipped++;
+		return 0;
+	}
+
+	const SweepTopology *topology = topology_chain(run->topologies, board.board);
+	if (!topology || topology->rows == 0)
+	{
+		run->no_layout++;
+		return 0;
+	}
+
+	uint16_t freq[SWEEP_MAX_ASICS];
+	sweep_expand(board.levels, SWEEP_LEVEL_BYTES, board.freq_base, board.freq_step, freq);
+	run->boards++;
+
+	if (run->aggregate)
+	{
+		HeatmapAggregate *type = aggregate_for(run, board.board, topology);
+		if (!type)
+		{
+			run->no_layout++;
+			return 0;
+		}
+		size_t cells = (size_t)topology->rows * topology->columns;
+		for (size_t c = 0; c < cells; c++)
+		{
+			int asic = topology->cell_asic[c];
+			type->sum[c] += asic >= 0 ? freq[asic] : 0;
+		}
+		type->boards++;
+		return 0;
+	}
+
+	Heatmap map;
+	heatmap_fill(&map, topology, freq);
+	heatmap_emit(run, &map, name, board.board);
+	return 0;
+}
+
+static void heatmap_emit_aggregates(HeatmapRun *run)
+{
+	for (size_t i = 0; i < run->type_count; i++)
+	{
+		HeatmapAggregate *type = &run->types[i];
+		const SweepTopology *topology = type->topology;
+		size_t cells = (size_t)topology->rows * topology->columns;
+
+		Heatmap map;
+		map.topology = topology;
+		for (size_t c = 0; c < cells; c++)
+		{
+			map.mhz[c] = (float)(type->sum[c] / type->boards);
+		}
+		heatmap_range(&map);
+
+		char title[64];
+		snprintf(title, sizeof(title), "%s mean of %zu", type->board, type->boards);
+		heatmap_emit(run, &map, run->format == HEATMAP_PPM ? type->board : title, type->board);
+	}
+}
+
+int cmd_heatmap(int argc, char **argv)
+{
+	HeatmapRun run;
+	memset(&run, 0, sizeof(run));
+	const char *topology_dir = NULL;
+	int paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			topology_dir = argv[++i];
+		}
+		else if (strcmp(argv[i], "-f") == 0 && i + 1 < argc)
+		{
+			const char *format = argv[++i];
+			if (strcmp(format, "text") == 0)
+			{
+				run.format = HEATMAP_TEXT;
+			}
+			else if (strcmp(format, "csv") == 0)
+			{
+				run.format = HEATMAP_CSV;
+			}
+			else if (strcmp(format, "ppm") == 0)
+			{
+				run.format = HEATMAP_PPM;
+			}
+			else
+			{
+				fprintf(stderr, "Error: Unknown format '%s' (text, csv, ppm)\n", format);
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			run.out_dir = argv[++i];
+		}
+		else if (strcmp(argv[i], "-a") == 0)
+		{
+			run.aggregate = 1;
+		}
+		else
+		{
+			paths[path_count++] = i;
+		}
+	}
+
+	if (path_count == 0 || !topology_dir)
+	{
+		fprintf(stderr, "Usage: eeprom_tool heatmap -t TOPOLOGY_DIR [-f text|csv|ppm] [-o DIR] [-a] PATH...\n");
+		return 1;
+	}
+	if (run.format == HEATMAP_PPM && !run.out_dir)
+	{
+		fprintf(stderr, "Error: PPM output needs -o DIR\n");
+		return 1;
+	}
+	if (run.aggregate && !(run.types = calloc(HEATMAP_MAX_TYPES, sizeof(HeatmapAggregate))))
+	{
+		fprintf(stderr, "Error: Out of memory\n");
+		return 1;
+	}
+	TopologyDB *topologies = topology_open(topology_dir);
+	if (!topologies)
+	{
+		free(run.types);
+		return 1;
+	}
+	run.topologies = topologies;
+
+	if (run.format == HEATMAP_CSV)
+	{
+		printf("image,board,row,column,asic,mhz\n");
+	}
+	for (int i = 0; i < path_count; i++)
+	{
+		batch_for_each(argv[paths[i]], heatmap_image, &run, NULL);
+	}
+	if (run.aggregate)
+	{
+		heatmap_emit_aggregates(&run);
+	}
+
+	fflush(stdout);
+	fprintf(stderr, "Boards: %zu, without sweep data: %zu, without chip layout: %zu\n",
+			run.boards, run.skipped, run.no_layout);
+	free(run.types);
+	topology_close(topologies);
+	return run.errors != 0;
+}
@@ -0,0 +1,45 @@
+#ifndef HEATMAP_H
+#define HEATMAP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "emit.h"
+#include "sweep.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Sweep Heatmaps
+// ═══════════════════════════════════════════════════════════════
+// Per-ASIC sweep frequencies placed on the physical chip matrix ("tpl")
+// of the board's topology. The cell -> ASIC map is resolved once per
+// board type when its topology is read (SweepTopology.cell_asic), so a
+// board costs one indexed load per cell.
+
+typedef enum
+{
+	HEATMAP_TEXT,                  // Frequency grid, colored on a terminal
+	HEATMAP_CSV,                   // image,board,row,column,asic,mhz
+	HEATMAP_PPM                    // One binary PPM per map, written to -o DIR
+} HeatmapFormat;
+
+// Values laid out on a topology's matrix
+typedef struct
+{
+	const SweepTopology *topology;
+	float mhz[SWEEP_MAX_CELLS];    // Per cell; ignored where cell_asic < 0
+	float min;                     // Range of the chip cells
+	float max;
+} Heatmap;
+
+// Place expanded frequencies (sweep_expand) on the topology's matrix
+void heatmap_fill(Heatmap *map, const SweepTopology *topology, const uint16_t *freq);
+
+// Render as text or CSV rows (title is the image name, board the type)
+void heatmap_render(EmitBuffer *buf, HeatmapFormat format, const Heatmap *map,
+					const char *title, const char *board);
+// Write map as a binary PPM, cell_pixels square pixels per chip
+int heatmap_write_ppm(const char *path, const Heatmap *map, int cell_pixels);
+
+// CLI: eeprom_tool heatmap -t TOPOLOGY_DIR [-f text|csv|ppm] [-o DIR] [-a] PATH...
+int cmd_heatmap(int argc, char **argv);
+
+#endif // HEATMAP_H
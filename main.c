@@ -7,6 +7,25 @@
 #include "eeprom_structure.h"
 #include "eeprom_ops.h"
 #include "ui.h"
+#include "probe.h"
+#include "check.h"
+#include "bench.h"
+#include "columns.h"
+#include "summary.h"
+#include "heatmap.h"
+#include "sweep.h"
+#include "topology.h"
+#include "validate.h"
+#include "pair.h"
+#include "assemble.h"
+#include "query.h"
+#include "patch.h"
+#include "retune.h"
+#include "transcode.h"
+#include "detect.h"
+#include "emit.h"
+#include "dump_format.h"
+#include "batch.h"
 
 #ifdef HAVE_I2C_SUPPORT
 #include "i2c_eeprom.h"
@@ -27,24 +46,48 @@ static int read_eeprom_file(const char *filename, uint8_t *buffer)
 	long file_size = ftell(file);
 	fseek(file, 0, SEEK_SET);
 
-	if (file_size <= 0 || file_size > EEPROM_SIZE)
+	if (file_size <= 0 || file_size > DUMP_MAX_SIZE)
 	{
 		printf("Error: Invalid file size: %ld bytes (expected 1-%d)\n",
-			   file_size, EEPROM_SIZE);
+			   file_size, DUMP_MAX_SIZE);
 		fclose(file);
 		return -4;
 	}
 
-	size_t read_size = fread(buffer, 1, file_size, file);
+	uint8_t *raw = malloc((size_t)file_size);
+	if (!raw)
+	{
+		printf("Error: Out of memory\n");
+		fclose(file);
+		return -2;
+	}
+
+	size_t read_size = fread(raw, 1, file_size, file);
 	fclose(file);
 
 	if (read_size != (size_t)file_size)
 	{
 		printf("Error: Failed to read file completely\n");
+		free(raw);
 		return -2;
 	}
 
+	DumpInfo info;
+	int result = dump_extract(raw, read_size, buffer, &info);
+	free(raw);
+
+	if (result != 0)
+	{
+		printf("Error: No valid EEPROM image found in %s\n", filename);
+		return -4;
+	}
+
 	printf("Read %zu bytes from %s\n", read_size, filename);
+	if (info.format != DUMP_FORMAT_BINARY || info.image_size > EEPROM_SIZE)
+	{
+		printf("Detected %s dump (%zu bytes), using window at offset 0x%zX\n",
+			   dump_format_name(info.format), info.image_size, info.offset);
+	}
 	return 0;
 }
 
@@ -75,9 +118,41 @@ static int write_eeprom_file(const char *filename, const uint8_t *buffer, size_t
 // Функции для работы с EEPROM
 // ═══════════════════════════════════════════════════════════════
 
-static void decode_and_print_eeprom(uint8_t *data)
+// Byte 0 first; if it names no known version or its layout fails a CRC,
+// score every layout and repair the header bytes from a better match
+static EEPROMVersion detect_image_version(uint8_t *data)
 {
 	EEPROMVersion version = eeprom_detect_version(data);
+	EEPROMCheck check = { 0 };
+	if (version != EEPROM_VERSION_UNKNOWN)
+	{
+		uint8_t copy[EEPROM_SIZE];
+		memcpy(copy, data, sizeof(copy));
+		eeprom_decode_check(copy, EEPROM_SIZE, version, &check);
+		if (check.crc_ok == EEPROM_CHECK_ALL(&check))
+		{
+			return version;
+		}
+	}
+
+	DetectResult result;
+	EEPROMVersion detected = eeprom_detect_scored(data, &result);
+	const DetectCandidate *best = &result.candidates[0];
+	if (detected == EEPROM_VERSION_UNKNOWN ||
+		__builtin_popcount(best->crc_ok) <= __builtin_popcount(check.crc_ok))
+	{
+		return version;
+	}
+
+	ui_print_warning("Header bytes 0x%02X 0x%02X disagree with the contents, which match v%d (score %u)",
+					 data[0], data[1], detected, best->score);
+	eeprom_detect_apply(data, best);
+	return detected;
+}
+
+static void decode_and_print_eeprom(uint8_t *data)
+{
+	EEPROMVersion version = detect_image_version(data);
 
 	// Decode data
 	if (eeprom_decode(data, EEPROM_SIZE, version) != EEPROM_SUCCESS)
@@ -118,12 +193,31 @@ static void decode_and_print_eeprom(uint8_t *data)
 	}
 }
 
-static void encode_and_save_eeprom(const char *filename, EEPROMStructure *eeprom)
+typedef struct
+{
+	uint8_t original[EEPROM_SIZE];     // Image as loaded, still encoded
+	int crc_ok;                        // Every region CRC matched on load
+	uint8_t dirty;                     // Regions changed while editing
+} EditSession;
+
+// Edits keep the stored CRCs current, so an image loaded with valid CRCs
+// only has its edited regions re-encrypted; one with CRC errors is
+// encoded in full, which recomputes them
+static int encode_edited(uint8_t *data, EEPROMVersion version, const EditSession *session)
+{
+	if (!session->crc_ok)
+	{
+		return eeprom_encode(data, EEPROM_SIZE, version);
+	}
+	return eeprom_encode_dirty(data, EEPROM_SIZE, version, session->original, session->dirty);
+}
+
+static void encode_and_save_eeprom(const char *filename, EEPROMStructure *eeprom, const EditSession *session)
 {
 	uint8_t data[EEPROM_SIZE];
 	eeprom_to_bytes(eeprom, data);
 
-	if (eeprom_encode(data, EEPROM_SIZE, (EEPROMVersion)eeprom->eeprom_version) != EEPROM_SUCCESS)
+	if (encode_edited(data, (EEPROMVersion)eeprom->eeprom_version, session) != EEPROM_SUCCESS)
 	{
 		printf("Error: Failed to encode EEPROM\n");
 		return;
@@ -135,14 +229,15 @@ static void encode_and_save_eeprom(const char *filename, EEPROMStructure *eeprom
 	}
 }
 
-static void encode_and_save_eeprom_v1(const char *filename, EEPROMStructure_v1 *eeprom)
+static void encode_and_save_eeprom_v1(const char *filename, EEPROMStructure_v1 *eeprom,
+									  const EditSession *session)
 {
 	uint8_t data[EEPROM_SIZE];
 	memset(data, 0xFF, EEPROM_SIZE);
 
 	eeprom_v1_serialize(eeprom, data);
 
-	if (eeprom_encode(data, EEPROM_SIZE, EEPROM_VERSION_V1) != EEPROM_SUCCESS)
+	if (encode_edited(data, EEPROM_VERSION_V1, session) != EEPROM_SUCCESS)
 	{
 		printf("Error: Failed to encode EEPROM v1\n");
 		return;
@@ -155,14 +250,15 @@ static void encode_and_save_eeprom_v1(const char *filename, EEPROMStructure_v1 *
 	}
 }
 
-static void encode_and_save_eeprom_v17(const char *filename, EEPROMStructure_v17 *eeprom)
+static void encode_and_save_eeprom_v17(const char *filename, EEPROMStructure_v17 *eeprom,
+									   const EditSession *session)
 {
 	uint8_t data[EEPROM_SIZE];
 	memset(data, 0xFF, EEPROM_SIZE);
 
 	eeprom_v17_serialize(eeprom, data);
 
-	if (eeprom_encode(data, EEPROM_SIZE, EEPROM_VERSION_V17) != EEPROM_SUCCESS)
+	if (encode_edited(data, EEPROM_VERSION_V17, session) != EEPROM_SUCCESS)
 	{
 		printf("Error: Failed to encode EEPROM v17\n");
 		return;
@@ -175,6 +271,81 @@ static void encode_and_save_eeprom_v17(const char *filename, EEPROMStructure_v17
 	}
 }
 
+// ═══════════════════════════════════════════════════════════════
+// Пакетные команды (non-interactive)
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	const char *name;
+	int (*run)(int argc, char **argv);
+	const char *usage;
+} Command;
+
+static const Command commands[] =
+{
+	{ "probe", cmd_probe, "probe [-l] PATH...         Classify images from header bytes (no crypto)" },
+	{ "check", cmd_check, "check [-q] [--cache DIR] [--cache-size MB] [--incremental MANIFEST] PATH...\n"
+						  "                             Decode and validate CRC / test results" },
+	{ "bench", cmd_bench, "bench [-n ROUNDS] PATH...  Time generic vs version-specialized decoding" },
+	{ "stats", cmd_stats, "stats [-f FIELD,...] PATH...\n"
+						  "                             Min / mean / max of fields across all images" },
+	{ "summary", cmd_summary, "summary PATH...            Fleet counts, pass rates, quantiles and distinct serials" },
+	{ "query", cmd_query, "query [-c] EXPR PATH...    List images matching a field expression" },
+	{ "patch", cmd_patch, "patch -s SPEC (-o DIR | --in-place) [-n] [--force] [--full] PATH...\n"
+						  "                             Set fields from a spec file and re-encode" },
+	{ "retune", cmd_retune, "retune -l LOG.csv (-o DIR | --in-place) [-n] [-r PERCENT] [-t TOPOLOGY_DIR] PATH...\n"
+							"                             Re-quantize sweep levels from per-chip nonce / error counts" },
+	{ "transcode", cmd_transcode, "transcode -v 1|4|5|6|17 (-o DIR | --in-place) [-n] [--strict] PATH...\n"
+								  "                             Re-lay images out as another EEPROM version" },
+	{ "export", cmd_export, "export [-f ndjson|json|csv|tsv] [-o FILE] PATH...\n"
+							"                             Decode images to machine-readable records" },
+	{ "detect", cmd_detect, "detect [-a] PATH...        Score every layout and key, report contradicted headers" },
+	{ "sweep", cmd_sweep, "sweep [-t TOPOLOGY_DIR] [-d] PATH...\n"
+						  "                             Per-ASIC sweep frequency statistics per board and domain" },
+	{ "heatmap", cmd_heatmap, "heatmap -t TOPOLOGY_DIR [-f text|csv|ppm] [-o DIR] [-a] PATH...\n"
+							  "                             Sweep frequencies on the physical chip layout" },
+	{ "topology", cmd_topology, "topology -t TOPOLOGY_DIR [BOARD...]\n"
+								"                             List board configs, or show the config of a board name" },
+	{ "validate", cmd_validate, "validate -t TOPOLOGY_DIR [-v] PATH...\n"
+								"                             Check images against their board's topology config" },
+	{ "pair", cmd_pair, "pair -s SERIAL[,SERIAL...] [-k N] [-m l1|l2] [-a] [-V VOLTS] [-t TOPOLOGY_DIR] PATH...\n"
+						"                             Boards with the most similar sweep profile (k nearest)" },
+	{ "assemble", cmd_assemble, "assemble [-t TOPOLOGY_DIR] [-n 3|4] [-V VOLTS] [-a] [-f text|csv] PATH...\n"
+								"                             Group boards into miners by family and voltage, max hashrate" },
+};
+
+static void print_usage(void)
+{
+	printf("Usage: eeprom_tool [COMMAND ARGS...]\n");
+	printf("Without a command the interactive menu is started.\n\nCommands:\n");
+	for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+	{
+		printf("  %s\n", commands[i].usage);
+	}
+	printf("\nBatch options (all commands):\n");
+	printf("  -j N, --threads N          Directory walker threads (default: CPUs)\n");
+	printf("  --ext .bin,.eep            Only read files with these extensions\n");
+	printf("  --cache DIR                Reuse decoded images from a decode cache in DIR\n");
+	printf("  --cache-size MB            Decode cache size bound (default: %d)\n", DECODE_CACHE_DEFAULT_MB);
+}
+
+static int run_command(int argc, char **argv)
+{
+	for (size_t i = 0; i < sizeof(commands) / sizeof(commands[0]); i++)
+	{
+		if (strcmp(argv[0], commands[i].name) == 0)
+		{
+			int result = commands[i].run(argc - 1, argv + 1);
+			batch_finish();
+			return result;
+		}
+	}
+
+	print_usage();
+	return strcmp(argv[0], "help") == 0 ? 0 : 1;
+}
+
 // ═══════════════════════════════════════════════════════════════
 // Главное меню
 // ═══════════════════════════════════════════════════════════════
@@ -183,6 +354,11 @@ int main(int argc, char *argv[])
 {
 	setlocale(LC_ALL, "en_US.UTF-8");
 
+	if (argc > 1)
+	{
+		return run_command(argc - 1, argv + 1);
+	}
+
 	char input_filename[MAX_FILENAME];
 	char output_filename[MAX_FILENAME];
 	uint8_t data[EEPROM_SIZE];
@@ -221,7 +397,15 @@ int main(int argc, char *argv[])
 			memset(data, 0xFF, EEPROM_SIZE);
 			if (read_eeprom_file(input_filename, data) == 0)
 			{
-				EEPROMVersion version = eeprom_detect_version(data);
+				EEPROMVersion version = detect_image_version(data);
+
+				EditSession session;
+				EEPROMCheck check;
+				uint8_t copy[EEPROM_SIZE];
+				memcpy(session.original, data, EEPROM_SIZE);
+				memcpy(copy, data, EEPROM_SIZE);
+				session.crc_ok = eeprom_decode_check(copy, EEPROM_SIZE, version, &check) == EEPROM_SUCCESS &&
+								 check.crc_ok == EEPROM_CHECK_ALL(&check);
 
 				if (eeprom_decode(data, EEPROM_SIZE, version) != EEPROM_SUCCESS)
 				{
@@ -234,11 +418,11 @@ int main(int argc, char *argv[])
 					EEPROMStructure_v1 eeprom_v1;
 					eeprom_v1_parse(&eeprom_v1, data);
 
-					if (eeprom_edit_interactive(&eeprom_v1, version) == EEPROM_SUCCESS)
+					if (eeprom_edit_interactive(&eeprom_v1, version, &session.dirty) == EEPROM_SUCCESS)
 					{
 						printf("Enter output filename: ");
 						scanf("%255s", output_filename);
-						encode_and_save_eeprom_v1(output_filename, &eeprom_v1);
+						encode_and_save_eeprom_v1(output_filename, &eeprom_v1, &session);
 					}
 				}
 				else if (version >= EEPROM_VERSION_V4 && version <= EEPROM_VERSION_V6)
@@ -246,11 +430,11 @@ int main(int argc, char *argv[])
 					EEPROMStructure eeprom;
 					eeprom_from_bytes(&eeprom, data);
 
-					if (eeprom_edit_interactive(&eeprom, version) == EEPROM_SUCCESS)
+					if (eeprom_edit_interactive(&eeprom, version, &session.dirty) == EEPROM_SUCCESS)
 					{
 						printf("Enter output filename: ");
 						scanf("%255s", output_filename);
-						encode_and_save_eeprom(output_filename, &eeprom);
+						encode_and_save_eeprom(output_filename, &eeprom, &session);
 					}
 				}
 				else if (version == EEPROM_VERSION_V17)
@@ -258,11 +442,11 @@ int main(int argc, char *argv[])
 					EEPROMStructure_v17 eeprom_v17;
 					eeprom_v17_parse(&eeprom_v17, data);
 
-					if (eeprom_edit_interactive(&eeprom_v17, version) == EEPROM_SUCCESS)
+					if (eeprom_edit_interactive(&eeprom_v17, version, &session.dirty) == EEPROM_SUCCESS)
 					{
 						printf("Enter output filename: ");
 						scanf("%255s", output_filename);
-						encode_and_save_eeprom_v17(output_filename, &eeprom_v17);
+						encode_and_save_eeprom_v17(output_filename, &eeprom_v17, &session);
 					}
 				}
 				else
@@ -0,0 +1,294 @@
+#include "manifest.h"
+#include "hash.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <inttypes.h>
+#include <unistd.h>
+
+#define MANIFEST_MAGIC "# eeprom_tool manifest 1"
+
+typedef struct
+{
+	char *name;
+	int64_t size;
+	int64_t mtime_sec;
+	int64_t mtime_nsec;
+	uint64_t ino;
+	EEPROMCheck check;
+	uint8_t skipped;               // File held no image
+	uint8_t seen;                  // Present in the current run
+} ManifestEntry;
+
+struct Manifest
+{
+	ManifestEntry *entries;
+	size_t count;
+	size_t capacity;
+
+	uint32_t *table;               // Open addressing: index + 1, 0 = empty
+	size_t table_mask;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// Hash table
+// ═══════════════════════════════════════════════════════════════
+
+static uint64_t manifest_hash(const char *name)
+{
+	return eeprom_hash64(name, strlen(name), 0x4D414E49u);
+}
+
+static void manifest_table_insert(Manifest *manifest, size_t index)
+{
+	size_t i = (size_t)manifest_hash(manifest->entries[index].name) & manifest->table_mask;
+	while (manifest->table[i])
+	{
+		i = (i + 1) & manifest->table_mask;
+	}
+	manifest->table[i] = (uint32_t)index + 1;
+}
+
+static int manifest_grow(Manifest *manifest)
+{
+	size_t capacity = manifest->capacity ? manifest->capacity * 2 : 1024;
+	ManifestEntry *entries = realloc(manifest->entries, capacity * sizeof(ManifestEntry));
+	uint32_t *table = calloc(capacity * 2, sizeof(uint32_t));
+	if (!entries || !table)
+	{
+		free(table);
+		if (entries)
+		{
+			manifest->entries = entries;
+		}
+		return -1;
+	}
+
+	free(manifest->table);
+	manifest->entries = entries;
+	manifest->capacity = capacity;
+	manifest->table = table;
+	manifest->table_mask = capacity * 2 - 1;
+
+	for (size_t i = 0; i < manifest->count; i++)
+	{
+		manifest_table_insert(manifest, i);
+	}
+	return 0;
+}
+
+static ManifestEntry *manifest_find(const Manifest *manifest, const char *name)
+{
+	if (!manifest->table)
+	{
+		return NULL;
+	}
+
+	size_t i = (size_t)manifest_hash(name) & manifest->table_mask;
+	while (manifest->table[i])
+	{
+		ManifestEntry *entry = &manifest->entries[manifest->table[i] - 1];
+		if (strcmp(entry->name, name) == 0)
+		{
+			return entry;
+		}
+		i = (i + 1) & manifest->table_mask;
+	}
+	return NULL;
+}
+
+static ManifestEntry *manifest_add(Manifest *manifest, const char *name)
+{
+	if (manifest->count == manifest->capacity && manifest_grow(manifest) != 0)
+	{
+		return NULL;
+	}
+
+	ManifestEntry *entry = &manifest->entries[manifest->count];
+	memset(entry, 0, sizeof(*entry));
+	entry->name = strdup(name);
+	if (!entry->name)
+	{
+		return NULL;
+	}
+
+	manifest_table_insert(manifest, manifest->count);
+	manifest->count++;
+	return entry;
+}
+
+static void manifest_set_stat(ManifestEntry *entry, const struct stat *st)
+{
+	entry->size = st->st_size;
+	entry->mtime_sec = st->st_mtim.tv_sec;
+	entry->mtime_nsec = st->st_mtim.tv_nsec;
+	entry->ino = st->st_ino;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Public API
+// ═══════════════════════════════════════════════════════════════
+
+Manifest *manifest_load(const char *path)
+{
+	Manifest *manifest = calloc(1, sizeof(Manifest));
+	if (!manifest)
+	{
+		return NULL;
+	}
+
+	FILE *file = fopen(path, "r");
+	if (!file)
+	{
+		return manifest;
+	}
+
+	char line[4608];
+	if (!fgets(line, sizeof(line), file) || strncmp(line, MANIFEST_MAGIC, strlen(MANIFEST_MAGIC)) != 0)
+	{
+		fprintf(stderr, "Warning: %s is not a manifest, starting a full run\n", path);
+		fclose(file);
+		return manifest;
+	}
+
+	while (fgets(line, sizeof(line), file))
+	{
+		int64_t size, sec, nsec;
+		uint64_t ino;
+		int version, regions, crc_ok, test_pass, name_pos = 0;
+
+		if (sscanf(line, "%" SCNd64 "\t%" SCNd64 ".%" SCNd64 "\t%" SCNu64 "\t%d\t%d\t%d\t%d\t%n",
+				   &size, &sec, &nsec, &ino, &version, &regions, &crc_ok, &test_pass, &name_pos) != 8 ||
+			name_pos == 0)
+		{
+			continue;
+		}
+
+		char *name = line + name_pos;
+		name[strcspn(name, "\n")] = '\0';
+
+		ManifestEntry *entry = manifest_add(manifest, name);
+		if (!entry)
+		{
+			break;
+		}
+		entry->size = size;
+		entry->mtime_sec = sec;
+		entry->mtime_nsec = nsec;
+		entry->ino = ino;
+		entry->skipped = version == 0;
+		entry->check.version = version == 0 ? EEPROM_VERSION_UNKNOWN : (EEPROMVersion)version;
+		entry->check.region_count = (uint8_t)regions;
+		entry->check.crc_ok = (uint8_t)crc_ok;
+		entry->check.test_pass = (uint8_t)test_pass;
+	}
+
+	fclose(file);
+	return manifest;
+}
+
+const EEPROMCheck *manifest_lookup(Manifest *manifest, const char *name, const struct stat *st,
+								   int *skipped)
+{
+	ManifestEntry *entry = manifest_find(manifest, name);
+	if (!entry ||
+		entry->size != st->st_size ||
+		entry->mtime_sec != st->st_mtim.tv_sec ||
+		entry->mtime_nsec != st->st_mtim.tv_nsec ||
+		entry->ino != (uint64_t)st->st_ino)
+	{
+		return NULL;
+	}
+
+	entry->seen = 1;
+	*skipped = entry->skipped;
+	return &entry->check;
+}
+
+static ManifestEntry *manifest_record(Manifest *manifest, const char *name, const struct stat *st)
+{
+	ManifestEntry *entry = manifest_find(manifest, name);
+	if (!entry)
+	{
+		entry = manifest_add(manifest, name);
+		if (!entry)
+		{
+			return NULL;
+		}
+	}
+
+	manifest_set_stat(entry, st);
+	entry->seen = 1;
+	return entry;
+}
+
+void manifest_update(Manifest *manifest, const char *name, const struct stat *st,
+					 const EEPROMCheck *check)
+{
+	ManifestEntry *entry = manifest_record(manifest, name, st);
+	if (entry)
+	{
+		entry->check = *check;
+		entry->skipped = 0;
+	}
+}
+
+void manifest_skip(Manifest *manifest, const char *name, const struct stat *st)
+{
+	ManifestEntry *entry = manifest_record(manifest, name, st);
+	if (entry)
+	{
+		memset(&entry->check, 0, sizeof(entry->check));
+		entry->skipped = 1;
+	}
+}
+
+int manifest_save(const Manifest *manifest, const char *path)
+{
+	char tmp_path[4200];
+	snprintf(tmp_path, sizeof(tmp_path), "%s.tmp", path);
+
+	FILE *file = fopen(tmp_path, "w");
+	if (!file)
+	{
+		fprintf(stderr, "Error: Cannot write manifest %s\n", tmp_path);
+		return -1;
+	}
+
+	fprintf(file, "%s\n", MANIFEST_MAGIC);
+	for (size_t i = 0; i < manifest->count; i++)
+	{
+		const ManifestEntry *entry = &manifest->entries[i];
+		if (!entry->seen)
+		{
+			continue;
+		}
+		fprintf(file, "%" PRId64 "\t%" PRId64 ".%09" PRId64 "\t%" PRIu64 "\t%d\t%u\t%u\t%u\t%s\n",
+				entry->size, entry->mtime_sec, entry->mtime_nsec, entry->ino,
+				entry->skipped ? 0 : (int)entry->check.version, entry->check.region_count,
+				entry->check.crc_ok, entry->check.test_pass, entry->name);
+	}
+
+	if (fclose(file) != 0 || rename(tmp_path, path) != 0)
+	{
+		fprintf(stderr, "Error: Failed to write manifest %s\n", path);
+		unlink(tmp_path);
+		return -1;
+	}
+	return 0;
+}
+
+void manifest_free(Manifest *manifest)
+{
+	if (!manifest)
+	{
+		return;
+	}
+	for (size_t i = 0; i < manifest->count; i++)
+	{
+		free(manifest->entries[i].name);
+	}
+	free(manifest->entries);
+	free(manifest->table);
+	free(manifest);
+}
@@ -0,0 +1,39 @@
+#ifndef MANIFEST_H
+#define MANIFEST_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <sys/stat.h>
+#include "eeprom_ops.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Incremental run manifest
+// ═══════════════════════════════════════════════════════════════
+// One line per image: path, size, mtime, inode and the EEPROMCheck of the
+// previous run. Files whose size/mtime/inode did not change are not read
+// again; their stored result is merged into the current run's output.
+// Files that held no image are recorded as skipped (version 0).
+
+typedef struct Manifest Manifest;
+
+// Load a manifest; a missing file gives an empty manifest
+Manifest *manifest_load(const char *path);
+
+// Returns the stored result if name is known and unchanged, NULL otherwise;
+// skipped is set for files recorded with manifest_skip(). Found entries
+// are kept for the next manifest_save().
+const EEPROMCheck *manifest_lookup(Manifest *manifest, const char *name, const struct stat *st,
+								   int *skipped);
+
+// Record a fresh result for name
+void manifest_update(Manifest *manifest, const char *name, const struct stat *st,
+					 const EEPROMCheck *check);
+// Record that name holds no image (not a dump, or extraction failed)
+void manifest_skip(Manifest *manifest, const char *name, const struct stat *st);
+
+// Write entries seen in this run (atomically); files that disappeared are dropped
+int manifest_save(const Manifest *manifest, const char *path);
+
+void manifest_free(Manifest *manifest);
+
+#endif // MANIFEST_H
@@ -0,0 +1,646 @@
+#include "pair.h"
+#include "batch.h"
+#include "eeprom_structure.h"
+#include "ui.h"
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+// Board Fields
+// ═══════════════════════════════════════════════════════════════
+
+// Printable text without padding (NUL, 0xFF, surrounding spaces)
+static void text_copy(char *dst, size_t dst_size, const char *src, size_t src_size)
+{
+	size_t start = 0, end = 0;
+	while (end < src_size && src[end] != '\0' && (uint8_t)src[end] != 0xFF)
+	{
+		end++;
+	}
+	while (start < end && src[start] == ' ')
+	{
+		start++;
+	}
+	while (end > start && src[end - 1] == ' ')
+	{
+		end--;
+	}
+
+	size_t n = 0;
+	for (size_t i = start; i < end && n + 1 < dst_size; i++)
+	{
+		dst[n++] = (src[i] >= 0x20 && src[i] < 0x7F) ? src[i] : '?';
+	}
+	dst[n] = '\0';
+}
+
+int pair_board_read(const uint8_t *decoded, const EEPROMCheck *check, PairBoard *board)
+{
+	// v17 has neither a board name nor PT2 fields
+	if (check->version != EEPROM_VERSION_V1 && check->version != EEPROM_VERSION_V4 &&
+		check->version != EEPROM_VERSION_V5 && check->version != EEPROM_VERSION_V6)
+	{
+		return -1;
+	}
+
+	memset(board, 0, sizeof(*board));
+	board->pt2_pass = (check->crc_ok & check->test_pass & 0x02) != 0;
+
+	if (check->version == EEPROM_VERSION_V1)
+	{
+		EEPROMStructure_v1 eeprom;
+		eeprom_v1_parse(&eeprom, decoded);
+		text_copy(board->serial, sizeof(board->serial), eeprom.pt1_data.board_serial,
+				  sizeof(eeprom.pt1_data.board_serial));
+		text_copy(board->board, sizeof(board->board), eeprom.board_name, sizeof(eeprom.board_name));
+		board->voltage = eeprom.pt2_data.voltage;
+		board->frequency = eeprom.pt2_data.frequency;
+		board->nonce_rate = eeprom.pt2_data.nonce_rate;
+		board->sweep_hashrate = eeprom.sweep_data.sweep_hashrate;
+	}
+	else
+	{
+		EEPROMStructure eeprom;
+		eeprom_from_bytes(&eeprom, decoded);
+		text_copy(board->serial, sizeof(board->serial), eeprom.board_info.board_sn,
+				  sizeof(eeprom.board_info.board_sn));
+		text_copy(board->board, sizeof(board->board), eeprom.board_info.board_name,
+				  sizeof(eeprom.board_info.board_name));
+		board->voltage = eeprom.test_params.voltage;
+		board->frequency = eeprom.test_params.frequency;
+		board->nonce_rate = eeprom.test_params.nonce_rate;
+		board->sweep_hashrate = eeprom.sweep_data.sweep_hashrate;
+	}
+
+	// Sweep data exists in v1 and v5/v6 only
+	SweepBoard sweep;
+	board->has_sweep = sweep_board(decoded, check, &sweep) == 0;
+	if (board->has_sweep)
+	{
+		board->freq_base = sweep.freq_base;
+		board->freq_step = sweep.freq_step;
+		memcpy(board->levels, sweep.levels, SWEEP_LEVEL_BYTES);
+	}
+	else
+	{
+		board->sweep_hashrate = 0;
+	}
+	return 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Inventory
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	pthread_key_t key;             // Per-thread PairInventory
+	pthread_mutex_t lock;
+	PairInventory *total;
+	int failed;                    // Out of memory
+} InventoryLoad;
+
+typedef struct
+{
+	InventoryLoad *load;
+	PairInventory inventory;
+} InventoryWorker;
+
+static int inventory_reserve(PairInventory *inventory, size_t count)
+{
+	if (count <= inventory->capacity)
+	{
+		return 0;
+	}
+	size_t capacity = inventory->capacity ? inventory->capacity * 2 : 1024;
+	while (capacity < count)
+	{
+		capacity *= 2;
+	}
+	PairBoard *boards = realloc(inventory->boards, capacity * sizeof(PairBoard));
+	if (!boards)
+	{
+		return -1;
+	}
+	inventory->boards = boards;
+	inventory->capacity = capacity;
+	return 0;
+}
+
+// Key destructor: append a worker's boards to the total on thread exit
+static void inventory_retire(void *ptr)
+{
+	InventoryWorker *worker = (InventoryWorker*)ptr;
+	InventoryLoad *load = worker->load;
+	PairInventory *total = load->total;
+	PairInventory *own = &worker->inventory;
+
+	pthread_mutex_lock(&load->lock);
+	if (inventory_reserve(total, total->count + own->count) == 0)
+	{
+		if (own->count)
+		{
+			memcpy(total->boards + total->count, own->boards, own->count * sizeof(PairBoard));
+		}
+		total->count += own->count;
+	}
+	else
+	{
+		load->failed = 1;
+	}
+	total->images += own->images;
+	total->with_sweep += own->with_sweep;
+	total->skipped += own->skipped;
+	pthread_mutex_unlock(&load->lock);
+
+	free(own->boards);
+	free(worker);
+}
+
+static int inventory_image(const char *name, const uint8_t *raw, size_t size, void *ctx)
+{
+	(void)name;
+	InventoryLoad *load = (InventoryLoad*)ctx;
+	InventoryWorker *worker = pthread_getspecific(load->key);
+	if (!worker)
+	{
+		if (!(worker = calloc(1, sizeof(InventoryWorker))))
+		{
+			load->failed = 1;
+			return 1;
+		}
+		worker->load = load;
+		pthread_setspecific(load->key, worker);
+	}
+
+	PairInventory *inventory = &worker->inventory;
+	uint8_t data[EEPROM_SIZE];
+	memset(data, 0xFF, sizeof(data));
+	memcpy(data, raw, size);
+
+	inventory->images++;
+	EEPROMCheck check;
+	if (batch_decode(data, &check) == EEPROM_ERROR_VERSION ||
+		inventory_reserve(inventory, inventory->count + 1) != 0 ||
+		pair_board_read(data, &check, &inventory->boards[inventory->count]) != 0)
+	{
+		inventory->skipped++;
+		return 0;
+	}
+	inventory->with_sweep += inventory->boards[inventory->count].has_sweep;
+	inventory->count++;
+	return 0;
+}
+
+static int board_compare(const void *a, const void *b)
+{
+	const PairBoard *x = (const PairBoard*)a;
+	const PairBoard *y = (const PairBoard*)b;
+	int order = strcmp(x->serial, y->serial);
+	return order ? order : memcmp(x, y, sizeof(PairBoard));
+}
+
+int pair_inventory_load(char **paths, int count, PairInventory *inventory)
+{
+	memset(inventory, 0, sizeof(*inventory));
+
+	InventoryLoad load;
+	memset(&load, 0, sizeof(load));
+	load.total = inventory;
+	if (pthread_key_create(&load.key, inventory_retire) != 0)
+	{
+		fprintf(stderr, "Error: Out of memory\n");
+		return -1;
+	}
+	pthread_mutex_init(&load.lock, NULL);
+
+	int result = batch_for_each_parallel(paths, count, inventory_image, &load, NULL);
+
+	InventoryWorker *own = pthread_getspecific(load.key);
+	if (own)
+	{
+		pthread_setspecific(load.key, NULL);
+		inventory_retire(own);
+	}
+	pthread_key_delete(load.key);
+	pthread_mutex_destroy(&load.lock);
+
+	if (load.failed)
+	{
+		fprintf(stderr, "Error: Out of memory\n");
+		pair_inventory_free(inventory);
+		return -1;
+	}
+
+	// Workers finish in any order; sorting makes runs repeatable
+	qsort(inventory->boards, inventory->count, sizeof(PairBoard), board_compare);
+	return result;
+}
+
+void pair_inventory_free(PairInventory *inventory)
+{
+	free(inventory->boards);
+	memset(inventory, 0, sizeof(*inventory));
+}
+
+const PairBoard *pair_inventory_find(const PairInventory *inventory, const char *serial)
+{
+	size_t lo = 0, hi = inventory->count;
+	while (lo < hi)
+	{
+		size_t mid = lo + (hi - lo) / 2;
+		if (strcmp(inventory->boards[mid].serial, serial) < 0)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	return lo < inventory->count && strcmp(inventory->boards[lo].serial, serial) == 0 ? &inventory->boards[lo] : NULL;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Quantized Index
+// ═══════════════════════════════════════════════════════════════
+
+int pair_index_build(PairIndex *index, const PairInventory *inventory, const TopologyDB *topologies)
+{
+	memset(index, 0, sizeof(*index));
+	if (inventory->count == 0)
+	{
+		return 0;
+	}
+	if (posix_memalign((void**)&index->vectors, 16, inventory->count * PAIR_DIMS) != 0)
+	{
+		fprintf(stderr, "Error: Out of memory\n");
+		index->vectors = NULL;
+		return -1;
+	}
+	index->count = inventory->count;
+
+	// Frequencies are base + level * step, so the fleet range follows
+	// from the bases and steps alone
+	uint32_t lo = UINT16_MAX, hi = 0;
+	for (size_t i = 0; i < inventory->count; i++)
+	{
+		const PairBoard *board = &inventory->boards[i];
+		if (!board->has_sweep)
+		{
+			continue;
+		}
+		uint32_t top = board->freq_base + (SWEEP_LEVELS - 1) * board->freq_step;
+		lo = board->freq_base < lo ? board->freq_base : lo;
+		hi = top > hi ? top : hi;
+	}
+	index->offset = (uint16_t)(lo <= hi ? lo : 0);
+	index->scale = (uint16_t)(lo <= hi ? (hi - lo + 254) / 255 : 1);
+	index->scale = index->scale ? index->scale : 1;
+
+	for (size_t i = 0; i < inventory->count; i++)
+	{
+		const PairBoard *board = &inventory->boards[i];
+		uint8_t *vector = index->vectors + i * PAIR_DIMS;
+		if (!board->has_sweep)
+		{
+			memset(vector, 0, PAIR_DIMS);
+			continue;
+		}
+		uint16_t freq[PAIR_DIMS];
+		sweep_expand(board->levels, SWEEP_LEVEL_BYTES, board->freq_base, board->freq_step, freq);
+
+		const SweepTopology *chain = topology_chain(topologies, board->board);
+		size_t asics = chain && chain->chain_asic_num < PAIR_DIMS ? (size_t)chain->chain_asic_num : PAIR_DIMS;
+		for (size_t a = 0; a < asics; a++)
+		{
+			uint32_t q = (freq[a] - index->offset + index->scale / 2u) / index->scale;
+			vector[a] = (uint8_t)(q < 255 ? q : 255);
+		}
+		memset(vector + asics, 0, PAIR_DIMS - asics);
+	}
+	return 0;
+}
+
+void pair_index_free(PairIndex *index)
+{
+	free(index->vectors);
+	memset(index, 0, sizeof(*index));
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Distance Kernels
+// ═══════════════════════════════════════════════════════════════
+// Vectors are PAIR_DIMS bytes (a multiple of 16) and 16-byte aligned.
+
+static inline uint32_t distance_l1(const uint8_t *a, const uint8_t *b)
+{
+#if defined(__SSE2__)
+	// SAD sums 8 absolute differences into each 64-bit half
+	__m128i acc = _mm_setzero_si128();
+	for (size_t i = 0; i < PAIR_DIMS; i += 16)
+	{
+		__m128i x = _mm_load_si128((const __m128i*)(a + i));
+		__m128i y = _mm_load_si128((const __m128i*)(b + i));
+		acc = _mm_add_epi64(acc, _mm_sad_epu8(x, y));
+	}
+	return (uint32_t)(_mm_cvtsi128_si32(acc) + _mm_cvtsi128_si32(_mm_srli_si128(acc, 8)));
+#elif defined(__ARM_NEON)
+	uint16x8_t acc = vdupq_n_u16(0);
+	for (size_t i = 0; i < PAIR_DIMS; i += 16)
+	{
+		acc = vpadalq_u8(acc, vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i)));
+	}
+	uint64x2_t sum = vpaddlq_u32(vpaddlq_u16(acc));
+	return (uint32_t)(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+#else
+	uint32_t sum = 0;
+	for (size_t i = 0; i < PAIR_DIMS; i++)
+	{
+		sum += (uint32_t)abs(a[i] - b[i]);
+	}
+	return sum;
+#endif
+}
+
+static inline uint32_t distance_l2(const uint8_t *a, const uint8_t *b)
+{
+#if defined(__SSE2__)
+	// |a - b| from two saturating subtractions, widened to 16 bits and
+	// squared + pairwise added by madd
+	const __m128i zero = _mm_setzero_si128();
+	__m128i acc = _mm_setzero_si128();
+	for (size_t i = 0; i < PAIR_DIMS; i += 16)
+	{
+		__m128i x = _mm_load_si128((const __m128i*)(a + i));
+		__m128i y = _mm_load_si128((const __m128i*)(b + i));
+		__m128i d = _mm_or_si128(_mm_subs_epu8(x, y), _mm_subs_epu8(y, x));
+		__m128i lo = _mm_unpacklo_epi8(d, zero);
+		__m128i hi = _mm_unpackhi_epi8(d, zero);
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(lo, lo));
+		acc = _mm_add_epi32(acc, _mm_madd_epi16(hi, hi));
+	}
+	acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 8));
+	acc = _mm_add_epi32(acc, _mm_srli_si128(acc, 4));
+	return (uint32_t)_mm_cvtsi128_si32(acc);
+#elif defined(__ARM_NEON)
+	uint32x4_t acc = vdupq_n_u32(0);
+	for (size_t i = 0; i < PAIR_DIMS; i += 16)
+	{
+		uint8x16_t d = vabdq_u8(vld1q_u8(a + i), vld1q_u8(b + i));
+		acc = vpadalq_u16(acc, vmull_u8(vget_low_u8(d), vget_low_u8(d)));
+		acc = vpadalq_u16(acc, vmull_u8(vget_high_u8(d), vget_high_u8(d)));
+	}
+	uint64x2_t sum = vpaddlq_u32(acc);
+	return (uint32_t)(vgetq_lane_u64(sum, 0) + vgetq_lane_u64(sum, 1));
+#else
+	uint32_t sum = 0;
+	for (size_t i = 0; i < PAIR_DIMS; i++)
+	{
+		int d = a[i] - b[i];
+		sum += (uint32_t)(d * d);
+	}
+	return sum;
+#endif
+}
+
+uint32_t pair_distance(const uint8_t *a, const uint8_t *b, PairMetric metric)
+{
+	return metric == PAIR_L2 ? distance_l2(a, b) : distance_l1(a, b);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// k-NN Search
+// ═══════════════════════════════════════════════════════════════
+
+// Insert into hits (sorted, nearest first) if it beats the current k-th
+static size_t hits_insert(PairHit *hits, size_t count, size_t k, size_t board, uint32_t distance)
+{
+	if (count == k && distance >= hits[k - 1].distance)
+	{
+		return count;
+	}
+	size_t i = count < k ? count++ : k - 1;
+	while (i > 0 && hits[i - 1].distance > distance)
+	{
+		hits[i] = hits[i - 1];
+		i--;
+	}
+	hits[i].board = board;
+	hits[i].distance = distance;
+	return count;
+}
+
+// Candidate filter; shared by both metric loops
+static int pair_eligible(const PairBoard *query, const PairBoard *candidate, int same_board, int max_voltage_diff)
+{
+	if (!candidate->has_sweep || strcmp(candidate->serial, query->serial) == 0)
+	{
+		return 0;
+	}
+	if (same_board && strcmp(candidate->board, query->board) != 0)
+	{
+		return 0;
+	}
+	return max_voltage_diff < 0 || abs((int)candidate->voltage - (int)query->voltage) <= max_voltage_diff;
+}
+
+size_t pair_search(const PairIndex *index, const PairInventory *inventory, size_t query,
+				   PairMetric metric, int same_board, int max_voltage_diff, PairHit *hits, size_t k)
+{
+	const PairBoard *target = &inventory->boards[query];
+	const uint8_t *q = index->vectors + query * PAIR_DIMS;
+	size_t count = 0;
+	if (k == 0)
+	{
+		return 0;
+	}
+
+	// One loop per metric keeps the kernel inlined in the scan
+	if (metric == PAIR_L2)
+	{
+		for (size_t i = 0; i < index->count; i++)
+		{
+			uint32_t distance = distance_l2(q, index->vectors + i * PAIR_DIMS);
+			if ((count < k || distance < hits[k - 1].distance) &&
+				pair_eligible(target, &inventory->boards[i], same_board, max_voltage_diff))
+			{
+				count = hits_insert(hits, count, k, i, distance);
+			}
+		}
+	}
+	else
+	{
+		for (size_t i = 0; i < index->count; i++)
+		{
+			uint32_t distance = distance_l1(q, index->vectors + i * PAIR_DIMS);
+			if ((count < k || distance < hits[k - 1].distance) &&
+				pair_eligible(target, &inventory->boards[i], same_board, max_voltage_diff))
+			{
+				count = hits_insert(hits, count, k, i, distance);
+			}
+		}
+	}
+	return count;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+#define PAIR_MAX_K 100
+
+static double elapsed_ms(const struct timespec *start, const struct timespec *end)
+{
+	return (end->tv_sec - start->tv_sec) * 1e3 + (end->tv_nsec - start->tv_nsec) / 1e6;
+}
+
+// Mean (L1) or RMS (L2) per-ASIC frequency gap in MHz
+static double hit_mhz(const PairIndex *index, PairMetric metric, uint32_t distance, size_t asics)
+{
+	double per_asic = (double)distance / (double)asics;
+	return (metric == PAIR_L2 ? sqrt(per_asic) : per_asic) * index->scale;
+}
+
+int cmd_pair(int argc, char **argv)
+{
+	char *serials = NULL;
+	const char *topology_dir = NULL;
+	size_t k = 10;
+	PairMetric metric = PAIR_L2;
+	int same_board = 1;
+	int max_voltage_diff = -1;
+	char *paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+		{
+			serials = argv[++i];
+		}
+		else if (strcmp(argv[i], "-k") == 0 && i + 1 < argc)
+		{
+			k = strtoul(argv[++i], NULL, 10);
+			k = k < 1 ? 1 : k > PAIR_MAX_K ? PAIR_MAX_K : k;
+		}
+		else if (strcmp(argv[i], "-m") == 0 && i + 1 < argc)
+		{
+			const char *name = argv[++i];
+			if (strcmp(name, "l1") != 0 && strcmp(name, "l2") != 0)
+			{
+				fprintf(stderr, "Error: Unknown metric '%s' (l1, l2)\n", name);
+				return 1;
+			}
+			metric = name[1] == '1' ? PAIR_L1 : PAIR_L2;
+		}
+		else if (strcmp(argv[i], "-a") == 0)
+		{
+			same_board = 0;
+		}
+		else if (strcmp(argv[i], "-V") == 0 && i + 1 < argc)
+		{
+			max_voltage_diff = (int)lround(strtod(argv[++i], NULL) * 100.0);
+		}
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			topology_dir = argv[++i];
+		}
+		else
+		{
+			paths[path_count++] = argv[i];
+		}
+	}
+
+	if (path_count == 0 || !serials)
+	{
+		fprintf(stderr, "Usage: eeprom_tool pair -s SERIAL[,SERIAL...] [-k N] [-m l1|l2] [-a]\n"
+						"                         [-V VOLTS] [-t TOPOLOGY_DIR] PATH...\n");
+		return 1;
+	}
+
+	TopologyDB *topologies = NULL;
+	if (topology_dir && !(topologies = topology_open(topology_dir)))
+	{
+		return 1;
+	}
+
+	struct timespec start, loaded, indexed;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	PairInventory inventory;
+	PairIndex index;
+	if (pair_inventory_load(paths, path_count, &inventory) < 0 && inventory.count == 0)
+	{
+		topology_close(topologies);
+		return 1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &loaded);
+	if (pair_index_build(&index, &inventory, topologies) != 0)
+	{
+		pair_inventory_free(&inventory);
+		topology_close(topologies);
+		return 1;
+	}
+	clock_gettime(CLOCK_MONOTONIC, &indexed);
+
+	fprintf(stderr, "Boards: %zu with sweep data of %zu images (read %.0f ms, index %.1f ms)\n",
+			inventory.with_sweep, inventory.images, elapsed_ms(&start, &loaded), elapsed_ms(&loaded, &indexed));
+
+	int result = 0;
+	PairHit hits[PAIR_MAX_K];
+	EmitBuffer buf = { 0 };
+	for (char *serial = strtok(serials, ","); serial; serial = strtok(NULL, ","))
+	{
+		const PairBoard *query = pair_inventory_find(&inventory, serial);
+		if (!query || !query->has_sweep)
+		{
+			fprintf(stderr, "Error: No board with serial '%s' and sweep data\n", serial);
+			result = 1;
+			continue;
+		}
+
+		struct timespec begin, end;
+		clock_gettime(CLOCK_MONOTONIC, &begin);
+		size_t count = pair_search(&index, &inventory, (size_t)(query - inventory.boards), metric,
+								   same_board, max_voltage_diff, hits, k);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		const SweepTopology *chain = topology_chain(topologies, query->board);
+		size_t asics = chain && chain->chain_asic_num < PAIR_DIMS ? (size_t)chain->chain_asic_num : PAIR_DIMS;
+
+		char title[96];
+		snprintf(title, sizeof(title), "%s (%s, %.2f V, %u MHz)", query->serial, query->board,
+				 query->voltage / 100.0, query->frequency);
+		ui_render_category_header(&buf, title);
+		ui_appendf(&buf, "  %3s %-20s %-10s %8s %6s %12s\n", "#", "Serial", "Board", "PT2 V", "MHz",
+				   metric == PAIR_L2 ? "RMS MHz" : "Mean MHz");
+		for (size_t i = 0; i < count; i++)
+		{
+			const PairBoard *board = &inventory.boards[hits[i].board];
+			ui_appendf(&buf, "  %3zu %-20s %-10s %8.2f %6u %12.2f\n", i + 1, board->serial, board->board,
+					   board->voltage / 100.0, board->frequency, hit_mhz(&index, metric, hits[i].distance, asics));
+		}
+		ui_appendf(&buf, "  %zu boards scanned in %.2f ms\n", index.count, elapsed_ms(&begin, &end));
+	}
+	ui_flush(&buf);
+	emit_buffer_free(&buf);
+
+	pair_index_free(&index);
+	pair_inventory_free(&inventory);
+	topology_close(topologies);
+	return result;
+}
@@ -0,0 +1,95 @@
+#ifndef PAIR_H
+#define PAIR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "eeprom_ops.h"
+#include "sweep.h"
+#include "topology.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Hashboard Pairing
+// ═══════════════════════════════════════════════════════════════
+// An inventory holds the pairing-relevant fields of every board with a
+// board name (v1, v4-v6). The index quantizes each board's expanded
+// frequency vector (one byte per ASIC, fleet-wide offset and scale) into
+// one contiguous 16-byte aligned matrix, so a k-nearest-neighbour query
+// is a single SIMD pass of L1 (SAD) or L2 distances over the archive.
+// Boards without sweep data stay in the inventory but never match.
+
+#define PAIR_DIMS       SWEEP_MAX_ASICS
+#define PAIR_SERIAL_LEN 20
+
+typedef struct
+{
+	char serial[PAIR_SERIAL_LEN];  // Board serial without padding
+	char board[TOPOLOGY_NAME_LEN]; // Board name, e.g. "BHB68701"
+	uint16_t voltage;              // PT2 PSU voltage, hundredths of a volt
+	uint16_t frequency;            // PT2 frequency, MHz
+	uint16_t nonce_rate;           // PT2 nonce rate
+	uint16_t sweep_hashrate;
+	uint8_t pt2_pass;              // PT2 region CRC and result good
+	uint8_t has_sweep;             // Sweep region with a good CRC; 0 = no levels
+	uint8_t freq_step;
+	uint8_t reserved;
+	uint16_t freq_base;
+	uint8_t levels[SWEEP_LEVEL_BYTES];
+} PairBoard;
+
+typedef struct
+{
+	PairBoard *boards;             // Sorted by serial
+	size_t count;
+	size_t capacity;
+	size_t images;                 // Images read
+	size_t with_sweep;             // Boards with has_sweep
+	size_t skipped;                // Unknown version or v17
+} PairInventory;
+
+typedef enum
+{
+	PAIR_L1,
+	PAIR_L2
+} PairMetric;
+
+typedef struct
+{
+	uint8_t *vectors;              // count * PAIR_DIMS, row i = inventory board i
+	size_t count;
+	uint16_t offset;               // MHz of quantized 0
+	uint16_t scale;                // MHz per quantized step
+} PairIndex;
+
+typedef struct
+{
+	size_t board;                  // Inventory row
+	uint32_t distance;             // In quantized units (squared for L2)
+} PairHit;
+
+// Pairing fields of a decoded image; -1 for v17 and unknown layouts
+int pair_board_read(const uint8_t *decoded, const EEPROMCheck *check, PairBoard *board);
+
+// Read every image under paths on the batch worker threads
+int pair_inventory_load(char **paths, int count, PairInventory *inventory);
+void pair_inventory_free(PairInventory *inventory);
+// First board with this serial, NULL if none
+const PairBoard *pair_inventory_find(const PairInventory *inventory, const char *serial);
+
+// Quantize the inventory. ASICs past the chain_asic_num of a board's
+// topology (if topologies is given) are zeroed so they do not count.
+int pair_index_build(PairIndex *index, const PairInventory *inventory, const TopologyDB *topologies);
+void pair_index_free(PairIndex *index);
+
+uint32_t pair_distance(const uint8_t *a, const uint8_t *b, PairMetric metric);
+
+// Up to k nearest boards to row query, nearest first, skipping the
+// query's serial and boards without sweep data. With same_board only
+// boards of the same name match; max_voltage_diff (hundredths, < 0 = any) bounds the PT2 voltage gap.
+size_t pair_search(const PairIndex *index, const PairInventory *inventory, size_t query,
+				   PairMetric metric, int same_board, int max_voltage_diff, PairHit *hits, size_t k);
+
+// CLI: eeprom_tool pair -s SERIAL[,SERIAL...] [-k N] [-m l1|l2] [-a]
+//                       [-V VOLTS] [-t TOPOLOGY_DIR] PATH...
+int cmd_pair(int argc, char **argv);
+
+#endif // PAIR_H
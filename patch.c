@@ -0,0 +1,921 @@
+#include "patch.h"
+#include "batch.h"
+#include "eeprom_ops.h"
+#include "eeprom_structure.h"
+#include "field_index.h"
+#include <ctype.h>
+#include <errno.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Spec Loading
+// ═══════════════════════════════════════════════════════════════
+
+static int spec_add(PatchSpec *spec, const char *serial, const char *field, const char *value)
+{
+	if (spec->count == spec->capacity)
+	{
+		size_t capacity = spec->capacity ? spec->capacity * 2 : 64;
+		PatchAssign *items = realloc(spec->items, capacity * sizeof(*items));
+		if (!items)
+		{
+			fprintf(stderr, "Error: Out of memory\n");
+			return -1;
+		}
+		spec->items = items;
+		spec->capacity = capacity;
+	}
+
+	PatchAssign *item = &spec->items[spec->count];
+	item->order = spec->count++;
+	snprintf(item->serial, sizeof(item->serial), "%s", serial);
+	snprintf(item->field, sizeof(item->field), "%s", field);
+	snprintf(item->value, sizeof(item->value), "%s", value);
+	return 0;
+}
+
+// Strip surrounding whitespace in place
+static char *trim(char *s)
+{
+	while (isspace((unsigned char)*s))
+	{
+		s++;
+	}
+	char *end = s + strlen(s);
+	while (end > s && isspace((unsigned char)end[-1]))
+	{
+		*--end = '\0';
+	}
+	return s;
+}
+
+// field=value lines, [SERIAL] sections, '#' comment lines ('#' inside a
+// value is kept)
+static int spec_parse_lines(char *text, PatchSpec *spec, const char *path)
+{
+	char serial[PATCH_SERIAL_MAX] = "";
+	int line_no = 0;
+
+	// strsep keeps empty lines so line numbers stay exact
+	for (char *line; (line = strsep(&text, "\n")) != NULL; )
+	{
+		line_no++;
+		line = trim(line);
+		if (!*line || line[0] == '#')
+		{
+			continue;
+		}
+
+		if (line[0] == '[')
+		{
+			char *end = strchr(line, ']');
+			if (!end)
+			{
+				fprintf(stderr, "Error: %s:%d: missing ']'\n", path, line_no);
+				return -1;
+			}
+			*end = '\0';
+			snprintf(serial, sizeof(serial), "%s", trim(line + 1));
+			continue;
+		}
+
+		char *eq = strchr(line, '=');
+		if (!eq)
+		{
+			fprintf(stderr, "Error: %s:%d: expected field=value\n", path, line_no);
+			return -1;
+		}
+		*eq = '\0';
+		if (spec_add(spec, serial, trim(line), trim(eq + 1)) != 0)
+		{
+			return -1;
+		}
+	}
+	return 0;
+}
+
+// Header row names the fields; the first column is the serial
+static int spec_parse_csv(char *text, PatchSpec *spec, const char *path)
+{
+	char *columns[64];
+	int column_count = 0;
+	int line_no = 0;
+
+	for (char *line; (line = strsep(&text, "\n")) != NULL; )
+	{
+		line_no++;
+		line = trim(line);
+		if (!*line || line[0] == '#')
+		{
+			continue;
+		}
+
+		// Split on commas, keeping empty cells
+		char *cells[64];
+		int cell_count = 0;
+		for (char *p = line; cell_count < 64; )
+		{
+			char *comma = strchr(p, ',');
+			if (comma)
+			{
+				*comma = '\0';
+			}
+			cells[cell_count++] = trim(p);
+			if (!comma)
+			{
+				break;
+			}
+			p = comma + 1;
+		}
+
+		if (column_count == 0)
+		{
+			for (int i = 0; i < cell_count; i++)
+			{
+				columns[column_count++] = cells[i];
+			}
+			continue;
+		}
+
+		if (!cells[0][0])
+		{
+			fprintf(stderr, "Error: %s:%d: empty serial\n", path, line_no);
+			return -1;
+		}
+		for (int i = 1; i < cell_count && i < column_count; i++)
+		{
+			if (cells[i][0] && spec_add(spec, cells[0], columns[i], cells[i]) != 0)
+			{
+				return -1;
+			}
+		}
+	}
+	return 0;
+}
+
+// Minimal JSON: one object of scalars, optionally nested one level by serial
+typedef struct
+{
+	const char *p;
+	const char *path;
+} JsonReader;
+
+static void json_space(JsonReader *json)
+{
+	while (isspace((unsigned char)*json->p))
+	{
+		json->p++;
+	}
+}
+
+static int json_fail(JsonReader *json, const char *what)
+{
+	fprintf(stderr, "Error: %s: %s near '%.16s'\n", json->path, what, json->p);
+	return -1;
+}
+
+// String or bare scalar (number, true/false) into buf
+static int json_scalar(JsonReader *json, char *buf, size_t size)
+{
+	size_t n = 0;
+	json_space(json);
+
+	if (*json->p == '"')
+	{
+		json->p++;
+		while (*json->p && *json->p != '"')
+		{
+			char c = *json->p++;
+			if (c == '\\' && *json->p)
+			{
+				c = *json->p++;
+			}
+			if (n + 1 < size)
+			{
+				buf[n++] = c;
+			}
+		}
+		if (*json->p != '"')
+		{
+			return json_fail(json, "unterminated string");
+		}
+		json->p++;
+	}
+	else
+	{
+		while (*json->p && !isspace((unsigned char)*json->p) && *json->p != ',' && *json->p != '}')
+		{
+			if (n + 1 < size)
+			{
+				buf[n++] = *json->p;
+			}
+			json->p++;
+		}
+		if (n == 0)
+		{
+			return json_fail(json, "expected a value");
+		}
+	}
+
+	buf[n] = '\0';
+	return 0;
+}
+
+static int json_object(JsonReader *json, PatchSpec *spec, const char *serial)
+{
+	json_space(json);
+	if (*json->p++ != '{')
+	{
+		return json_fail(json, "expected '{'");
+	}
+
+	json_space(json);
+	if (*json->p == '}')
+	{
+		json->p++;
+		return 0;
+	}
+
+	for (;;)
+	{
+		char key[64];
+		if (json_scalar(json, key, sizeof(key)) != 0)
+		{
+			return -1;
+		}
+		json_space(json);
+		if (*json->p++ != ':')
+		{
+			return json_fail(json, "expected ':'");
+		}
+		json_space(json);
+
+		if (*json->p == '{')
+		{
+			if (serial[0])
+			{
+				return json_fail(json, "objects nest only one level");
+			}
+			if (json_object(json, spec, key) != 0)
+			{
+				return -1;
+			}
+		}
+		else
+		{
+			char value[PATCH_VALUE_MAX];
+			if (json_scalar(json, value, sizeof(value)) != 0 || spec_add(spec, serial, key, value) != 0)
+			{
+				return -1;
+			}
+		}
+
+		json_space(json);
+		if (*json->p == ',')
+		{
+			json->p++;
+			continue;
+		}
+		if (*json->p++ == '}')
+		{
+			return 0;
+		}
+		return json_fail(json, "expected ',' or '}'");
+	}
+}
+
+// "" (global) sorts first; spec order breaks ties so later lines win
+// within a serial
+static int assign_compare(const void *a, const void *b)
+{
+	const PatchAssign *x = (const PatchAssign*)a;
+	const PatchAssign *y = (const PatchAssign*)b;
+	int order = strcmp(x->serial, y->serial);
+	if (order != 0)
+	{
+		return order;
+	}
+	return x->order < y->order ? -1 : x->order > y->order;
+}
+
+int patch_spec_load(const char *path, PatchSpec *spec)
+{
+	memset(spec, 0, sizeof(*spec));
+
+	FILE *file = fopen(path, "rb");
+	if (!file)
+	{
+		fprintf(stderr, "Error: Cannot open spec %s\n", path);
+		return -1;
+	}
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	char *text = malloc(size > 0 ? (size_t)size + 1 : 1);
+	if (!text)
+	{
+		fclose(file);
+		fprintf(stderr, "Error: Out of memory\n");
+		return -1;
+	}
+	size_t n = fread(text, 1, size > 0 ? (size_t)size : 0, file);
+	fclose(file);
+	text[n] = '\0';
+
+	const char *ext = strrchr(path, '.');
+	char *start = trim(text);
+	int result;
+
+	// Sniff the first line that is not blank or a comment: a comment may
+	// hold commas of its own
+	const char *first = start;
+	while (*first == '#')
+	{
+		first += strcspn(first, "\n");
+		while (isspace((unsigned char)*first))
+		{
+			first++;
+		}
+	}
+	size_t first_len = strcspn(first, "\n");
+	const char *comma = memchr(first, ',', first_len);
+	const char *eq = memchr(first, '=', first_len);
+
+	if (start[0] == '{' || (ext && strcasecmp(ext, ".json") == 0))
+	{
+		JsonReader json = { start, path };
+		result = json_object(&json, spec, "");
+		json_space(&json);
+		if (result == 0 && *json.p)
+		{
+			result = json_fail(&json, "trailing data");
+		}
+	}
+	else if ((ext && strcasecmp(ext, ".csv") == 0) || (comma && (!eq || comma < eq)))
+	{
+		result = spec_parse_csv(start, spec, path);
+	}
+	else
+	{
+		result = spec_parse_lines(start, spec, path);
+	}
+	free(text);
+
+	if (result == 0 && spec->count == 0)
+	{
+		fprintf(stderr, "Error: %s: no field assignments\n", path);
+		result = -1;
+	}
+	if (result != 0)
+	{
+		patch_spec_free(spec);
+		return -1;
+	}
+
+	qsort(spec->items, spec->count, sizeof(*spec->items), assign_compare);
+	while (spec->global_count < spec->count && !spec->items[spec->global_count].serial[0])
+	{
+		spec->global_count++;
+	}
+	return 0;
+}
+
+void patch_spec_free(PatchSpec *spec)
+{
+	free(spec->items);
+	memset(spec, 0, sizeof(*spec));
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Applying Assignments
+// ═══════════════════════════════════════════════════════════════
+
+int patch_set_field(void *eeprom, EEPROMVersion version, const char *name, const char *value,
+					char *error, size_t error_size)
+{
+	const FieldMetadata *field = field_index_find(version, name);
+	const FieldMetadata *members[2];
+	if (!field && field_index_members(version, name, members, 2) > 1)
+	{
+		snprintf(error, error_size, "'%s' is ambiguous in v%d images: use %s or %s",
+				 name, version, members[0]->path, members[1]->path);
+		return -1;
+	}
+	if (!field || !eeprom_field_in_layout(field, eeprom_get_layout(version)))
+	{
+		snprintf(error, error_size, "no field '%s' in v%d images", name, version);
+		return -1;
+	}
+	if (field->read_only)
+	{
+		snprintf(error, error_size, "'%s' is read-only", field->name);
+		return -1;
+	}
+
+	uint8_t *ptr = (uint8_t*)eeprom + field->offset;
+	uint8_t bytes[PATCH_VALUE_MAX];
+	memset(bytes, 0, sizeof(bytes));
+
+	switch (field->type)
+	{
+		case FIELD_TYPE_UINT8:
+		case FIELD_TYPE_HEX8:
+		case FIELD_TYPE_INT8:
+		case FIELD_TYPE_UINT16:
+		case FIELD_TYPE_HEX16:
+		case FIELD_TYPE_VOLTAGE:
+		case FIELD_TYPE_HASHRATE:
+		{
+			char *end;
+			errno = 0;
+			double number = strtod(value, &end);
+			int decimal = strchr(value, '.') != NULL;
+			if (!decimal)
+			{
+				number = (double)strtol(value, &end, 0);
+			}
+			if (end == value || *end || errno)
+			{
+				snprintf(error, error_size, "'%s': '%s' is not a number", field->name, value);
+				return -1;
+			}
+
+			// Decimal voltage/hashrate values are in V or TH/s
+			if (decimal && (field->type == FIELD_TYPE_VOLTAGE || field->type == FIELD_TYPE_HASHRATE))
+			{
+				number *= 100.0;
+			}
+			else if (decimal)
+			{
+				snprintf(error, error_size, "'%s' takes whole numbers", field->name);
+				return -1;
+			}
+
+			long raw = lround(number);
+			if (raw < field->min_value || raw > field->max_value)
+			{
+				snprintf(error, error_size, "'%s' = %ld is outside %d..%d",
+						 field->name, raw, field->min_value, field->max_value);
+				return -1;
+			}
+
+			if (field->size == 2)
+			{
+				uint16_t v = (uint16_t)raw;
+				memcpy(bytes, &v, 2);
+			}
+			else
+			{
+				bytes[0] = (uint8_t)raw;
+			}
+			break;
+		}
+
+		case FIELD_TYPE_STRING:
+		{
+			size_t len = strlen(value);
+			if (len > field->size)
+			{
+				snprintf(error, error_size, "'%s' holds at most %zu characters", field->name, field->size);
+				return -1;
+			}
+			memcpy(bytes, value, len);
+			break;
+		}
+
+		default:
+			snprintf(error, error_size, "'%s' cannot be patched", field->name);
+			return -1;
+	}
+
+	if (memcmp(ptr, bytes, field->size) == 0)
+	{
+		return 0;
+	}
+
+	uint8_t old_value[PATCH_VALUE_MAX];
+	memcpy(old_value, ptr, field->size);
+	memcpy(ptr, bytes, field->size);
+	eeprom_field_update_crc(eeprom, version, field, old_value);
+	return 1;
+}
+
+// Parsed structure of any layout
+typedef union
+{
+	EEPROMStructure v4_v6;
+	EEPROMStructure_v17 v17;
+	EEPROMStructure_v1 v1;
+} PatchImage;
+
+static void image_parse(PatchImage *image, const uint8_t *data, EEPROMVersion version)
+{
+	switch (version)
+	{
+		case EEPROM_VERSION_V1:
+			eeprom_v1_parse(&image->v1, data);
+			break;
+		case EEPROM_VERSION_V17:
+			eeprom_v17_parse(&image->v17, data);
+			break;
+		default:
+			eeprom_from_bytes(&image->v4_v6, data);
+			break;
+	}
+}
+
+static void image_serialize(const PatchImage *image, uint8_t *data, EEPROMVersion version)
+{
+	switch (version)
+	{
+		case EEPROM_VERSION_V1:
+			eeprom_v1_serialize(&image->v1, data);
+			break;
+		case EEPROM_VERSION_V17:
+			eeprom_v17_serialize(&image->v17, data);
+			break;
+		default:
+			eeprom_to_bytes(&image->v4_v6, data);
+			break;
+	}
+}
+
+// Board serial without padding ("" if the layout has none)
+static void image_serial(const PatchImage *image, EEPROMVersion version, char *out, size_t size)
+{
+	const FieldMetadata *field = field_index_find(version, "Board Serial");
+	if (!field)
+	{
+		field = field_index_find(version, "Serial Number");
+	}
+
+	size_t n = 0;
+	if (field)
+	{
+		const uint8_t *p = (const uint8_t*)image + field->offset;
+		size_t i = 0;
+		while (i < field->size && p[i] == ' ')
+		{
+			i++;
+		}
+		for (; i < field->size && n + 1 < size && p[i] && p[i] != 0xFF; i++)
+		{
+			out[n++] = (char)p[i];
+		}
+	}
+	while (n > 0 && out[n - 1] == ' ')
+	{
+		n--;
+	}
+	out[n] = '\0';
+}
+
+static int apply_range(const PatchAssign *items, size_t count, PatchImage *image, EEPROMVersion version,
+					   uint8_t *dirty, char *error, size_t error_size)
+{
+	int changed = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		int result = patch_set_field(image, version, items[i].field, items[i].value, error, error_size);
+		if (result < 0)
+		{
+			return -1;
+		}
+		if (result)
+		{
+			const FieldMetadata *field = field_index_find(version, items[i].field);
+			*dirty |= eeprom_field_regions(field, eeprom_get_layout(version));
+		}
+		changed += result;
+	}
+	return changed;
+}
+
+int patch_apply(const PatchSpec *spec, uint8_t *data, EEPROMVersion version, uint8_t *dirty,
+				char *error, size_t error_size)
+{
+	PatchImage image;
+	image_parse(&image, data, version);
+	*dirty = 0;
+
+	int changed = apply_range(spec->items, spec->global_count, &image, version, dirty, error, error_size);
+	if (changed < 0)
+	{
+		return -1;
+	}
+
+	// Serial-specific assignments: binary search for the first match
+	char serial[PATCH_SERIAL_MAX];
+	image_serial(&image, version, serial, sizeof(serial));
+	if (serial[0] && spec->count > spec->global_count)
+	{
+		const PatchAssign *items = spec->items + spec->global_count;
+		size_t lo = 0, hi = spec->count - spec->global_count;
+		while (lo < hi)
+		{
+			size_t mid = (lo + hi) / 2;
+			if (strcmp(items[mid].serial, serial) < 0)
+			{
+				lo = mid + 1;
+			}
+			else
+			{
+				hi = mid;
+			}
+		}
+		size_t end = lo;
+		while (end < spec->count - spec->global_count && strcmp(items[end].serial, serial) == 0)
+		{
+			end++;
+		}
+
+		int more = apply_range(items + lo, end - lo, &image, version, dirty, error, error_size);
+		if (more < 0)
+		{
+			return -1;
+		}
+		changed += more;
+	}
+
+	if (changed)
+	{
+		image_serialize(&image, data, version);
+	}
+	return changed;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	PatchSpec spec;
+	const char *out_dir;
+	int in_place;
+	int dry_run;
+	int force;
+	int full;                      // Re-encode every region
+
+	pthread_mutex_t lock;
+	size_t patched;
+	size_t unchanged;
+	size_t skipped;
+	size_t failed;
+} PatchRun;
+
+static mode_t create_mode;
+static pthread_once_t create_mode_once = PTHREAD_ONCE_INIT;
+
+// umask can only be read by setting it, so do that once before any file
+// is created
+static void create_mode_init(void)
+{
+	mode_t mask = umask(0);
+	umask(mask);
+	create_mode = 0666 & ~mask;
+}
+
+int patch_write_atomic(const char *path, const uint8_t *data, size_t size)
+{
+	char tmp_path[4200];
+	if (snprintf(tmp_path, sizeof(tmp_path), "%s.tmpXXXXXX", path) >= (int)sizeof(tmp_path))
+	{
+		return -1;
+	}
+
+	// mkstemp creates 0600: keep the mode of a file being replaced, give
+	// new files the usual 0666 & ~umask
+	pthread_once(&create_mode_once, create_mode_init);
+	struct stat st;
+	mode_t mode = stat(path, &st) == 0 ? st.st_mode & 07777 : create_mode;
+
+	int fd = mkstemp(tmp_path);
+	if (fd < 0)
+	{
+		return -1;
+	}
+
+	ssize_t written = write(fd, data, size);
+	int ok = written == (ssize_t)size && fchmod(fd, mode) == 0 && fsync(fd) == 0;
+	ok = close(fd) == 0 && ok;
+
+	if (!ok || rename(tmp_path, path) != 0)
+	{
+		unlink(tmp_path);
+		return -1;
+	}
+	return 0;
+}
+
+void patch_output_path(const char *out_dir, const char *name, size_t image_size, char *out, size_t size)
+{
+	if (!out_dir)
+	{
+		snprintf(out, size, "%s", name);
+		return;
+	}
+
+	const char *base = name;
+	for (const char *p = name; *p; p++)
+	{
+		if (*p == '/' || *p == ':')
+		{
+			base = p + 1;
+		}
+	}
+
+	// The image was extracted from a larger dump or a text format but is
+	// written raw, so it must not keep a name claiming the input format
+	struct stat st;
+	if (stat(name, &st) == 0 && S_ISREG(st.st_mode) && (size_t)st.st_size != image_size)
+	{
+		const char *dot = strrchr(base, '.');
+		int stem = dot && dot != base ? (int)(dot - base) : (int)strlen(base);
+		snprintf(out, size, "%s/%.*s.bin", out_dir, stem, base);
+		fprintf(stderr, "Note: %s is not a raw image, writing it raw as %s\n", name, out);
+		return;
+	}
+	snprintf(out, size, "%s/%s", out_dir, base);
+}
+
+static void patch_report(PatchRun *run, size_t *counter, const char *name, const char *error)
+{
+	pthread_mutex_lock(&run->lock);
+	(*counter)++;
+	if (error)
+	{
+		fprintf(stderr, "Error: %s: %s\n", name, error);
+	}
+	pthread_mutex_unlock(&run->lock);
+}
+
+static int patch_image(const char *name, const uint8_t *raw, size_t size, void *ctx)
+{
+	PatchRun *run = (PatchRun*)ctx;
+	uint8_t original[EEPROM_SIZE];
+	uint8_t data[EEPROM_SIZE];
+	memset(original, 0xFF, sizeof(original));
+	memcpy(original, raw, size);
+	memcpy(data, original, sizeof(data));
+
+	EEPROMCheck check;
+	if (batch_decode(data, &check) != EEPROM_SUCCESS)
+	{
+		patch_report(run, &run->skipped, name, "unknown EEPROM version");
+		return 0;
+	}
+	if (check.crc_ok != EEPROM_CHECK_ALL(&check) && !run->force)
+	{
+		patch_report(run, &run->skipped, name, "CRC mismatch, not patched (use --force)");
+		return 0;
+	}
+
+	char error[160];
+	uint8_t dirty;
+	int changed = patch_apply(&run->spec, data, check.version, &dirty, error, sizeof(error));
+	if (changed < 0)
+	{
+		patch_report(run, &run->failed, name, error);
+		return 0;
+	}
+	if (changed == 0)
+	{
+		patch_report(run, &run->unchanged, name, NULL);
+		return 0;
+	}
+
+	// CRCs were updated per field, so only the edited regions are
+	// encrypted; a forced image with CRC errors, or any with --full, is
+	// re-encoded in full
+	int incremental = check.crc_ok == EEPROM_CHECK_ALL(&check) && !run->full;
+	int result = incremental ? eeprom_encode_dirty(data, EEPROM_SIZE, check.version, original, dirty)
+							 : eeprom_encode(data, EEPROM_SIZE, check.version);
+	if (result != EEPROM_SUCCESS)
+	{
+		patch_report(run, &run->failed, name, "encode failed");
+		return 0;
+	}
+
+	// The whole written image must decode cleanly: a changed header byte
+	// can invalidate regions that were not re-encoded
+	uint8_t verify[EEPROM_SIZE];
+	EEPROMCheck verify_check;
+	memcpy(verify, data, sizeof(verify));
+	if (eeprom_decode_check(verify, EEPROM_SIZE, check.version, &verify_check) != EEPROM_SUCCESS ||
+		verify_check.crc_ok != EEPROM_CHECK_ALL(&verify_check))
+	{
+		patch_report(run, &run->failed, name, "re-encoded image fails CRC check");
+		return 0;
+	}
+
+	if (!run->dry_run)
+	{
+		char path[4200];
+		patch_output_path(run->in_place ? NULL : run->out_dir, name, size, path, sizeof(path));
+
+		struct stat st;
+		if (run->in_place && (stat(name, &st) != 0 || !S_ISREG(st.st_mode) || (size_t)st.st_size != size))
+		{
+			patch_report(run, &run->failed, name, "not a plain image file, use -o DIR");
+			return 0;
+		}
+		if (patch_write_atomic(path, data, size) != 0)
+		{
+			patch_report(run, &run->failed, name, "cannot write output");
+			return 0;
+		}
+	}
+
+	pthread_mutex_lock(&run->lock);
+	run->patched++;
+	printf("  %s: %d field%s\n", name, changed, changed == 1 ? "" : "s");
+	pthread_mutex_unlock(&run->lock);
+	return 0;
+}
+
+int cmd_patch(int argc, char **argv)
+{
+	PatchRun run;
+	memset(&run, 0, sizeof(run));
+	const char *spec_path = NULL;
+	char *paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-s") == 0 && i + 1 < argc)
+		{
+			spec_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			run.out_dir = argv[++i];
+		}
+		else if (strcmp(argv[i], "--in-place") == 0)
+		{
+			run.in_place = 1;
+		}
+		else if (strcmp(argv[i], "-n") == 0)
+		{
+			run.dry_run = 1;
+		}
+		else if (strcmp(argv[i], "--force") == 0)
+		{
+			run.force = 1;
+		}
+		else if (strcmp(argv[i], "--full") == 0)
+		{
+			run.full = 1;
+		}
+		else
+		{
+			paths[path_count++] = argv[i];
+		}
+	}
+
+	if (!spec_path || path_count == 0 || (!run.out_dir && !run.in_place && !run.dry_run) ||
+		(run.out_dir && run.in_place))
+	{
+		fprintf(stderr, "Usage: eeprom_tool patch -s SPEC (-o DIR | --in-place) [-n] [--force] [--full] PATH...\n");
+		return 1;
+	}
+
+	if (run.out_dir)
+	{
+		struct stat st;
+		if (stat(run.out_dir, &st) != 0 && mkdir(run.out_dir, 0755) != 0)
+		{
+			fprintf(stderr, "Error: Cannot create %s\n", run.out_dir);
+			return 1;
+		}
+	}
+
+	if (patch_spec_load(spec_path, &run.spec) != 0)
+	{
+		return 1;
+	}
+
+	pthread_mutex_init(&run.lock, NULL);
+	batch_for_each_parallel(paths, path_count, patch_image, &run, NULL);
+	pthread_mutex_destroy(&run.lock);
+
+	fflush(stdout);
+	fprintf(stderr, "%s: %zu, unchanged: %zu, skipped: %zu, errors: %zu\n",
+			run.dry_run ? "Would patch" : "Patched", run.patched, run.unchanged, run.skipped, run.failed);
+
+	patch_spec_free(&run.spec);
+	return run.failed ? 2 : 0;
+}
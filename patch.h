@@ -0,0 +1,79 @@
+#ifndef PATCH_H
+#define PATCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "eeprom_defs.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Batch Patching
+// ═══════════════════════════════════════════════════════════════
+// A spec is a list of field assignments, each either for every image or
+// for the board with a given serial. Accepted spec formats:
+//
+//   field=value lines       "PSU Voltage = 13.80", "[SERIAL]" starts a
+//                           section for one board, lines starting
+//                           with '#' are comments
+//   JSON                    {"chip_bin": 2, "SERIAL": {"pt2_result": 1}}
+//   CSV keyed by serial     serial,frequency,psu_voltage
+//                           JYZZ...,500,13.60
+//
+// The format follows a .json/.csv extension, otherwise the content: '{'
+// is JSON, a first non-comment line with a comma before any '=' is CSV.
+// A spec without any assignment is an error.
+//
+// Field names are resolved through field_index (display names, paths and
+// member names). Voltage/hashrate values with a decimal point are in V or
+// TH/s, other numbers are raw (0x.. accepted).
+
+#define PATCH_SERIAL_MAX 40
+#define PATCH_VALUE_MAX  64
+
+typedef struct
+{
+	char serial[PATCH_SERIAL_MAX];  // "" = every image
+	char field[64];
+	char value[PATCH_VALUE_MAX];
+	size_t order;                  // Position in the spec file
+} PatchAssign;
+
+typedef struct
+{
+	PatchAssign *items;            // Global assignments first, then by serial
+	size_t count;
+	size_t capacity;
+	size_t global_count;
+} PatchSpec;
+
+// Load and sort a spec; prints an error and returns -1 on failure
+int patch_spec_load(const char *path, PatchSpec *spec);
+void patch_spec_free(PatchSpec *spec);
+
+// Set one field in a parsed structure of the given version after checking
+// type, read-only flag and FieldMetadata range; the region CRC is updated
+// incrementally. Returns 1 if the value changed, 0 if it was already set,
+// -1 on error (message in error).
+int patch_set_field(void *eeprom, EEPROMVersion version, const char *field, const char *value,
+					char *error, size_t error_size);
+
+// Apply every matching assignment to a decoded image and set dirty to the
+// regions that need re-encoding. Returns the number of fields changed, or
+// -1 on error (message in error).
+int patch_apply(const PatchSpec *spec, uint8_t *data, EEPROMVersion version, uint8_t *dirty,
+				char *error, size_t error_size);
+
+// Write through a temporary file in the same directory, then rename. A
+// replaced file keeps its mode, a new one gets 0666 & ~umask.
+int patch_write_atomic(const char *path, const uint8_t *data, size_t size);
+// Output path of an image: DIR/<last path component> (tar members by
+// member name), or name itself when out_dir is NULL (in place). Images
+// are written raw: an input file that is not image_size bytes (programmer
+// dump, Intel HEX, hex text) gets a .bin extension and a note on stderr.
+void patch_output_path(const char *out_dir, const char *name, size_t image_size, char *out, size_t size);
+
+// CLI: eeprom_tool patch -s SPEC (-o DIR | --in-place) [-n] [--force] [--full] PATH...
+// --full encrypts every region and recomputes its CRC, instead of only the
+// regions the spec changed (the result is the same)
+int cmd_patch(int argc, char **argv);
+
+#endif // PATCH_H
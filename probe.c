@@ -0,0 +1,195 @@
+#include "probe.h"
+#include "batch.h"
+#include "eeprom_structure.h"
+#include "ui.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Header classification
+// ═══════════════════════════════════════════════════════════════
+
+void eeprom_probe(const uint8_t *data, size_t size, ProbeInfo *info)
+{
+	memset(info, 0, sizeof(*info));
+	info->version = size >= 2 ? eeprom_detect_version(data) : EEPROM_VERSION_UNKNOWN;
+
+	switch (info->version)
+	{
+		case EEPROM_VERSION_V1:
+		{
+			info->algorithm = CRYPTO_ALGORITHM_AES256CBC;
+			size_t len = size < EEPROM_V1_HEADER_SIZE ? size - 1 : EEPROM_V1_HEADER_SIZE - 1;
+			size_t n = 0;
+			for (; n < len && n < sizeof(info->model) - 1; n++)
+			{
+				char c = (char)data[offsetof(EEPROMStructure_v1, board_name) + n];
+				if (c == '\0')
+				{
+					break;
+				}
+				info->model[n] = (c >= 0x20 && c < 0x7F) ? c : '?';
+			}
+			info->model[n] = '\0';
+			break;
+		}
+
+		case EEPROM_VERSION_V4:
+		case EEPROM_VERSION_V5:
+		case EEPROM_VERSION_V6:
+			info->algorithm = data[1] >> 4;
+			info->key_index = data[1] & 0xF;
+			break;
+
+		case EEPROM_VERSION_V17:
+			info->algorithm = data[0] >> 4;
+			info->key_index = data[0] & 0xF;
+			break;
+
+		default:
+			break;
+	}
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Grouping
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	ProbeInfo key;
+	size_t count;
+} ProbeGroup;
+
+typedef struct
+{
+	ProbeGroup *groups;
+	size_t count;
+	size_t capacity;
+	int list;                      // Print one line per image
+} ProbeState;
+
+static int probe_same(const ProbeInfo *a, const ProbeInfo *b)
+{
+	return a->version == b->version &&
+		   a->algorithm == b->algorithm &&
+		   a->key_index == b->key_index &&
+		   strcmp(a->model, b->model) == 0;
+}
+
+static int probe_image(const char *name, const uint8_t *data, size_t size, void *ctx)
+{
+	ProbeState *state = (ProbeState*)ctx;
+	ProbeInfo info;
+	eeprom_probe(data, size, &info);
+
+	if (state->list)
+	{
+		printf("%s\t%d\t%s\t%u\t%u\n", name, info.version,
+			   info.model[0] ? info.model : "-", info.algorithm, info.key_index);
+	}
+
+	for (size_t i = 0; i < state->count; i++)
+	{
+		if (probe_same(&state->groups[i].key, &info))
+		{
+			state->groups[i].count++;
+			return 0;
+		}
+	}
+
+	if (state->count == state->capacity)
+	{
+		size_t capacity = state->capacity ? state->capacity * 2 : 32;
+		ProbeGroup *groups = realloc(state->groups, capacity * sizeof(ProbeGroup));
+		if (!groups)
+		{
+			fprintf(stderr, "Error: Out of memory\n");
+			return 1;
+		}
+		state->groups = groups;
+		state->capacity = capacity;
+	}
+
+	state->groups[state->count].key = info;
+	state->groups[state->count].count = 1;
+	state->count++;
+	return 0;
+}
+
+static int probe_group_cmp(const void *a, const void *b)
+{
+	const ProbeGroup *ga = (const ProbeGroup*)a;
+	const ProbeGroup *gb = (const ProbeGroup*)b;
+
+	if (ga->key.version != gb->key.version)
+	{
+		return ga->key.version < gb->key.version ? -1 : 1;
+	}
+	int c = strcmp(ga->key.model, gb->key.model);
+	if (c != 0)
+	{
+		return c;
+	}
+	return (ga->key.algorithm << 4 | ga->key.key_index) -
+		   (gb->key.algorithm << 4 | gb->key.key_index);
+}
+
+int cmd_probe(int argc, char **argv)
+{
+	ProbeState state;
+	memset(&state, 0, sizeof(state));
+
+	BatchStats stats;
+	memset(&stats, 0, sizeof(stats));
+
+	int paths = 0;
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-l") == 0)
+		{
+			state.list = 1;
+			continue;
+		}
+		batch_for_each(argv[i], probe_image, &state, &stats);
+		paths++;
+	}
+
+	if (paths == 0)
+	{
+		fprintf(stderr, "Usage: eeprom_tool probe [-l] PATH...\n");
+		free(state.groups);
+		return 1;
+	}
+
+	qsort(state.groups, state.count, sizeof(ProbeGroup), probe_group_cmp);
+
+	ui_print_header("EEPROM Probe Summary");
+	printf("  %-8s %-16s %-10s %10s\n", "Version", "Model", "Alg/Key", "Count");
+	ui_print_separator();
+	for (size_t i = 0; i < state.count; i++)
+	{
+		const ProbeInfo *key = &state.groups[i].key;
+		char alg_key[16];
+
+		if (key->version == EEPROM_VERSION_UNKNOWN)
+		{
+			printf("  %-8s %-16s %-10s %10zu\n", "unknown", "-", "-", state.groups[i].count);
+			continue;
+		}
+
+		snprintf(alg_key, sizeof(alg_key), "%u/%u", key->algorithm, key->key_index);
+		printf("  v%-7d %-16s %-10s %10zu\n", key->version,
+			   key->model[0] ? key->model : "-", alg_key, state.groups[i].count);
+	}
+	ui_print_separator();
+	printf("  Images: %zu, files: %zu, skipped: %zu\n", stats.images, stats.files_seen, stats.skipped);
+
+	free(state.groups);
+	return 0;
+}
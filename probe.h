@@ -0,0 +1,26 @@
+#ifndef PROBE_H
+#define PROBE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "eeprom_defs.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Header-only probe (no crypto)
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	EEPROMVersion version;
+	uint8_t algorithm;             // Crypto algorithm from header (CRYPTO_ALGORITHM_*)
+	uint8_t key_index;             // Key index from header
+	char model[16];                // Plaintext board name (v1 only, "" otherwise)
+} ProbeInfo;
+
+// Classify an image from its unencrypted header bytes
+void eeprom_probe(const uint8_t *data, size_t size, ProbeInfo *info);
+
+// CLI: eeprom_tool probe [-l] PATH...
+int cmd_probe(int argc, char **argv);
+
+#endif // PROBE_H
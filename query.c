@@ -0,0 +1,798 @@
+#include "query.h"
+#include "batch.h"
+#include "columns.h"
+#include "eeprom_defs.h"
+#include "eeprom_ops.h"
+#include "field_index.h"
+#include <ctype.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+#define QUERY_MAX_TERMS  64
+#define QUERY_MAX_NODES  (QUERY_MAX_TERMS * 2)
+#define QUERY_MAX_CODE   (QUERY_MAX_NODES * 2)
+#define QUERY_MAX_TEXT   32
+
+typedef enum
+{
+	CMP_EQ,
+	CMP_NE,
+	CMP_LT,
+	CMP_LE,
+	CMP_GT,
+	CMP_GE
+} QueryCmp;
+
+typedef enum
+{
+	TERM_FIELD,
+	TERM_CRC_OK,                   // All region CRCs match
+	TERM_TEST_PASS                 // All region test results == 1
+} QueryTermKind;
+
+typedef struct
+{
+	QueryTermKind kind;
+	QueryCmp cmp;
+	int is_string;
+	Column column;                          // Binding per layout (no storage)
+	int8_t region[COLUMN_VERSIONS];         // Region holding the field, -1 = plaintext
+	int32_t value;                          // Numeric constant (raw units)
+	char text[QUERY_MAX_TEXT];              // String constant
+	int prefix;                             // text ended with '*'
+	int cost;                               // Regions to decrypt, worst layout
+} QueryTerm;
+
+typedef enum
+{
+	OP_TERM,                       // Push result of terms[arg]
+	OP_NOT,                        // Negate top
+	OP_AND,                        // Top false: jump to arg, else pop
+	OP_OR                          // Top true: jump to arg, else pop
+} QueryOpcode;
+
+typedef struct
+{
+	uint8_t opcode;
+	uint16_t arg;
+} QueryOp;
+
+struct Query
+{
+	QueryTerm terms[QUERY_MAX_TERMS];
+	size_t term_count;
+	QueryOp code[QUERY_MAX_CODE];
+	size_t code_len;
+};
+
+// ═══════════════════════════════════════════════════════════════
+// Parser
+// ═══════════════════════════════════════════════════════════════
+
+typedef enum
+{
+	NODE_TERM,
+	NODE_NOT,
+	NODE_AND,
+	NODE_OR
+} QueryNodeType;
+
+typedef struct
+{
+	QueryNodeType type;
+	int term;                      // NODE_TERM
+	int child;                     // First operand
+	int next;                      // Next operand of the parent and/or
+	int cost;
+} QueryNode;
+
+typedef struct
+{
+	const char *p;
+	Query *query;
+	QueryNode nodes[QUERY_MAX_NODES];
+	int node_count;
+	char *error;
+	size_t error_size;
+	int failed;
+} QueryParser;
+
+static int parse_or(QueryParser *ps);
+
+static int parse_fail(QueryParser *ps, const char *fmt, ...)
+{
+	if (!ps->failed)
+	{
+		va_list ap;
+		va_start(ap, fmt);
+		vsnprintf(ps->error, ps->error_size, fmt, ap);
+		va_end(ap);
+		ps->failed = 1;
+	}
+	return -1;
+}
+
+static void skip_space(QueryParser *ps)
+{
+	while (isspace((unsigned char)*ps->p))
+	{
+		ps->p++;
+	}
+}
+
+static int accept(QueryParser *ps, const char *token)
+{
+	skip_space(ps);
+	size_t n = strlen(token);
+	if (strncmp(ps->p, token, n) != 0)
+	{
+		return 0;
+	}
+	ps->p += n;
+	return 1;
+}
+
+// Case-insensitive keyword that is not the prefix of a longer word
+static int accept_word(QueryParser *ps, const char *word)
+{
+	skip_space(ps);
+	size_t n = strlen(word);
+	if (strncasecmp(ps->p, word, n) != 0 || isalnum((unsigned char)ps->p[n]) || ps->p[n] == '_')
+	{
+		return 0;
+	}
+	ps->p += n;
+	return 1;
+}
+
+static int new_node(QueryParser *ps, QueryNodeType type)
+{
+	if (ps->node_count >= QUERY_MAX_NODES)
+	{
+		return parse_fail(ps, "expression too long");
+	}
+	QueryNode *node = &ps->nodes[ps->node_count];
+	memset(node, 0, sizeof(*node));
+	node->type = type;
+	node->child = -1;
+	node->next = -1;
+	return ps->node_count++;
+}
+
+// Quoted string or bare word into buf
+static int parse_word(QueryParser *ps, char *buf, size_t size, int *quoted)
+{
+	skip_space(ps);
+	size_t n = 0;
+	*quoted = *ps->p == '"';
+
+	if (*quoted)
+	{
+		ps->p++;
+		while (*ps->p && *ps->p != '"')
+		{
+			if (n + 1 < size)
+			{
+				buf[n++] = *ps->p;
+			}
+			ps->p++;
+		}
+		if (*ps->p != '"')
+		{
+			return parse_fail(ps, "unterminated string");
+		}
+		ps->p++;
+	}
+	else
+	{
+		while (isalnum((unsigned char)*ps->p) || *ps->p == '_' || *ps->p == '.' ||
+			   ((*ps->p == '-' || *ps->p == '+') && n == 0))
+		{
+			if (n + 1 < size)
+			{
+				buf[n++] = *ps->p;
+			}
+			ps->p++;
+		}
+	}
+
+	buf[n] = '\0';
+	if (n == 0 && !*quoted)
+	{
+		return parse_fail(ps, "expected a field name or value near '%.16s'", ps->p);
+	}
+	return 0;
+}
+
+static int region_of(const EEPROMLayout *layout, size_t offset)
+{
+	for (size_t r = 0; r < layout->region_count; r++)
+	{
+		const RegionMeta *region = &layout->regions[r];
+		if (offset >= region->data_start && offset < region->data_start + region->data_size)
+		{
+			return (int)r;
+		}
+	}
+	return -1;
+}
+
+static int bind_term(QueryParser *ps, QueryTerm *term, const char *name)
+{
+	memset(term->region, -1, sizeof(term->region));
+
+	if (strcasecmp(name, "crc_ok") == 0 || strcasecmp(name, "test_pass") == 0)
+	{
+		term->kind = strcasecmp(name, "crc_ok") == 0 ? TERM_CRC_OK : TERM_TEST_PASS;
+		term->cost = 3;
+		return 0;
+	}
+
+	term->kind = TERM_FIELD;
+
+	// Byte 0 in every layout
+	if (strcasecmp(name, "version") == 0)
+	{
+		memset(&term->column, 0, sizeof(term->column));
+		term->column.kind = COLUMN_U8;
+		term->column.width = 1;
+		for (int slot = 0; slot < COLUMN_VERSIONS; slot++)
+		{
+			term->column.source[slot].size = 1;
+		}
+		return 0;
+	}
+
+	int bound = column_bind(&term->column, name) == 0;
+
+	// A bare member name shared by several fields of one layout would
+	// silently never match images of that layout
+	for (int slot = 0; slot < COLUMN_VERSIONS; slot++)
+	{
+		const FieldMetadata *members[2];
+		size_t uses = term->column.source[slot].size ? 0 :
+			field_index_members(column_version(slot), name, members, 2);
+		if (uses > 1)
+		{
+			return parse_fail(ps, "'%s' is ambiguous in v%d images: use %s, %s%s or a display name",
+							  name, (int)column_version(slot), members[0]->path, members[1]->path,
+							  uses > 2 ? ", ..." : "");
+		}
+	}
+	if (!bound)
+	{
+		return parse_fail(ps, "unknown field '%s'", name);
+	}
+
+	for (int slot = 0; slot < COLUMN_VERSIONS; slot++)
+	{
+		if (term->column.source[slot].size)
+		{
+			const EEPROMLayout *layout = eeprom_get_layout(column_version(slot));
+			term->region[slot] = (int8_t)region_of(layout, term->column.source[slot].offset);
+			term->cost = term->region[slot] >= 0 ? 1 : term->cost;
+		}
+	}
+	term->is_string = term->column.kind == COLUMN_BYTES;
+	return 0;
+}
+
+static int parse_term(QueryParser *ps)
+{
+	Query *query = ps->query;
+	if (query->term_count >= QUERY_MAX_TERMS)
+	{
+		return parse_fail(ps, "too many comparisons");
+	}
+
+	char name[64];
+	int quoted;
+	if (parse_word(ps, name, sizeof(name), &quoted) != 0)
+	{
+		return -1;
+	}
+
+	QueryTerm *term = &query->terms[query->term_count];
+	memset(term, 0, sizeof(*term));
+	if (bind_term(ps, term, name) != 0)
+	{
+		return -1;
+	}
+
+	// Longer operators first
+	static const struct { const char *token; QueryCmp cmp; } ops[] =
+	{
+		{ "==", CMP_EQ }, { "!=", CMP_NE }, { "<=", CMP_LE }, { ">=", CMP_GE },
+		{ "<", CMP_LT }, { ">", CMP_GT }, { "=", CMP_EQ }
+	};
+	size_t op;
+	for (op = 0; op < sizeof(ops) / sizeof(ops[0]); op++)
+	{
+		if (accept(ps, ops[op].token))
+		{
+			term->cmp = ops[op].cmp;
+			break;
+		}
+	}
+	if (op == sizeof(ops) / sizeof(ops[0]))
+	{
+		return parse_fail(ps, "expected a comparison after '%s'", name);
+	}
+
+	char value[QUERY_MAX_TEXT];
+	if (parse_word(ps, value, sizeof(value), &quoted) != 0)
+	{
+		return -1;
+	}
+
+	if (term->is_string)
+	{
+		if (term->cmp != CMP_EQ && term->cmp != CMP_NE)
+		{
+			return parse_fail(ps, "'%s' is text, only == and != apply", name);
+		}
+		size_t len = strlen(value);
+		term->prefix = len > 0 && value[len - 1] == '*';
+		if (term->prefix)
+		{
+			value[len - 1] = '\0';
+		}
+		snprintf(term->text, sizeof(term->text), "%s", value);
+	}
+	else
+	{
+		char *end;
+		double number = strchr(value, '.') ? strtod(value, &end) : (double)strtol(value, &end, 0);
+		if (quoted || *end || end == value)
+		{
+			return parse_fail(ps, "'%s' expects a number, got '%s'", name, value);
+		}
+
+		// "PSU Voltage > 13.80": decimal constants are in display units
+		const FieldMetadata *field = term->column.field;
+		if (strchr(value, '.') && field &&
+			(field->type == FIELD_TYPE_VOLTAGE || field->type == FIELD_TYPE_HASHRATE))
+		{
+			number *= 100.0;
+		}
+		term->value = (int32_t)lround(number);
+	}
+
+	int node = new_node(ps, NODE_TERM);
+	if (node < 0)
+	{
+		return -1;
+	}
+	ps->nodes[node].term = (int)query->term_count++;
+	ps->nodes[node].cost = term->cost;
+	return node;
+}
+
+static int parse_unary(QueryParser *ps)
+{
+	skip_space(ps);
+	int negate = ps->p[0] == '!' && ps->p[1] != '=' ? accept(ps, "!") : accept_word(ps, "not");
+	if (negate)
+	{
+		int child = parse_unary(ps);
+		if (child < 0)
+		{
+			return -1;
+		}
+		int node = new_node(ps, NODE_NOT);
+		if (node < 0)
+		{
+			return -1;
+		}
+		ps->nodes[node].child = child;
+		ps->nodes[node].cost = ps->nodes[child].cost;
+		return node;
+	}
+
+	if (accept(ps, "("))
+	{
+		int node = parse_or(ps);
+		if (node < 0)
+		{
+			return -1;
+		}
+		if (!accept(ps, ")"))
+		{
+			return parse_fail(ps, "missing ')'");
+		}
+		return node;
+	}
+
+	return parse_term(ps);
+}
+
+// and/or chains become one node with a list of operands
+static int parse_chain(QueryParser *ps, QueryNodeType type, int (*operand)(QueryParser*),
+					   const char *word, const char *symbol)
+{
+	int first = operand(ps);
+	if (first < 0)
+	{
+		return -1;
+	}
+
+	int node = -1, last = first;
+	while (accept_word(ps, word) || accept(ps, symbol))
+	{
+		if (node < 0)
+		{
+			node = new_node(ps, type);
+			if (node < 0)
+			{
+				return -1;
+			}
+			ps->nodes[node].child = first;
+			ps->nodes[node].cost = ps->nodes[first].cost;
+		}
+
+		int next = operand(ps);
+		if (next < 0)
+		{
+			return -1;
+		}
+		ps->nodes[last].next = next;
+		ps->nodes[node].cost += ps->nodes[next].cost;
+		last = next;
+	}
+	return node < 0 ? first : node;
+}
+
+static int parse_and(QueryParser *ps)
+{
+	return parse_chain(ps, NODE_AND, parse_unary, "and", "&&");
+}
+
+static int parse_or(QueryParser *ps)
+{
+	return parse_chain(ps, NODE_OR, parse_and, "or", "||");
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Code Generation
+// ═══════════════════════════════════════════════════════════════
+
+static void emit(QueryParser *ps, int index)
+{
+	Query *query = ps->query;
+	const QueryNode *node = &ps->nodes[index];
+
+	if (node->type == NODE_TERM)
+	{
+		query->code[query->code_len++] = (QueryOp){ OP_TERM, (uint16_t)node->term };
+		return;
+	}
+	if (node->type == NODE_NOT)
+	{
+		emit(ps, node->child);
+		query->code[query->code_len++] = (QueryOp){ OP_NOT, 0 };
+		return;
+	}
+
+	// Cheapest operands first (stable), so plaintext fields and regions
+	// already needed earlier decide the chain before more decryption
+	int operands[QUERY_MAX_NODES] = { node->child };
+	int count = 0;
+	for (int child = node->child; child >= 0; child = ps->nodes[child].next)
+	{
+		int pos = count++;
+		while (pos > 0 && ps->nodes[operands[pos - 1]].cost > ps->nodes[child].cost)
+		{
+			operands[pos] = operands[pos - 1];
+			pos--;
+		}
+		operands[pos] = child;
+	}
+
+	size_t jumps[QUERY_MAX_NODES];
+	uint8_t opcode = node->type == NODE_AND ? OP_AND : OP_OR;
+
+	emit(ps, operands[0]);
+	for (int i = 1; i < count; i++)
+	{
+		jumps[i] = query->code_len;
+		query->code[query->code_len++] = (QueryOp){ opcode, 0 };
+		emit(ps, operands[i]);
+	}
+	for (int i = 1; i < count; i++)
+	{
+		query->code[jumps[i]].arg = (uint16_t)query->code_len;
+	}
+}
+
+Query *query_compile(const char *text, char *error, size_t error_size)
+{
+	Query *query = calloc(1, sizeof(*query));
+	QueryParser *ps = calloc(1, sizeof(*ps));
+	if (!query || !ps)
+	{
+		snprintf(error, error_size, "out of memory");
+		free(query);
+		free(ps);
+		return NULL;
+	}
+
+	ps->p = text;
+	ps->query = query;
+	ps->error = error;
+	ps->error_size = error_size;
+
+	int root = parse_or(ps);
+	skip_space(ps);
+	if (root >= 0 && *ps->p)
+	{
+		root = parse_fail(ps, "unexpected '%.16s'", ps->p);
+	}
+
+	if (root < 0)
+	{
+		free(ps);
+		free(query);
+		return NULL;
+	}
+
+	emit(ps, root);
+	free(ps);
+	return query;
+}
+
+void query_free(Query *query)
+{
+	free(query);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Evaluation
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	uint8_t data[EEPROM_SIZE];
+	EEPROMVersion version;
+	int slot;
+	uint8_t decoded;               // Bit i: region i decrypted
+	EEPROMCheck check;
+} QueryImage;
+
+static void ensure_region(QueryImage *image, int region)
+{
+	if (!(image->decoded & (1u << region)))
+	{
+		eeprom_decode_region(image->data, image->version, region, &image->check);
+		image->decoded |= 1u << region;
+	}
+}
+
+static int compare(int32_t a, QueryCmp cmp, int32_t b)
+{
+	switch (cmp)
+	{
+		case CMP_EQ: return a == b;
+		case CMP_NE: return a != b;
+		case CMP_LT: return a < b;
+		case CMP_LE: return a <= b;
+		case CMP_GT: return a > b;
+		case CMP_GE: return a >= b;
+	}
+	return 0;
+}
+
+// Text up to NUL/0xFF padding, trailing spaces ignored
+static int compare_text(const QueryTerm *term, const uint8_t *field, size_t size)
+{
+	size_t len = 0;
+	while (len < size && field[len] && field[len] != 0xFF)
+	{
+		len++;
+	}
+	while (len > 0 && field[len - 1] == ' ')
+	{
+		len--;
+	}
+
+	size_t want = strlen(term->text);
+	int equal = term->prefix ? len >= want && memcmp(field, term->text, want) == 0
+							 : len == want && memcmp(field, term->text, want) == 0;
+	return term->cmp == CMP_EQ ? equal : !equal;
+}
+
+static int eval_term(const QueryTerm *term, QueryImage *image)
+{
+	if (term->kind != TERM_FIELD)
+	{
+		uint8_t all = (uint8_t)((1u << image->check.region_count) - 1);
+		for (int r = 0; r < image->check.region_count; r++)
+		{
+			ensure_region(image, r);
+		}
+		uint8_t mask = term->kind == TERM_CRC_OK ? image->check.crc_ok : image->check.test_pass;
+		return compare(mask == all, term->cmp, term->value);
+	}
+
+	// Comparisons on fields missing from this layout are false (not
+	// negates them like any other term)
+	const ColumnSource *source = &term->column.source[image->slot];
+	if (!source->size)
+	{
+		return 0;
+	}
+	if (term->region[image->slot] >= 0)
+	{
+		ensure_region(image, term->region[image->slot]);
+	}
+
+	const uint8_t *p = image->data + source->offset;
+	if (term->is_string)
+	{
+		return compare_text(term, p, source->size);
+	}
+
+	int32_t value;
+	if (source->size == 2)
+	{
+		value = source->big_endian ? (p[0] << 8 | p[1]) : (p[0] | p[1] << 8);
+	}
+	else
+	{
+		value = term->column.kind == COLUMN_I8 ? (int8_t)p[0] : p[0];
+	}
+	return compare(value, term->cmp, term->value);
+}
+
+int query_match(const Query *query, const uint8_t *data, size_t size)
+{
+	QueryImage image;
+	memset(image.data, 0xFF, sizeof(image.data));
+	memcpy(image.data, data, size < EEPROM_SIZE ? size : EEPROM_SIZE);
+
+	image.slot = column_slot(image.data[0]);
+	if (image.slot < 0)
+	{
+		return -1;
+	}
+	image.version = (EEPROMVersion)image.data[0];
+	image.decoded = 0;
+	memset(&image.check, 0, sizeof(image.check));
+	image.check.version = image.version;
+	image.check.region_count = (uint8_t)eeprom_get_layout(image.version)->region_count;
+
+	// A decode cache hit has every region decoded; a miss is decoded one
+	// region at a time and not stored
+	if (batch_decode_cached(image.data, &image.check))
+	{
+		image.decoded = 0xFF;
+	}
+
+	int stack[QUERY_MAX_CODE];
+	int sp = 0;
+	size_t pc = 0;
+
+	while (pc < query->code_len)
+	{
+		const QueryOp *op = &query->code[pc];
+		switch (op->opcode)
+		{
+			case OP_TERM:
+				stack[sp++] = eval_term(&query->terms[op->arg], &image);
+				pc++;
+				break;
+			case OP_NOT:
+				stack[sp - 1] = !stack[sp - 1];
+				pc++;
+				break;
+			case OP_AND:
+				pc = stack[sp - 1] ? (sp--, pc + 1) : op->arg;
+				break;
+			case OP_OR:
+				pc = stack[sp - 1] ? op->arg : (sp--, pc + 1);
+				break;
+		}
+	}
+	return stack[0];
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+// Images are matched on the batch worker threads (-j, default: CPUs);
+// matching names are printed as they are found.
+
+typedef struct
+{
+	const Query *query;
+	int count_only;
+	pthread_mutex_t lock;
+	size_t images;
+	size_t matched;
+	size_t unknown;
+} QueryRun;
+
+static int query_image(const char *name, const uint8_t *data, size_t size, void *ctx)
+{
+	QueryRun *run = (QueryRun*)ctx;
+	int match = query_match(run->query, data, size);
+
+	pthread_mutex_lock(&run->lock);
+	run->images++;
+	run->unknown += match < 0;
+	if (match > 0)
+	{
+		run->matched++;
+		if (!run->count_only)
+		{
+			printf("%s\n", name);
+		}
+	}
+	pthread_mutex_unlock(&run->lock);
+	return 0;
+}
+
+int cmd_query(int argc, char **argv)
+{
+	QueryRun run;
+	memset(&run, 0, sizeof(run));
+	const char *expr = NULL;
+	char *paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-c") == 0)
+		{
+			run.count_only = 1;
+			continue;
+		}
+		if (!expr)
+		{
+			expr = argv[i];
+			continue;
+		}
+		paths[path_count++] = argv[i];
+	}
+
+	if (!expr || path_count == 0)
+	{
+		fprintf(stderr, "Usage: eeprom_tool query [-c] EXPR PATH...\n");
+		return 1;
+	}
+
+	char error[128];
+	run.query = query_compile(expr, error, sizeof(error));
+	if (!run.query)
+	{
+		fprintf(stderr, "Error: %s\n", error);
+		return 1;
+	}
+
+	pthread_mutex_init(&run.lock, NULL);
+	batch_for_each_parallel(paths, path_count, query_image, &run, NULL);
+	pthread_mutex_destroy(&run.lock);
+
+	if (run.count_only)
+	{
+		printf("%zu\n", run.matched);
+	}
+	fflush(stdout);
+	fprintf(stderr, "%zu of %zu images matched", run.matched, run.images);
+	if (run.unknown)
+	{
+		fprintf(stderr, " (%zu of unknown version)", run.unknown);
+	}
+	fprintf(stderr, "\n");
+
+	query_free((Query*)run.query);
+	return 0;
+}
@@ -0,0 +1,44 @@
+#ifndef QUERY_H
+#define QUERY_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Field Queries
+// ═══════════════════════════════════════════════════════════════
+// Expressions over FieldMetadata names (or their snake_case aliases):
+//
+//   version >= 4 and version <= 6 and chip_bin == 2 and pt2_result != 1
+//   "PSU Voltage" > 13.80 or not (board_name == "BHB42*")
+//
+// Operators: == != < <= > >=, and/&&, or/||, not/!, parentheses.
+// Pseudo fields: version (byte 0), crc_ok and test_pass (all regions).
+// Decimal constants on voltage/hashrate fields are in V or TH/s; a string
+// constant ending in '*' is a prefix match. "voltage" is the PT2 PSU
+// voltage in v1 images as in the others; any other bare member name that
+// several fields of one layout share is rejected.
+// A comparison on a field the image's layout lacks is false, whatever
+// the operator: "sweep_result != 1" never matches a v4 image while
+// "not sweep_result == 1" matches every v4 image.
+//
+// A query is compiled once into a short stack program. Terms in and/or
+// chains are ordered by how many regions they need decrypted, and regions
+// are decrypted only when a term first reads them.
+
+typedef struct Query Query;
+
+// Returns NULL and writes a message to error on syntax or name errors
+Query *query_compile(const char *text, char *error, size_t error_size);
+void query_free(Query *query);
+
+// 1 if the image matches, 0 if not, -1 if its version is unknown.
+// data (size <= EEPROM_SIZE) is copied; safe to call from several threads.
+// Only the regions the query reads are decrypted, unless the image is in
+// the --cache decode cache.
+int query_match(const Query *query, const uint8_t *data, size_t size);
+
+// CLI: eeprom_tool query [-c] EXPR PATH...
+int cmd_query(int argc, char **argv);
+
+#endif // QUERY_H
@@ -0,0 +1,661 @@
+#include "retune.h"
+#include "batch.h"
+#include "eeprom_ops.h"
+#include "eeprom_structure.h"
+#include "patch.h"
+#include "topology.h"
+#include <ctype.h>
+#include <math.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/stat.h>
+
+#define RETUNE_MAX_BASE 2000       // Sweep Freq Base range in the schema
+
+// ═══════════════════════════════════════════════════════════════
+// Performance Log
+// ═══════════════════════════════════════════════════════════════
+
+enum
+{
+	COLUMN_NONE,
+	COLUMN_SERIAL,
+	COLUMN_ASIC,
+	COLUMN_NONCES,
+	COLUMN_ERRORS
+};
+
+static char *trim(char *s)
+{
+	while (isspace((unsigned char)*s))
+	{
+		s++;
+	}
+	char *end = s + strlen(s);
+	while (end > s && isspace((unsigned char)end[-1]))
+	{
+		*--end = '\0';
+	}
+	return s;
+}
+
+static int column_kind(const char *name)
+{
+	static const struct
+	{
+		const char *name;
+		int kind;
+	} names[] = {
+		{ "serial", COLUMN_SERIAL }, { "board_sn", COLUMN_SERIAL }, { "sn", COLUMN_SERIAL },
+		{ "asic", COLUMN_ASIC }, { "chip", COLUMN_ASIC },
+		{ "nonces", COLUMN_NONCES }, { "nonce", COLUMN_NONCES },
+		{ "errors", COLUMN_ERRORS }, { "error", COLUMN_ERRORS }, { "hw", COLUMN_ERRORS },
+	};
+	for (size_t i = 0; i < sizeof(names) / sizeof(names[0]); i++)
+	{
+		if (strcasecmp(name, names[i].name) == 0)
+		{
+			return names[i].kind;
+		}
+	}
+	return COLUMN_NONE;
+}
+
+static int chip_compare(const void *a, const void *b)
+{
+	const RetuneChip *x = (const RetuneChip*)a;
+	const RetuneChip *y = (const RetuneChip*)b;
+	int c = strcmp(x->serial, y->serial);
+	return c ? c : (int)x->asic - (int)y->asic;
+}
+
+static int log_add(RetuneLog *log, const RetuneChip *chip)
+{
+	if (log->count == log->capacity)
+	{
+		size_t capacity = log->capacity ? log->capacity * 2 : 1024;
+		RetuneChip *chips = realloc(log->chips, capacity * sizeof(RetuneChip));
+		if (!chips)
+		{
+			fprintf(stderr, "Error: Out of memory\n");
+			return -1;
+		}
+		log->chips = chips;
+		log->capacity = capacity;
+	}
+	log->chips[log->count++] = *chip;
+	return 0;
+}
+
+static int log_parse(char *text, RetuneLog *log, const char *path)
+{
+	int columns[16];
+	int column_count = 0;
+	int line_no = 0;
+	char *save_line;
+
+	for (char *line = strtok_r(text, "\n", &save_line); line; line = strtok_r(NULL, "\n", &save_line))
+	{
+		line_no++;
+		line = trim(line);
+		if (!*line || line[0] == '#')
+		{
+			continue;
+		}
+
+		char *cells[16];
+		int cell_count = 0;
+		for (char *p = line; cell_count < 16; )
+		{
+			char *comma = strchr(p, ',');
+			if (comma)
+			{
+				*comma = '\0';
+			}
+			cells[cell_count++] = trim(p);
+			if (!comma)
+			{
+				break;
+			}
+			p = comma + 1;
+		}
+
+		if (column_count == 0)
+		{
+			int seen = 0;
+			for (int i = 0; i < cell_count; i++)
+			{
+				columns[column_count++] = column_kind(cells[i]);
+				seen |= 1 << columns[i];
+			}
+			log->has_nonces = (seen >> COLUMN_NONCES) & 1;
+			log->has_errors = (seen >> COLUMN_ERRORS) & 1;
+			if (!((seen >> COLUMN_SERIAL) & 1) || !((seen >> COLUMN_ASIC) & 1) ||
+				!(log->has_nonces || log->has_errors))
+			{
+				fprintf(stderr, "Error: %s:%d: header needs serial, asic and nonces and/or errors\n",
+						path, line_no);
+				return -1;
+			}
+			continue;
+		}
+
+		RetuneChip chip;
+		memset(&chip, 0, sizeof(chip));
+		for (int i = 0; i < cell_count && i < column_count; i++)
+		{
+			char *end;
+			unsigned long value = strtoul(cells[i], &end, 10);
+			int number = end != cells[i] && !*end;
+			switch (columns[i])
+			{
+				case COLUMN_SERIAL:
+					snprintf(chip.serial, sizeof(chip.serial), "%s", cells[i]);
+					continue;
+				case COLUMN_ASIC:
+					if (!number || value >= SWEEP_MAX_ASICS)
+					{
+						fprintf(stderr, "Error: %s:%d: ASIC must be 0..%d\n", path, line_no, SWEEP_MAX_ASICS - 1);
+						return -1;
+					}
+					chip.asic = (uint16_t)value;
+					continue;
+				case COLUMN_NONCES:
+				case COLUMN_ERRORS:
+					if (!number || value > UINT32_MAX)
+					{
+						fprintf(stderr, "Error: %s:%d: '%s' is not a count\n", path, line_no, cells[i]);
+						return -1;
+					}
+					*(columns[i] == COLUMN_NONCES ? &chip.nonces : &chip.errors) = (uint32_t)value;
+					continue;
+			}
+		}
+		if (!chip.serial[0])
+		{
+			fprintf(stderr, "Error: %s:%d: empty serial\n", path, line_no);
+			return -1;
+		}
+		if (log_add(log, &chip) != 0)
+		{
+			return -1;
+		}
+	}
+	return 0;
+}
+
+int retune_log_load(const char *path, RetuneLog *log)
+{
+	memset(log, 0, sizeof(*log));
+
+	FILE *file = fopen(path, "rb");
+	if (!file)
+	{
+		fprintf(stderr, "Error: Cannot open log %s\n", path);
+		return -1;
+	}
+	fseek(file, 0, SEEK_END);
+	long size = ftell(file);
+	fseek(file, 0, SEEK_SET);
+
+	char *text = malloc(size > 0 ? (size_t)size + 1 : 1);
+	if (!text)
+	{
+		fclose(file);
+		fprintf(stderr, "Error: Out of memory\n");
+		return -1;
+	}
+	size_t n = fread(text, 1, size > 0 ? (size_t)size : 0, file);
+	fclose(file);
+	text[n] = '\0';
+
+	int result = log_parse(text, log, path);
+	free(text);
+	if (result != 0)
+	{
+		retune_log_free(log);
+		return -1;
+	}
+
+	// Sum rows of the same chip (several logging intervals)
+	qsort(log->chips, log->count, sizeof(RetuneChip), chip_compare);
+	size_t out = 0;
+	for (size_t i = 0; i < log->count; i++)
+	{
+		if (out > 0 && chip_compare(&log->chips[out - 1], &log->chips[i]) == 0)
+		{
+			RetuneChip *chip = &log->chips[out - 1];
+			uint64_t nonces = (uint64_t)chip->nonces + log->chips[i].nonces;
+			uint64_t errors = (uint64_t)chip->errors + log->chips[i].errors;
+			chip->nonces = nonces > UINT32_MAX ? UINT32_MAX : (uint32_t)nonces;
+			chip->errors = errors > UINT32_MAX ? UINT32_MAX : (uint32_t)errors;
+			continue;
+		}
+		log->chips[out++] = log->chips[i];
+	}
+	log->count = out;
+	return 0;
+}
+
+void retune_log_free(RetuneLog *log)
+{
+	free(log->chips);
+	memset(log, 0, sizeof(*log));
+}
+
+const RetuneChip *retune_log_find(const RetuneLog *log, const char *serial, size_t *count)
+{
+	size_t lo = 0, hi = log->count;
+	while (lo < hi)
+	{
+		size_t mid = lo + (hi - lo) / 2;
+		if (strcmp(log->chips[mid].serial, serial) < 0)
+		{
+			lo = mid + 1;
+		}
+		else
+		{
+			hi = mid;
+		}
+	}
+	size_t end = lo;
+	while (end < log->count && strcmp(log->chips[end].serial, serial) == 0)
+	{
+		end++;
+	}
+	*count = end - lo;
+	return end > lo ? &log->chips[lo] : NULL;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Targets and Quantization
+// ═══════════════════════════════════════════════════════════════
+
+static int double_compare(const void *a, const void *b)
+{
+	double x = *(const double*)a, y = *(const double*)b;
+	return x < y ? -1 : x > y;
+}
+
+void retune_targets(const RetuneLog *log, const RetuneChip *chips, size_t count, const uint16_t *freq,
+					size_t asics, double max_change, uint16_t *target)
+{
+	memcpy(target, freq, asics * sizeof(uint16_t));
+
+	// Board median of nonces per MHz, and the worst error count
+	double rates[SWEEP_MAX_ASICS];
+	size_t rate_count = 0;
+	uint32_t max_errors = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		if (chips[i].asic < asics && freq[chips[i].asic])
+		{
+			rates[rate_count++] = (double)chips[i].nonces / freq[chips[i].asic];
+			max_errors = chips[i].errors > max_errors ? chips[i].errors : max_errors;
+		}
+	}
+	qsort(rates, rate_count, sizeof(double), double_compare);
+	double median = rate_count ? rates[rate_count / 2] : 0.0;
+
+	for (size_t i = 0; i < count; i++)
+	{
+		const RetuneChip *chip = &chips[i];
+		if (chip->asic >= asics || !freq[chip->asic])
+		{
+			continue;
+		}
+
+		double f = freq[chip->asic];
+		double ratio = 1.0;
+		if (log->has_nonces)
+		{
+			ratio = median > 0.0 ? (chip->nonces / f) / median : 1.0;
+			if (log->has_errors && chip->nonces + (uint64_t)chip->errors > 0)
+			{
+				ratio *= 1.0 - (double)chip->errors / ((double)chip->nonces + chip->errors);
+			}
+		}
+		else if (max_errors)
+		{
+			ratio = 1.0 - max_change * chip->errors / max_errors;
+		}
+
+		ratio = ratio < 1.0 - max_change ? 1.0 - max_change : ratio > 1.0 + max_change ? 1.0 + max_change : ratio;
+		long value = lround(f * ratio);
+		target[chip->asic] = (uint16_t)(value > UINT16_MAX ? UINT16_MAX : value);
+	}
+}
+
+// MHz lost to rounding down, giving up once limit is reached
+static uint32_t quantize_loss(const uint16_t *target, size_t asics, int base, int step, uint32_t limit)
+{
+	int top = base + (SWEEP_LEVELS - 1) * step;
+	uint32_t loss = 0;
+	for (size_t i = 0; i < asics && loss < limit; i++)
+	{
+		int value = target[i];
+		loss += (uint32_t)(value >= top ? value - top : (value - base) % step);
+	}
+	return loss;
+}
+
+void retune_quantize(const uint16_t *target, size_t asics, RetuneQuantization *q)
+{
+	int lo = UINT16_MAX, hi = 0;
+	for (size_t i = 0; i < asics; i++)
+	{
+		lo = target[i] < lo ? target[i] : lo;
+		hi = target[i] > hi ? target[i] : hi;
+	}
+	memset(q->levels, 0, sizeof(q->levels));
+	q->loss = 0;
+	if (asics == 0)
+	{
+		return;
+	}
+
+	// The base cannot exceed the slowest target (its level 0 would
+	// overclock it); a step above the span only loses more
+	int best_base = q->base, best_step = q->step;
+	uint32_t best = best_step && best_base <= lo ? quantize_loss(target, asics, best_base, best_step, UINT32_MAX)
+												 : UINT32_MAX;
+	int max_step = hi - lo < 1 ? 1 : hi - lo > UINT8_MAX ? UINT8_MAX : hi - lo;
+	int base_hi = lo < RETUNE_MAX_BASE ? lo : RETUNE_MAX_BASE;
+
+	for (int step = 1; step <= max_step && best; step++)
+	{
+		int base_lo = lo - step + 1 > 0 ? lo - step + 1 : 0;
+		base_lo = base_lo < base_hi ? base_lo : base_hi;
+		for (int base = base_hi; base >= base_lo && best; base--)
+		{
+			uint32_t loss = quantize_loss(target, asics, base, step, best);
+			if (loss < best)
+			{
+				best = loss;
+				best_base = base;
+				best_step = step;
+			}
+		}
+	}
+
+	q->base = (uint16_t)best_base;
+	q->step = (uint8_t)best_step;
+	q->loss = best;
+	for (size_t i = 0; i < asics; i++)
+	{
+		int level = (target[i] - best_base) / best_step;
+		level = level > SWEEP_LEVELS - 1 ? SWEEP_LEVELS - 1 : level;
+		q->levels[i / 2] |= (uint8_t)(i % 2 ? level : level << 4);
+	}
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	RetuneLog log;
+	TopologyDB *topologies;
+	const char *out_dir;
+	int in_place;
+	int dry_run;
+	double max_change;
+
+	pthread_mutex_t lock;
+	size_t retuned;
+	size_t unchanged;
+	size_t unlogged;               // No log rows for the serial
+	size_t skipped;
+	size_t failed;
+	uint64_t loss;
+} RetuneRun;
+
+static void retune_report(RetuneRun *run, size_t *counter, const char *name, const char *error)
+{
+	pthread_mutex_lock(&run->lock);
+	(*counter)++;
+	if (error)
+	{
+		fprintf(stderr, "Error: %s: %s\n", name, error);
+	}
+	pthread_mutex_unlock(&run->lock);
+}
+
+// New base, step, levels and hashrate into the decoded image
+static void sweep_write(uint8_t *data, EEPROMVersion version, const RetuneQuantization *q, double scale)
+{
+	if (version == EEPROM_VERSION_V1)
+	{
+		EEPROMStructure_v1 eeprom;
+		eeprom_v1_parse(&eeprom, data);
+		long hashrate = lround(eeprom.sweep_data.sweep_hashrate * scale);
+		eeprom.sweep_data.sweep_hashrate = (uint16_t)(hashrate > UINT16_MAX ? UINT16_MAX : hashrate);
+		eeprom.sweep_data.sweep_freq_base = q->base;
+		eeprom.sweep_data.sweep_freq_step = q->step;
+		memcpy(eeprom.sweep_data.sweep_level, q->levels, SWEEP_LEVEL_BYTES);
+		eeprom_v1_serialize(&eeprom, data);
+	}
+	else
+	{
+		EEPROMStructure eeprom;
+		eeprom_from_bytes(&eeprom, data);
+		long hashrate = lround(eeprom.sweep_data.sweep_hashrate * scale);
+		eeprom.sweep_data.sweep_hashrate = (uint16_t)(hashrate > UINT16_MAX ? UINT16_MAX : hashrate);
+		eeprom.sweep_data.sweep_freq_base = q->base;
+		eeprom.sweep_data.sweep_freq_step = q->step;
+		memcpy(eeprom.sweep_data.sweep_level, q->levels, SWEEP_LEVEL_BYTES);
+		eeprom_to_bytes(&eeprom, data);
+	}
+}
+
+static int retune_image(const char *name, const uint8_t *raw, size_t size, void *ctx)
+{
+	RetuneRun *run = (RetuneRun*)ctx;
+	uint8_t data[EEPROM_SIZE];
+	memset(data, 0xFF, sizeof(data));
+	memcpy(data, raw, size);
+
+	EEPROMCheck check;
+	if (batch_decode(data, &check) != EEPROM_SUCCESS)
+	{
+		retune_report(run, &run->skipped, name, "unknown EEPROM version");
+		return 0;
+	}
+	if (check.crc_ok != EEPROM_CHECK_ALL(&check))
+	{
+		retune_report(run, &run->skipped, name, "CRC mismatch, not retuned");
+		return 0;
+	}
+
+	PairBoard board;
+	SweepBoard sweep;
+	if (pair_board_read(data, &check, &board) != 0 || sweep_board(data, &check, &sweep) != 0)
+	{
+		retune_report(run, &run->skipped, name, NULL);
+		return 0;
+	}
+
+	size_t count;
+	const RetuneChip *chips = retune_log_find(&run->log, board.serial, &count);
+	if (!count)
+	{
+		retune_report(run, &run->unlogged, name, NULL);
+		return 0;
+	}
+
+	// ASICs on the chain per the board's config, else up to the last logged
+	const SweepTopology *topology = topology_chain(run->topologies, board.board);
+	size_t asics = chips[count - 1].asic + 1;
+	if (topology && topology->chain_asic_num > 0 && topology->chain_asic_num <= SWEEP_MAX_ASICS)
+	{
+		asics = (size_t)topology->chain_asic_num;
+	}
+
+	uint16_t freq[SWEEP_MAX_ASICS];
+	uint16_t target[SWEEP_MAX_ASICS];
+	sweep_expand(sweep.levels, SWEEP_LEVEL_BYTES, sweep.freq_base, sweep.freq_step, freq);
+	retune_targets(&run->log, chips, count, freq, asics, run->max_change, target);
+
+	RetuneQuantization q;
+	q.base = sweep.freq_base;
+	q.step = sweep.freq_step;
+	retune_quantize(target, asics, &q);
+	if (q.base == sweep.freq_base && q.step == sweep.freq_step &&
+		memcmp(q.levels, sweep.levels, SWEEP_LEVEL_BYTES) == 0)
+	{
+		retune_report(run, &run->unchanged, name, NULL);
+		return 0;
+	}
+
+	// The sweep hashrate follows the chain's summed frequency
+	uint16_t retuned[SWEEP_MAX_ASICS];
+	uint64_t before = 0, after = 0;
+	sweep_expand(q.levels, SWEEP_LEVEL_BYTES, q.base, q.step, retuned);
+	for (size_t i = 0; i < asics; i++)
+	{
+		before += freq[i];
+		after += retuned[i];
+	}
+
+	sweep_write(data, check.version, &q, before ? (double)after / (double)before : 1.0);
+	if (eeprom_encode(data, EEPROM_SIZE, check.version) != EEPROM_SUCCESS)
+	{
+		retune_report(run, &run->failed, name, "encode failed");
+		return 0;
+	}
+
+	uint8_t verify[EEPROM_SIZE];
+	EEPROMCheck verify_check;
+	memcpy(verify, data, sizeof(verify));
+	if (eeprom_decode_check(verify, EEPROM_SIZE, check.version, &verify_check) != EEPROM_SUCCESS ||
+		verify_check.crc_ok != EEPROM_CHECK_ALL(&verify_check))
+	{
+		retune_report(run, &run->failed, name, "re-encoded image fails CRC check");
+		return 0;
+	}
+
+	if (!run->dry_run)
+	{
+		char path[4200];
+		patch_output_path(run->in_place ? NULL : run->out_dir, name, size, path, sizeof(path));
+
+		struct stat st;
+		if (run->in_place && (stat(name, &st) != 0 || !S_ISREG(st.st_mode) || (size_t)st.st_size != size))
+		{
+			retune_report(run, &run->failed, name, "not a plain image file, use -o DIR");
+			return 0;
+		}
+		if (patch_write_atomic(path, data, size) != 0)
+		{
+			retune_report(run, &run->failed, name, "cannot write output");
+			return 0;
+		}
+	}
+
+	pthread_mutex_lock(&run->lock);
+	run->retuned++;
+	run->loss += q.loss;
+	printf("  %s: %s base %u->%u MHz, step %u->%u MHz, mean %.1f->%.1f MHz, loss %u MHz\n",
+		   name, board.serial, sweep.freq_base, q.base, sweep.freq_step, q.step,
+		   (double)before / asics, (double)after / asics, q.loss);
+	pthread_mutex_unlock(&run->lock);
+	return 0;
+}
+
+int cmd_retune(int argc, char **argv)
+{
+	RetuneRun run;
+	memset(&run, 0, sizeof(run));
+	run.max_change = 0.10;
+	const char *log_path = NULL;
+	const char *topology_dir = NULL;
+	char *paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-l") == 0 && i + 1 < argc)
+		{
+			log_path = argv[++i];
+		}
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			run.out_dir = argv[++i];
+		}
+		else if (strcmp(argv[i], "--in-place") == 0)
+		{
+			run.in_place = 1;
+		}
+		else if (strcmp(argv[i], "-n") == 0)
+		{
+			run.dry_run = 1;
+		}
+		else if (strcmp(argv[i], "-r") == 0 && i + 1 < argc)
+		{
+			run.max_change = strtod(argv[++i], NULL) / 100.0;
+			if (run.max_change < 0.0 || run.max_change > 1.0)
+			{
+				fprintf(stderr, "Error: Change limit must be 0..100 percent\n");
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			topology_dir = argv[++i];
+		}
+		else
+		{
+			paths[path_count++] = argv[i];
+		}
+	}
+
+	if (!log_path || path_count == 0 || (!run.out_dir && !run.in_place && !run.dry_run) ||
+		(run.out_dir && run.in_place))
+	{
+		fprintf(stderr, "Usage: eeprom_tool retune -l LOG.csv (-o DIR | --in-place) [-n] [-r PERCENT]\n"
+						"                           [-t TOPOLOGY_DIR] PATH...\n");
+		return 1;
+	}
+
+	if (run.out_dir)
+	{
+		struct stat st;
+		if (stat(run.out_dir, &st) != 0 && mkdir(run.out_dir, 0755) != 0)
+		{
+			fprintf(stderr, "Error: Cannot create %s\n", run.out_dir);
+			return 1;
+		}
+	}
+
+	if (topology_dir && !(run.topologies = topology_open(topology_dir)))
+	{
+		return 1;
+	}
+	if (retune_log_load(log_path, &run.log) != 0)
+	{
+		topology_close(run.topologies);
+		return 1;
+	}
+
+	pthread_mutex_init(&run.lock, NULL);
+	batch_for_each_parallel(paths, path_count, retune_image, &run, NULL);
+	pthread_mutex_destroy(&run.lock);
+
+	fflush(stdout);
+	fprintf(stderr, "%s: %zu, unchanged: %zu, not in log: %zu, skipped: %zu, errors: %zu, "
+			"quantization loss: %llu MHz\n",
+			run.dry_run ? "Would retune" : "Retuned", run.retuned, run.unchanged, run.unlogged,
+			run.skipped, run.failed, (unsigned long long)run.loss);
+
+	retune_log_free(&run.log);
+	topology_close(run.topologies);
+	return run.failed ? 2 : 0;
+}
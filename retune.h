@@ -0,0 +1,67 @@
+#ifndef RETUNE_H
+#define RETUNE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "pair.h"
+#include "sweep.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Sweep Level Retuning
+// ═══════════════════════════════════════════════════════════════
+// A performance log has one CSV row per chip with a header naming the
+// columns: serial, asic (or chip), and nonces and/or errors (hw). Rows of
+// the same chip are summed. Each logged ASIC gets a target frequency:
+//
+//   nonces only      f * (nonces/f) / median(nonces/f) over the board
+//   nonces, errors   the same, times 1 - errors / (nonces + errors)
+//   errors only      f * (1 - max_change * errors / max(errors))
+//
+// clamped to f * (1 +- max_change). Unlogged ASICs keep f. The targets
+// are then re-quantized into a new base, step and 4-bit levels.
+
+typedef struct
+{
+	char serial[PAIR_SERIAL_LEN];
+	uint16_t asic;
+	uint32_t nonces;
+	uint32_t errors;
+} RetuneChip;
+
+typedef struct
+{
+	RetuneChip *chips;             // Sorted by serial, then ASIC
+	size_t count;
+	size_t capacity;
+	int has_nonces;
+	int has_errors;
+} RetuneLog;
+
+typedef struct
+{
+	uint16_t base;                 // MHz
+	uint8_t step;                  // MHz
+	uint32_t loss;                 // MHz below target, summed over the ASICs
+	uint8_t levels[SWEEP_LEVEL_BYTES];
+} RetuneQuantization;
+
+// Load and sort a log; prints an error and returns -1 on failure
+int retune_log_load(const char *path, RetuneLog *log);
+void retune_log_free(RetuneLog *log);
+// Log rows of one board (count 0 if none)
+const RetuneChip *retune_log_find(const RetuneLog *log, const char *serial, size_t *count);
+
+// Target frequencies of the first asics ASICs from their current ones
+void retune_targets(const RetuneLog *log, const RetuneChip *chips, size_t count, const uint16_t *freq,
+					size_t asics, double max_change, uint16_t *target);
+
+// Base, step and levels that never exceed a target and lose the fewest
+// MHz to rounding down. q->base and q->step hold the current values on
+// entry and are kept on a tie. Levels past asics are 0.
+void retune_quantize(const uint16_t *target, size_t asics, RetuneQuantization *q);
+
+// CLI: eeprom_tool retune -l LOG.csv (-o DIR | --in-place) [-n] [-r PERCENT]
+//                         [-t TOPOLOGY_DIR] PATH...
+int cmd_retune(int argc, char **argv);
+
+#endif // RETUNE_H
@@ -0,0 +1,213 @@
+#include "sketch.h"
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// t-digest
+// ═══════════════════════════════════════════════════════════════
+
+void tdigest_init(TDigest *digest)
+{
+	digest->merged = 0;
+	digest->count = 0;
+	digest->total = 0.0;
+	digest->min = INFINITY;
+	digest->max = -INFINITY;
+}
+
+static int centroid_compare(const void *a, const void *b)
+{
+	double ma = ((const TDigestCentroid*)a)->mean;
+	double mb = ((const TDigestCentroid*)b)->mean;
+	return (ma > mb) - (ma < mb);
+}
+
+// k1(q) = compression / 2pi * asin(2q - 1) and its inverse
+static double scale_k(double q)
+{
+	return TDIGEST_COMPRESSION / (2.0 * M_PI) * asin(2.0 * q - 1.0);
+}
+
+static double scale_q(double k)
+{
+	return (sin(k * 2.0 * M_PI / TDIGEST_COMPRESSION) + 1.0) / 2.0;
+}
+
+// Sort everything and merge neighbours while a centroid spans at most
+// one unit of k
+static void tdigest_compress(TDigest *digest)
+{
+	if (digest->count == digest->merged && digest->merged > 0)
+	{
+		return;
+	}
+	if (digest->count == 0)
+	{
+		return;
+	}
+
+	TDigestCentroid *c = digest->centroids;
+	qsort(c, digest->count, sizeof(TDigestCentroid), centroid_compare);
+
+	double total = digest->total;
+	double before = 0.0;           // Weight of the emitted centroids
+	double limit = total * scale_q(scale_k(0.0) + 1.0);
+	size_t out = 0;
+	TDigestCentroid current = c[0];
+
+	for (size_t i = 1; i < digest->count; i++)
+	{
+		if (before + current.weight + c[i].weight <= limit)
+		{
+			current.weight += c[i].weight;
+			current.mean += (c[i].mean - current.mean) * c[i].weight / current.weight;
+		}
+		else
+		{
+			before += current.weight;
+			c[out++] = current;
+			limit = total * scale_q(scale_k(before / total) + 1.0);
+			current = c[i];
+		}
+	}
+	c[out++] = current;
+
+	digest->merged = out;
+	digest->count = out;
+}
+
+static void tdigest_push(TDigest *digest, double mean, double weight)
+{
+	if (digest->count == TDIGEST_CAPACITY)
+	{
+		tdigest_compress(digest);
+	}
+	digest->centroids[digest->count].mean = mean;
+	digest->centroids[digest->count].weight = weight;
+	digest->count++;
+	digest->total += weight;
+}
+
+void tdigest_add(TDigest *digest, double value)
+{
+	tdigest_push(digest, value, 1.0);
+	if (value < digest->min)
+	{
+		digest->min = value;
+	}
+	if (value > digest->max)
+	{
+		digest->max = value;
+	}
+}
+
+void tdigest_merge(TDigest *dst, TDigest *src)
+{
+	tdigest_compress(src);
+	for (size_t i = 0; i < src->count; i++)
+	{
+		tdigest_push(dst, src->centroids[i].mean, src->centroids[i].weight);
+	}
+	if (src->min < dst->min)
+	{
+		dst->min = src->min;
+	}
+	if (src->max > dst->max)
+	{
+		dst->max = src->max;
+	}
+}
+
+double tdigest_quantile(TDigest *digest, double q)
+{
+	tdigest_compress(digest);
+	if (digest->count == 0)
+	{
+		return 0.0;
+	}
+	if (q <= 0.0)
+	{
+		return digest->min;
+	}
+	if (q >= 1.0)
+	{
+		return digest->max;
+	}
+
+	const TDigestCentroid *c = digest->centroids;
+	size_t n = digest->count;
+	double target = q * digest->total;
+
+	// Each centroid's mean sits at the middle of its weight; interpolate
+	// between neighbouring middles, and towards min/max at the ends
+	if (target < c[0].weight / 2.0)
+	{
+		return digest->min + (c[0].mean - digest->min) * target / (c[0].weight / 2.0);
+	}
+
+	double cumulative = 0.0;
+	for (size_t i = 0; i + 1 < n; i++)
+	{
+		double left = cumulative + c[i].weight / 2.0;
+		double right = cumulative + c[i].weight + c[i + 1].weight / 2.0;
+		if (target < right)
+		{
+			return c[i].mean + (c[i + 1].mean - c[i].mean) * (target - left) / (right - left);
+		}
+		cumulative += c[i].weight;
+	}
+
+	double left = digest->total - c[n - 1].weight / 2.0;
+	double span = digest->total - left;
+	return c[n - 1].mean + (digest->max - c[n - 1].mean) * (target - left) / span;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// HyperLogLog
+// ═══════════════════════════════════════════════════════════════
+
+void hll_add(HyperLogLog *hll, uint64_t hash)
+{
+	uint32_t index = (uint32_t)(hash >> (64 - HLL_PRECISION));
+	// Position of the first set bit after the index bits; the sentinel
+	// bit caps the rank for an all-zero remainder
+	uint64_t rest = hash << HLL_PRECISION | (1ULL << (HLL_PRECISION - 1));
+	uint8_t rank = (uint8_t)(__builtin_clzll(rest) + 1);
+	if (rank > hll->registers[index])
+	{
+		hll->registers[index] = rank;
+	}
+}
+
+void hll_merge(HyperLogLog *dst, const HyperLogLog *src)
+{
+	for (size_t i = 0; i < HLL_REGISTERS; i++)
+	{
+		if (src->registers[i] > dst->registers[i])
+		{
+			dst->registers[i] = src->registers[i];
+		}
+	}
+}
+
+double hll_estimate(const HyperLogLog *hll)
+{
+	const double m = HLL_REGISTERS;
+	double sum = 0.0;
+	size_t zeros = 0;
+	for (size_t i = 0; i < HLL_REGISTERS; i++)
+	{
+		sum += ldexp(1.0, -hll->registers[i]);
+		zeros += hll->registers[i] == 0;
+	}
+
+	double estimate = 0.7213 / (1.0 + 1.079 / m) * m * m / sum;
+
+	// Linear counting while many registers are still empty
+	if (estimate <= 2.5 * m && zeros > 0)
+	{
+		estimate = m * log(m / (double)zeros);
+	}
+	return estimate;
+}
@@ -0,0 +1,62 @@
+#ifndef SKETCH_H
+#define SKETCH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Mergeable Streaming Sketches
+// ═══════════════════════════════════════════════════════════════
+// Fixed-size summaries for fleet-wide scans: memory does not grow with
+// the number of images, and two sketches of the same kind combine into
+// the sketch of the union, so each thread keeps its own and they are
+// merged at the end.
+
+// ── t-digest (quantiles) ───────────────────────────────────────
+// Merging variant with the arcsine scale function: centroids near the
+// tails stay small, so p1/p99 are accurate to a fraction of a percent.
+
+#define TDIGEST_COMPRESSION 100
+// Merged centroids plus the unsorted insert buffer
+#define TDIGEST_CAPACITY    (5 * TDIGEST_COMPRESSION)
+
+typedef struct
+{
+	double mean;
+	double weight;
+} TDigestCentroid;
+
+typedef struct
+{
+	TDigestCentroid centroids[TDIGEST_CAPACITY];
+	size_t merged;                 // Sorted, compressed entries at the front
+	size_t count;                  // merged + buffered points
+	double total;                  // Weight of everything added
+	double min;
+	double max;
+} TDigest;
+
+void tdigest_init(TDigest *digest);
+void tdigest_add(TDigest *digest, double value);
+// Fold src into dst (src is compressed as a side effect)
+void tdigest_merge(TDigest *dst, TDigest *src);
+// Value at quantile q (0..1); 0 if empty
+double tdigest_quantile(TDigest *digest, double q);
+
+// ── HyperLogLog (distinct counts) ──────────────────────────────
+// 2^14 one-byte registers: ~0.8% standard error in 16 KB.
+
+#define HLL_PRECISION 14
+#define HLL_REGISTERS (1u << HLL_PRECISION)
+
+typedef struct
+{
+	uint8_t registers[HLL_REGISTERS];
+} HyperLogLog;
+
+// Add a 64-bit hash of the item (eeprom_hash64)
+void hll_add(HyperLogLog *hll, uint64_t hash);
+void hll_merge(HyperLogLog *dst, const HyperLogLog *src);
+double hll_estimate(const HyperLogLog *hll);
+
+#endif // SKETCH_H
@@ -0,0 +1,642 @@
+#include "summary.h"
+#include "batch.h"
+#include "columns.h"
+#include "eeprom_ops.h"
+#include "field_index.h"
+#include "hash.h"
+#include "sketch.h"
+#include "ui.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Field Bindings
+// ═══════════════════════════════════════════════════════════════
+// Each metric is looked up under every name it has in some layout; the
+// result is one FieldMetadata per version slot (NULL if absent).
+
+typedef enum
+{
+	METRIC_SERIAL,
+	METRIC_FACTORY_JOB,
+	METRIC_BOARD_NAME,
+	METRIC_CHIP_BIN,
+	METRIC_VOLTAGE,
+	METRIC_FREQUENCY,
+	METRIC_HASHRATE,
+	METRIC_FREQ_BASE,
+	METRIC_FREQ_STEP,
+	METRIC_COUNT
+} Metric;
+
+static const char *const metric_names[METRIC_COUNT][3] =
+{
+	[METRIC_SERIAL]      = { "Board Serial", "Serial Number", NULL },
+	[METRIC_FACTORY_JOB] = { "Factory Job", NULL },
+	[METRIC_BOARD_NAME]  = { "Board Name", NULL },
+	[METRIC_CHIP_BIN]    = { "Chip Bin", NULL },
+	[METRIC_VOLTAGE]     = { "PSU Voltage", "Test Voltage", NULL },
+	[METRIC_FREQUENCY]   = { "Frequency", "Test Frequency", NULL },
+	[METRIC_HASHRATE]    = { "Sweep Hashrate", "Test Hashrate", NULL },
+	[METRIC_FREQ_BASE]   = { "Sweep Freq Base", NULL },
+	[METRIC_FREQ_STEP]   = { "Sweep Freq Step", NULL },
+};
+
+// Metrics summarized with a t-digest, one per version slot because the
+// units differ between layouts (V / mV, GH/s / TH/s)
+static const Metric quantile_metrics[] = { METRIC_VOLTAGE, METRIC_FREQUENCY, METRIC_HASHRATE };
+#define QUANTILE_METRICS (sizeof(quantile_metrics) / sizeof(quantile_metrics[0]))
+
+static const FieldMetadata *bindings[METRIC_COUNT][COLUMN_VERSIONS];
+static uint8_t binding_regions[METRIC_COUNT][COLUMN_VERSIONS];  // eeprom_field_regions()
+static pthread_once_t bindings_once = PTHREAD_ONCE_INIT;
+
+static void build_bindings(void)
+{
+	for (int m = 0; m < METRIC_COUNT; m++)
+	{
+		for (int slot = 0; slot < COLUMN_VERSIONS; slot++)
+		{
+			EEPROMVersion version = column_version(slot);
+			const EEPROMLayout *layout = eeprom_get_layout(version);
+			for (const char *const *name = metric_names[m]; *name; name++)
+			{
+				const FieldMetadata *field = field_index_find(version, *name);
+				if (field && eeprom_field_in_layout(field, layout))
+				{
+					bindings[m][slot] = field;
+					binding_regions[m][slot] = eeprom_field_regions(field, layout);
+					break;
+				}
+			}
+		}
+	}
+}
+
+// Binding of a metric, NULL if the layout lacks it or a region holding it
+// failed its CRC
+static const FieldMetadata *metric_field(Metric metric, int slot, const EEPROMCheck *check)
+{
+	if (binding_regions[metric][slot] & ~check->crc_ok)
+	{
+		return NULL;
+	}
+	return bindings[metric][slot];
+}
+
+static int32_t read_number(const uint8_t *decoded, const FieldMetadata *field)
+{
+	const uint8_t *p = decoded + field->offset;
+	if (field->size == 2)
+	{
+		return field->big_endian ? (p[0] << 8 | p[1]) : (p[0] | p[1] << 8);
+	}
+	return field->type == FIELD_TYPE_INT8 ? (int8_t)p[0] : p[0];
+}
+
+// Display value: hundredths for voltages and hashrates, mV as V
+static double read_scaled(const uint8_t *decoded, const FieldMetadata *field)
+{
+	double value = read_number(decoded, field);
+	if (field->type == FIELD_TYPE_VOLTAGE || field->type == FIELD_TYPE_HASHRATE)
+	{
+		return value / 100.0;
+	}
+	if (field->unit && strcmp(field->unit, "mV") == 0)
+	{
+		return value / 1000.0;
+	}
+	return value;
+}
+
+static const char *scaled_unit(const FieldMetadata *field)
+{
+	if (field->unit && strcmp(field->unit, "mV") == 0)
+	{
+		return "V";
+	}
+	return field->unit ? field->unit : "";
+}
+
+// Length without trailing padding (NUL, 0xFF, spaces); 0 = blank
+static size_t string_length(const uint8_t *p, size_t size)
+{
+	size_t n = 0;
+	while (n < size && p[n] != 0x00)
+	{
+		n++;
+	}
+	while (n > 0 && (p[n - 1] == 0xFF || p[n - 1] == ' '))
+	{
+		n--;
+	}
+	return n;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Bounded Count Tables
+// ═══════════════════════════════════════════════════════════════
+// Board names and sweep bases take few distinct values on a healthy
+// fleet; anything past the table size is counted as "other" so corrupt
+// images cannot grow it.
+
+#define SUMMARY_MAX_NAMES  128
+#define SUMMARY_MAX_VALUES 64
+#define SUMMARY_MAX_TESTS  8
+#define SUMMARY_NAME_LEN   16
+
+typedef struct
+{
+	char name[SUMMARY_NAME_LEN];
+	size_t count;
+} NameCount;
+
+typedef struct
+{
+	NameCount entries[SUMMARY_MAX_NAMES];
+	size_t used;
+	size_t other;
+} NameTable;
+
+typedef struct
+{
+	uint32_t value;
+	size_t count;
+} ValueCount;
+
+typedef struct
+{
+	ValueCount entries[SUMMARY_MAX_VALUES];
+	size_t used;
+	size_t other;
+} ValueTable;
+
+static void name_table_add(NameTable *table, const char *name, size_t count)
+{
+	for (size_t i = 0; i < table->used; i++)
+	{
+		if (strcmp(table->entries[i].name, name) == 0)
+		{
+			table->entries[i].count += count;
+			return;
+		}
+	}
+	if (table->used == SUMMARY_MAX_NAMES)
+	{
+		table->other += count;
+		return;
+	}
+	NameCount *entry = &table->entries[table->used++];
+	snprintf(entry->name, sizeof(entry->name), "%s", name);
+	entry->count = count;
+}
+
+static void value_table_add(ValueTable *table, uint32_t value, size_t count)
+{
+	for (size_t i = 0; i < table->used; i++)
+	{
+		if (table->entries[i].value == value)
+		{
+			table->entries[i].count += count;
+			return;
+		}
+	}
+	if (table->used == SUMMARY_MAX_VALUES)
+	{
+		table->other += count;
+		return;
+	}
+	table->entries[table->used].value = value;
+	table->entries[table->used].count = count;
+	table->used++;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Per-thread Summary
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	const char *name;              // RegionMeta.test_name
+	size_t tested;
+	size_t passed;
+} TestCount;
+
+typedef struct Summary Summary;
+
+typedef struct
+{
+	pthread_key_t key;             // Per-thread Summary
+	pthread_mutex_t lock;
+	Summary *total;                // Thread summaries are merged here
+} SummaryRun;
+
+struct Summary
+{
+	SummaryRun *run;
+	size_t images;
+	size_t unknown;
+	size_t crc_errors;
+	size_t versions[COLUMN_VERSIONS];
+	size_t chip_bins[256];
+	size_t freq_steps[256];
+	NameTable board_names;
+	ValueTable freq_bases;
+	TestCount tests[SUMMARY_MAX_TESTS];
+	size_t test_count;
+	TDigest quantiles[QUANTILE_METRICS][COLUMN_VERSIONS];
+	HyperLogLog serials;
+	HyperLogLog factory_jobs;
+};
+
+static Summary *summary_create(SummaryRun *run)
+{
+	Summary *summary = calloc(1, sizeof(*summary));
+	if (!summary)
+	{
+		return NULL;
+	}
+	summary->run = run;
+	for (size_t m = 0; m < QUANTILE_METRICS; m++)
+	{
+		for (int slot = 0; slot < COLUMN_VERSIONS; slot++)
+		{
+			tdigest_init(&summary->quantiles[m][slot]);
+		}
+	}
+	return summary;
+}
+
+static TestCount *summary_test(Summary *summary, const char *name)
+{
+	for (size_t i = 0; i < summary->test_count; i++)
+	{
+		if (strcmp(summary->tests[i].name, name) == 0)
+		{
+			return &summary->tests[i];
+		}
+	}
+	if (summary->test_count == SUMMARY_MAX_TESTS)
+	{
+		return NULL;
+	}
+	TestCount *test = &summary->tests[summary->test_count++];
+	test->name = name;
+	return test;
+}
+
+static void summary_merge(Summary *dst, Summary *src)
+{
+	dst->images += src->images;
+	dst->unknown += src->unknown;
+	dst->crc_errors += src->crc_errors;
+	for (int slot = 0; slot < COLUMN_VERSIONS; slot++)
+	{
+		dst->versions[slot] += src->versions[slot];
+	}
+	for (size_t i = 0; i < 256; i++)
+	{
+		dst->chip_bins[i] += src->chip_bins[i];
+		dst->freq_steps[i] += src->freq_steps[i];
+	}
+
+	for (size_t i = 0; i < src->board_names.used; i++)
+	{
+		name_table_add(&dst->board_names, src->board_names.entries[i].name, src->board_names.entries[i].count);
+	}
+	dst->board_names.other += src->board_names.other;
+	for (size_t i = 0; i < src->freq_bases.used; i++)
+	{
+		value_table_add(&dst->freq_bases, src->freq_bases.entries[i].value, src->freq_bases.entries[i].count);
+	}
+	dst->freq_bases.other += src->freq_bases.other;
+
+	for (size_t i = 0; i < src->test_count; i++)
+	{
+		TestCount *test = summary_test(dst, src->tests[i].name);
+		if (test)
+		{
+			test->tested += src->tests[i].tested;
+			test->passed += src->tests[i].passed;
+		}
+	}
+
+	for (size_t m = 0; m < QUANTILE_METRICS; m++)
+	{
+		for (int slot = 0; slot < COLUMN_VERSIONS; slot++)
+		{
+			tdigest_merge(&dst->quantiles[m][slot], &src->quantiles[m][slot]);
+		}
+	}
+	hll_merge(&dst->serials, &src->serials);
+	hll_merge(&dst->factory_jobs, &src->factory_jobs);
+}
+
+// Key destructor: fold a worker's summary into the total on thread exit
+static void summary_retire(void *ptr)
+{
+	Summary *summary = (Summary*)ptr;
+	SummaryRun *run = summary->run;
+
+	pthread_mutex_lock(&run->lock);
+	summary_merge(run->total, summary);
+	pthread_mutex_unlock(&run->lock);
+	free(summary);
+}
+
+// Every image counts towards its version; test results and field metrics
+// only come from regions whose CRC matched
+static void summary_add(Summary *summary, const uint8_t *decoded, int slot, const EEPROMCheck *check)
+{
+	const EEPROMLayout *layout = eeprom_get_layout(check->version);
+	const FieldMetadata *field;
+
+	summary->versions[slot]++;
+	summary->crc_errors += check->crc_ok != EEPROM_CHECK_ALL(check);
+
+	for (size_t r = 0; r < layout->region_count; r++)
+	{
+		const char *name = layout->regions[r].test_name;
+		TestCount *test = name && (check->crc_ok >> r & 1) ? summary_test(summary, name) : NULL;
+		if (test)
+		{
+			test->tested++;
+			test->passed += (check->test_pass >> r) & 1;
+		}
+	}
+
+	if ((field = metric_field(METRIC_CHIP_BIN, slot, check)))
+	{
+		summary->chip_bins[decoded[field->offset]]++;
+	}
+	if ((field = metric_field(METRIC_FREQ_STEP, slot, check)))
+	{
+		summary->freq_steps[decoded[field->offset]]++;
+	}
+	if ((field = metric_field(METRIC_FREQ_BASE, slot, check)))
+	{
+		value_table_add(&summary->freq_bases, (uint32_t)read_number(decoded, field), 1);
+	}
+	if ((field = metric_field(METRIC_BOARD_NAME, slot, check)))
+	{
+		char name[SUMMARY_NAME_LEN];
+		size_t n = string_length(decoded + field->offset, field->size);
+		n = n < sizeof(name) - 1 ? n : sizeof(name) - 1;
+		memcpy(name, decoded + field->offset, n);
+		name[n] = '\0';
+		name_table_add(&summary->board_names, n ? name : "(blank)", 1);
+	}
+
+	if ((field = metric_field(METRIC_SERIAL, slot, check)))
+	{
+		size_t n = string_length(decoded + field->offset, field->size);
+		if (n)
+		{
+			hll_add(&summary->serials, eeprom_hash64(decoded + field->offset, n, 0));
+		}
+	}
+	if ((field = metric_field(METRIC_FACTORY_JOB, slot, check)))
+	{
+		size_t n = string_length(decoded + field->offset, field->size);
+		if (n)
+		{
+			hll_add(&summary->factory_jobs, eeprom_hash64(decoded + field->offset, n, 0));
+		}
+	}
+
+	for (size_t m = 0; m < QUANTILE_METRICS; m++)
+	{
+		if ((field = metric_field(quantile_metrics[m], slot, check)))
+		{
+			tdigest_add(&summary->quantiles[m][slot], read_scaled(decoded, field));
+		}
+	}
+}
+
+static int summary_image(const char *name, const uint8_t *raw, size_t size, void *ctx)
+{
+	(void)name;
+	SummaryRun *run = (SummaryRun*)ctx;
+	Summary *summary = pthread_getspecific(run->key);
+	if (!summary)
+	{
+		if (!(summary = summary_create(run)))
+		{
+			fprintf(stderr, "Error: Out of memory\n");
+			return 1;
+		}
+		pthread_setspecific(run->key, summary);
+	}
+
+	uint8_t data[EEPROM_SIZE];
+	memset(data, 0xFF, sizeof(data));
+	memcpy(data, raw, size);
+
+	summary->images++;
+	EEPROMCheck check;
+	int slot = column_slot(data[0]);
+	if (slot < 0 || batch_decode(data, &check) == EEPROM_ERROR_VERSION)
+	{
+		summary->unknown++;
+		return 0;
+	}
+	summary_add(summary, data, slot, &check);
+	return 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Report
+// ═══════════════════════════════════════════════════════════════
+
+static double percent(size_t part, size_t whole)
+{
+	return whole ? 100.0 * (double)part / (double)whole : 0.0;
+}
+
+static int name_count_compare(const void *a, const void *b)
+{
+	const NameCount *na = (const NameCount*)a, *nb = (const NameCount*)b;
+	if (na->count != nb->count)
+	{
+		return na->count < nb->count ? 1 : -1;
+	}
+	return strcmp(na->name, nb->name);
+}
+
+static int value_count_compare(const void *a, const void *b)
+{
+	const ValueCount *va = (const ValueCount*)a, *vb = (const ValueCount*)b;
+	if (va->count != vb->count)
+	{
+		return va->count < vb->count ? 1 : -1;
+	}
+	return (va->value > vb->value) - (va->value < vb->value);
+}
+
+static void render_count(EmitBuffer *buf, const char *label, size_t count, size_t whole)
+{
+	ui_appendf(buf, "  %-22s %10zu %7.2f%%\n", label, count, percent(count, whole));
+}
+
+static void render_summary(EmitBuffer *buf, Summary *s)
+{
+	size_t decoded = s->images - s->unknown;
+	char label[32];
+
+	ui_render_header(buf, "Fleet Summary");
+	ui_appendf(buf, "  Images: %zu, unknown version: %zu, CRC errors: %zu\n", s->images, s->unknown, s->crc_errors);
+	ui_appendf(buf, "  Distinct serials: ~%.0f, distinct factory jobs: ~%.0f\n",
+			   hll_estimate(&s->serials), hll_estimate(&s->factory_jobs));
+
+	ui_render_category_header(buf, "Versions");
+	for (int slot = 0; slot < COLUMN_VERSIONS; slot++)
+	{
+		if (s->versions[slot])
+		{
+			snprintf(label, sizeof(label), "v%d", column_version(slot));
+			render_count(buf, label, s->versions[slot], decoded);
+		}
+	}
+
+	ui_render_category_header(buf, "Board Name");
+	qsort(s->board_names.entries, s->board_names.used, sizeof(NameCount), name_count_compare);
+	for (size_t i = 0; i < s->board_names.used; i++)
+	{
+		render_count(buf, s->board_names.entries[i].name, s->board_names.entries[i].count, decoded);
+	}
+	if (s->board_names.other)
+	{
+		render_count(buf, "(other)", s->board_names.other, decoded);
+	}
+
+	ui_render_category_header(buf, "Chip Bin");
+	for (size_t bin = 0; bin < 256; bin++)
+	{
+		if (s->chip_bins[bin])
+		{
+			snprintf(label, sizeof(label), "%zu", bin);
+			render_count(buf, label, s->chip_bins[bin], decoded);
+		}
+	}
+
+	ui_render_category_header(buf, "Test Pass Rate");
+	for (size_t i = 0; i < s->test_count; i++)
+	{
+		const TestCount *test = &s->tests[i];
+		ui_appendf(buf, "  %-22s %10zu %7.2f%%  of %zu\n", test->name, test->passed,
+				   percent(test->passed, test->tested), test->tested);
+	}
+
+	static const double levels[] = { 0.01, 0.05, 0.25, 0.50, 0.75, 0.95, 0.99 };
+	ui_render_category_header(buf, "Quantiles");
+	ui_appendf(buf, "  %-24s %-4s %9s %8s %8s %8s %8s %8s %8s %8s %8s %8s\n", "Field", "Ver", "Count",
+			   "Min", "P1", "P5", "P25", "P50", "P75", "P95", "P99", "Max");
+	for (size_t m = 0; m < QUANTILE_METRICS; m++)
+	{
+		for (int slot = 0; slot < COLUMN_VERSIONS; slot++)
+		{
+			TDigest *digest = &s->quantiles[m][slot];
+			const FieldMetadata *field = bindings[quantile_metrics[m]][slot];
+			if (!field || digest->total == 0.0)
+			{
+				continue;
+			}
+			snprintf(label, sizeof(label), "%s%s%s%s", field->name, *scaled_unit(field) ? " (" : "",
+					 scaled_unit(field), *scaled_unit(field) ? ")" : "");
+			ui_appendf(buf, "  %-24.24s v%-3d %9.0f %8.2f", label, column_version(slot), digest->total, digest->min);
+			for (size_t q = 0; q < sizeof(levels) / sizeof(levels[0]); q++)
+			{
+				ui_appendf(buf, " %8.2f", tdigest_quantile(digest, levels[q]));
+			}
+			ui_appendf(buf, " %8.2f\n", digest->max);
+		}
+	}
+
+	ui_render_category_header(buf, "Sweep Freq Base (MHz)");
+	qsort(s->freq_bases.entries, s->freq_bases.used, sizeof(ValueCount), value_count_compare);
+	size_t swept = 0;
+	for (size_t i = 0; i < s->freq_bases.used; i++)
+	{
+		swept += s->freq_bases.entries[i].count;
+	}
+	swept += s->freq_bases.other;
+	for (size_t i = 0; i < s->freq_bases.used; i++)
+	{
+		snprintf(label, sizeof(label), "%u", s->freq_bases.entries[i].value);
+		render_count(buf, label, s->freq_bases.entries[i].count, swept);
+	}
+	if (s->freq_bases.other)
+	{
+		render_count(buf, "(other)", s->freq_bases.other, swept);
+	}
+
+	ui_render_category_header(buf, "Sweep Freq Step (MHz)");
+	for (size_t step = 0; step < 256; step++)
+	{
+		if (s->freq_steps[step])
+		{
+			snprintf(label, sizeof(label), "%zu", step);
+			render_count(buf, label, s->freq_steps[step], swept);
+		}
+	}
+	emit_char(buf, '\n');
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+int cmd_summary(int argc, char **argv)
+{
+	char *paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		paths[path_count++] = argv[i];
+	}
+
+	if (path_count == 0)
+	{
+		fprintf(stderr, "Usage: eeprom_tool summary PATH...\n");
+		return 1;
+	}
+
+	pthread_once(&bindings_once, build_bindings);
+
+	SummaryRun run;
+	memset(&run, 0, sizeof(run));
+	if (!(run.total = summary_create(&run)) || pthread_key_create(&run.key, summary_retire) != 0)
+	{
+		fprintf(stderr, "Error: Out of memory\n");
+		free(run.total);
+		return 1;
+	}
+	pthread_mutex_init(&run.lock, NULL);
+
+	// Workers merge their summaries as they exit
+	batch_for_each_parallel(paths, path_count, summary_image, &run, NULL);
+
+	Summary *own = pthread_getspecific(run.key);
+	if (own)
+	{
+		pthread_setspecific(run.key, NULL);
+		summary_retire(own);
+	}
+	pthread_key_delete(run.key);
+	pthread_mutex_destroy(&run.lock);
+
+	EmitBuffer buf = { 0 };
+	render_summary(&buf, run.total);
+	ui_flush(&buf);
+	emit_buffer_free(&buf);
+
+	free(run.total);
+	return 0;
+}
@@ -0,0 +1,17 @@
+#ifndef SUMMARY_H
+#define SUMMARY_H
+
+// ═══════════════════════════════════════════════════════════════
+// Fleet Summary
+// ═══════════════════════════════════════════════════════════════
+// Single pass over an archive: counts per version, board name and chip
+// bin, test pass rates, voltage / frequency / hashrate quantiles, sweep
+// base and step distributions, and distinct serials and factory jobs.
+// Every worker thread fills a fixed-size summary (t-digests, HyperLogLogs
+// and bounded count tables, see sketch.h) that is merged into the result
+// when the thread exits, so memory does not depend on the image count.
+
+// CLI: eeprom_tool summary PATH...
+int cmd_summary(int argc, char **argv);
+
+#endif // SUMMARY_H
@@ -0,0 +1,356 @@
+#include "sweep.h"
+#include "batch.h"
+#include "eeprom_defs.h"
+#include "eeprom_ops.h"
+#include "topology.h"
+#include "ui.h"
+#include <ctype.h>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// ═══════════════════════════════════════════════════════════════
+// Nibble Expansion
+// ═══════════════════════════════════════════════════════════════
+
+static void sweep_expand_scalar(const uint8_t *levels, size_t bytes, uint16_t base, uint8_t step, uint16_t *freq)
+{
+	for (size_t i = 0; i < bytes; i++)
+	{
+		freq[2 * i] = (uint16_t)((levels[i] >> 4) * step + base);
+		freq[2 * i + 1] = (uint16_t)((levels[i] & 0x0F) * step + base);
+	}
+}
+
+void sweep_expand(const uint8_t *levels, size_t bytes, uint16_t base, uint8_t step, uint16_t *freq)
+{
+	size_t i = 0;
+
+#if defined(__SSE2__)
+	// 16 bytes -> 32 frequencies: split nibbles, interleave high/low,
+	// widen to 16 bits, then level * step + base
+	const __m128i mask = _mm_set1_epi8(0x0F);
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i vstep = _mm_set1_epi16(step);
+	const __m128i vbase = _mm_set1_epi16((short)base);
+
+	for (; i + 16 <= bytes; i += 16)
+	{
+		__m128i x = _mm_loadu_si128((const __m128i*)(levels + i));
+		__m128i hi = _mm_and_si128(_mm_srli_epi16(x, 4), mask);
+		__m128i lo = _mm_and_si128(x, mask);
+		__m128i n0 = _mm_unpacklo_epi8(hi, lo);
+		__m128i n1 = _mm_unpackhi_epi8(hi, lo);
+
+		__m128i f0 = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(n0, zero), vstep), vbase);
+		__m128i f1 = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(n0, zero), vstep), vbase);
+		__m128i f2 = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(n1, zero), vstep), vbase);
+		__m128i f3 = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(n1, zero), vstep), vbase);
+
+		_mm_storeu_si128((__m128i*)(freq + 2 * i), f0);
+		_mm_storeu_si128((__m128i*)(freq + 2 * i + 8), f1);
+		_mm_storeu_si128((__m128i*)(freq + 2 * i + 16), f2);
+		_mm_storeu_si128((__m128i*)(freq + 2 * i + 24), f3);
+	}
+#elif defined(__ARM_NEON)
+	const uint16x8_t vstep = vdupq_n_u16(step);
+	const uint16x8_t vbase = vdupq_n_u16(base);
+
+	for (; i + 16 <= bytes; i += 16)
+	{
+		uint8x16_t x = vld1q_u8(levels + i);
+		uint8x16x2_t n = vzipq_u8(vshrq_n_u8(x, 4), vandq_u8(x, vdupq_n_u8(0x0F)));
+
+		vst1q_u16(freq + 2 * i, vmlaq_u16(vbase, vmovl_u8(vget_low_u8(n.val[0])), vstep));
+		vst1q_u16(freq + 2 * i + 8, vmlaq_u16(vbase, vmovl_u8(vget_high_u8(n.val[0])), vstep));
+		vst1q_u16(freq + 2 * i + 16, vmlaq_u16(vbase, vmovl_u8(vget_low_u8(n.val[1])), vstep));
+		vst1q_u16(freq + 2 * i + 24, vmlaq_u16(vbase, vmovl_u8(vget_high_u8(n.val[1])), vstep));
+	}
+#endif
+
+	sweep_expand_scalar(levels + i, bytes - i, base, step, freq + 2 * i);
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Statistics
+// ═══════════════════════════════════════════════════════════════
+
+void sweep_stats(const uint16_t *freq, const uint8_t *levels, size_t asics, SweepStats *stats)
+{
+	memset(stats, 0, sizeof(*stats));
+	stats->asics = asics;
+	if (asics == 0)
+	{
+		return;
+	}
+
+	// Branch-free reductions, vectorized by the compiler
+	uint16_t lo = UINT16_MAX, hi = 0;
+	uint64_t sum = 0, sum_sq = 0;
+	for (size_t i = 0; i < asics; i++)
+	{
+		uint32_t f = freq[i];
+		lo = f < lo ? (uint16_t)f : lo;
+		hi = f > hi ? (uint16_t)f : hi;
+		sum += f;
+		sum_sq += f * f;
+	}
+
+	for (size_t i = 0; i < asics; i++)
+	{
+		uint8_t level = (i & 1) ? (levels[i / 2] & 0x0F) : (levels[i / 2] >> 4);
+		stats->histogram[level]++;
+	}
+
+	stats->min = lo;
+	stats->max = hi;
+	stats->mean = (double)sum / asics;
+	double variance = (double)sum_sq / asics - stats->mean * stats->mean;
+	stats->stddev = variance > 0 ? sqrt(variance) : 0.0;
+}
+
+size_t sweep_domains(const uint16_t *freq, size_t asics, size_t domain_asics,
+					 SweepDomain *domains, size_t max_domains)
+{
+	if (domain_asics == 0)
+	{
+		return 0;
+	}
+
+	size_t count = 0;
+	for (size_t start = 0; start < asics && count < max_domains; start += domain_asics, count++)
+	{
+		size_t end = start + domain_asics < asics ? start + domain_asics : asics;
+		uint16_t lo = UINT16_MAX, hi = 0;
+		uint32_t sum = 0;
+
+		for (size_t i = start; i < end; i++)
+		{
+			lo = freq[i] < lo ? freq[i] : lo;
+			hi = freq[i] > hi ? freq[i] : hi;
+			sum += freq[i];
+		}
+
+		domains[count].min = lo;
+		domains[count].max = hi;
+		domains[count].mean = (double)sum / (end - start);
+	}
+	return count;
+}
+
+// Board name without padding, e.g. "BHB42601"
+static void board_name_copy(char *dst, size_t dst_size, const char *src, size_t src_size)
+{
+	size_t n = 0;
+	for (size_t i = 0; i < src_size && n + 1 < dst_size && isalnum((unsigned char)src[i]); i++)
+	{
+		dst[n++] = src[i];
+	}
+	dst[n] = '\0';
+}
+
+int sweep_board(const uint8_t *decoded, const EEPROMCheck *check, SweepBoard *board)
+{
+	// Sweep data is region 3 of the v5/v6 and v1 layouts
+	if (check->region_count < 3 || !(check->crc_ok & 0x04) || check->version == EEPROM_VERSION_V17)
+	{
+		return -1;
+	}
+
+	if (check->version == EEPROM_VERSION_V1)
+	{
+		EEPROMStructure_v1 eeprom;
+		eeprom_v1_parse(&eeprom, decoded);
+		board_name_copy(board->board, sizeof(board->board), eeprom.board_name, sizeof(eeprom.board_name));
+		board->freq_base = eeprom.sweep_data.sweep_freq_base;
+		board->freq_step = eeprom.sweep_data.sweep_freq_step;
+		board->levels = decoded + offsetof(EEPROMStructure_v1, sweep_data.sweep_level);
+	}
+	else
+	{
+		EEPROMStructure eeprom;
+		eeprom_from_bytes(&eeprom, decoded);
+		board_name_copy(board->board, sizeof(board->board), eeprom.board_info.board_name,
+						sizeof(eeprom.board_info.board_name));
+		board->freq_base = eeprom.sweep_data.sweep_freq_base;
+		board->freq_step = eeprom.sweep_data.sweep_freq_step;
+		board->levels = decoded + offsetof(EEPROMStructure, sweep_data.sweep_level);
+	}
+	return 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	const TopologyDB *topologies;
+	int show_domains;
+	size_t boards;
+	size_t skipped;                // No sweep region or sweep CRC error
+	SweepStats fleet;              // min/max/histogram over all boards
+	uint64_t fleet_sum;
+	uint64_t fleet_sum_sq;
+} SweepContext;
+
+static int sweep_collect(const char *name, const uint8_t *data, size_t size, void *user)
+{
+	SweepContext *ctx = (SweepContext*)user;
+	uint8_t work[EEPROM_SIZE];
+	memset(work, 0xFF, sizeof(work));
+	memcpy(work, data, size < EEPROM_SIZE ? size : EEPROM_SIZE);
+
+	EEPROMCheck check;
+	batch_decode(work, &check);
+	if (check.version == EEPROM_VERSION_UNKNOWN)
+	{
+		return 0;
+	}
+
+	SweepBoard board;
+	if (sweep_board(work, &check, &board) != 0)
+	{
+		ctx->skipped++;
+		return 0;
+	}
+
+	uint16_t freq[SWEEP_MAX_ASICS];
+	sweep_expand(board.levels, SWEEP_LEVEL_BYTES, board.freq_base, board.freq_step, freq);
+
+	const SweepTopology *topology = topology_chain(ctx->topologies, board.board);
+	size_t asics = SWEEP_MAX_ASICS;
+	if (topology && topology->chain_asic_num > 0 && topology->chain_asic_num < SWEEP_MAX_ASICS)
+	{
+		asics = (size_t)topology->chain_asic_num;
+	}
+
+	SweepStats stats;
+	sweep_stats(freq, board.levels, asics, &stats);
+
+	printf("  %-40s %-10s %5zu %6u %6u %8.1f %7.1f\n", name, board.board[0] ? board.board : "-", asics,
+		   stats.min, stats.max, stats.mean, stats.stddev);
+
+	if (topology && topology->domain_asic_num > 0)
+	{
+		SweepDomain domains[SWEEP_MAX_ASICS];
+		size_t count = sweep_domains(freq, asics, (size_t)topology->domain_asic_num, domains, SWEEP_MAX_ASICS);
+
+		size_t worst = 0;
+		for (size_t d = 1; d < count; d++)
+		{
+			worst = domains[d].mean < domains[worst].mean ? d : worst;
+		}
+		printf("    %zu domains x %d ASICs, lowest domain %zu: %.1f MHz\n",
+			   count, topology->domain_asic_num, worst, count ? domains[worst].mean : 0.0);
+
+		if (ctx->show_domains)
+		{
+			for (size_t d = 0; d < count; d++)
+			{
+				printf("    domain %3zu: min %4u  max %4u  mean %7.1f\n",
+					   d, domains[d].min, domains[d].max, domains[d].mean);
+			}
+		}
+	}
+
+	// Fleet totals
+	SweepStats *fleet = &ctx->fleet;
+	if (ctx->boards == 0 || stats.min < fleet->min)
+	{
+		fleet->min = stats.min;
+	}
+	if (stats.max > fleet->max)
+	{
+		fleet->max = stats.max;
+	}
+	for (int l = 0; l < SWEEP_LEVELS; l++)
+	{
+		fleet->histogram[l] += stats.histogram[l];
+	}
+	for (size_t i = 0; i < asics; i++)
+	{
+		ctx->fleet_sum += freq[i];
+		ctx->fleet_sum_sq += (uint64_t)freq[i] * freq[i];
+	}
+	fleet->asics += asics;
+	ctx->boards++;
+	return 0;
+}
+
+int cmd_sweep(int argc, char **argv)
+{
+	SweepContext ctx;
+	memset(&ctx, 0, sizeof(ctx));
+	const char *topology_dir = NULL;
+	int paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			topology_dir = argv[++i];
+			continue;
+		}
+		if (strcmp(argv[i], "-d") == 0)
+		{
+			ctx.show_domains = 1;
+			continue;
+		}
+		paths[path_count++] = i;
+	}
+
+	if (path_count == 0)
+	{
+		fprintf(stderr, "Usage: eeprom_tool sweep [-t TOPOLOGY_DIR] [-d] PATH...\n");
+		return 1;
+	}
+
+	TopologyDB *topologies = NULL;
+	if (topology_dir && !(topologies = topology_open(topology_dir)))
+	{
+		return 1;
+	}
+	ctx.topologies = topologies;
+
+	ui_print_header("Sweep Frequencies");
+	printf("  %-40s %-10s %5s %6s %6s %8s %7s\n", "Image", "Board", "ASICs", "Min", "Max", "Mean", "StdDev");
+	ui_print_separator();
+
+	for (int i = 0; i < path_count; i++)
+	{
+		batch_for_each(argv[paths[i]], sweep_collect, &ctx, NULL);
+	}
+
+	ui_print_separator();
+	printf("  Boards: %zu, without sweep data: %zu\n", ctx.boards, ctx.skipped);
+
+	SweepStats *fleet = &ctx.fleet;
+	if (fleet->asics)
+	{
+		double mean = (double)ctx.fleet_sum / fleet->asics;
+		double variance = (double)ctx.fleet_sum_sq / fleet->asics - mean * mean;
+		printf("  ASICs: %zu, min %u, max %u, mean %.1f, stddev %.1f MHz\n", fleet->asics,
+			   fleet->min, fleet->max, mean, variance > 0 ? sqrt(variance) : 0.0);
+		printf("  Level histogram:");
+		for (int l = 0; l < SWEEP_LEVELS; l++)
+		{
+			printf(" %u", fleet->histogram[l]);
+		}
+		printf("\n");
+	}
+	topology_close(topologies);
+	return 0;
+}
@@ -0,0 +1,75 @@
+#ifndef SWEEP_H
+#define SWEEP_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "eeprom_ops.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Sweep Level Analysis
+// ═══════════════════════════════════════════════════════════════
+// sweep_level packs one 4-bit level per ASIC, high nibble first:
+// frequency = level * sweep_freq_step + sweep_freq_base.
+
+#define SWEEP_LEVEL_BYTES 128
+#define SWEEP_MAX_ASICS   (SWEEP_LEVEL_BYTES * 2)
+#define SWEEP_LEVELS      16
+
+// Cells of the largest "tpl" chip matrix (rows x columns)
+#define SWEEP_MAX_CELLS   512
+
+typedef struct
+{
+	size_t asics;                  // ASICs included
+	uint16_t min;                  // MHz
+	uint16_t max;
+	double mean;
+	double stddev;
+	uint32_t histogram[SWEEP_LEVELS]; // ASICs per level
+} SweepStats;
+
+typedef struct
+{
+	uint16_t min;                  // MHz
+	uint16_t max;
+	double mean;
+} SweepDomain;
+
+// Chain geometry from a topol_*.conf file (see topology.h)
+typedef struct
+{
+	int chain_asic_num;            // ASICs on the hashboard
+	int domain_asic_num;           // ASICs per voltage domain
+	int rows;                      // "tpl" matrix, 0 x 0 if the config has none
+	int columns;
+	int16_t cell_asic[SWEEP_MAX_CELLS]; // ASIC index per cell, row-major; -1 = no chip
+} SweepTopology;
+
+// Sweep region of a decoded image
+typedef struct
+{
+	char board[16];                // Board name without padding, e.g. "BHB42601"
+	uint16_t freq_base;
+	uint8_t freq_step;
+	const uint8_t *levels;         // SWEEP_LEVEL_BYTES packed levels in the image
+} SweepBoard;
+
+// Unpack bytes of packed levels into 2 * bytes frequencies (SSE2/NEON
+// when available, scalar otherwise)
+void sweep_expand(const uint8_t *levels, size_t bytes, uint16_t base, uint8_t step, uint16_t *freq);
+
+// Statistics over the first asics entries of an expanded vector
+void sweep_stats(const uint16_t *freq, const uint8_t *levels, size_t asics, SweepStats *stats);
+
+// Consecutive groups of domain_asics; returns the number of domains written
+size_t sweep_domains(const uint16_t *freq, size_t asics, size_t domain_asics,
+					 SweepDomain *domains, size_t max_domains);
+
+// Locate the sweep data of a decoded image; -1 if the layout has none
+// (v4, v17) or the sweep region failed its CRC
+int sweep_board(const uint8_t *decoded, const EEPROMCheck *check, SweepBoard *board);
+
+// CLI: eeprom_tool sweep [-t TOPOLOGY_DIR] [-d] PATH...
+int cmd_sweep(int argc, char **argv);
+
+#endif // SWEEP_H
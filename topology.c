@@ -0,0 +1,1184 @@
+#include "topology.h"
+#include "hash.h"
+#include "ui.h"
+#include <ctype.h>
+#include <dirent.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// ═══════════════════════════════════════════════════════════════
+// JSON Pull Reader
+// ═══════════════════════════════════════════════════════════════
+// Works on the mapped file in place. Values are consumed by the caller
+// or skipped; the first syntax error sets error and makes every further
+// call return 0, which unwinds the loops below.
+
+typedef struct
+{
+	const char *p;
+	const char *end;
+	int error;
+} JsonReader;
+
+static int json_peek(JsonReader *r)
+{
+	while (r->p < r->end && isspace((unsigned char)*r->p))
+	{
+		r->p++;
+	}
+	return r->error || r->p >= r->end ? 0 : (unsigned char)*r->p;
+}
+
+static int json_expect(JsonReader *r, char c)
+{
+	if (json_peek(r) == c)
+	{
+		r->p++;
+		return 1;
+	}
+	r->error = 1;
+	return 0;
+}
+
+// String into out (truncated, NUL-terminated); out may be NULL to skip
+static int json_string(JsonReader *r, char *out, size_t size)
+{
+	if (!json_expect(r, '"'))
+	{
+		return 0;
+	}
+
+	size_t n = 0;
+	while (r->p < r->end && *r->p != '"')
+	{
+		char c = *r->p++;
+		if (c == '\\' && r->p < r->end)
+		{
+			c = *r->p++;
+			if (c == 'u')
+			{
+				// Not used by the schema; keep a placeholder
+				r->p = r->end - r->p > 4 ? r->p + 4 : r->end;
+				c = '?';
+			}
+			else if (c == 'n' || c == 't' || c == 'r')
+			{
+				c = ' ';
+			}
+		}
+		if (out && n + 1 < size)
+		{
+			out[n++] = c;
+		}
+	}
+	if (r->p >= r->end)
+	{
+		r->error = 1;
+		return 0;
+	}
+	r->p++;
+	if (out && size)
+	{
+		out[n] = '\0';
+	}
+	return 1;
+}
+
+static int json_literal(JsonReader *r, const char *word)
+{
+	size_t n = strlen(word);
+	if ((size_t)(r->end - r->p) >= n && memcmp(r->p, word, n) == 0)
+	{
+		r->p += n;
+		return 1;
+	}
+	r->error = 1;
+	return 0;
+}
+
+// Integer part of a number (fraction and exponent skipped); true = 1
+static long json_int(JsonReader *r)
+{
+	int c = json_peek(r);
+	if (c == 't')
+	{
+		return json_literal(r, "true");
+	}
+	if (c == 'f')
+	{
+		json_literal(r, "false");
+		return 0;
+	}
+	if (c == 'n')
+	{
+		json_literal(r, "null");
+		return 0;
+	}
+
+	int negative = c == '-';
+	r->p += negative;
+	if (r->p >= r->end || !isdigit((unsigned char)*r->p))
+	{
+		r->error = 1;
+		return 0;
+	}
+
+	long value = 0;
+	while (r->p < r->end && isdigit((unsigned char)*r->p))
+	{
+		value = value * 10 + (*r->p++ - '0');
+	}
+	while (r->p < r->end && (isdigit((unsigned char)*r->p) || strchr(".eE+-", *r->p)))
+	{
+		r->p++;
+	}
+	return negative ? -value : value;
+}
+
+static void json_skip(JsonReader *r)
+{
+	int c = json_peek(r);
+	if (c == '"')
+	{
+		json_string(r, NULL, 0);
+	}
+	else if (c == '{' || c == '[')
+	{
+		int depth = 0;
+		while (r->p < r->end)
+		{
+			c = (unsigned char)*r->p;
+			if (c == '"')
+			{
+				if (!json_string(r, NULL, 0))
+				{
+					return;
+				}
+				continue;
+			}
+			r->p++;
+			depth += (c == '{' || c == '[') - (c == '}' || c == ']');
+			if (depth == 0)
+			{
+				return;
+			}
+		}
+		r->error = 1;
+	}
+	else if (c)
+	{
+		json_int(r);
+	}
+}
+
+// Enter an object or array; any other value is skipped and 0 returned
+static int json_enter(JsonReader *r, char open)
+{
+	if (json_peek(r) == open)
+	{
+		r->p++;
+		return 1;
+	}
+	json_skip(r);
+	return 0;
+}
+
+// Next "key": of the current object, 0 at its closing brace
+static int json_next_key(JsonReader *r, char *key, size_t size)
+{
+	int c = json_peek(r);
+	if (c == ',')
+	{
+		r->p++;
+		c = json_peek(r);
+	}
+	if (c == '}')
+	{
+		r->p++;
+		return 0;
+	}
+	return c == '"' && json_string(r, key, size) && json_expect(r, ':');
+}
+
+// 1 if the current array has another element, 0 at its closing bracket
+static int json_next_item(JsonReader *r)
+{
+	int c = json_peek(r);
+	if (c == ',')
+	{
+		r->p++;
+		c = json_peek(r);
+	}
+	if (c == ']')
+	{
+		r->p++;
+		return 0;
+	}
+	return c != 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Schema
+// ═══════════════════════════════════════════════════════════════
+
+#define KEY_MAX 32
+
+typedef struct
+{
+	topology_board_cb cb;
+	void *ctx;
+	int boards;
+	int stop;
+} ParseRun;
+
+static void parse_sensors(JsonReader *r, TopologyBoard *board)
+{
+	if (!json_enter(r, '['))
+	{
+		return;
+	}
+	while (json_next_item(r))
+	{
+		TopologySensor sensor;
+		memset(&sensor, 0, sizeof(sensor));
+		sensor.bind_asic = -1;
+		int has_addr = 0;
+
+		if (json_enter(r, '{'))
+		{
+			char key[KEY_MAX];
+			while (json_next_key(r, key, sizeof(key)))
+			{
+				if (strcmp(key, "type") == 0)
+				{
+					json_string(r, sensor.type, sizeof(sensor.type));
+				}
+				else if (strcmp(key, "iic") == 0)
+				{
+					sensor.i2c_addr = (uint8_t)json_int(r);
+					has_addr = 1;
+				}
+				else if (strcmp(key, "bind_asic") == 0)
+				{
+					sensor.bind_asic = (int16_t)json_int(r);
+				}
+				else
+				{
+					json_skip(r);
+				}
+			}
+		}
+		if ((has_addr || sensor.bind_asic >= 0) && board->sensor_count < TOPOLOGY_MAX_SENSORS)
+		{
+			board->sensors[board->sensor_count++] = sensor;
+		}
+	}
+}
+
+static void parse_asic(JsonReader *r, TopologyBoard *board)
+{
+	char key[KEY_MAX];
+	if (!json_enter(r, '{'))
+	{
+		return;
+	}
+	while (json_next_key(r, key, sizeof(key)))
+	{
+		if (strcmp(key, "asic_id") == 0)
+		{
+			json_string(r, board->asic_id, sizeof(board->asic_id));
+		}
+		else if (strcmp(key, "asic_core_num") == 0)
+		{
+			board->asic_core_num = (uint16_t)json_int(r);
+		}
+		else
+		{
+			json_skip(r);
+		}
+	}
+}
+
+static void parse_power(JsonReader *r, TopologyBoard *board)
+{
+	char key[KEY_MAX];
+	if (!json_enter(r, '{'))
+	{
+		return;
+	}
+	while (json_next_key(r, key, sizeof(key)))
+	{
+		if (strcmp(key, "type") == 0)
+		{
+			json_string(r, board->power_type, sizeof(board->power_type));
+		}
+		else if (strcmp(key, "i2c_addr") == 0)
+		{
+			board->power_i2c_addr = (uint8_t)json_int(r);
+		}
+		else if (strcmp(key, "version") == 0 && json_enter(r, '['))
+		{
+			while (json_next_item(r))
+			{
+				long version = json_int(r);
+				if (board->power_version_count < TOPOLOGY_MAX_VERSIONS)
+				{
+					board->power_versions[board->power_version_count++] = (uint16_t)version;
+				}
+			}
+		}
+		else
+		{
+			json_skip(r);
+		}
+	}
+}
+
+// Fans are a list of fans, or a control object with "speed_info" per fan
+static void parse_fan(JsonReader *r, TopologyBoard *board)
+{
+	char key[KEY_MAX];
+	int c = json_peek(r);
+	if (c == '[')
+	{
+		r->p++;
+		while (json_next_item(r))
+		{
+			json_skip(r);
+			board->fan_count++;
+		}
+	}
+	else if (json_enter(r, '{'))
+	{
+		while (json_next_key(r, key, sizeof(key)))
+		{
+			if (strcmp(key, "speed_info") == 0 && json_enter(r, '['))
+			{
+				while (json_next_item(r))
+				{
+					json_skip(r);
+					board->fan_count++;
+				}
+			}
+			else
+			{
+				json_skip(r);
+			}
+		}
+	}
+}
+
+static void parse_pic(JsonReader *r, TopologyBoard *board)
+{
+	char key[KEY_MAX];
+	if (!json_enter(r, '{'))
+	{
+		return;
+	}
+	while (json_next_key(r, key, sizeof(key)))
+	{
+		if (strcmp(key, "type") == 0)
+		{
+			json_string(r, board->pic_type, sizeof(board->pic_type));
+		}
+		else if (strcmp(key, "i2c_addr") == 0)
+		{
+			board->pic_i2c_addr = (uint8_t)json_int(r);
+		}
+		else if (strcmp(key, "sensor") == 0)
+		{
+			parse_sensors(r, board);
+		}
+		else
+		{
+			json_skip(r);
+		}
+	}
+}
+
+static void parse_eeprom(JsonReader *r, TopologyBoard *board)
+{
+	char key[KEY_MAX];
+	if (!json_enter(r, '{'))
+	{
+		return;
+	}
+	while (json_next_key(r, key, sizeof(key)))
+	{
+		if (strcmp(key, "type") == 0)
+		{
+			json_string(r, board->eeprom_type, sizeof(board->eeprom_type));
+		}
+		else if (strcmp(key, "i2c_addr") == 0)
+		{
+			board->eeprom_i2c_addr = (uint8_t)json_int(r);
+		}
+		else
+		{
+			json_skip(r);
+		}
+	}
+}
+
+// [[chip, ...], ...] with 1-based chip numbers, 0 = empty cell. A ragged
+// or oversized matrix leaves rows = 0.
+static void parse_tpl(JsonReader *r, SweepTopology *chain)
+{
+	int rows = 0, columns = 0, cells = 0, valid = 1;
+	if (!json_enter(r, '['))
+	{
+		return;
+	}
+	while (json_next_item(r))
+	{
+		int count = 0;
+		if (json_enter(r, '['))
+		{
+			while (json_next_item(r))
+			{
+				long chip = json_int(r);
+				if (cells < SWEEP_MAX_CELLS && chip >= 0 && chip <= SWEEP_MAX_ASICS)
+				{
+					chain->cell_asic[cells++] = (int16_t)(chip - 1);
+				}
+				else
+				{
+					valid = 0;
+				}
+				count++;
+			}
+		}
+		valid &= rows == 0 || count == columns;
+		columns = count;
+		rows++;
+	}
+
+	chain->rows = valid ? rows : 0;
+	chain->columns = valid ? columns : 0;
+}
+
+static void parse_chain(JsonReader *r, TopologyBoard *board)
+{
+	char key[KEY_MAX];
+	if (!json_enter(r, '{'))
+	{
+		return;
+	}
+	while (json_next_key(r, key, sizeof(key)))
+	{
+		if (strcmp(key, "chain_num") == 0)
+		{
+			board->chain_num = (uint8_t)json_int(r);
+		}
+		else if (strcmp(key, "chain_asic_num") == 0)
+		{
+			board->chain.chain_asic_num = (int)json_int(r);
+		}
+		else if (strcmp(key, "domain_asic_num") == 0)
+		{
+			board->chain.domain_asic_num = (int)json_int(r);
+		}
+		else if (strcmp(key, "pic") == 0)
+		{
+			parse_pic(r, board);
+		}
+		else if (strcmp(key, "eeprom") == 0)
+		{
+			parse_eeprom(r, board);
+		}
+		else if (strcmp(key, "sensor") == 0 || strcmp(key, "asic_sensor") == 0)
+		{
+			parse_sensors(r, board);
+		}
+		else if (strcmp(key, "asic") == 0)
+		{
+			parse_asic(r, board);
+		}
+		else if (strcmp(key, "tpl") == 0)
+		{
+			parse_tpl(r, &board->chain);
+		}
+		else
+		{
+			json_skip(r);
+		}
+	}
+}
+
+// A board object, or the file's top-level object holding "config"
+static void parse_board(JsonReader *r, ParseRun *run)
+{
+	TopologyBoard board;
+	memset(&board, 0, sizeof(board));
+	size_t aliases = 0;
+	char key[KEY_MAX];
+
+	if (!json_enter(r, '{'))
+	{
+		return;
+	}
+	while (json_next_key(r, key, sizeof(key)))
+	{
+		if (strcmp(key, "config") == 0)
+		{
+			if (json_enter(r, '['))
+			{
+				while (json_next_item(r) && !run->stop)
+				{
+					parse_board(r, run);
+				}
+			}
+		}
+		else if (strcmp(key, "machine") == 0)
+		{
+			json_string(r, board.machine, sizeof(board.machine));
+		}
+		else if (strcmp(key, "mix_boardnames") == 0 && json_enter(r, '['))
+		{
+			while (json_next_item(r))
+			{
+				char *alias = aliases < TOPOLOGY_MAX_ALIASES ? board.aliases[aliases++] : NULL;
+				json_string(r, alias, alias ? TOPOLOGY_NAME_LEN : 0);
+			}
+		}
+		else if (strcmp(key, "power") == 0)
+		{
+			parse_power(r, &board);
+		}
+		else if (strcmp(key, "fan") == 0)
+		{
+			parse_fan(r, &board);
+		}
+		else if (strcmp(key, "asic") == 0)
+		{
+			parse_asic(r, &board);
+		}
+		else if (strcmp(key, "chain") == 0)
+		{
+			parse_chain(r, &board);
+		}
+		else
+		{
+			json_skip(r);
+		}
+	}
+
+	// Mixed-board lists usually include the machine itself
+	size_t kept = 0;
+	for (size_t a = 0; a < aliases; a++)
+	{
+		if (strcmp(board.aliases[a], board.machine) != 0)
+		{
+			memmove(board.aliases[kept++], board.aliases[a], TOPOLOGY_NAME_LEN);
+		}
+	}
+	memset(board.aliases[kept], 0, (TOPOLOGY_MAX_ALIASES - kept) * TOPOLOGY_NAME_LEN);
+
+	if (!r->error && board.machine[0] && !run->stop)
+	{
+		run->boards++;
+		run->stop = run->cb(&board, run->ctx) != 0;
+	}
+}
+
+int topology_parse_file(const char *path, topology_board_cb cb, void *ctx)
+{
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0 || st.st_size == 0)
+	{
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return -1;
+	}
+
+	void *text = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (text == MAP_FAILED)
+	{
+		return -1;
+	}
+
+	JsonReader reader = { (const char*)text, (const char*)text + st.st_size, 0 };
+	ParseRun run = { cb, ctx, 0, 0 };
+	parse_board(&reader, &run);
+	munmap(text, (size_t)st.st_size);
+
+	return reader.error ? -1 : run.boards;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Compiled Cache
+// ═══════════════════════════════════════════════════════════════
+
+#define TOPOLOGY_MAGIC "EETOPOL\0"
+#define TOPOLOGY_SEED  0x746F706F6C6F6779ULL
+
+typedef struct
+{
+	char magic[8];
+	uint32_t schema;
+	uint32_t record_size;          // sizeof(TopologyBoard) of the writer
+	uint64_t fingerprint;          // Conf file names, sizes and mtimes
+	uint32_t board_count;
+	uint32_t slot_count;           // Power of two
+} TopologyHeader;
+
+typedef struct
+{
+	uint32_t tag;                  // High half of the name hash
+	uint32_t index;                // Record + 1, 0 = empty
+} TopologySlot;
+
+struct TopologyDB
+{
+	uint8_t *blob;                 // Header, slots, records
+	size_t size;
+	int mapped;                    // blob is an mmap of the cache file
+	const TopologyHeader *header;
+	const TopologySlot *slots;
+	const TopologyBoard *boards;
+};
+
+static int is_conf_name(const char *name)
+{
+	size_t n = strlen(name);
+	return strncmp(name, "topol_", 6) == 0 && n > 11 && strcmp(name + n - 5, ".conf") == 0;
+}
+
+static int name_compare(const void *a, const void *b)
+{
+	return strcmp(*(char *const*)a, *(char *const*)b);
+}
+
+// Sorted topol_*.conf names of dir (caller frees), count in *count
+static char **list_confs(const char *dir, size_t *count)
+{
+	DIR *d = opendir(dir);
+	if (!d)
+	{
+		return NULL;
+	}
+
+	char **names = NULL;
+	size_t used = 0, capacity = 0;
+	struct dirent *entry;
+	while ((entry = readdir(d)))
+	{
+		if (!is_conf_name(entry->d_name))
+		{
+			continue;
+		}
+		if (used == capacity)
+		{
+			capacity = capacity ? capacity * 2 : 64;
+			char **next = realloc(names, capacity * sizeof(char*));
+			if (!next)
+			{
+				break;
+			}
+			names = next;
+		}
+		if (!(names[used] = strdup(entry->d_name)))
+		{
+			break;
+		}
+		used++;
+	}
+	closedir(d);
+
+	if (!names)
+	{
+		names = malloc(sizeof(char*));
+	}
+	if (names)
+	{
+		qsort(names, used, sizeof(char*), name_compare);
+	}
+	*count = used;
+	return names;
+}
+
+static void free_names(char **names, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+	{
+		free(names[i]);
+	}
+	free(names);
+}
+
+static uint64_t confs_fingerprint(const char *dir, char **names, size_t count)
+{
+	uint64_t hash = TOPOLOGY_CACHE_SCHEMA;
+	for (size_t i = 0; i < count; i++)
+	{
+		char path[4096];
+		struct stat st;
+		snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+		int64_t stamp[3] = { 0, 0, 0 };
+		if (stat(path, &st) == 0)
+		{
+			stamp[0] = (int64_t)st.st_size;
+			stamp[1] = (int64_t)st.st_mtim.tv_sec;
+			stamp[2] = (int64_t)st.st_mtim.tv_nsec;
+		}
+		hash = eeprom_hash64(names[i], strlen(names[i]), hash);
+		hash = eeprom_hash64(stamp, sizeof(stamp), hash);
+	}
+	return hash;
+}
+
+static size_t blob_size(uint32_t boards, uint32_t slots)
+{
+	return sizeof(TopologyHeader) + slots * sizeof(TopologySlot) + boards * sizeof(TopologyBoard);
+}
+
+static void db_attach(TopologyDB *db)
+{
+	db->header = (const TopologyHeader*)db->blob;
+	db->slots = (const TopologySlot*)(db->blob + sizeof(TopologyHeader));
+	db->boards = (const TopologyBoard*)(db->slots + db->header->slot_count);
+}
+
+static int board_has_name(const TopologyBoard *board, const char *name)
+{
+	if (strcmp(board->machine, name) == 0)
+	{
+		return 1;
+	}
+	for (size_t i = 0; i < TOPOLOGY_MAX_ALIASES; i++)
+	{
+		if (board->aliases[i][0] && strcmp(board->aliases[i], name) == 0)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+const TopologyBoard *topology_find(const TopologyDB *db, const char *name)
+{
+	if (!db || !name[0] || db->header->slot_count == 0)
+	{
+		return NULL;
+	}
+
+	uint64_t hash = eeprom_hash64(name, strlen(name), TOPOLOGY_SEED);
+	uint32_t tag = (uint32_t)(hash >> 32);
+	uint32_t mask = db->header->slot_count - 1;
+
+	for (uint32_t pos = (uint32_t)hash & mask;; pos = (pos + 1) & mask)
+	{
+		const TopologySlot *slot = &db->slots[pos];
+		if (slot->index == 0)
+		{
+			return NULL;
+		}
+		if (slot->tag == tag && board_has_name(&db->boards[slot->index - 1], name))
+		{
+			return &db->boards[slot->index - 1];
+		}
+	}
+}
+
+const SweepTopology *topology_chain(const TopologyDB *db, const char *name)
+{
+	const TopologyBoard *board = topology_find(db, name);
+	return board && board->chain.chain_asic_num > 0 ? &board->chain : NULL;
+}
+
+// Insert name -> record unless the name is taken
+static void slot_insert(TopologyDB *db, const char *name, uint32_t record)
+{
+	if (topology_find(db, name))
+	{
+		return;
+	}
+
+	uint64_t hash = eeprom_hash64(name, strlen(name), TOPOLOGY_SEED);
+	uint32_t mask = db->header->slot_count - 1;
+	TopologySlot *slots = (TopologySlot*)db->slots;
+	uint32_t pos = (uint32_t)hash & mask;
+	while (slots[pos].index)
+	{
+		pos = (pos + 1) & mask;
+	}
+	slots[pos].tag = (uint32_t)(hash >> 32);
+	slots[pos].index = record + 1;
+}
+
+// Boards gathered while parsing; a machine defined in its own
+// topol_<machine>.conf wins over the same machine in a family file
+typedef struct
+{
+	TopologyBoard *boards;
+	uint8_t *exact;
+	size_t count;
+	size_t capacity;
+	const char *file;              // Conf file being parsed
+	int failed;
+} BuildRun;
+
+static int build_add(const TopologyBoard *board, void *ctx)
+{
+	BuildRun *build = (BuildRun*)ctx;
+	char own[TOPOLOGY_NAME_LEN + 16];
+	snprintf(own, sizeof(own), "topol_%s.conf", board->machine);
+	int exact = strcmp(build->file, own) == 0;
+
+	for (size_t i = 0; i < build->count; i++)
+	{
+		if (strcmp(build->boards[i].machine, board->machine) == 0)
+		{
+			if (exact && !build->exact[i])
+			{
+				build->boards[i] = *board;
+				build->exact[i] = 1;
+			}
+			return 0;
+		}
+	}
+
+	if (build->count == build->capacity)
+	{
+		size_t capacity = build->capacity ? build->capacity * 2 : 64;
+		TopologyBoard *boards = realloc(build->boards, capacity * sizeof(TopologyBoard));
+		uint8_t *flags = boards ? realloc(build->exact, capacity) : NULL;
+		if (boards)
+		{
+			build->boards = boards;
+		}
+		if (!flags)
+		{
+			build->failed = 1;
+			return 1;
+		}
+		build->exact = flags;
+		build->capacity = capacity;
+	}
+	build->boards[build->count] = *board;
+	build->exact[build->count] = (uint8_t)exact;
+	build->count++;
+	return 0;
+}
+
+static TopologyDB *db_build(const char *dir, char **names, size_t count, uint64_t fingerprint)
+{
+	BuildRun build;
+	memset(&build, 0, sizeof(build));
+	for (size_t i = 0; i < count && !build.failed; i++)
+	{
+		char path[4096];
+		snprintf(path, sizeof(path), "%s/%s", dir, names[i]);
+		build.file = names[i];
+		if (topology_parse_file(path, build_add, &build) < 0)
+		{
+			fprintf(stderr, "Warning: Cannot parse %s\n", path);
+		}
+	}
+
+	uint32_t slots = 16;
+	while (slots < build.count * (TOPOLOGY_MAX_ALIASES + 1) * 2)
+	{
+		slots <<= 1;
+	}
+
+	TopologyDB *db = calloc(1, sizeof(TopologyDB));
+	size_t size = blob_size((uint32_t)build.count, slots);
+	if (!db || build.failed || !(db->blob = calloc(1, size)))
+	{
+		free(db);
+		free(build.boards);
+		free(build.exact);
+		return NULL;
+	}
+	db->size = size;
+
+	TopologyHeader *header = (TopologyHeader*)db->blob;
+	memcpy(header->magic, TOPOLOGY_MAGIC, 8);
+	header->schema = TOPOLOGY_CACHE_SCHEMA;
+	header->record_size = sizeof(TopologyBoard);
+	header->fingerprint = fingerprint;
+	header->board_count = (uint32_t)build.count;
+	header->slot_count = slots;
+	db_attach(db);
+
+	if (build.count)
+	{
+		memcpy((TopologyBoard*)db->boards, build.boards, build.count * sizeof(TopologyBoard));
+	}
+	// Machine names first so an alias never shadows a real board
+	for (uint32_t i = 0; i < build.count; i++)
+	{
+		slot_insert(db, db->boards[i].machine, i);
+	}
+	for (uint32_t i = 0; i < build.count; i++)
+	{
+		for (size_t a = 0; a < TOPOLOGY_MAX_ALIASES; a++)
+		{
+			if (db->boards[i].aliases[a][0])
+			{
+				slot_insert(db, db->boards[i].aliases[a], i);
+			}
+		}
+	}
+
+	free(build.boards);
+	free(build.exact);
+	return db;
+}
+
+// Write through a temporary file, then rename; failures leave no cache
+static void db_save(const TopologyDB *db, const char *path)
+{
+	char tmp_path[4200];
+	if (snprintf(tmp_path, sizeof(tmp_path), "%s.XXXXXX", path) >= (int)sizeof(tmp_path))
+	{
+		return;
+	}
+	int fd = mkstemp(tmp_path);
+	if (fd < 0)
+	{
+		return;
+	}
+
+	int ok = write(fd, db->blob, db->size) == (ssize_t)db->size;
+	ok = (close(fd) == 0) && ok;
+	if (!ok || chmod(tmp_path, 0644) != 0 || rename(tmp_path, path) != 0)
+	{
+		unlink(tmp_path);
+	}
+}
+
+static TopologyDB *db_map(const char *path, uint64_t fingerprint)
+{
+	int fd = open(path, O_RDONLY | O_CLOEXEC);
+	struct stat st;
+	if (fd < 0 || fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(TopologyHeader))
+	{
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+		return NULL;
+	}
+
+	void *blob = mmap(NULL, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (blob == MAP_FAILED)
+	{
+		return NULL;
+	}
+
+	const TopologyHeader *header = (const TopologyHeader*)blob;
+	TopologyDB *db = NULL;
+	if (memcmp(header->magic, TOPOLOGY_MAGIC, 8) == 0 &&
+		header->schema == TOPOLOGY_CACHE_SCHEMA &&
+		header->record_size == sizeof(TopologyBoard) &&
+		header->fingerprint == fingerprint &&
+		header->slot_count && (header->slot_count & (header->slot_count - 1)) == 0 &&
+		blob_size(header->board_count, header->slot_count) == (size_t)st.st_size &&
+		(db = calloc(1, sizeof(TopologyDB))))
+	{
+		db->blob = blob;
+		db->size = (size_t)st.st_size;
+		db->mapped = 1;
+		db_attach(db);
+		return db;
+	}
+
+	munmap(blob, (size_t)st.st_size);
+	return NULL;
+}
+
+TopologyDB *topology_open(const char *dir)
+{
+	size_t count;
+	char **names = list_confs(dir, &count);
+	if (!names)
+	{
+		fprintf(stderr, "Error: Cannot read topology directory %s\n", dir);
+		return NULL;
+	}
+
+	char cache_path[4096];
+	snprintf(cache_path, sizeof(cache_path), "%s/%s", dir, TOPOLOGY_CACHE_NAME);
+	uint64_t fingerprint = confs_fingerprint(dir, names, count);
+
+	TopologyDB *db = db_map(cache_path, fingerprint);
+	if (!db && (db = db_build(dir, names, count, fingerprint)))
+	{
+		db_save(db, cache_path);
+	}
+
+	free_names(names, count);
+	return db;
+}
+
+void topology_close(TopologyDB *db)
+{
+	if (!db)
+	{
+		return;
+	}
+	if (db->mapped)
+	{
+		munmap(db->blob, db->size);
+	}
+	else
+	{
+		free(db->blob);
+	}
+	free(db);
+}
+
+size_t topology_count(const TopologyDB *db)
+{
+	return db ? db->header->board_count : 0;
+}
+
+const TopologyBoard *topology_at(const TopologyDB *db, size_t index)
+{
+	return &db->boards[index];
+}
+
+int topology_from_cache(const TopologyDB *db)
+{
+	return db->mapped;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+static void render_board(EmitBuffer *buf, const TopologyBoard *board)
+{
+	ui_render_category_header(buf, board->machine);
+	ui_appendf(buf, "  %-22s %s, %u cores\n", "ASIC", board->asic_id[0] ? board->asic_id : "-",
+			   board->asic_core_num);
+	ui_appendf(buf, "  %-22s %d ASICs, %d per domain, %u chains\n", "Chain",
+			   board->chain.chain_asic_num, board->chain.domain_asic_num, board->chain_num);
+	if (board->chain.rows)
+	{
+		ui_appendf(buf, "  %-22s %d x %d\n", "Chip matrix", board->chain.rows, board->chain.columns);
+	}
+	ui_appendf(buf, "  %-22s %s @ 0x%02X\n", "Power", board->power_type[0] ? board->power_type : "-",
+			   board->power_i2c_addr);
+	if (board->pic_type[0])
+	{
+		ui_appendf(buf, "  %-22s %s @ 0x%02X\n", "PIC", board->pic_type, board->pic_i2c_addr);
+	}
+	if (board->eeprom_type[0])
+	{
+		ui_appendf(buf, "  %-22s %s @ 0x%02X\n", "EEPROM", board->eeprom_type, board->eeprom_i2c_addr);
+	}
+	for (size_t i = 0; i < board->sensor_count; i++)
+	{
+		const TopologySensor *sensor = &board->sensors[i];
+		ui_appendf(buf, "  %-22s %s", i == 0 ? "Sensors" : "", sensor->type[0] ? sensor->type : "-");
+		if (sensor->i2c_addr)
+		{
+			ui_appendf(buf, " @ 0x%02X", sensor->i2c_addr);
+		}
+		if (sensor->bind_asic >= 0)
+		{
+			ui_appendf(buf, " (ASIC %d)", sensor->bind_asic);
+		}
+		emit_char(buf, '\n');
+	}
+	if (board->aliases[0][0])
+	{
+		ui_appendf(buf, "  %-22s", "Also matches");
+		for (size_t a = 0; a < TOPOLOGY_MAX_ALIASES && board->aliases[a][0]; a++)
+		{
+			ui_appendf(buf, " %s", board->aliases[a]);
+		}
+		emit_char(buf, '\n');
+	}
+}
+
+int cmd_topology(int argc, char **argv)
+{
+	const char *dir = NULL;
+	char *names[argc > 0 ? argc : 1];
+	int name_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			dir = argv[++i];
+		}
+		else
+		{
+			names[name_count++] = argv[i];
+		}
+	}
+
+	if (!dir)
+	{
+		fprintf(stderr, "Usage: eeprom_tool topology -t TOPOLOGY_DIR [BOARD...]\n");
+		return 1;
+	}
+
+	struct timespec start, end;
+	clock_gettime(CLOCK_MONOTONIC, &start);
+	TopologyDB *db = topology_open(dir);
+	clock_gettime(CLOCK_MONOTONIC, &end);
+	if (!db)
+	{
+		return 1;
+	}
+
+	int result = 0;
+	EmitBuffer buf = { 0 };
+	if (name_count == 0)
+	{
+		ui_render_header(&buf, "Board Topologies");
+		ui_appendf(&buf, "  %-12s %-8s %6s %7s %7s %8s %s\n", "Machine", "ASIC", "ASICs", "Domain",
+				   "Matrix", "Sensors", "Power");
+		ui_render_separator(&buf);
+		for (size_t i = 0; i < topology_count(db); i++)
+		{
+			const TopologyBoard *board = topology_at(db, i);
+			char matrix[16] = "-";
+			if (board->chain.rows)
+			{
+				snprintf(matrix, sizeof(matrix), "%dx%d", board->chain.rows, board->chain.columns);
+			}
+			ui_appendf(&buf, "  %-12s %-8s %6d %7d %7s %8u %s\n", board->machine,
+					   board->asic_id[0] ? board->asic_id : "-", board->chain.chain_asic_num,
+					   board->chain.domain_asic_num, matrix, board->sensor_count,
+					   board->power_type[0] ? board->power_type : "-");
+		}
+		ui_render_separator(&buf);
+	}
+	for (int i = 0; i < name_count; i++)
+	{
+		const TopologyBoard *board = topology_find(db, names[i]);
+		if (!board)
+		{
+			fprintf(stderr, "Error: No topology for board '%s'\n", names[i]);
+			result = 1;
+			continue;
+		}
+		render_board(&buf, board);
+	}
+	ui_flush(&buf);
+	emit_buffer_free(&buf);
+
+	double ms = (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+	fprintf(stderr, "Boards: %zu, %s in %.2f ms\n", topology_count(db),
+			topology_from_cache(db) ? "loaded from cache" : "parsed", ms);
+	topology_close(db);
+	return result;
+}
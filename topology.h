@@ -0,0 +1,86 @@
+#ifndef TOPOLOGY_H
+#define TOPOLOGY_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "sweep.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Board Topology Database
+// ═══════════════════════════════════════════════════════════════
+// topol_*.conf files hold one board object or {"config": [boards...]}.
+// A schema-specific pull reader walks the JSON in place (no allocation,
+// unknown keys skipped) and keeps the keys the tool uses. All boards of a
+// directory are compiled into <dir>/.topology.cache:
+//   header | hash slots (name -> record) | TopologyBoard records
+// which later runs mmap and probe directly. The cache is rebuilt when the
+// names, sizes or mtimes of the conf files change.
+//
+// Bump TOPOLOGY_CACHE_SCHEMA whenever TopologyBoard or the reader change.
+#define TOPOLOGY_CACHE_SCHEMA 1
+#define TOPOLOGY_CACHE_NAME   ".topology.cache"
+
+#define TOPOLOGY_NAME_LEN     16
+#define TOPOLOGY_MAX_ALIASES  4
+#define TOPOLOGY_MAX_SENSORS  8
+#define TOPOLOGY_MAX_VERSIONS 16
+
+typedef struct
+{
+	char type[TOPOLOGY_NAME_LEN];  // "LM75A", ...
+	uint8_t i2c_addr;              // "iic"
+	int16_t bind_asic;             // -1 if not bound to an ASIC
+} TopologySensor;
+
+typedef struct
+{
+	char machine[TOPOLOGY_NAME_LEN];               // Board name, e.g. "BHB42601"
+	char aliases[TOPOLOGY_MAX_ALIASES][TOPOLOGY_NAME_LEN]; // "mix_boardnames"
+	char asic_id[TOPOLOGY_NAME_LEN];               // "BM1362"
+	char power_type[TOPOLOGY_NAME_LEN];
+	char pic_type[TOPOLOGY_NAME_LEN];
+	char eeprom_type[TOPOLOGY_NAME_LEN];
+	uint16_t power_versions[TOPOLOGY_MAX_VERSIONS];
+	uint8_t power_version_count;
+	uint8_t power_i2c_addr;
+	uint8_t pic_i2c_addr;
+	uint8_t eeprom_i2c_addr;
+	uint8_t fan_count;
+	uint8_t chain_num;             // Hashboards per machine
+	uint8_t sensor_count;
+	TopologySensor sensors[TOPOLOGY_MAX_SENSORS];  // PIC and chain sensors
+	uint16_t asic_core_num;
+	SweepTopology chain;           // Counts and "tpl" cell -> ASIC map
+} TopologyBoard;
+
+typedef struct TopologyDB TopologyDB;
+
+// Called for every board object of a file; return non-zero to stop
+typedef int (*topology_board_cb)(const TopologyBoard *board, void *ctx);
+
+// Parse one conf file. Returns the number of boards, -1 if the file
+// cannot be read or is not valid JSON.
+int topology_parse_file(const char *path, topology_board_cb cb, void *ctx);
+
+// Open the database for a directory: mmap the cache if it is current,
+// otherwise parse the conf files and (if the directory is writable)
+// store a fresh cache. NULL if the directory cannot be read.
+TopologyDB *topology_open(const char *dir);
+void topology_close(TopologyDB *db);
+
+// Board by machine name or alias (one hash probe), NULL if unknown
+const TopologyBoard *topology_find(const TopologyDB *db, const char *name);
+
+// Chain geometry of a board, NULL if db is NULL, the board is unknown or
+// its config has no chain_asic_num
+const SweepTopology *topology_chain(const TopologyDB *db, const char *name);
+
+size_t topology_count(const TopologyDB *db);
+const TopologyBoard *topology_at(const TopologyDB *db, size_t index);
+// 1 if the last open used the mmapped cache, 0 if it parsed the files
+int topology_from_cache(const TopologyDB *db);
+
+// CLI: eeprom_tool topology -t TOPOLOGY_DIR [BOARD...]
+int cmd_topology(int argc, char **argv);
+
+#endif // TOPOLOGY_H
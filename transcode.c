@@ -0,0 +1,593 @@
+#include "transcode.h"
+#include "batch.h"
+#include "eeprom_ops.h"
+#include "eeprom_structure.h"
+#include "field_index.h"
+#include "patch.h"
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Field Map
+// ═══════════════════════════════════════════════════════════════
+// Display names per layout family (NULL = the layout has no such field).
+// fallback names the mapping whose target value fills this one when the
+// source lacks it.
+
+enum
+{
+	FAMILY_S19,                    // v4, v5, v6
+	FAMILY_V1,
+	FAMILY_V17,
+	FAMILY_COUNT
+};
+
+typedef struct
+{
+	const char *name;
+	const char *fields[FAMILY_COUNT];
+	const char *fallback;
+} TranscodeMap;
+
+static const TranscodeMap transcode_map[] =
+{
+	// Identification
+	{ "serial",           { "Board Serial", "Board Serial", "Serial Number" }, NULL },
+	{ "board_name",       { "Board Name", "Board Name", NULL }, NULL },
+	{ "factory_job",      { "Factory Job", "Factory Job", NULL }, NULL },
+	{ "chip_die",         { "Chip Die", "Chip Die", "Chip Die" }, NULL },
+	{ "chip_marking",     { "Chip Marking", "Chip Marking", "Chip Marking" }, NULL },
+	{ "chip_bin",         { "Chip Bin", "Chip Bin", "Chip Bin" }, NULL },
+	{ "ft_version",       { "FT Version", "FT Version", "FT Program Version" }, NULL },
+	{ "chip_tech",        { "Chip Tech", "Chip Tech", "Chip Technology" }, NULL },
+	{ "pcb_version",      { "PCB Version", "PCB Version", "PCB Version" }, NULL },
+	{ "bom_version",      { "BOM Version", "BOM Version", "BOM Version" }, NULL },
+	{ "asic_sensor_type", { "ASIC Sensor Type", "ASIC Sensor Type", "ASIC Sensor Type" }, NULL },
+	{ "subformat",        { NULL, NULL, "Subformat Version" }, NULL },
+	{ "miner_type",       { NULL, NULL, "Miner Type" }, NULL },
+
+	// PT1 / PT2
+	{ "pt1_result",       { "PT1 Result", "PT1 Result", NULL }, "pt2_result" },
+	{ "pt1_count",        { "PT1 Count", "PT1 Count", NULL }, NULL },
+	{ "voltage",          { "PSU Voltage", "PSU Voltage", "Test Voltage" }, NULL },
+	{ "frequency",        { "Frequency", "Frequency", "Test Frequency" }, NULL },
+	{ "nonce_rate",       { "Nonce Rate", "Nonce Rate", NULL }, NULL },
+	{ "test_hashrate",    { NULL, NULL, "Test Hashrate" }, NULL },
+	{ "pcb_temp_in",      { "PCB Temp In", "PCB Temp In", "PCB Temp In" }, NULL },
+	{ "pcb_temp_out",     { "PCB Temp Out", "PCB Temp Out", "PCB Temp Out" }, NULL },
+	{ "test_version",     { "Test Version", NULL, NULL }, NULL },
+	{ "test_standard",    { "Test Standard", NULL, NULL }, NULL },
+	{ "test_parameter",   { NULL, NULL, "Test Parameter" }, NULL },
+	{ "done_type",        { NULL, "Done Type", NULL }, NULL },
+	{ "pt2_result",       { "PT2 Result", "PT2 Result", "Test Result" }, NULL },
+	{ "pt2_count",        { "PT2 Count", "PT2 Count", NULL }, NULL },
+
+	// Sweep
+	{ "sweep_voltage",    { NULL, "SWEEP Voltage", NULL }, "voltage" },
+	{ "sweep_hashrate",   { "Sweep Hashrate", "Sweep Hashrate", NULL }, NULL },
+	{ "sweep_freq_base",  { "Sweep Freq Base", "Sweep Freq Base", NULL }, "frequency" },
+	{ "sweep_freq_step",  { "Sweep Freq Step", "Sweep Freq Step", NULL }, NULL },
+	{ "sweep_level",      { "ASIC Frequencies", "ASIC Frequencies", NULL }, NULL },
+	{ "sweep_result",     { "Sweep Result", "Sweep Result", NULL }, "pt2_result" },
+	{ "sweep_count",      { NULL, "Sweep Count", NULL }, NULL },
+};
+
+#define TRANSCODE_MAPS (sizeof(transcode_map) / sizeof(transcode_map[0]))
+
+_Static_assert(TRANSCODE_MAPS <= TRANSCODE_MAX_FIELDS, "report masks hold one bit per mapping");
+
+const char *transcode_field_name(size_t index)
+{
+	return index < TRANSCODE_MAPS ? transcode_map[index].name : NULL;
+}
+
+static int family_of(EEPROMVersion version)
+{
+	switch (version)
+	{
+		case EEPROM_VERSION_V4:
+		case EEPROM_VERSION_V5:
+		case EEPROM_VERSION_V6:
+			return FAMILY_S19;
+		case EEPROM_VERSION_V1:
+			return FAMILY_V1;
+		case EEPROM_VERSION_V17:
+			return FAMILY_V17;
+		default:
+			return -1;
+	}
+}
+
+// Field of mapping i in a layout, NULL if absent (v4 has no sweep region)
+static const FieldMetadata *map_field(size_t i, EEPROMVersion version)
+{
+	const char *name = transcode_map[i].fields[family_of(version)];
+	if (!name)
+	{
+		return NULL;
+	}
+	const FieldMetadata *field = field_index_find(version, name);
+	return field && eeprom_field_in_layout(field, eeprom_get_layout(version)) ? field : NULL;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Values
+// ═══════════════════════════════════════════════════════════════
+
+typedef union
+{
+	EEPROMStructure v4_v6;
+	EEPROMStructure_v17 v17;
+	EEPROMStructure_v1 v1;
+} TranscodeImage;
+
+static void image_parse(TranscodeImage *image, const uint8_t *data, EEPROMVersion version)
+{
+	switch (version)
+	{
+		case EEPROM_VERSION_V1:
+			eeprom_v1_parse(&image->v1, data);
+			break;
+		case EEPROM_VERSION_V17:
+			eeprom_v17_parse(&image->v17, data);
+			break;
+		default:
+			eeprom_from_bytes(&image->v4_v6, data);
+			break;
+	}
+}
+
+static void image_serialize(const TranscodeImage *image, uint8_t *data, EEPROMVersion version)
+{
+	switch (version)
+	{
+		case EEPROM_VERSION_V1:
+			eeprom_v1_serialize(&image->v1, data);
+			break;
+		case EEPROM_VERSION_V17:
+			eeprom_v17_serialize(&image->v17, data);
+			break;
+		default:
+			eeprom_to_bytes(&image->v4_v6, data);
+			break;
+	}
+}
+
+static int field_numeric(const FieldMetadata *field)
+{
+	return field->type != FIELD_TYPE_STRING && field->type != FIELD_TYPE_ARRAY_UINT8 &&
+		   field->type != FIELD_TYPE_FREQ_LEVELS;
+}
+
+// Structures hold 16-bit fields in host order
+static int32_t value_read(const void *image, const FieldMetadata *field)
+{
+	const uint8_t *p = (const uint8_t*)image + field->offset;
+	if (field->type == FIELD_TYPE_INT8)
+	{
+		return (int8_t)p[0];
+	}
+	if (field->size == 2)
+	{
+		uint16_t v;
+		memcpy(&v, p, 2);
+		return v;
+	}
+	return p[0];
+}
+
+// Store value clamped to what the field can hold; returns 1 if it was
+// clamped. Values outside the schema range are kept as they are.
+static int value_write(void *image, const FieldMetadata *field, int32_t value)
+{
+	int32_t lo = field->type == FIELD_TYPE_INT8 ? INT8_MIN : 0;
+	int32_t hi = field->type == FIELD_TYPE_INT8 ? INT8_MAX : field->size == 2 ? UINT16_MAX : UINT8_MAX;
+	int32_t stored = value < lo ? lo : value > hi ? hi : value;
+	uint8_t *p = (uint8_t*)image + field->offset;
+	if (field->size == 2)
+	{
+		uint16_t v = (uint16_t)stored;
+		memcpy(p, &v, 2);
+	}
+	else
+	{
+		p[0] = (uint8_t)stored;
+	}
+	return stored != value;
+}
+
+static int byte_blank(uint8_t c)
+{
+	return c == 0x00 || c == ' ' || c == 0xFF;
+}
+
+// Any content worth reporting when a field is dropped
+static int field_set(const void *image, const FieldMetadata *field)
+{
+	if (field_numeric(field))
+	{
+		return value_read(image, field) != 0;
+	}
+	const uint8_t *p = (const uint8_t*)image + field->offset;
+	for (size_t i = 0; i < field->size; i++)
+	{
+		if (field->type == FIELD_TYPE_STRING ? !byte_blank(p[i]) : p[i] != 0)
+		{
+			return 1;
+		}
+	}
+	return 0;
+}
+
+// Convert one field; returns 1 if information was lost
+static int field_convert(const void *src, const FieldMetadata *from, void *dst, const FieldMetadata *to)
+{
+	const uint8_t *in = (const uint8_t*)src + from->offset;
+	uint8_t *out = (uint8_t*)dst + to->offset;
+
+	if (!field_numeric(from) || !field_numeric(to))
+	{
+		if (field_numeric(from) != field_numeric(to))
+		{
+			return field_set(src, from);
+		}
+		size_t n = from->size < to->size ? from->size : to->size;
+		memcpy(out, in, n);
+		int lost = 0;
+		for (size_t i = n; i < from->size; i++)
+		{
+			lost |= from->type == FIELD_TYPE_STRING ? !byte_blank(in[i]) : in[i] != 0;
+		}
+		return lost;
+	}
+
+	// PSU voltage: hundredths of a volt in v1-v6, mV in v17
+	int32_t value = value_read(src, from);
+	int from_mv = from->unit && strcmp(from->unit, "mV") == 0;
+	int to_mv = to->unit && strcmp(to->unit, "mV") == 0;
+	int lost = 0;
+	if (from_mv && !to_mv)
+	{
+		lost = value % 10 != 0;
+		value = (value + 5) / 10;
+	}
+	else if (to_mv && !from_mv)
+	{
+		value *= 10;
+	}
+	return value_write(dst, to, value) | lost;
+}
+
+// Sensor addresses are padding in the schema but shared by v4-v6 and v17
+static int sensors_copy(const TranscodeImage *src, EEPROMVersion from, TranscodeImage *dst, EEPROMVersion to)
+{
+	uint8_t sensors[6] = { 0 };
+	int have = 1;
+	switch (family_of(from))
+	{
+		case FAMILY_S19:
+			memcpy(sensors, src->v4_v6.board_info.asic_sensor_addr, 4);
+			sensors[4] = src->v4_v6.board_info.pic_sensor_type;
+			sensors[5] = src->v4_v6.board_info.pic_sensor_addr;
+			break;
+		case FAMILY_V17:
+			memcpy(sensors, src->v17.data.asic_sensor_addr, 4);
+			sensors[4] = src->v17.data.pic_sensor_type;
+			sensors[5] = src->v17.data.pic_sensor_addr;
+			break;
+		default:
+			have = 0;
+			break;
+	}
+
+	switch (family_of(to))
+	{
+		case FAMILY_S19:
+			memcpy(dst->v4_v6.board_info.asic_sensor_addr, sensors, 4);
+			dst->v4_v6.board_info.pic_sensor_type = sensors[4];
+			dst->v4_v6.board_info.pic_sensor_addr = sensors[5];
+			return 0;
+		case FAMILY_V17:
+			memcpy(dst->v17.data.asic_sensor_addr, sensors, 4);
+			dst->v17.data.pic_sensor_type = sensors[4];
+			dst->v17.data.pic_sensor_addr = sensors[5];
+			return 0;
+		default:
+			for (size_t i = 0; have && i < sizeof(sensors); i++)
+			{
+				if (!byte_blank(sensors[i]))
+				{
+					return 1;
+				}
+			}
+			return 0;
+	}
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Transcoding
+// ═══════════════════════════════════════════════════════════════
+
+int transcode_image(const uint8_t *data, EEPROMVersion from, uint8_t *out, EEPROMVersion to,
+					TranscodeReport *report)
+{
+	memset(report, 0, sizeof(*report));
+	if (family_of(from) < 0 || family_of(to) < 0)
+	{
+		return -1;
+	}
+
+	TranscodeImage src, dst;
+	image_parse(&src, data, from);
+	memset(&dst, 0, sizeof(dst));
+
+	for (size_t i = 0; i < TRANSCODE_MAPS; i++)
+	{
+		const FieldMetadata *source = map_field(i, from);
+		const FieldMetadata *target = map_field(i, to);
+		if (source && (target ? field_convert(&src, source, &dst, target) : field_set(&src, source)))
+		{
+			report->lossy |= 1ull << i;
+		}
+	}
+
+	// Fallbacks read the converted target value of another mapping
+	for (size_t i = 0; i < TRANSCODE_MAPS; i++)
+	{
+		const FieldMetadata *target = map_field(i, to);
+		if (!target || map_field(i, from) || !transcode_map[i].fallback)
+		{
+			continue;
+		}
+		for (size_t j = 0; j < TRANSCODE_MAPS; j++)
+		{
+			const FieldMetadata *value = map_field(j, to);
+			if (value && strcmp(transcode_map[j].name, transcode_map[i].fallback) == 0)
+			{
+				value_write(&dst, target, value_read(&dst, value));
+				report->synthesized |= 1ull << i;
+			}
+		}
+	}
+
+	report->sensors_lost = (uint8_t)sensors_copy(&src, from, &dst, to);
+
+	// Header of the target layout
+	switch (family_of(to))
+	{
+		case FAMILY_S19:
+		{
+			const EEPROMLayout *layout = eeprom_get_layout(to);
+			dst.v4_v6.eeprom_version = (uint8_t)to;
+			dst.v4_v6.algorithm_and_key_version = family_of(from) == FAMILY_S19
+				? src.v4_v6.algorithm_and_key_version
+				: (uint8_t)(layout->algorithm << 4 | layout->key_index);
+			break;
+		}
+		case FAMILY_V1:
+			dst.v1.eeprom_version = (uint8_t)to;
+			break;
+		default:
+			dst.v17.algorithm_and_key = (uint8_t)to;
+			dst.v17.data_length = (uint8_t)(sizeof(EEPROMStructure_v17) - 2);
+			break;
+	}
+
+	memset(out, 0xFF, EEPROM_SIZE);
+	image_serialize(&dst, out, to);
+	return 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	EEPROMVersion target;
+	const char *out_dir;
+	int in_place;
+	int dry_run;
+	int strict;
+
+	pthread_mutex_t lock;
+	size_t transcoded;
+	size_t lossy;                  // Transcoded with information lost
+	size_t unchanged;              // Already the target version
+	size_t skipped;
+	size_t failed;
+} TranscodeRun;
+
+static void transcode_report(TranscodeRun *run, size_t *counter, const char *name, const char *error)
+{
+	pthread_mutex_lock(&run->lock);
+	(*counter)++;
+	if (error)
+	{
+		fprintf(stderr, "%s: %s: %s\n", counter == &run->failed ? "Error" : "Skipped", name, error);
+	}
+	pthread_mutex_unlock(&run->lock);
+}
+
+// Comma-separated mapping names of mask into out
+static void mask_names(uint64_t mask, int sensors, char *out, size_t size)
+{
+	size_t n = 0;
+	out[0] = '\0';
+	for (size_t i = 0; i < TRANSCODE_MAPS && n < size; i++)
+	{
+		if (mask & (1ull << i))
+		{
+			n += (size_t)snprintf(out + n, size - n, "%s%s", n ? ", " : "", transcode_map[i].name);
+		}
+	}
+	if (sensors && n < size)
+	{
+		snprintf(out + n, size - n, "%ssensor addresses", n ? ", " : "");
+	}
+}
+
+static int transcode_file(const char *name, const uint8_t *raw, size_t size, void *ctx)
+{
+	TranscodeRun *run = (TranscodeRun*)ctx;
+	uint8_t data[EEPROM_SIZE];
+	memset(data, 0xFF, sizeof(data));
+	memcpy(data, raw, size);
+
+	EEPROMCheck check;
+	if (batch_decode(data, &check) != EEPROM_SUCCESS)
+	{
+		transcode_report(run, &run->skipped, name, "unknown EEPROM version");
+		return 0;
+	}
+	if (check.crc_ok != EEPROM_CHECK_ALL(&check))
+	{
+		transcode_report(run, &run->failed, name, "CRC mismatch, not transcoded");
+		return 0;
+	}
+	if (check.version == run->target)
+	{
+		transcode_report(run, &run->unchanged, name, NULL);
+		return 0;
+	}
+
+	uint8_t out[EEPROM_SIZE];
+	TranscodeReport report;
+	if (transcode_image(data, check.version, out, run->target, &report) != 0)
+	{
+		transcode_report(run, &run->failed, name, "unsupported version");
+		return 0;
+	}
+	int lossy = report.lossy || report.sensors_lost;
+	if (lossy && run->strict)
+	{
+		char names[512];
+		char error[600];
+		mask_names(report.lossy, report.sensors_lost, names, sizeof(names));
+		snprintf(error, sizeof(error), "lossy (%s), not transcoded", names);
+		transcode_report(run, &run->failed, name, error);
+		return 0;
+	}
+
+	if (eeprom_encode(out, EEPROM_SIZE, run->target) != EEPROM_SUCCESS)
+	{
+		transcode_report(run, &run->failed, name, "encode failed");
+		return 0;
+	}
+	uint8_t verify[EEPROM_SIZE];
+	EEPROMCheck verify_check;
+	memcpy(verify, out, sizeof(verify));
+	if (eeprom_decode_check(verify, EEPROM_SIZE, run->target, &verify_check) != EEPROM_SUCCESS ||
+		verify_check.crc_ok != EEPROM_CHECK_ALL(&verify_check))
+	{
+		transcode_report(run, &run->failed, name, "transcoded image fails CRC check");
+		return 0;
+	}
+
+	if (!run->dry_run)
+	{
+		char path[4200];
+		patch_output_path(run->in_place ? NULL : run->out_dir, name, size, path, sizeof(path));
+
+		struct stat st;
+		if (run->in_place && (stat(name, &st) != 0 || !S_ISREG(st.st_mode) || (size_t)st.st_size != size))
+		{
+			transcode_report(run, &run->failed, name, "not a plain image file, use -o DIR");
+			return 0;
+		}
+		if (patch_write_atomic(path, out, EEPROM_SIZE) != 0)
+		{
+			transcode_report(run, &run->failed, name, "cannot write output");
+			return 0;
+		}
+	}
+
+	char lost[512], synthesized[512];
+	mask_names(report.lossy, report.sensors_lost, lost, sizeof(lost));
+	mask_names(report.synthesized, 0, synthesized, sizeof(synthesized));
+
+	pthread_mutex_lock(&run->lock);
+	run->transcoded++;
+	run->lossy += lossy;
+	printf("  %s: v%d -> v%d%s%s%s%s\n", name, check.version, run->target,
+		   lost[0] ? ", lost: " : "", lost, synthesized[0] ? ", synthesized: " : "", synthesized);
+	pthread_mutex_unlock(&run->lock);
+	return 0;
+}
+
+int cmd_transcode(int argc, char **argv)
+{
+	TranscodeRun run;
+	memset(&run, 0, sizeof(run));
+	run.target = EEPROM_VERSION_UNKNOWN;
+	char *paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-v") == 0 && i + 1 < argc)
+		{
+			run.target = (EEPROMVersion)atoi(argv[++i]);
+			if (family_of(run.target) < 0)
+			{
+				fprintf(stderr, "Error: Unknown target version '%s' (1, 4, 5, 6, 17)\n", argv[i]);
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc)
+		{
+			run.out_dir = argv[++i];
+		}
+		else if (strcmp(argv[i], "--in-place") == 0)
+		{
+			run.in_place = 1;
+		}
+		else if (strcmp(argv[i], "-n") == 0)
+		{
+			run.dry_run = 1;
+		}
+		else if (strcmp(argv[i], "--strict") == 0)
+		{
+			run.strict = 1;
+		}
+		else
+		{
+			paths[path_count++] = argv[i];
+		}
+	}
+
+	if (run.target == EEPROM_VERSION_UNKNOWN || path_count == 0 ||
+		(!run.out_dir && !run.in_place && !run.dry_run) || (run.out_dir && run.in_place))
+	{
+		fprintf(stderr, "Usage: eeprom_tool transcode -v 1|4|5|6|17 (-o DIR | --in-place) [-n] [--strict] PATH...\n");
+		return 1;
+	}
+
+	if (run.out_dir)
+	{
+		struct stat st;
+		if (stat(run.out_dir, &st) != 0 && mkdir(run.out_dir, 0755) != 0)
+		{
+			fprintf(stderr, "Error: Cannot create %s\n", run.out_dir);
+			return 1;
+		}
+	}
+
+	pthread_mutex_init(&run.lock, NULL);
+	batch_for_each_parallel(paths, path_count, transcode_file, &run, NULL);
+	pthread_mutex_destroy(&run.lock);
+
+	fflush(stdout);
+	fprintf(stderr, "%s: %zu (%zu lossy), already v%d: %zu, skipped: %zu, errors: %zu\n",
+			run.dry_run ? "Would transcode" : "Transcoded", run.transcoded, run.lossy, run.target,
+			run.unchanged, run.skipped, run.failed);
+	return run.failed ? 2 : 0;
+}
@@ -0,0 +1,51 @@
+#ifndef TRANSCODE_H
+#define TRANSCODE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include "eeprom_defs.h"
+
+// ═══════════════════════════════════════════════════════════════
+// Cross-Version Transcoding
+// ═══════════════════════════════════════════════════════════════
+// Fields are mapped between EEPROMStructure (v4-v6), EEPROMStructure_v1
+// and EEPROMStructure_v17 by semantic name (see the table in
+// transcode.c). Rules for fields that do not map one to one:
+//
+//   dropped        the target has no such field ("Factory Job" to v17,
+//                  "Test Hashrate" and "Miner Type" out of v17, sensor
+//                  addresses to v1)
+//   truncated      strings longer than the target field ("Chip Die" to v17)
+//   clamped        numbers wider than the target field ("BOM Version" to
+//                  v1's single byte); out-of-range values are kept as is
+//   rescaled       PSU voltage in hundredths of a volt <-> v17 mV
+//   synthesized    fields the source lacks: PT1 Result from the test
+//                  result, SWEEP Voltage from the PSU voltage, and a sweep
+//                  region for v4/v17 sources that puts every ASIC at the
+//                  PT2 frequency (step 0) with the PT2 result as its result
+//
+// Other missing fields are 0 or blank. Header bytes follow the target
+// layout; v4-v6 keep the source's algorithm/key byte when it has one.
+// Images with a region CRC mismatch are not transcoded and count as errors.
+
+#define TRANSCODE_MAX_FIELDS 64
+
+typedef struct
+{
+	uint64_t lossy;                // Bit i: mapping i dropped, truncated, clamped or rounded
+	uint64_t synthesized;          // Bit i: mapping i filled by a rule
+	uint8_t sensors_lost;          // Sensor addresses dropped (v1 has none)
+} TranscodeReport;
+
+// Semantic name of mapping i (for reports), NULL past the table
+const char *transcode_field_name(size_t index);
+
+// Map decoded image data of version from into out (EEPROM_SIZE bytes,
+// decoded) as version to. Returns 0, or -1 if either version is unknown.
+int transcode_image(const uint8_t *data, EEPROMVersion from, uint8_t *out, EEPROMVersion to,
+					TranscodeReport *report);
+
+// CLI: eeprom_tool transcode -v 1|4|5|6|17 (-o DIR | --in-place) [-n] [--strict] PATH...
+int cmd_transcode(int argc, char **argv);
+
+#endif // TRANSCODE_H
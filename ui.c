@@ -1,21 +1,127 @@
 #include "ui.h"
 #include "eeprom_structure.h"
+#include "sweep.h"
 #include <stdio.h>
 #include <stdarg.h>
+#include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <unistd.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Render Buffer
+// ═══════════════════════════════════════════════════════════════
+
+static int color_mode = -1;        // -1 = not decided yet
+
+int ui_color_enabled(void)
+{
+	if (color_mode < 0)
+	{
+		color_mode = isatty(STDOUT_FILENO) && !getenv("NO_COLOR");
+	}
+	return color_mode;
+}
+
+void ui_set_color(int enabled)
+{
+	color_mode = enabled != 0;
+}
+
+const char *ui_color(const char *code)
+{
+	return ui_color_enabled() ? code : "";
+}
+
+void ui_appendf(EmitBuffer *buf, const char *format, ...)
+{
+	char stack[256];
+	va_list args;
+	va_start(args, format);
+	int n = vsnprintf(stack, sizeof(stack), format, args);
+	va_end(args);
+
+	if (n < 0)
+	{
+		return;
+	}
+	if ((size_t)n < sizeof(stack))
+	{
+		emit_put(buf, stack, (size_t)n);
+		return;
+	}
+
+	char *heap = malloc((size_t)n + 1);
+	if (heap)
+	{
+		va_start(args, format);
+		vsnprintf(heap, (size_t)n + 1, format, args);
+		va_end(args);
+		emit_put(buf, heap, (size_t)n);
+		free(heap);
+	}
+}
+
+// Color code, dropped when color is off
+static void append_color(EmitBuffer *buf, const char *code)
+{
+	if (ui_color_enabled())
+	{
+		emit_str(buf, code);
+	}
+}
+
+void ui_flush(EmitBuffer *buf)
+{
+	// Keep order with anything already sitting in stdio's buffer
+	fflush(stdout);
+
+	const char *p = buf->data;
+	size_t len = buf->len;
+	while (len)
+	{
+		ssize_t n = write(STDOUT_FILENO, p, len);
+		if (n <= 0)
+		{
+			break;
+		}
+		p += n;
+		len -= (size_t)n;
+	}
+	buf->len = 0;
+}
 
 // ═══════════════════════════════════════════════════════════════
 // Formatted Output Functions
 // ═══════════════════════════════════════════════════════════════
 
+static void print_message(const char *color, const char *prefix, const char *format, va_list args)
+{
+	char stack[512];
+	EmitBuffer buf = { 0 };
+	append_color(&buf, color);
+	emit_str(&buf, prefix);
+	append_color(&buf, TERM_RESET);
+
+	va_list copy;
+	va_copy(copy, args);
+	int n = vsnprintf(stack, sizeof(stack), format, copy);
+	va_end(copy);
+	if (n > 0)
+	{
+		emit_put(&buf, stack, (size_t)n < sizeof(stack) ? (size_t)n : sizeof(stack) - 1);
+	}
+	emit_char(&buf, '\n');
+
+	ui_flush(&buf);
+	emit_buffer_free(&buf);
+}
+
 void ui_print_success(const char *format, ...)
 {
 	va_list args;
 	va_start(args, format);
-	printf(TERM_GREEN "✓ " TERM_RESET);
-	vprintf(format, args);
-	printf("\n");
+	print_message(TERM_GREEN, "✓ ", format, args);
 	va_end(args);
 }
 
@@ -23,9 +129,7 @@ void ui_print_error(const char *format, ...)
 {
 	va_list args;
 	va_start(args, format);
-	printf(TERM_RED "✗ Error: " TERM_RESET);
-	vprintf(format, args);
-	printf("\n");
+	print_message(TERM_RED, "✗ Error: ", format, args);
 	va_end(args);
 }
 
@@ -33,9 +137,7 @@ void ui_print_warning(const char *format, ...)
 {
 	va_list args;
 	va_start(args, format);
-	printf(TERM_YELLOW "⚠ Warning: " TERM_RESET);
-	vprintf(format, args);
-	printf("\n");
+	print_message(TERM_YELLOW, "⚠ Warning: ", format, args);
 	va_end(args);
 }
 
@@ -43,29 +145,68 @@ void ui_print_info(const char *format, ...)
 {
 	va_list args;
 	va_start(args, format);
-	printf(TERM_CYAN "ℹ " TERM_RESET);
-	vprintf(format, args);
-	printf("\n");
+	print_message(TERM_CYAN, "ℹ ", format, args);
 	va_end(args);
 }
 
+void ui_render_header(EmitBuffer *buf, const char *title)
+{
+	emit_char(buf, '\n');
+	append_color(buf, TERM_BOLD TERM_CYAN);
+	emit_str(buf, title);
+	append_color(buf, TERM_RESET);
+	emit_char(buf, '\n');
+	append_color(buf, TERM_DIM);
+	emit_str(buf, "════════════════════════════════════════════════════════════════\n");
+	append_color(buf, TERM_RESET);
+}
+
+void ui_render_separator(EmitBuffer *buf)
+{
+	append_color(buf, TERM_DIM);
+	emit_str(buf, "────────────────────────────────────────────────────────────────\n");
+	append_color(buf, TERM_RESET);
+}
+
+void ui_render_category_header(EmitBuffer *buf, const char *category)
+{
+	emit_char(buf, '\n');
+	append_color(buf, TERM_BOLD TERM_BLUE);
+	emit_str(buf, "── ");
+	emit_str(buf, category);
+	emit_char(buf, ' ');
+	append_color(buf, TERM_RESET);
+	append_color(buf, TERM_DIM);
+	emit_str(buf, "────────────────────────────────────────────────────────\n");
+	append_color(buf, TERM_RESET);
+}
+
+// One-shot wrappers: render, then a single write
+#define UI_PRINT_ONCE(render, ...) \
+	do \
+	{ \
+		EmitBuffer buf_ = { 0 }; \
+		render(&buf_, __VA_ARGS__); \
+		ui_flush(&buf_); \
+		emit_buffer_free(&buf_); \
+	} while (0)
+
 void ui_print_header(const char *title)
 {
-	printf("\n");
-	printf(TERM_BOLD TERM_CYAN "%s" TERM_RESET "\n", title);
-	printf(TERM_DIM "════════════════════════════════════════════════════════════════\n" TERM_RESET);
+	UI_PRINT_ONCE(ui_render_header, title);
 }
 
 void ui_print_separator(void)
 {
-	printf(TERM_DIM "────────────────────────────────────────────────────────────────\n" TERM_RESET);
+	EmitBuffer buf = { 0 };
+	ui_render_separator(&buf);
+	ui_flush(&buf);
+	emit_buffer_free(&buf);
 }
 
 void ui_print_category_header(const char *category)
 {
-	printf("\n");
-	printf(TERM_BOLD TERM_BLUE "── %s " TERM_RESET, category);
-	printf(TERM_DIM "────────────────────────────────────────────────────────\n" TERM_RESET);
+	UI_PRINT_ONCE(ui_render_category_header, category);
 }
 
 // ═══════════════════════════════════════════════════════════════
@@ -161,184 +302,201 @@ bool ui_input_string(const char *prompt, char *buffer, size_t maxlen)
 // EEPROM Display Functions
 // ═══════════════════════════════════════════════════════════════
 
-void ui_print_field(const void *base, const FieldMetadata *field)
+static void render_name(EmitBuffer *buf, const char *name)
+{
+	emit_str(buf, "  ");
+	append_color(buf, TERM_BOLD);
+	ui_appendf(buf, "%-27s", name);
+	append_color(buf, TERM_RESET);
+	emit_char(buf, ':');
+}
+
+static void render_read_only(EmitBuffer *buf, int read_only)
+{
+	if (read_only)
+	{
+		append_color(buf, TERM_DIM);
+		emit_str(buf, " [RO]");
+		append_color(buf, TERM_RESET);
+	}
+}
+
+static void render_value(EmitBuffer *buf, const char *name, int read_only, const char *format, ...)
 {
-	const uint8_t *ptr = (const uint8_t*)base + field->offset;
 	char value_buf[256];
-	value_buf[0] = '\0';
+	va_list args;
+	va_start(args, format);
+	vsnprintf(value_buf, sizeof(value_buf), format, args);
+	va_end(args);
 
-	switch (field->type)
+	render_name(buf, name);
+	emit_char(buf, ' ');
+	emit_str(buf, value_buf);
+	render_read_only(buf, read_only);
+	emit_char(buf, '\n');
+}
+
+static void render_bytes(EmitBuffer *buf, const char *name, int read_only, const uint8_t *array, size_t size)
+{
+	render_name(buf, name);
+	emit_str(buf, " [");
+	for (size_t i = 0; i < size && i < 16; i++)
 	{
-		case FIELD_TYPE_UINT8:
+		if (i > 0)
 		{
-			uint8_t value = *(const uint8_t*)ptr;
-			snprintf(value_buf, sizeof(value_buf), field->format, value);
-			break;
+			emit_char(buf, ' ');
 		}
+		emit_hex(buf, array[i], 2);
+	}
+	if (size > 16)
+	{
+		emit_str(buf, " ...");
+	}
+	emit_char(buf, ']');
+	render_read_only(buf, read_only);
+	emit_char(buf, '\n');
+}
 
-		case FIELD_TYPE_UINT16:
+// Right-aligned in width columns
+static void render_padded(EmitBuffer *buf, unsigned value, int width)
+{
+	int digits = 1;
+	for (unsigned v = value; v >= 10; v /= 10)
+	{
+		digits++;
+	}
+	for (; digits < width; digits++)
+	{
+		emit_char(buf, ' ');
+	}
+	emit_uint(buf, value);
+}
+
+static void render_freq_levels(EmitBuffer *buf, const char *name, int read_only, const uint8_t *array,
+							   size_t size, uint16_t freq_base, uint8_t freq_step)
+{
+	render_name(buf, name);
+	render_read_only(buf, read_only);
+	emit_char(buf, '\n');
+
+	uint16_t freq[SWEEP_MAX_ASICS];
+	if (size > SWEEP_LEVEL_BYTES)
+	{
+		size = SWEEP_LEVEL_BYTES;
+	}
+	sweep_expand(array, size, freq_base, freq_step, freq);
+
+	// Выводим частоты (каждый байт содержит 2 частоты по 4 бита)
+	for (size_t i = 0; i < size; i++)
+	{
+		if (i % 8 == 0)
 		{
-			uint16_t value = *(const uint16_t*)ptr;
-			if (field->unit)
-			{
-				snprintf(value_buf, sizeof(value_buf), "%u %s", value, field->unit);
-			}
-			else
-			{
-				snprintf(value_buf, sizeof(value_buf), "%u", value);
-			}
-			break;
+			emit_str(buf, "    ");
 		}
 
-		case FIELD_TYPE_INT8:
+		emit_char(buf, ' ');
+		render_padded(buf, freq[2 * i], 4);
+		emit_char(buf, ' ');
+		render_padded(buf, freq[2 * i + 1], 4);
+
+		if ((i % 8) == 7)
 		{
-			int8_t value = *(const int8_t*)ptr;
-			if (field->unit)
-			{
-				snprintf(value_buf, sizeof(value_buf), "%d %s", value, field->unit);
-			}
-			else
-			{
-				snprintf(value_buf, sizeof(value_buf), "%d", value);
-			}
-			break;
+			emit_char(buf, '\n');
 		}
+	}
+}
+
+// Per-type renderers shared by the generated renderers and ui_render_field()
+#define UI_PRINT_UINT8(reg, v, name, n, unit, fmt, ro)       render_value(buf, name, ro, fmt, v)
+#define UI_PRINT_HEX8(reg, v, name, n, unit, fmt, ro)        render_value(buf, name, ro, "0x%02X", v)
+#define UI_PRINT_HEX16(reg, v, name, n, unit, fmt, ro)       render_value(buf, name, ro, "0x%04X", v)
+#define UI_PRINT_STRING(reg, v, name, n, unit, fmt, ro)      render_value(buf, name, ro, fmt, v)
+#define UI_PRINT_VOLTAGE(reg, v, name, n, unit, fmt, ro)     render_value(buf, name, ro, "%.2f V", (v) / 100.0f)
+#define UI_PRINT_HASHRATE(reg, v, name, n, unit, fmt, ro)    render_value(buf, name, ro, fmt, (v) / 100.0f)
+#define UI_PRINT_ARRAY_UINT8(reg, v, name, n, unit, fmt, ro) render_bytes(buf, name, ro, v, n)
+#define UI_PRINT_UINT16(reg, v, name, n, unit, fmt, ro) \
+	do { if (unit) render_value(buf, name, ro, "%u %s", v, unit); else render_value(buf, name, ro, "%u", v); } while (0)
+#define UI_PRINT_INT8(reg, v, name, n, unit, fmt, ro) \
+	do { if (unit) render_value(buf, name, ro, "%d %s", v, unit); else render_value(buf, name, ro, "%d", v); } while (0)
+#define UI_PRINT_FREQ_LEVELS(reg, v, name, n, unit, fmt, ro) \
+	render_freq_levels(buf, name, ro, v, n, (reg)->sweep_freq_base, (reg)->sweep_freq_step)
+
+#define UI_PRINT(reg, v, type, n, name, cat, lo, hi, unit, fmt, flags) \
+	do \
+	{ \
+		if ((cat) != category) \
+		{ \
+			ui_render_category_header(buf, cat); \
+			category = (cat); \
+		} \
+		UI_PRINT_##type(reg, v, name, n, unit, fmt, ((flags) & SCHEMA_RO) != 0); \
+	} while (0);
+
+#define UI_PRINT_TOP(T, member, ...)            UI_PRINT(eeprom, eeprom->member, __VA_ARGS__)
+#define UI_PRINT_FIELD(T, region, member, ...)  UI_PRINT(&eeprom->region, eeprom->region.member, __VA_ARGS__)
+
+// Straight-line renderer for one layout, expanded from its schema
+#define UI_DEFINE_PRINTER(schema, T, fn) \
+	static void fn(EmitBuffer *buf, const T *eeprom) \
+	{ \
+		const char *category = NULL; \
+		schema(T, UI_PRINT_TOP, SCHEMA_NONE, SCHEMA_NONE, UI_PRINT_FIELD, SCHEMA_NONE, SCHEMA_NONE) \
+	}
+
+UI_DEFINE_PRINTER(EEPROM_SCHEMA_V4_V6, EEPROMStructure, ui_render_v4_v6)
+UI_DEFINE_PRINTER(EEPROM_SCHEMA_V17, EEPROMStructure_v17, ui_render_v17)
+UI_DEFINE_PRINTER(EEPROM_SCHEMA_V1, EEPROMStructure_v1, ui_render_v1)
+
+void ui_render_field(EmitBuffer *buf, const void *base, const FieldMetadata *field)
+{
+	const uint8_t *ptr = (const uint8_t*)base + field->offset;
+	uint16_t u16;
+	memcpy(&u16, ptr, sizeof(u16) <= field->size ? sizeof(u16) : field->size);
 
+	switch (field->type)
+	{
+		case FIELD_TYPE_UINT8:
+			UI_PRINT_UINT8(base, *ptr, field->name, field->size, field->unit, field->format, field->read_only);
+			break;
+		case FIELD_TYPE_UINT16:
+			UI_PRINT_UINT16(base, u16, field->name, field->size, field->unit, field->format, field->read_only);
+			break;
+		case FIELD_TYPE_INT8:
+			UI_PRINT_INT8(base, *(const int8_t*)ptr, field->name, field->size, field->unit, field->format, field->read_only);
+			break;
 		case FIELD_TYPE_STRING:
-		{
-			snprintf(value_buf, sizeof(value_buf), field->format, (const char*)ptr);
+			UI_PRINT_STRING(base, (const char*)ptr, field->name, field->size, field->unit, field->format, field->read_only);
 			break;
-		}
-
 		case FIELD_TYPE_HEX8:
-		{
-			uint8_t value = *(const uint8_t*)ptr;
-			snprintf(value_buf, sizeof(value_buf), "0x%02X", value);
+			UI_PRINT_HEX8(base, *ptr, field->name, field->size, field->unit, field->format, field->read_only);
 			break;
-		}
-
 		case FIELD_TYPE_HEX16:
-		{
-			uint16_t value = *(const uint16_t*)ptr;
-			snprintf(value_buf, sizeof(value_buf), "0x%04X", value);
+			UI_PRINT_HEX16(base, u16, field->name, field->size, field->unit, field->format, field->read_only);
 			break;
-		}
-
 		case FIELD_TYPE_VOLTAGE:
-		{
-			uint16_t value = *(const uint16_t*)ptr;
-			snprintf(value_buf, sizeof(value_buf), "%.2f V", value / 100.0f);
+			UI_PRINT_VOLTAGE(base, u16, field->name, field->size, field->unit, field->format, field->read_only);
 			break;
-		}
-
 		case FIELD_TYPE_HASHRATE:
-		{
-			uint16_t value = *(const uint16_t*)ptr;
-			snprintf(value_buf, sizeof(value_buf), field->format, value / 100.0f);
+			UI_PRINT_HASHRATE(base, u16, field->name, field->size, field->unit, field->format, field->read_only);
 			break;
-		}
-
 		case FIELD_TYPE_ARRAY_UINT8:
-		{
-			if (strcmp(field->name, "ASIC Frequencies") == 0)
-			{
-				uint16_t freq_base;
-				uint8_t freq_step;
-				size_t array_size = field->size;
-				const uint8_t *array = (const uint8_t*)ptr;
-
-				// Определяем версию EEPROM по offset
-				if (field->offset == offsetof(EEPROMStructure_v1, sweep_data.sweep_level))
-				{
-					// EEPROM v1 (S21+)
-					const EEPROMStructure_v1 *eeprom = (const EEPROMStructure_v1*)base;
-					freq_base = eeprom->sweep_data.sweep_freq_base;
-					freq_step = eeprom->sweep_data.sweep_freq_step;
-				}
-				else
-				{
-					// EEPROM v4/v5/v6 (S19/S19+)
-					const EEPROMStructure *eeprom = (const EEPROMStructure*)base;
-					freq_base = eeprom->sweep_data.sweep_freq_base;
-					freq_step = eeprom->sweep_data.sweep_freq_step;
-				}
-
-				printf("  " TERM_BOLD "%-27s" TERM_RESET ":", field->name);
-				if (field->read_only)
-				{
-					printf(TERM_DIM " [RO]" TERM_RESET);
-				}
-				printf("\n");
-
-				// Выводим частоты (каждый байт содержит 2 частоты по 4 бита)
-				for (size_t i = 0; i < array_size; i++)
-				{
-					if (i % 8 == 0)
-					{
-						printf("    ");
-					}
-
-					uint8_t v0 = array[i] >> 4;      // Старшие 4 бита
-					uint8_t v1 = array[i] & 0x0F;    // Младшие 4 бита
-
-					uint16_t freq0 = v0 * freq_step + freq_base;
-					uint16_t freq1 = v1 * freq_step + freq_base;
-
-					printf(" %4u %4u", freq0, freq1);
-
-					if ((i % 8) == 7)
-					{
-						printf("\n");
-					}
-				}
-
-				return;
-			}
-			else
-			{
-				const uint8_t *array = (const uint8_t*)ptr;
-				int pos = 0;
-				pos += snprintf(value_buf + pos, sizeof(value_buf) - pos, "[");
-				for (size_t i = 0; i < field->size && i < 16; i++)
-				{
-					if (i > 0) pos += snprintf(value_buf + pos, sizeof(value_buf) - pos, " ");
-					pos += snprintf(value_buf + pos, sizeof(value_buf) - pos, "0x%02X", array[i]);
-				}
-				if (field->size > 16)
-				{
-					pos += snprintf(value_buf + pos, sizeof(value_buf) - pos, " ...");
-				}
-				snprintf(value_buf + pos, sizeof(value_buf) - pos, "]");
-			}
+		case FIELD_TYPE_FREQ_LEVELS:
+			// Level decoding needs the region; the full renderers handle it
+			render_bytes(buf, field->name, field->read_only, ptr, field->size);
 			break;
-		}
-
 		default:
-			snprintf(value_buf, sizeof(value_buf), "<unknown type>");
+			render_value(buf, field->name, field->read_only, "<unknown type>");
 			break;
 	}
-
-	printf("  " TERM_BOLD "%-27s" TERM_RESET ": %s", field->name, value_buf);
-
-	if (field->read_only)
-	{
-		printf(TERM_DIM " [RO]" TERM_RESET);
-	}
-
-	printf("\n");
 }
 
-void ui_print_eeprom(const void *eeprom_struct, EEPROMVersion version)
+void ui_print_field(const void *base, const FieldMetadata *field)
 {
-	size_t field_count;
-	const FieldMetadata *fields = eeprom_get_fields(version, &field_count);
-
-	if (!fields || field_count == 0)
-	{
-		ui_print_error("No field metadata for EEPROM version %d", version);
-		return;
-	}
+	UI_PRINT_ONCE(ui_render_field, base, field);
+}
 
+int ui_render_eeprom(EmitBuffer *buf, const void *eeprom_struct, EEPROMVersion version)
+{
 	char title[64];
 	if (version == EEPROM_VERSION_V1)
 	{
@@ -352,22 +510,44 @@ void ui_print_eeprom(const void *eeprom_struct, EEPROMVersion version)
 	{
 		snprintf(title, sizeof(title), "EEPROM v%d Structure (Antminer S Series)", version);
 	}
-	ui_print_header(title);
 
-	const char *current_category = NULL;
-
-	for (size_t i = 0; i < field_count; i++)
+	switch (version)
 	{
-		const FieldMetadata *field = &fields[i];
+		case EEPROM_VERSION_V1:
+			ui_render_header(buf, title);
+			ui_render_v1(buf, eeprom_struct);
+			break;
 
-		if (current_category == NULL || strcmp(current_category, field->category) != 0)
-		{
-			ui_print_category_header(field->category);
-			current_category = field->category;
-		}
+		case EEPROM_VERSION_V4:
+		case EEPROM_VERSION_V5:
+		case EEPROM_VERSION_V6:
+			ui_render_header(buf, title);
+			ui_render_v4_v6(buf, eeprom_struct);
+			break;
 
-		ui_print_field(eeprom_struct, field);
+		case EEPROM_VERSION_V17:
+			ui_render_header(buf, title);
+			ui_render_v17(buf, eeprom_struct);
+			break;
+
+		default:
+			return -1;
 	}
 
-	printf("\n");
+	emit_char(buf, '\n');
+	return 0;
+}
+
+void ui_print_eeprom(const void *eeprom_struct, EEPROMVersion version)
+{
+	EmitBuffer buf = { 0 };
+	if (ui_render_eeprom(&buf, eeprom_struct, version) == 0)
+	{
+		ui_flush(&buf);
+	}
+	else
+	{
+		ui_print_error("No field metadata for EEPROM version %d", version);
+	}
+	emit_buffer_free(&buf);
 }
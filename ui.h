@@ -6,6 +6,7 @@
 #include <stdbool.h>
 #include "eeprom_defs.h"
 #include "eeprom_structure.h"
+#include "emit.h"
 
 // ═══════════════════════════════════════════════════════════════
 // ANSI Color Codes
@@ -33,6 +34,29 @@
 #define TERM_BG_CYAN    "\033[46m"
 #define TERM_BG_WHITE   "\033[47m"
 
+// ═══════════════════════════════════════════════════════════════
+// Render Buffer
+// ═══════════════════════════════════════════════════════════════
+// Screens are rendered into an EmitBuffer and written with ui_flush(),
+// one write() per board. Color codes are emitted only when stdout is a
+// terminal and NO_COLOR is unset.
+
+int ui_color_enabled(void);
+void ui_set_color(int enabled);
+// code, or "" when color is off
+const char *ui_color(const char *code);
+
+void ui_appendf(EmitBuffer *buf, const char *format, ...) __attribute__((format(printf, 2, 3)));
+// Write the buffer to stdout (after anything pending in stdio) and empty it
+void ui_flush(EmitBuffer *buf);
+
+void ui_render_header(EmitBuffer *buf, const char *title);
+void ui_render_separator(EmitBuffer *buf);
+void ui_render_category_header(EmitBuffer *buf, const char *category);
+void ui_render_field(EmitBuffer *buf, const void *base, const FieldMetadata *field);
+// -1 if the version has no field metadata
+int ui_render_eeprom(EmitBuffer *buf, const void *eeprom_struct, EEPROMVersion version);
+
 // ═══════════════════════════════════════════════════════════════
 // UI Helper Functions
 // ═══════════════════════════════════════════════════════════════
@@ -0,0 +1,503 @@
+#include "validate.h"
+#include "batch.h"
+#include "columns.h"
+#include "eeprom_ops.h"
+#include "eeprom_structure.h"
+#include "sweep.h"
+#include "topology.h"
+#include "ui.h"
+#include <ctype.h>
+#include <pthread.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// ═══════════════════════════════════════════════════════════════
+// Rules
+// ═══════════════════════════════════════════════════════════════
+// Images are gathered per worker into a batch of columns, then each rule
+// runs as one loop over the whole batch and sets its bit in the row's
+// checked / violations masks.
+
+#define VALIDATE_BATCH     256
+#define VALIDATE_NAME_LEN  256
+#define VALIDATE_MAX_NAMES 32     // Distinct unknown board names listed
+#define SENSOR_ADDRS       4
+
+typedef enum
+{
+	RULE_BOARD_NAME,
+	RULE_BOARD_UNKNOWN,
+	RULE_SENSOR_ADDR,
+	RULE_SWEEP_OVERFLOW,
+	RULE_COUNT
+} ValidateRule;
+
+static const struct
+{
+	const char *id;
+	const char *text;
+} rules[RULE_COUNT] =
+{
+	{ "board-name",     "Board name is blank" },
+	{ "board-unknown",  "No topol_*.conf for the board name" },
+	{ "sensor-addr",    "ASIC sensor address not among the config's sensors" },
+	{ "sweep-overflow", "Sweep levels set past chain_asic_num" },
+};
+
+typedef struct
+{
+	size_t rows;
+	char names[VALIDATE_BATCH][VALIDATE_NAME_LEN];         // Image names, for -v
+	char board[VALIDATE_BATCH][TOPOLOGY_NAME_LEN];         // "" if the layout has none
+	uint8_t has_board[VALIDATE_BATCH];                     // Layout has a board name
+	const TopologyBoard *topology[VALIDATE_BATCH];         // NULL if unknown
+	uint8_t has_sensors[VALIDATE_BATCH];                   // Layout stores sensor addresses
+	uint8_t sensor_addr[VALIDATE_BATCH][SENSOR_ADDRS];
+	uint8_t has_sweep[VALIDATE_BATCH];                     // Sweep region with a good CRC
+	uint8_t levels[VALIDATE_BATCH][SWEEP_LEVEL_BYTES];
+	uint8_t checked[VALIDATE_BATCH];                       // Bit per rule that applied
+	uint8_t violations[VALIDATE_BATCH];                    // Bit per rule that failed
+} ValidateBatch;
+
+static void rule_board_name(ValidateBatch *batch)
+{
+	for (size_t i = 0; i < batch->rows; i++)
+	{
+		uint8_t blank = batch->has_board[i] && batch->board[i][0] == '\0';
+		batch->checked[i] |= batch->has_board[i] << RULE_BOARD_NAME;
+		batch->violations[i] |= blank << RULE_BOARD_NAME;
+	}
+}
+
+static void rule_board_unknown(ValidateBatch *batch)
+{
+	for (size_t i = 0; i < batch->rows; i++)
+	{
+		uint8_t named = batch->board[i][0] != '\0';
+		uint8_t unknown = named && !batch->topology[i];
+		batch->checked[i] |= named << RULE_BOARD_UNKNOWN;
+		batch->violations[i] |= unknown << RULE_BOARD_UNKNOWN;
+	}
+}
+
+// 0x00 / 0xFF mean no address was recorded
+static void rule_sensor_addr(ValidateBatch *batch)
+{
+	for (size_t i = 0; i < batch->rows; i++)
+	{
+		const TopologyBoard *board = batch->topology[i];
+		if (!batch->has_sensors[i] || !board)
+		{
+			continue;
+		}
+
+		uint8_t allowed[256 / 8] = { 0 };
+		int configured = 0;
+		for (size_t s = 0; s < board->sensor_count; s++)
+		{
+			uint8_t addr = board->sensors[s].i2c_addr;
+			allowed[addr >> 3] |= (uint8_t)(addr ? 1u << (addr & 7) : 0);
+			configured |= addr != 0;
+		}
+		if (!configured)
+		{
+			continue;
+		}
+
+		uint8_t bad = 0;
+		for (size_t a = 0; a < SENSOR_ADDRS; a++)
+		{
+			uint8_t addr = batch->sensor_addr[i][a];
+			uint8_t set = addr != 0x00 && addr != 0xFF;
+			bad |= set & !((allowed[addr >> 3] >> (addr & 7)) & 1);
+		}
+		batch->checked[i] |= 1u << RULE_SENSOR_ADDR;
+		batch->violations[i] |= bad << RULE_SENSOR_ADDR;
+	}
+}
+
+// Levels are packed high nibble first, so ASIC n is the high nibble of
+// byte n / 2; everything after the last ASIC of the chain must be zero
+static void rule_sweep_overflow(ValidateBatch *batch)
+{
+	for (size_t i = 0; i < batch->rows; i++)
+	{
+		const TopologyBoard *board = batch->topology[i];
+		int asics = board ? board->chain.chain_asic_num : 0;
+		if (!batch->has_sweep[i] || asics <= 0 || asics >= SWEEP_MAX_ASICS)
+		{
+			continue;
+		}
+
+		const uint8_t *levels = batch->levels[i];
+		uint8_t tail = asics & 1 ? levels[asics / 2] & 0x0F : 0;
+		for (size_t b = (size_t)(asics + 1) / 2; b < SWEEP_LEVEL_BYTES; b++)
+		{
+			tail |= levels[b];
+		}
+		batch->checked[i] |= 1u << RULE_SWEEP_OVERFLOW;
+		batch->violations[i] |= (uint8_t)(tail != 0) << RULE_SWEEP_OVERFLOW;
+	}
+}
+
+static void (*const rule_checks[RULE_COUNT])(ValidateBatch*) =
+{
+	rule_board_name,
+	rule_board_unknown,
+	rule_sensor_addr,
+	rule_sweep_overflow,
+};
+
+// ═══════════════════════════════════════════════════════════════
+// Per-thread Totals
+// ═══════════════════════════════════════════════════════════════
+
+typedef struct
+{
+	char name[TOPOLOGY_NAME_LEN];
+	size_t count;
+} UnknownBoard;
+
+typedef struct
+{
+	size_t images;
+	size_t unknown_version;
+	size_t failed_images;          // Images with at least one violation
+	size_t checked[RULE_COUNT];
+	size_t violations[RULE_COUNT];
+	UnknownBoard unknown[VALIDATE_MAX_NAMES];
+	size_t unknown_count;
+	size_t unknown_other;          // Occurrences past VALIDATE_MAX_NAMES names
+} ValidateTotals;
+
+typedef struct
+{
+	const TopologyDB *topologies;
+	int verbose;
+	pthread_key_t key;             // Per-thread ValidateWorker
+	pthread_mutex_t lock;
+	ValidateTotals total;          // Workers are merged here
+} ValidateRun;
+
+typedef struct
+{
+	ValidateRun *run;
+	ValidateTotals totals;
+	ValidateBatch batch;
+} ValidateWorker;
+
+// Layout offsets of the board name and ASIC sensor addresses per
+// column slot (v1, v4, v5, v6, v17); size 0 = not in the layout
+static Column board_name_column;
+static const uint16_t sensor_offsets[COLUMN_VERSIONS] =
+{
+	0,
+	offsetof(EEPROMStructure, board_info.asic_sensor_addr),
+	offsetof(EEPROMStructure, board_info.asic_sensor_addr),
+	offsetof(EEPROMStructure, board_info.asic_sensor_addr),
+	offsetof(EEPROMStructure_v17, data.asic_sensor_addr),
+};
+static pthread_once_t bindings_once = PTHREAD_ONCE_INIT;
+
+static void build_bindings(void)
+{
+	column_bind(&board_name_column, "Board Name");
+}
+
+static void unknown_add(ValidateTotals *totals, const char *name, size_t count)
+{
+	for (size_t i = 0; i < totals->unknown_count; i++)
+	{
+		if (strcmp(totals->unknown[i].name, name) == 0)
+		{
+			totals->unknown[i].count += count;
+			return;
+		}
+	}
+	if (totals->unknown_count == VALIDATE_MAX_NAMES)
+	{
+		totals->unknown_other += count;
+		return;
+	}
+	UnknownBoard *entry = &totals->unknown[totals->unknown_count++];
+	snprintf(entry->name, sizeof(entry->name), "%s", name);
+	entry->count = count;
+}
+
+static void totals_merge(ValidateTotals *dst, const ValidateTotals *src)
+{
+	dst->images += src->images;
+	dst->unknown_version += src->unknown_version;
+	dst->failed_images += src->failed_images;
+	for (size_t r = 0; r < RULE_COUNT; r++)
+	{
+		dst->checked[r] += src->checked[r];
+		dst->violations[r] += src->violations[r];
+	}
+	for (size_t i = 0; i < src->unknown_count; i++)
+	{
+		unknown_add(dst, src->unknown[i].name, src->unknown[i].count);
+	}
+	dst->unknown_other += src->unknown_other;
+}
+
+// Run every rule over the batch, count and (with -v) list the results
+static void batch_flush(ValidateWorker *worker)
+{
+	ValidateBatch *batch = &worker->batch;
+	ValidateTotals *totals = &worker->totals;
+	if (batch->rows == 0)
+	{
+		return;
+	}
+
+	memset(batch->checked, 0, batch->rows);
+	memset(batch->violations, 0, batch->rows);
+	for (size_t r = 0; r < RULE_COUNT; r++)
+	{
+		rule_checks[r](batch);
+	}
+
+	for (size_t r = 0; r < RULE_COUNT; r++)
+	{
+		size_t checked = 0, violations = 0;
+		for (size_t i = 0; i < batch->rows; i++)
+		{
+			checked += (batch->checked[i] >> r) & 1;
+			violations += (batch->violations[i] >> r) & 1;
+		}
+		totals->checked[r] += checked;
+		totals->violations[r] += violations;
+	}
+
+	EmitBuffer buf = { 0 };
+	for (size_t i = 0; i < batch->rows; i++)
+	{
+		if (!batch->violations[i])
+		{
+			continue;
+		}
+		totals->failed_images++;
+		if (batch->violations[i] & (1u << RULE_BOARD_UNKNOWN))
+		{
+			unknown_add(totals, batch->board[i], 1);
+		}
+		if (worker->run->verbose)
+		{
+			ui_appendf(&buf, "  %-40s %-10s", batch->names[i], batch->board[i][0] ? batch->board[i] : "-");
+			for (size_t r = 0; r < RULE_COUNT; r++)
+			{
+				if ((batch->violations[i] >> r) & 1)
+				{
+					ui_appendf(&buf, " %s", rules[r].id);
+				}
+			}
+			emit_char(&buf, '\n');
+		}
+	}
+	if (buf.len)
+	{
+		pthread_mutex_lock(&worker->run->lock);
+		ui_flush(&buf);
+		pthread_mutex_unlock(&worker->run->lock);
+	}
+	emit_buffer_free(&buf);
+	batch->rows = 0;
+}
+
+// Key destructor: validate what is left and fold the worker into the total
+static void worker_retire(void *ptr)
+{
+	ValidateWorker *worker = (ValidateWorker*)ptr;
+	ValidateRun *run = worker->run;
+	batch_flush(worker);
+
+	pthread_mutex_lock(&run->lock);
+	totals_merge(&run->total, &worker->totals);
+	pthread_mutex_unlock(&run->lock);
+	free(worker);
+}
+
+// Board name without padding, e.g. "BHB42601"
+static void board_name_read(char *dst, const uint8_t *src, size_t size)
+{
+	size_t n = 0;
+	for (size_t i = 0; i < size && n + 1 < TOPOLOGY_NAME_LEN && isalnum(src[i]); i++)
+	{
+		dst[n++] = (char)src[i];
+	}
+	dst[n] = '\0';
+}
+
+static void batch_add(ValidateWorker *worker, const char *name, const uint8_t *decoded,
+					  int slot, const EEPROMCheck *check)
+{
+	ValidateBatch *batch = &worker->batch;
+	size_t row = batch->rows++;
+
+	snprintf(batch->names[row], VALIDATE_NAME_LEN, "%s", name);
+
+	const ColumnSource *source = &board_name_column.source[slot];
+	batch->has_board[row] = source->size != 0;
+	batch->board[row][0] = '\0';
+	if (source->size)
+	{
+		board_name_read(batch->board[row], decoded + source->offset, source->size);
+	}
+	batch->topology[row] = topology_find(worker->run->topologies, batch->board[row]);
+
+	batch->has_sensors[row] = sensor_offsets[slot] != 0;
+	memcpy(batch->sensor_addr[row], decoded + sensor_offsets[slot], SENSOR_ADDRS);
+
+	SweepBoard sweep;
+	batch->has_sweep[row] = sweep_board(decoded, check, &sweep) == 0;
+	if (batch->has_sweep[row])
+	{
+		memcpy(batch->levels[row], sweep.levels, SWEEP_LEVEL_BYTES);
+	}
+
+	if (batch->rows == VALIDATE_BATCH)
+	{
+		batch_flush(worker);
+	}
+}
+
+static int validate_image(const char *name, const uint8_t *raw, size_t size, void *ctx)
+{
+	ValidateRun *run = (ValidateRun*)ctx;
+	ValidateWorker *worker = pthread_getspecific(run->key);
+	if (!worker)
+	{
+		if (!(worker = calloc(1, sizeof(ValidateWorker))))
+		{
+			fprintf(stderr, "Error: Out of memory\n");
+			return 1;
+		}
+		worker->run = run;
+		pthread_setspecific(run->key, worker);
+	}
+
+	uint8_t data[EEPROM_SIZE];
+	memset(data, 0xFF, sizeof(data));
+	memcpy(data, raw, size);
+
+	worker->totals.images++;
+	EEPROMCheck check;
+	int slot = column_slot(data[0]);
+	if (slot < 0 || batch_decode(data, &check) == EEPROM_ERROR_VERSION)
+	{
+		worker->totals.unknown_version++;
+		return 0;
+	}
+	batch_add(worker, name, data, slot, &check);
+	return 0;
+}
+
+// ═══════════════════════════════════════════════════════════════
+// Report
+// ═══════════════════════════════════════════════════════════════
+
+static void render_report(EmitBuffer *buf, const ValidateTotals *total)
+{
+	ui_render_header(buf, "Topology Validation");
+	ui_appendf(buf, "  Images: %zu, unknown version: %zu, with violations: %zu\n\n",
+			   total->images, total->unknown_version, total->failed_images);
+	ui_appendf(buf, "  %-16s %9s %10s %7s  %s\n", "Rule", "Checked", "Violations", "%", "Description");
+	ui_render_separator(buf);
+	for (size_t r = 0; r < RULE_COUNT; r++)
+	{
+		double share = total->checked[r] ? 100.0 * (double)total->violations[r] / (double)total->checked[r] : 0.0;
+		ui_appendf(buf, "  %-16s %9zu %10zu %6.2f%%  %s\n", rules[r].id, total->checked[r],
+				   total->violations[r], share, rules[r].text);
+	}
+	ui_render_separator(buf);
+
+	if (total->unknown_count)
+	{
+		ui_render_category_header(buf, "Boards without topology");
+		for (size_t i = 0; i < total->unknown_count; i++)
+		{
+			ui_appendf(buf, "  %-22s %zu\n", total->unknown[i].name, total->unknown[i].count);
+		}
+		if (total->unknown_other)
+		{
+			ui_appendf(buf, "  %-22s %zu\n", "(other)", total->unknown_other);
+		}
+	}
+}
+
+// ═══════════════════════════════════════════════════════════════
+// CLI
+// ═══════════════════════════════════════════════════════════════
+
+int cmd_validate(int argc, char **argv)
+{
+	ValidateRun run;
+	memset(&run, 0, sizeof(run));
+	const char *topology_dir = NULL;
+	char *paths[argc > 0 ? argc : 1];
+	int path_count = 0;
+
+	for (int i = 0; i < argc; i++)
+	{
+		if (batch_parse_option(argc, argv, &i))
+		{
+			continue;
+		}
+		if (strcmp(argv[i], "-t") == 0 && i + 1 < argc)
+		{
+			topology_dir = argv[++i];
+		}
+		else if (strcmp(argv[i], "-v") == 0)
+		{
+			run.verbose = 1;
+		}
+		else
+		{
+			paths[path_count++] = argv[i];
+		}
+	}
+
+	if (path_count == 0 || !topology_dir)
+	{
+		fprintf(stderr, "Usage: eeprom_tool validate -t TOPOLOGY_DIR [-v] PATH...\n");
+		return 1;
+	}
+
+	TopologyDB *topologies = topology_open(topology_dir);
+	if (!topologies)
+	{
+		return 1;
+	}
+	pthread_once(&bindings_once, build_bindings);
+	run.topologies = topologies;
+	if (pthread_key_create(&run.key, worker_retire) != 0)
+	{
+		fprintf(stderr, "Error: Out of memory\n");
+		topology_close(topologies);
+		return 1;
+	}
+	pthread_mutex_init(&run.lock, NULL);
+
+	// Workers validate their last batch and merge as they exit
+	batch_for_each_parallel(paths, path_count, validate_image, &run, NULL);
+
+	ValidateWorker *own = pthread_getspecific(run.key);
+	if (own)
+	{
+		pthread_setspecific(run.key, NULL);
+		worker_retire(own);
+	}
+	pthread_key_delete(run.key);
+	pthread_mutex_destroy(&run.lock);
+
+	EmitBuffer buf = { 0 };
+	render_report(&buf, &run.total);
+	ui_flush(&buf);
+	emit_buffer_free(&buf);
+
+	topology_close(topologies);
+	return run.total.failed_images ? 2 : 0;
+}
@@ -0,0 +1,11 @@
+#ifndef VALIDATE_H
+#define VALIDATE_H
+
+// CLI: eeprom_tool validate -t TOPOLOGY_DIR [-v] PATH...
+// Joins every decoded image with the topology of its board name and
+// counts values the board type cannot have (unknown board, sensor
+// addresses not in the config, sweep levels past the chain's ASICs).
+// -v lists each image with a violation. Exits with 2 if any was found.
+int cmd_validate(int argc, char **argv);
+
+#endif // VALIDATE_H